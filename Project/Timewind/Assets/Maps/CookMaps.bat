@@ -0,0 +1,2 @@
+..\..\x64\Release\MapCooker.exe Level1.csv Level1-2.csv Level1-3.csv Level1-4.csv MainMenuBackground.csv Sandbox.csv
+pause
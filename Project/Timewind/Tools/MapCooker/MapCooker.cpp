@@ -0,0 +1,160 @@
+/*************************************************************************************************/
+/*!
+\file MapCooker.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Command line tool that cooks csv maps into the binary map format the game loads.
+	Usage: MapCooker <map.csv> [more maps...]
+	Each map is written next to its csv with the .cmap extension.
+
+    Functions include:
+        + main
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// The cooked map format shared with the game
+#include "../../source/Gameplay/CookedMap.h"
+
+// Console output and file reading
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Cooks a single csv map and writes it to disk
+
+	\param csvFilename
+		The map to cook
+
+	\return
+		Whether the map was cooked
+*/
+/*************************************************************************************************/
+static bool CookMap(const std::string& csvFilename);
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The starting function of the program
+
+	\return
+		Returns 0 if every map was cooked, 1 otherwise
+*/
+/*************************************************************************************************/
+int main(int argc, char** argv)
+{
+	// Prints the usage if no maps were given
+	if (argc < 2)
+	{
+		std::cout << "Usage: MapCooker <map.csv> [more maps...]" << std::endl;
+		return 1;
+	}
+
+	// Cooks each map, carrying on past failures so every broken map gets reported
+	bool allCooked = true;
+	for (int i = 1; i < argc; i++)
+	{
+		allCooked = CookMap(argv[i]) && allCooked;
+	}
+
+	return allCooked ? 0 : 1;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Cooks a single csv map and writes it to disk
+
+	\param csvFilename
+		The map to cook
+
+	\return
+		Whether the map was cooked
+*/
+/*************************************************************************************************/
+static bool CookMap(const std::string& csvFilename)
+{
+	// Reads in the csv
+	std::ifstream csvFile(csvFilename, std::ios::binary);
+	if (!csvFile)
+	{
+		std::cout << "Error: failed to open " << csvFilename << std::endl;
+		return false;
+	}
+	std::string csvData((std::istreambuf_iterator<char>(csvFile)), std::istreambuf_iterator<char>());
+
+	// Cooks the map
+	std::vector<uint8_t> cookedImage;
+	std::string error;
+	if (!CookedMap::CookFromCsv(csvData.data(), csvData.size(), cookedImage, error))
+	{
+		std::cout << "Error: " << csvFilename << ": " << error << std::endl;
+		return false;
+	}
+
+	// Swaps the extension for the cooked one
+	std::string cookedFilename = csvFilename;
+	size_t extension = cookedFilename.find_last_of('.');
+	if (extension != std::string::npos && cookedFilename.find_first_of("/\\", extension) == std::string::npos)
+	{
+		cookedFilename.erase(extension);
+	}
+	cookedFilename += ".cmap";
+
+	// Writes the map
+	if (!CookedMap::WriteToFile(cookedFilename, cookedImage))
+	{
+		std::cout << "Error: failed to write " << cookedFilename << std::endl;
+		return false;
+	}
+
+	// Reopens the written file the same way the game does to make sure it validates
+	CookedMap cookedMap;
+	if (!cookedMap.Open(cookedFilename))
+	{
+		std::cout << "Error: " << cookedMap.GetError() << std::endl;
+		return false;
+	}
+
+	std::cout << csvFilename << " -> " << cookedFilename << " (" << cookedMap.GetWidth() << "x" << cookedMap.GetHeight() << ", "
+		<< cookedMap.GetSpecialTileCount() << " special tiles, " << cookedImage.size() << " bytes)" << std::endl;
+	return true;
+}
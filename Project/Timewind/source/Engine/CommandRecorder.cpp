@@ -0,0 +1,350 @@
+/*************************************************************************************************/
+/*!
+\file CommandRecorder.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Records a render pass's draws on several threads at once. Each worker has its own command
+	pool for every frame in flight and records secondary command buffers that continue the
+	render pass, which the frame's primary command buffer then runs in order
+
+    Functions include:
+        + CommandRecorder::CommandRecorder
+		+ CommandRecorder::~CommandRecorder
+		+ CommandRecorder::Init
+		+ CommandRecorder::BeginFrame
+		+ CommandRecorder::BeginPass
+		+ CommandRecorder::BeginSecondary
+		+ CommandRecorder::Run
+		+ CommandRecorder::Free
+		+ CommandRecorder::WorkerLoop
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "CommandRecorder.h"
+#include "cppShortcuts.h"
+
+// Checking vulkan results
+#include "Window.h"
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the command recorder class
+*/
+/*************************************************************************************************/
+CommandRecorder::CommandRecorder() : device(VK_NULL_HANDLE), workerCount(1), currentFrame(0), passState(), taskCount(0), remainingTasks(0), round(0), stopping(false)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the command recorder class
+*/
+/*************************************************************************************************/
+CommandRecorder::~CommandRecorder()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes the command pools and starts the worker threads
+
+	\param vkDevice
+		The logical device
+
+	\param graphicsFamily
+		The queue family the command buffers are submitted to
+
+	\param framesInFlight
+		How many frames can be recorded before the oldest one is finished
+
+	\param workerCount_
+		How many threads record at once, counting the thread that calls Run
+*/
+/*************************************************************************************************/
+void CommandRecorder::Init(VkDevice vkDevice, uint32_t graphicsFamily, int framesInFlight, int workerCount_)
+{
+	device = vkDevice;
+	workerCount = workerCount_ < 1 ? 1 : workerCount_;
+
+	// Command pools can't be used by two threads at once, so every worker gets its own for each
+	// frame in flight. Buffers are reset together by resetting the pool
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	poolInfo.queueFamilyIndex = graphicsFamily;
+
+	frames.resize(framesInFlight);
+	for (std::vector<WorkerFrame>& frame : frames)
+	{
+		frame.resize(workerCount);
+		for (WorkerFrame& workerFrame : frame)
+		{
+			_Window->CheckVulkanSuccess(vkCreateCommandPool(device, &poolInfo, NULL, &workerFrame.pool), "failed to create recording command pool!");
+			workerFrame.used = 0;
+		}
+	}
+
+	// Worker 0 is whoever calls Run
+	for (int i = 1; i < workerCount; i++)
+	{
+		threads.emplace_back(&CommandRecorder::WorkerLoop, this, i);
+	}
+
+	_Debug->Print(Debug::MessageType::Debug, "CommandRecorder: Recording on " + std::to_string(workerCount) + " threads");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts a new frame, resetting every secondary command buffer the frame used last
+		time. Only call once the frame's fence has been waited on
+
+	\param frame
+		The index of the frame in flight being recorded
+*/
+/*************************************************************************************************/
+void CommandRecorder::BeginFrame(int frame)
+{
+	currentFrame = frame;
+	for (WorkerFrame& workerFrame : frames[currentFrame])
+	{
+		vkResetCommandPool(device, workerFrame.pool, 0);
+		workerFrame.used = 0;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets the render pass that secondary command buffers continue. The pass must be begun
+		with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+
+	\param passState_
+		The pass's render pass, framebuffer, pipeline and frame set
+*/
+/*************************************************************************************************/
+void CommandRecorder::BeginPass(const PassState& passState_)
+{
+	passState = passState_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts a secondary command buffer that continues the current pass, with the pass's
+		pipeline, viewport, scissor and frame set already bound. Only call from inside Run,
+		with the worker index Run gave the task
+
+	\param worker
+		The worker recording the command buffer
+
+	\return
+		The command buffer, ready to draw into
+*/
+/*************************************************************************************************/
+VkCommandBuffer CommandRecorder::BeginSecondary(int worker)
+{
+	// Reuses one of the worker's buffers from last time this frame came around, or makes another
+	WorkerFrame& workerFrame = frames[currentFrame][worker];
+	if (workerFrame.used == workerFrame.buffers.size())
+	{
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = workerFrame.pool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandBufferCount = 1;
+
+		VkCommandBuffer newBuffer;
+		_Window->CheckVulkanSuccess(vkAllocateCommandBuffers(device, &allocInfo, &newBuffer), "failed to allocate secondary command buffer!");
+		workerFrame.buffers.push_back(newBuffer);
+	}
+	VkCommandBuffer commandBuffer = workerFrame.buffers[workerFrame.used++];
+
+	// Continues the pass's only subpass
+	VkCommandBufferInheritanceInfo inheritanceInfo{};
+	inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritanceInfo.renderPass = passState.renderPass;
+	inheritanceInfo.subpass = 0;
+	inheritanceInfo.framebuffer = passState.framebuffer;
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	beginInfo.pInheritanceInfo = &inheritanceInfo;
+	vkBeginCommandBuffer(commandBuffer, &beginInfo);
+
+	// Nothing carries over from the primary command buffer, so the pass's state is set again
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, passState.pipeline);
+
+	VkViewport viewport{};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = static_cast<float>(passState.extent.width);
+	viewport.height = static_cast<float>(passState.extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = passState.extent;
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, passState.pipelineLayout, 0, 1, &passState.frameSet, 0, NULL);
+
+	return commandBuffer;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Runs tasks on the workers and waits for them all. Task i runs on worker i, and the
+		calling thread runs task 0 itself
+
+	\param taskCount_
+		How many tasks to run, at most the worker count
+
+	\param task
+		The work, given the task's index
+*/
+/*************************************************************************************************/
+void CommandRecorder::Run(int taskCount_, const std::function<void(int)>& task)
+{
+	// A single task isn't worth waking anyone for
+	if (taskCount_ <= 1)
+	{
+		if (taskCount_ == 1)
+		{
+			task(0);
+		}
+		return;
+	}
+
+	// Starts a new round for the worker threads
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentTask = task;
+		taskCount = taskCount_ < workerCount ? taskCount_ : workerCount;
+		remainingTasks = taskCount - 1;
+		round++;
+	}
+	startCondition.notify_all();
+
+	// Does the first task here rather than sit idle
+	task(0);
+
+	// Waits for the rest
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCondition.wait(lock, [this]() { return remainingTasks == 0; });
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Stops the worker threads and destroys the command pools. The device must be idle
+*/
+/*************************************************************************************************/
+void CommandRecorder::Free()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	startCondition.notify_all();
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	threads.clear();
+
+	// Destroying the pools frees their command buffers too
+	for (std::vector<WorkerFrame>& frame : frames)
+	{
+		for (WorkerFrame& workerFrame : frame)
+		{
+			vkDestroyCommandPool(device, workerFrame.pool, NULL);
+		}
+	}
+	frames.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Waits for rounds of tasks and runs this worker's task from each
+
+	\param worker
+		The worker the thread is
+*/
+/*************************************************************************************************/
+void CommandRecorder::WorkerLoop(int worker)
+{
+	uint64_t lastRound = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		startCondition.wait(lock, [this, lastRound]() { return stopping || round != lastRound; });
+		if (stopping)
+		{
+			return;
+		}
+		lastRound = round;
+
+		// Rounds with fewer tasks than workers leave the last workers out
+		if (worker >= taskCount)
+		{
+			continue;
+		}
+
+		lock.unlock();
+		currentTask(worker);
+		lock.lock();
+
+		if (--remainingTasks == 0)
+		{
+			doneCondition.notify_one();
+		}
+	}
+}
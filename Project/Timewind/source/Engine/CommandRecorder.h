@@ -0,0 +1,286 @@
+/*************************************************************************************************/
+/*!
+\file CommandRecorder.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Records a render pass's draws on several threads at once. Each worker has its own command
+	pool for every frame in flight and records secondary command buffers that continue the
+	render pass, which the frame's primary command buffer then runs in order
+
+    Public Functions:
+        + CommandRecorder
+		+ ~CommandRecorder
+		+ Init
+		+ BeginFrame
+		+ BeginPass
+		+ BeginSecondary
+		+ Run
+		+ Free
+		+ GetWorkerCount
+		+ GetPassState
+
+	Private Functions:
+		+ WorkerLoop
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_CommandRecorder_H_
+#define Syncopatience_CommandRecorder_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The worker threads and the work handed to them
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The command recorder class
+*/
+/*************************************************************************************************/
+class CommandRecorder
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// Everything a secondary command buffer needs to continue a render pass. Secondary command
+	// buffers start with no state, so each one binds all of this itself
+	typedef struct
+	{
+		VkRenderPass renderPass;				// The render pass being continued
+		VkFramebuffer framebuffer;				// The framebuffer the pass draws to
+		VkPipeline pipeline;					// The pipeline the pass draws with
+		VkPipelineLayout pipelineLayout;		// The pipeline's layout
+		VkDescriptorSet frameSet;				// The frame's uniform set, bound to set 0
+		VkExtent2D extent;						// The size of the viewport and scissor
+	}PassState;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the command recorder class
+	*/
+	/*************************************************************************************************/
+	CommandRecorder();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the command recorder class
+	*/
+	/*************************************************************************************************/
+	~CommandRecorder();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes the command pools and starts the worker threads
+
+		\param vkDevice
+			The logical device
+
+		\param graphicsFamily
+			The queue family the command buffers are submitted to
+
+		\param framesInFlight
+			How many frames can be recorded before the oldest one is finished
+
+		\param workerCount_
+			How many threads record at once, counting the thread that calls Run
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, uint32_t graphicsFamily, int framesInFlight, int workerCount_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts a new frame, resetting every secondary command buffer the frame used last
+			time. Only call once the frame's fence has been waited on
+
+		\param frame
+			The index of the frame in flight being recorded
+	*/
+	/*************************************************************************************************/
+	void BeginFrame(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets the render pass that secondary command buffers continue. The pass must be begun
+			with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+
+		\param passState_
+			The pass's render pass, framebuffer, pipeline and frame set
+	*/
+	/*************************************************************************************************/
+	void BeginPass(const PassState& passState_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts a secondary command buffer that continues the current pass, with the pass's
+			pipeline, viewport, scissor and frame set already bound. Only call from inside Run,
+			with the worker index Run gave the task
+
+		\param worker
+			The worker recording the command buffer
+
+		\return
+			The command buffer, ready to draw into
+	*/
+	/*************************************************************************************************/
+	VkCommandBuffer BeginSecondary(int worker);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Runs tasks on the workers and waits for them all. Task i runs on worker i, and the
+			calling thread runs task 0 itself
+
+		\param taskCount
+			How many tasks to run, at most the worker count
+
+		\param task
+			The work, given the task's index
+	*/
+	/*************************************************************************************************/
+	void Run(int taskCount, const std::function<void(int)>& task);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Stops the worker threads and destroys the command pools. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many threads record at once, counting the thread that calls Run
+
+		\return
+			The worker count
+	*/
+	/*************************************************************************************************/
+	int GetWorkerCount() { return workerCount; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the pass secondary command buffers are continuing
+
+		\return
+			The pass state
+	*/
+	/*************************************************************************************************/
+	const PassState& GetPassState() { return passState; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// One worker's command buffers for one frame in flight
+	typedef struct
+	{
+		VkCommandPool pool;						// Only ever used by the one worker
+		std::vector<VkCommandBuffer> buffers;	// Every secondary command buffer made so far, kept for reuse
+		size_t used;							// How many of the buffers the frame has used
+	}WorkerFrame;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device
+	int workerCount;							// Threads recording at once, counting the caller of Run
+	int currentFrame;							// The frame being recorded
+	PassState passState;						// The pass secondary command buffers continue
+	std::vector<std::vector<WorkerFrame>> frames;	// Each frame in flight's command buffers, per worker
+
+	std::vector<std::thread> threads;			// The worker threads, one less than the worker count
+	std::mutex mutex;							// Guards everything below
+	std::condition_variable startCondition;		// Wakes the workers when there's a new round of tasks
+	std::condition_variable doneCondition;		// Wakes Run when the last worker is done
+	std::function<void(int)> currentTask;		// The work of the current round
+	int taskCount;								// How many tasks the current round has
+	int remainingTasks;							// Tasks on the worker threads that haven't finished
+	uint64_t round;								// Counts rounds so workers can tell a new one started
+	bool stopping;								// Tells the workers to exit
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Waits for rounds of tasks and runs this worker's task from each
+
+		\param worker
+			The worker the thread is
+	*/
+	/*************************************************************************************************/
+	void WorkerLoop(int worker);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_CommandRecorder_H_
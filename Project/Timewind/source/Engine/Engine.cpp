@@ -9,6 +9,7 @@
 
     Public Functions:
         + Engine::createEngine
+		+ Engine::SetLaunchOptions
 		+ Engine::~Engine
 		+ Engine::Init
 		+ Engine::Update
@@ -51,6 +52,8 @@ Copyright (c) 2023 Aiden Cvengros
 #include "../Game_Objects/Camera.h"
 #include "../Scenes/Scene.h"
 #include <sstream>
+#include <algorithm>
+#include <chrono>
 
 //-------------------------------------------------------------------------------------------------
 // Private Constants
@@ -61,6 +64,7 @@ Copyright (c) 2023 Aiden Cvengros
 //-------------------------------------------------------------------------------------------------
 
 Engine* Engine::engineInstance;			// Forward reference for the engine instance
+Engine::LaunchOptions Engine::launchOptions = { false, 0, {}, "Captures", false, 0, false, false, 0, 2, 0 };	// Runs in a window until closed by default
 
 Texture* tempTexture;																				// TEMP CODE
 Texture* tempTexture2;																				// TEMP CODE
@@ -105,6 +109,20 @@ Engine* Engine::createEngine()
 	return engineInstance;
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets how the engine runs. Only has an effect before the engine is created
+
+	\param options
+		The launch options
+*/
+/*************************************************************************************************/
+void Engine::SetLaunchOptions(const LaunchOptions& options)
+{
+	launchOptions = options;
+}
+
 /*********************************************************************************************/
 /*!
 	\brief
@@ -129,9 +147,37 @@ void Engine::Init()
 	debugSystem->Init();
 
 	// Creates and initializes the game window
-	gameWindow = new Window(1200, 900, "Retrofit");
+	gameWindow = new Window(1200, 900, "Retrofit", 2, launchOptions.headless);
+	gameWindow->SetCrtQuality((Window::CrtQuality)launchOptions.crtQuality, launchOptions.crtCompute);
+	gameWindow->GetResolutionScaler()->SetEnabled(!launchOptions.fixedResolution);
+	gameWindow->SetRenderConfig({ (Window::PresentMode)launchOptions.presentMode, launchOptions.framesInFlight, (uint32_t)launchOptions.swapChainImages });
 	gameWindow->Init();
 
+	// Headless runs have no close button, so they stop after a set number of frames
+	if (launchOptions.headless)
+	{
+		if (launchOptions.frameLimit == 0)
+		{
+			launchOptions.frameLimit = launchOptions.captureFrames.empty() ? DEFAULT_HEADLESS_FRAMES
+				: *std::max_element(launchOptions.captureFrames.begin(), launchOptions.captureFrames.end());
+		}
+
+		FrameCapture* frameCapture = gameWindow->GetFrameCapture();
+		frameCapture->SetOutput(launchOptions.captureDirectory, launchOptions.capturePpm ? FrameCapture::Format::Ppm : FrameCapture::Format::Png);
+		for (unsigned long long captureFrame : launchOptions.captureFrames)
+		{
+			frameCapture->Request(captureFrame);
+		}
+		if (!launchOptions.goldenDirectory.empty())
+		{
+			frameCapture->SetGolden(launchOptions.goldenDirectory, launchOptions.goldenTolerance);
+		}
+	}
+	else if (!launchOptions.captureFrames.empty())
+	{
+		_Debug->Print(Debug::MessageType::Error, "Engine: Frames can only be captured when running headless");
+	}
+
 	// Adds essential game systems to the system list
 	InputManager* inputManager = new InputManager();
 	AudioManager* audioManager = new AudioManager();
@@ -167,8 +213,9 @@ void Engine::Init()
 /*********************************************************************************************/
 void Engine::Update()
 {
-	// Creates the game loop until the window is closed
-	while (!glfwWindowShouldClose(_Window->GetVulkanWindowPtr()))
+	// Creates the game loop until the window is closed or the frame limit is reached
+	std::chrono::steady_clock::time_point loopStart = std::chrono::steady_clock::now();
+	while (!_Window->ShouldClose() && (launchOptions.frameLimit == 0 || frameCount < launchOptions.frameLimit))
 	{
 		// Updates the frame count
 		frameCount++;
@@ -178,11 +225,16 @@ void Engine::Update()
 		frameCountString << "Start of frame " << frameCount;
 		_Debug->Print(Debug::MessageType::Debug, frameCountString.str());
 
-		// Tracks how long it has been since the previous frame
-		double newTime = glfwGetTime();
-		double dt = std::min(newTime - lastTime, 0.1);
-		lastTime = newTime;
-		dt = fmin(dt, 0.1);
+		// Tracks how long it has been since the previous frame. Headless runs step by a fixed
+		// amount so the same frame number always shows the same thing
+		double dt = HEADLESS_FRAME_TIME;
+		if (!launchOptions.headless)
+		{
+			double newTime = glfwGetTime();
+			dt = std::min(newTime - lastTime, 0.1);
+			lastTime = newTime;
+			dt = fmin(dt, 0.1);
+		}
 		totalTime += dt;
 #ifdef _DEBUG
 		// Prints out the framerate. Debug only
@@ -199,9 +251,25 @@ void Engine::Update()
 			system->Update(dt);
 		}
 
+		// Headless runs are benchmarks, so their last frame's render numbers go in the log
+		if (launchOptions.headless && frameCount == launchOptions.frameLimit)
+		{
+			_Window->RequestFrameStats();
+		}
+
 		// After updating, draws to screen
 		Draw();
 	}
+
+	// Reports how fast frames were drawn, which is the benchmark result for headless runs
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loopStart).count();
+	std::stringstream throughputString;
+	throughputString << "Engine: Drew " << frameCount << " frames in " << seconds << " s (" << (seconds > 0.0 ? frameCount / seconds : 0.0) << " fps)";
+	_Debug->Print(Debug::MessageType::Debug, throughputString.str());
+	if (launchOptions.headless)
+	{
+		std::cout << throughputString.str() << std::endl;
+	}
 }
 
 /*********************************************************************************************/
@@ -222,10 +290,6 @@ void Engine::Draw()
 		system->Draw();
 	}
 
-	// Starts the mask render pass draw
-	_Window->DrawMaskRenderPass();
-	_GameObjectManager->DrawGlitches();
-
 	// Finishes the drawing commands for this frame
 	_Window->CleanupDraw();
 }
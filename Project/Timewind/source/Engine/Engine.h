@@ -9,6 +9,7 @@
 
     Public Functions:
         + Engine::createEngine
+		+ Engine::SetLaunchOptions
 		+ Engine::~Engine
 		+ Engine::Init
 		+ Engine::Update
@@ -37,6 +38,10 @@ Copyright (c) 2023 Aiden Cvengros
 #include "System.h"
 #include <map>
 
+// The launch options
+#include <string>
+#include <vector>
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
@@ -68,9 +73,30 @@ public:
 	// Public Consts
 	//---------------------------------------------------------------------------------------------
 
+	static const unsigned long long DEFAULT_HEADLESS_FRAMES = 600;	// Frames a headless run draws when not told how many
+	static constexpr double HEADLESS_FRAME_TIME = 1.0 / 60.0;		// The fixed dt of headless runs, so every run draws the same frames
+
 	//---------------------------------------------------------------------------------------------
 	// Public Structures
 	//---------------------------------------------------------------------------------------------
+
+	// How the engine was asked to run, from the command line
+	typedef struct
+	{
+		bool headless;							// Renders offscreen with no window, for tests and benchmarks
+		unsigned long long frameLimit;			// Frames to draw before quitting, 0 to run until closed
+		std::vector<unsigned long long> captureFrames;	// Frames to read back and write out, headless only
+		std::string captureDirectory;			// Where captured frames are written
+		bool capturePpm;						// Writes raw PPM files instead of PNG
+		int crtQuality;							// How much of the CRT look is drawn, as a Window::CrtQuality
+		bool crtCompute;						// Runs the CRT filter's horizontal pass as a compute shader
+		bool fixedResolution;					// Always draws the scene at full size instead of following the GPU time
+		int presentMode;						// How frames are handed to the screen, as a Window::PresentMode
+		int framesInFlight;						// Frames the CPU can record ahead of the GPU
+		int swapChainImages;					// Images to ask the swap chain for, 0 for the window's default
+		std::string goldenDirectory;			// Captures to compare against, empty to not compare
+		int goldenTolerance;					// The most a channel may differ from the golden frame by
+	}LaunchOptions;
 	
 	//---------------------------------------------------------------------------------------------
 	// Public Variables
@@ -92,6 +118,17 @@ public:
 	/*************************************************************************************************/
 	static Engine* createEngine();
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets how the engine runs. Only has an effect before the engine is created
+
+		\param options
+			The launch options
+	*/
+	/*************************************************************************************************/
+	static void SetLaunchOptions(const LaunchOptions& options);
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -169,6 +206,14 @@ public:
 	*/
 	/*********************************************************************************************/
 	double GetTotalTime() { return totalTime; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Gets the number of the frame being run, starting from 1
+	*/
+	/*********************************************************************************************/
+	unsigned long long GetFrameCount() { return frameCount; }
 	
 private:
 	//---------------------------------------------------------------------------------------------
@@ -184,6 +229,7 @@ private:
 	//---------------------------------------------------------------------------------------------
 	
 	static Engine* engineInstance;						// Points to the singleton engine instance
+	static LaunchOptions launchOptions;					// How the engine was asked to run
 
 	std::map<System::SystemTypes, System *> systemList;	// Holds a list of all systems that need to be managed
 	Window* gameWindow;									// Points to the window so the engine can communicate directly with the window
@@ -5,10 +5,21 @@
 \par email: ajcvengros\@gmail.com
 \date 2026.4.06
 \brief
-    The font class
+    The font class. Holds a signed distance field atlas of the font's glyphs, which stays sharp
+	at every text size. The atlas, glyph metrics and kerning are cached to a file next to the
+	font, so after the first run loading a font is a file read and one texture upload. Characters
+	past the atlas's ascii are rendered by the font's glyph cache the first time they're drawn
 
     Functions include:
-        + [FILL]
+        + Font::Font
+		+ Font::~Font
+		+ Font::Free
+		+ Font::GetCharacter
+		+ Font::GetKerning
+		+ Font::LoadCache
+		+ Font::GenerateAtlas
+		+ Font::SaveCache
+		+ HashBytes
 
 Copyright (c) 2023 Aiden Cvengros
 */
@@ -28,17 +39,57 @@ Copyright (c) 2023 Aiden Cvengros
 
 // Includes freetype
 #include <ft2build.h>
-#include FT_FREETYPE_H  
+#include FT_FREETYPE_H
+#include FT_MODULE_H
 
 // Extra includes
-#include <unordered_map>
 #include "../Engine/Texture.h"
 #include <algorithm>
 
+// Reading the font and reading and writing the cache file
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+// Swapping the finished file into place
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
+// The size glyphs are rendered at. The distance field scales, so one size covers all text sizes
+const uint32_t glyphPixelSize = 48;
+
+// How far the distance field reaches past each outline, in pixels. It's also the padding around
+// each glyph, and it's what keeps edges smooth when text is drawn much smaller
+const uint32_t sdfSpread = 6;
+
+// Width of the atlas. Its height is however tall the packed glyphs come out
+const uint32_t atlasPixelWidth = 512;
+
+// Empty pixels between packed glyphs, so filtering never reads a neighbor
+const uint32_t glyphGap = 1;
+
+// The characters in the atlas
+const unsigned int characterCount = 128;
+
+// The printable characters kerning pairs are read for
+const unsigned int firstKernedCharacter = 32;
+const unsigned int lastKernedCharacter = 126;
+
+// What's added to the font's filename for its cache file
+const std::string cacheExtension = ".sdfcache";
+
+const uint32_t fnvOffsetBasis = 2166136261u;	// FNV-1a starting value
+const uint32_t fnvPrime = 16777619u;			// FNV-1a multiplier
+
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
 //-------------------------------------------------------------------------------------------------
@@ -55,6 +106,8 @@ Copyright (c) 2023 Aiden Cvengros
 // Private Function Declarations
 //-------------------------------------------------------------------------------------------------
 
+static uint32_t HashBytes(const uint8_t* data, size_t size);
+
 //-------------------------------------------------------------------------------------------------
 // Public Function Definitions
 //-------------------------------------------------------------------------------------------------
@@ -68,134 +121,507 @@ Copyright (c) 2023 Aiden Cvengros
 		The name and location of the font file
 */
 /*************************************************************************************************/
-Font::Font(std::string filename_) : bmpHeight(0), invertedBmpWidth(0.0f), texture(NULL)
+Font::Font(std::string filename_) : bmpHeight(0), atlasWidth(0), atlasHeight(0), invertedAtlasSize(0.0f), texture(NULL)
 {
 	// Sets the given variables
 	filename = filename_;
 
+	// Reads the whole font, since the cache is keyed by its contents
+	std::vector<uint8_t> fontData;
+	std::ifstream fontFile(filename, std::ios::binary | std::ios::ate);
+	if (fontFile)
+	{
+		std::streamoff fileSize = fontFile.tellg();
+		fontData.resize(fileSize > 0 ? (size_t)fileSize : 0);
+		fontFile.seekg(0);
+		fontFile.read((char*)fontData.data(), fontData.size());
+	}
+	if (!fontFile || fontData.empty())
+	{
+		_Debug->Print(Debug::MessageType::Error, "Font: Failed to read " + filename);
+		return;
+	}
+	uint32_t fontHash = HashBytes(fontData.data(), fontData.size());
+
+	// Everything past the atlas is rendered at the same size and spread when it's first drawn
+	glyphCache.Init(fontData, filename, glyphPixelSize, sdfSpread);
+
+	// Only renders the glyphs if there's no cache made from this exact font and these settings
+	std::vector<uint8_t> atlas;
+	if (LoadCache(fontHash, (uint32_t)fontData.size(), atlas))
+	{
+		_Debug->Print(Debug::MessageType::Debug, "Font: Loaded " + filename + " from its cache");
+	}
+	else
+	{
+		characters.clear();
+		kerning.clear();
+		if (!GenerateAtlas(fontData, atlas))
+		{
+			return;
+		}
+
+		if (!SaveCache(fontHash, (uint32_t)fontData.size(), atlas))
+		{
+			_Debug->Print(Debug::MessageType::Error, "Font: Failed to write " + filename + cacheExtension);
+		}
+	}
+
+	invertedAtlasSize = glm::vec2(1.0f / (float)atlasWidth, 1.0f / (float)atlasHeight);
+	texture = new Texture(atlasWidth, atlasHeight, atlas.data());
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the camera class
+*/
+/*************************************************************************************************/
+Font::~Font()
+{
+	// Frees the texture from memory if it is getting destroyed
+	Free();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Frees the texture from memory
+*/
+/*************************************************************************************************/
+void Font::Free()
+{
+	if (texture)
+	{
+		texture->Free();
+	}
+	glyphCache.Free();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the font data for the given character. Characters outside the atlas are
+		rendered into the glyph cache if they aren't there yet
+
+	\param codepoint
+		The character's unicode codepoint
+
+	\param character
+		Set to that character's font data
+
+	\return
+		Whether the character is ready. False means it has to wait for a later frame
+*/
+/*************************************************************************************************/
+bool Font::GetCharacter(uint32_t codepoint, Character& character)
+{
+	if (codepoint < characterCount)
+	{
+		auto it = characters.find((char)codepoint);
+		character = it != characters.end() ? it->second : Character{ glm::ivec2(0), glm::ivec2(0), glm::ivec2(0), 0 };
+		character.texture = texture;
+		character.cacheSlot = -1;
+		return true;
+	}
+
+	GlyphCache::Entry entry;
+	int slot;
+	bool ready = glyphCache.Find(codepoint, entry, slot);
+	character = { entry.size, entry.bearing, entry.atlasPosition, entry.advance, entry.page, slot };
+	return ready;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns how much closer or further apart two characters sit than their advance says
+
+	\param left
+		The first character's codepoint
+
+	\param right
+		The codepoint of the character after it
+
+	\return
+		The adjustment in the font's pixels, 0 for most pairs and any pair outside ascii
+*/
+/*************************************************************************************************/
+float Font::GetKerning(uint32_t left, uint32_t right)
+{
+	// Only the atlas's printable characters have kerning read for them
+	if (kerning.empty() || left > lastKernedCharacter || right > lastKernedCharacter)
+	{
+		return 0.0f;
+	}
+
+	auto it = kerning.find((left << 8) | right);
+	return it != kerning.end() ? (float)it->second / 64.0f : 0.0f;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads the atlas, metrics and kerning from the cache file if it was made from this font
+		with the current settings
+
+	\param fontHash
+		The hash of the font file
+
+	\param fontSize
+		The size of the font file in bytes
+
+	\param atlas
+		Set to the atlas's pixels
+
+	\return
+		Whether the cache could be used
+*/
+/*************************************************************************************************/
+bool Font::LoadCache(uint32_t fontHash, uint32_t fontSize, std::vector<uint8_t>& atlas)
+{
+	// No file just means the font hasn't been loaded on this machine yet
+	std::string cacheFilename = filename + cacheExtension;
+	std::ifstream file(cacheFilename, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return false;
+	}
+	std::streamoff fileSize = file.tellg();
+	if (fileSize < (std::streamoff)sizeof(CacheHeader))
+	{
+		return false;
+	}
+	std::vector<uint8_t> fileData((size_t)fileSize);
+	file.seekg(0);
+	file.read((char*)fileData.data(), fileSize);
+	if (!file)
+	{
+		return false;
+	}
+
+	// A different font or different settings means the glyphs have to be rendered again
+	CacheHeader header;
+	memcpy(&header, fileData.data(), sizeof(CacheHeader));
+	std::string reason;
+	if (header.magic != magic || header.version != version || header.headerSize != sizeof(CacheHeader))
+	{
+		reason = "not a font cache or an older version";
+	}
+	else if (header.fontHash != fontHash || header.fontSize != fontSize)
+	{
+		reason = "made from a different font file";
+	}
+	else if (header.pixelSize != glyphPixelSize || header.spread != sdfSpread || header.atlasWidth != atlasPixelWidth)
+	{
+		reason = "made with different settings";
+	}
+	else if (header.dataSize != fileData.size() - sizeof(CacheHeader)
+		|| header.dataSize != header.glyphCount * sizeof(CachedGlyph) + header.kerningCount * sizeof(CachedKerning) + (size_t)header.atlasWidth * header.atlasHeight)
+	{
+		reason = "file is truncated";
+	}
+	else if (HashBytes(fileData.data() + sizeof(CacheHeader), header.dataSize) != header.checksum)
+	{
+		reason = "checksum doesn't match";
+	}
+
+	if (!reason.empty())
+	{
+		_Debug->Print(Debug::MessageType::Debug, "Font: Rebuilding " + cacheFilename + ", " + reason);
+		return false;
+	}
+
+	// Glyphs, then kerning pairs, then the atlas
+	const uint8_t* data = fileData.data() + sizeof(CacheHeader);
+	for (uint32_t i = 0; i < header.glyphCount; i++)
+	{
+		CachedGlyph glyph;
+		memcpy(&glyph, data, sizeof(CachedGlyph));
+		data += sizeof(CachedGlyph);
+
+		Character character =
+		{
+			glm::ivec2(glyph.width, glyph.height),
+			glm::ivec2(glyph.bearingX, glyph.bearingY),
+			glm::ivec2(glyph.atlasX, glyph.atlasY),
+			glyph.advance
+		};
+		characters[(char)glyph.code] = character;
+	}
+
+	for (uint32_t i = 0; i < header.kerningCount; i++)
+	{
+		CachedKerning pair;
+		memcpy(&pair, data, sizeof(CachedKerning));
+		data += sizeof(CachedKerning);
+		kerning[pair.pair] = pair.amount;
+	}
+
+	atlasWidth = header.atlasWidth;
+	atlasHeight = header.atlasHeight;
+	bmpHeight = header.bmpHeight;
+	atlas.assign(data, data + (size_t)atlasWidth * atlasHeight);
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Renders each glyph's distance field with freetype, packs them into the atlas and reads
+		the kerning pairs
+
+	\param fontData
+		The font file
+
+	\param atlas
+		Set to the atlas's pixels
+
+	\return
+		Whether the font could be read
+*/
+/*************************************************************************************************/
+bool Font::GenerateAtlas(const std::vector<uint8_t>& fontData, std::vector<uint8_t>& atlas)
+{
 	// Initializes the freetype library
 	FT_Library ft;
 	if (FT_Init_FreeType(&ft))
 	{
-		std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-		return;
+		_Debug->Print(Debug::MessageType::Error, "Font: Could not init FreeType for " + filename);
+		return false;
 	}
 
-	// Reads in a face
+	// The distance field renderer pads each glyph by its spread
+	FT_Int spread = (FT_Int)sdfSpread;
+	FT_Property_Set(ft, "sdf", "spread", &spread);
+
+	// Reads in a face from the bytes already in memory
 	FT_Face face;
-	if (FT_New_Face(ft, filename_.c_str(), 0, &face))
+	if (FT_New_Memory_Face(ft, fontData.data(), (FT_Long)fontData.size(), 0, &face))
 	{
-		std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-		return;
+		_Debug->Print(Debug::MessageType::Error, "Font: Failed to load " + filename);
+		FT_Done_FreeType(ft);
+		return false;
 	}
-	
+
 	// Sets the pixel size of the font
-	FT_Set_Pixel_Sizes(face, 0, 48);
-	uint32_t bmpWidth = 0;
-	std::vector<uint8_t> pixels;
-	std::unordered_map<char, std::vector<uint8_t>> data;
+	FT_Set_Pixel_Sizes(face, 0, glyphPixelSize);
 
-	// Loops through the list of normal character slots
-	for (unsigned char c = 0; c < 128; c++)
+	// Renders every glyph before packing, so they can be packed tallest first
+	std::vector<std::vector<uint8_t>> glyphPixels(characterCount);
+	for (unsigned int c = 0; c < characterCount; c++)
 	{
-		// load character glyph 
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
+		Character character = { glm::ivec2(0), glm::ivec2(0), glm::ivec2(0), 0 };
+
+		// Characters without an outline, like spaces, only have an advance
+		if (FT_Load_Char(face, c, FT_LOAD_DEFAULT))
 		{
-			std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+			_Debug->Print(Debug::MessageType::Debug, "Font: Failed to load glyph " + std::to_string(c) + " of " + filename);
+			characters[(char)c] = character;
 			continue;
 		}
+		character.advance = static_cast<unsigned int>(face->glyph->advance.x);
 
-		bmpHeight = std::max(bmpHeight, face->glyph->bitmap.rows);
-
-		unsigned int pitch = face->glyph->bitmap.pitch;
-		Character character =
-		{
-			glm::ivec2(face->glyph->bitmap.width,face->glyph->bitmap.rows),
-			glm::ivec2(face->glyph->bitmap_left,face->glyph->bitmap_top),
-			bmpWidth,
-			static_cast<unsigned int>(face->glyph->advance.x)
-		};
-
-		characters.insert(std::pair<char, Character>(c, character));
-		if (face->glyph->bitmap.width > 0)
+		if (face->glyph->format == FT_GLYPH_FORMAT_OUTLINE && face->glyph->outline.n_points > 0
+			&& FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF) == 0 && face->glyph->bitmap.width > 0)
 		{
-			void* ptr = face->glyph->bitmap.buffer;
+			FT_Bitmap& bitmap = face->glyph->bitmap;
+			character.size = glm::ivec2(bitmap.width, bitmap.rows);
+			character.bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+			bmpHeight = std::max(bmpHeight, bitmap.rows > 2 * sdfSpread ? bitmap.rows - 2 * sdfSpread : 0u);
+
+			// Copies the rows out tightly, since the pitch can be wider than the glyph
+			std::vector<uint8_t>& pixels = glyphPixels[c];
+			pixels.resize((size_t)bitmap.width * bitmap.rows);
+			for (unsigned int row = 0; row < bitmap.rows; row++)
+			{
+				memcpy(pixels.data() + (size_t)row * bitmap.width, bitmap.buffer + (ptrdiff_t)row * bitmap.pitch, bitmap.width);
+			}
+		}
 
-			std::vector<uint8_t> charData(face->glyph->bitmap.width * face->glyph->bitmap.rows);
+		characters[(char)c] = character;
+	}
 
-			int rows = face->glyph->bitmap.rows;
-			int width = face->glyph->bitmap.width;
-			for (int i = 0; i < rows; i++)
+	// Kerning pairs for the printable characters. Most are 0, so only the rest are kept
+	if (FT_HAS_KERNING(face))
+	{
+		for (unsigned int left = firstKernedCharacter; left <= lastKernedCharacter; left++)
+		{
+			FT_UInt leftIndex = FT_Get_Char_Index(face, left);
+			for (unsigned int right = firstKernedCharacter; right <= lastKernedCharacter; right++)
 			{
-				for (int j = 0; j < width; j++)
+				FT_Vector delta;
+				if (FT_Get_Kerning(face, leftIndex, FT_Get_Char_Index(face, right), FT_KERNING_DEFAULT, &delta) == 0 && delta.x != 0)
 				{
-					uint8_t byte = face->glyph->bitmap.buffer[i * pitch + j];
-					charData[(i * pitch + j)] = byte;
+					kerning[(left << 8) | right] = (int)delta.x;
 				}
 			}
-			data.insert(std::pair<char, std::vector<uint8_t>>(c, charData));
 		}
-		bmpWidth += face->glyph->bitmap.width;
-		characters.insert(std::pair<char, Character>(c, character));
 	}
 
 	// Closes up freetype
 	FT_Done_Face(face);
+	FT_Done_FreeType(ft);
 
-	invertedBmpWidth = 1.0f / (float)bmpWidth;
-
-	uint8_t* buffer = new uint8_t[bmpHeight * bmpWidth];
-	memset(buffer, 0, bmpHeight * bmpWidth);
-
-	uint32_t xpos = 0;
-	for (unsigned char c = 0; c < 128; c++)
+	// Packs the glyphs into shelves, tallest first so each shelf wastes little height
+	std::vector<unsigned int> packOrder;
+	for (unsigned int c = 0; c < characterCount; c++)
 	{
-		Character& character = characters[c];
-
-		std::vector<uint8_t>& charData = data[c];
-		uint32_t width = character.size.x;
-		uint32_t height = character.size.y;
-		for (uint32_t i = 0; i < height; i++) {
-			for (uint32_t j = 0; j < width; j++) {
-				uint8_t byte = charData[i * width + j];
-				buffer[(i * bmpWidth + xpos + j)] = byte;
-				//buffer[(i * bmpWidth + xpos + j) * 4 + 1] = 1;
-				//buffer[(i * bmpWidth + xpos + j) * 4 + 2] = 1;
-				//buffer[(i * bmpWidth + xpos + j) * 4 + 3] = byte;
-			}
+		if (!glyphPixels[c].empty())
+		{
+			packOrder.push_back(c);
+		}
+	}
+	std::stable_sort(packOrder.begin(), packOrder.end(),
+		[this](unsigned int a, unsigned int b) { return characters[(char)a].size.y > characters[(char)b].size.y; });
+
+	atlasWidth = atlasPixelWidth;
+	uint32_t shelfX = glyphGap;
+	uint32_t shelfY = glyphGap;
+	uint32_t shelfHeight = 0;
+	for (unsigned int c : packOrder)
+	{
+		Character& character = characters[(char)c];
+		if (shelfX + character.size.x + glyphGap > atlasWidth)
+		{
+			shelfY += shelfHeight + glyphGap;
+			shelfX = glyphGap;
+			shelfHeight = 0;
 		}
-		xpos += width;
+		character.atlasPosition = glm::ivec2(shelfX, shelfY);
+		shelfX += character.size.x + glyphGap;
+		shelfHeight = std::max(shelfHeight, (uint32_t)character.size.y);
 	}
+	atlasHeight = std::max(shelfY + shelfHeight + glyphGap, 1u);
 
-	texture = new Texture(bmpWidth, bmpHeight, buffer);
-	delete buffer;
+	// Copies each glyph into its place
+	atlas.assign((size_t)atlasWidth * atlasHeight, 0);
+	for (unsigned int c : packOrder)
+	{
+		const Character& character = characters[(char)c];
+		for (int row = 0; row < character.size.y; row++)
+		{
+			memcpy(atlas.data() + (size_t)(character.atlasPosition.y + row) * atlasWidth + character.atlasPosition.x,
+				glyphPixels[c].data() + (size_t)row * character.size.x, character.size.x);
+		}
+	}
 
-	FT_Done_FreeType(ft);
+	_Debug->Print(Debug::MessageType::Debug, "Font: Rendered " + std::to_string(packOrder.size()) + " glyphs of " + filename + " into a "
+		+ std::to_string(atlasWidth) + "x" + std::to_string(atlasHeight) + " atlas with " + std::to_string(kerning.size()) + " kerning pairs");
+	return true;
 }
 
 /*************************************************************************************************/
 /*!
 	\brief
-		Destructor for the camera class
+		Writes the atlas, metrics and kerning to the cache file. Writes a temporary file first
+		then renames it over the old one so a half written cache is never left behind
+
+	\param fontHash
+		The hash of the font file
+
+	\param fontSize
+		The size of the font file in bytes
+
+	\param atlas
+		The atlas's pixels
+
+	\return
+		Whether the file was written
 */
 /*************************************************************************************************/
-Font::~Font()
+bool Font::SaveCache(uint32_t fontHash, uint32_t fontSize, const std::vector<uint8_t>& atlas)
 {
-	// Frees the texture from memory if it is getting destroyed
-	Free();
+	// Lays out everything after the header so it can be hashed in one go
+	std::vector<uint8_t> data;
+	data.reserve(characters.size() * sizeof(CachedGlyph) + kerning.size() * sizeof(CachedKerning) + atlas.size());
+	for (const std::pair<const char, Character>& entry : characters)
+	{
+		const Character& character = entry.second;
+		CachedGlyph glyph =
+		{
+			(int32_t)(unsigned char)entry.first,
+			character.size.x, character.size.y,
+			character.bearing.x, character.bearing.y,
+			character.atlasPosition.x, character.atlasPosition.y,
+			character.advance
+		};
+		data.insert(data.end(), (const uint8_t*)&glyph, (const uint8_t*)&glyph + sizeof(CachedGlyph));
+	}
+	for (const std::pair<const uint32_t, int>& entry : kerning)
+	{
+		CachedKerning pair = { entry.first, entry.second };
+		data.insert(data.end(), (const uint8_t*)&pair, (const uint8_t*)&pair + sizeof(CachedKerning));
+	}
+	data.insert(data.end(), atlas.begin(), atlas.end());
+
+	CacheHeader header{};
+	header.magic = magic;
+	header.version = version;
+	header.headerSize = sizeof(CacheHeader);
+	header.fontHash = fontHash;
+	header.fontSize = fontSize;
+	header.pixelSize = glyphPixelSize;
+	header.spread = sdfSpread;
+	header.atlasWidth = atlasWidth;
+	header.atlasHeight = atlasHeight;
+	header.bmpHeight = bmpHeight;
+	header.glyphCount = (uint32_t)characters.size();
+	header.kerningCount = (uint32_t)kerning.size();
+	header.dataSize = (uint32_t)data.size();
+	header.checksum = HashBytes(data.data(), data.size());
+
+	// Writes everything to a temporary file
+	std::string cacheFilename = filename + cacheExtension;
+	std::string tempFilename = cacheFilename + ".tmp";
+	{
+		std::ofstream outputFile(tempFilename, std::ios::binary | std::ios::trunc);
+		if (!outputFile)
+		{
+			return false;
+		}
+		outputFile.write((const char*)&header, sizeof(CacheHeader));
+		outputFile.write((const char*)data.data(), data.size());
+		if (!outputFile)
+		{
+			return false;
+		}
+	}
+
+	// Swaps the finished file into place
+#ifdef _WIN32
+	return MoveFileExA(tempFilename.c_str(), cacheFilename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(tempFilename.c_str(), cacheFilename.c_str()) == 0;
+#endif
 }
 
 /*************************************************************************************************/
 /*!
 	\brief
-		Frees the texture from memory
+		Hashes the given bytes with FNV-1a
+
+	\param data
+		The bytes to hash
+
+	\param size
+		The number of bytes
+
+	\return
+		The hash
 */
 /*************************************************************************************************/
-void Font::Free()
+static uint32_t HashBytes(const uint8_t* data, size_t size)
 {
-	texture->Free();
+	uint32_t hash = fnvOffsetBasis;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= fnvPrime;
+	}
+	return hash;
 }
-
-//-------------------------------------------------------------------------------------------------
-// Private Function Definitions
-//-------------------------------------------------------------------------------------------------
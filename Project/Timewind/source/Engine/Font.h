@@ -5,10 +5,29 @@
 \par email: ajcvengros\@gmail.com
 \date 2026.4.06
 \brief
-    The font class
-
-    Functions include:
-        + [FILL]
+    The font class. Holds a signed distance field atlas of the font's glyphs, which stays sharp
+	at every text size. The atlas, glyph metrics and kerning are cached to a file next to the
+	font, so after the first run loading a font is a file read and one texture upload. Characters
+	past the atlas's ascii are rendered by the font's glyph cache the first time they're drawn
+
+    Public Functions:
+        + Font
+		+ ~Font
+		+ Free
+		+ GetTexture
+		+ GetFilename
+		+ GetInvertedAtlasSize
+		+ GetBmpHeight
+		+ GetCharacter
+		+ GetKerning
+		+ TouchGlyph
+		+ GetGlyphGeneration
+		+ GetGlyphCacheStats
+
+	Private Functions:
+		+ LoadCache
+		+ GenerateAtlas
+		+ SaveCache
 
 Copyright (c) 2023 Aiden Cvengros
 */
@@ -28,6 +47,11 @@ Copyright (c) 2023 Aiden Cvengros
 // has the string class for filenames
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
+
+// Renders the characters that aren't in the atlas
+#include "GlyphCache.h"
 
 // Includes glfw library for texture management
 #define VK_USE_PLATFORM_WIN32_KHR
@@ -63,12 +87,17 @@ public:
 	// Public Consts
 	//---------------------------------------------------------------------------------------------
 
+	static const uint32_t magic = 0x43465754;	// "TWFC" when read as bytes on little endian
+	static const uint32_t version = 1;			// Bumped whenever the cache layout changes
+
 	struct Character
 	{
-		glm::ivec2 size;						// Size of glyph
+		glm::ivec2 size;						// Size of glyph, including the distance field's padding
 		glm::ivec2 bearing;						// Offset from baseline to left/top of glyph
-		float offset;							// The horizontal offset of this character in the texture
+		glm::ivec2 atlasPosition;				// The top left corner of this character in the texture
 		unsigned int advance;					// Offset to advance to next glyph
+		Texture* texture;						// The texture the character is in, the atlas or a glyph cache page
+		int cacheSlot;							// The character's cell in the glyph cache, -1 if it doesn't have one
 	};
 	
 	//---------------------------------------------------------------------------------------------
@@ -135,13 +164,13 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Returns the inverted width of the texture aka the width of a character
+			Returns one over the texture's width and height, for turning pixels into uvs
 
 		\return
-			The inverted bitmap width
+			The inverted atlas size
 	*/
 	/*************************************************************************************************/
-	float GetInvertedBmpWidth() { return invertedBmpWidth; }
+	glm::vec2 GetInvertedAtlasSize() { return invertedAtlasSize; }
 
 	/*************************************************************************************************/
 	/*!
@@ -157,16 +186,70 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Returns the font data for the given character
+			Returns the font data for the given character. Characters outside the atlas are
+			rendered into the glyph cache if they aren't there yet
+
+		\param codepoint
+			The character's unicode codepoint
 
 		\param character
-			The given character
+			Set to that character's font data
+
+		\return
+			Whether the character is ready. False means it has to wait for a later frame
+	*/
+	/*************************************************************************************************/
+	bool GetCharacter(uint32_t codepoint, Character& character);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how much closer or further apart two characters sit than their advance says
+
+		\param left
+			The first character's codepoint
+
+		\param right
+			The codepoint of the character after it
+
+		\return
+			The adjustment in the font's pixels, 0 for most pairs and any pair outside ascii
+	*/
+	/*************************************************************************************************/
+	float GetKerning(uint32_t left, uint32_t right);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Marks a cached character as drawn this frame, so its cell isn't given to another one
+
+		\param slot
+			The character's cell in the glyph cache
+	*/
+	/*************************************************************************************************/
+	void TouchGlyph(int slot) { glyphCache.Touch(slot); }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns a number that changes whenever a cached character loses its cell
+
+		\return
+			The glyph cache's generation
+	*/
+	/*************************************************************************************************/
+	unsigned int GetGlyphGeneration() { return glyphCache.GetGeneration(); }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what the glyph cache has done
 
 		\return
-			That character's font data
+			The glyph cache's counts and rendering times
 	*/
 	/*************************************************************************************************/
-	Character GetCharacter(char character) { return characters[character]; }
+	GlyphCache::Stats GetGlyphCacheStats() { return glyphCache.GetStats(); }
 	
 private:
 	//---------------------------------------------------------------------------------------------
@@ -176,6 +259,45 @@ private:
 	//---------------------------------------------------------------------------------------------
 	// Private Structures
 	//---------------------------------------------------------------------------------------------
+
+	// The header at the start of the cache file. Every field is 4 bytes so there is no padding
+	typedef struct
+	{
+		uint32_t magic;							// Identifies the file as a font cache
+		uint32_t version;						// The layout version the file was written with
+		uint32_t headerSize;					// Size of this header in bytes
+		uint32_t fontHash;						// FNV-1a hash of the font file the atlas was made from
+		uint32_t fontSize;						// Size of that font file in bytes
+		uint32_t pixelSize;						// The size the glyphs were rendered at
+		uint32_t spread;						// How far the distance field reaches past each outline, in pixels
+		uint32_t atlasWidth;					// Width of the atlas in pixels
+		uint32_t atlasHeight;					// Height of the atlas in pixels
+		uint32_t bmpHeight;						// The tallest glyph, without padding
+		uint32_t glyphCount;					// Glyphs after the header
+		uint32_t kerningCount;					// Kerning pairs after the glyphs
+		uint32_t dataSize;						// Size of everything after the header
+		uint32_t checksum;						// FNV-1a hash of everything after the header
+	}CacheHeader;
+
+	// One character as it's written to the cache
+	typedef struct
+	{
+		int32_t code;							// The character
+		int32_t width;							// The character's size
+		int32_t height;
+		int32_t bearingX;						// The character's offset from the baseline
+		int32_t bearingY;
+		int32_t atlasX;							// The character's top left corner in the atlas
+		int32_t atlasY;
+		uint32_t advance;						// Offset to advance to the next glyph, in 1/64ths of a pixel
+	}CachedGlyph;
+
+	// One kerning pair as it's written to the cache
+	typedef struct
+	{
+		uint32_t pair;							// The left character in the high byte, the right in the low
+		int32_t amount;							// The adjustment, in 1/64ths of a pixel
+	}CachedKerning;
 	
 	//---------------------------------------------------------------------------------------------
 	// Private Variables
@@ -185,14 +307,79 @@ private:
 	Texture* texture;							// The font texture
 
 	std::map<char, Character> characters;		// The list of character structs
+	std::unordered_map<uint32_t, int> kerning;	// Nonzero kerning in 1/64ths of a pixel, keyed by left << 8 | right
 
 	unsigned int bmpHeight;						// The max height to allow the font
-	float invertedBmpWidth;						// The inverse of the max height aka 
+	uint32_t atlasWidth;						// The atlas's width in pixels
+	uint32_t atlasHeight;						// The atlas's height in pixels
+	glm::vec2 invertedAtlasSize;				// One over the atlas's width and height
+
+	GlyphCache glyphCache;						// The characters that aren't in the atlas
 
 	//---------------------------------------------------------------------------------------------
 	// Private Function Declarations
 	//---------------------------------------------------------------------------------------------
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads the atlas, metrics and kerning from the cache file if it was made from this font
+			with the current settings
+
+		\param fontHash
+			The hash of the font file
+
+		\param fontSize
+			The size of the font file in bytes
+
+		\param atlas
+			Set to the atlas's pixels
+
+		\return
+			Whether the cache could be used
+	*/
+	/*************************************************************************************************/
+	bool LoadCache(uint32_t fontHash, uint32_t fontSize, std::vector<uint8_t>& atlas);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Renders each glyph's distance field with freetype, packs them into the atlas and reads
+			the kerning pairs
+
+		\param fontData
+			The font file
+
+		\param atlas
+			Set to the atlas's pixels
+
+		\return
+			Whether the font could be read
+	*/
+	/*************************************************************************************************/
+	bool GenerateAtlas(const std::vector<uint8_t>& fontData, std::vector<uint8_t>& atlas);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes the atlas, metrics and kerning to the cache file. Writes a temporary file first
+			then renames it over the old one so a half written cache is never left behind
+
+		\param fontHash
+			The hash of the font file
+
+		\param fontSize
+			The size of the font file in bytes
+
+		\param atlas
+			The atlas's pixels
+
+		\return
+			Whether the file was written
+	*/
+	/*************************************************************************************************/
+	bool SaveCache(uint32_t fontHash, uint32_t fontSize, const std::vector<uint8_t>& atlas);
+
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -0,0 +1,265 @@
+/*************************************************************************************************/
+/*!
+\file FrameAllocator.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Hands out slices of persistently mapped memory for data that only lives for one frame, like
+	sprite and glyph instances. Each frame in flight has its own memory, which is reused
+	from the start once that frame's fence has signaled
+
+    Functions include:
+        + FrameAllocator::FrameAllocator
+		+ FrameAllocator::~FrameAllocator
+		+ FrameAllocator::Init
+		+ FrameAllocator::BeginFrame
+		+ FrameAllocator::Allocate
+		+ FrameAllocator::Free
+		+ FrameAllocator::GetCapacity
+		+ FrameAllocator::AddBlock
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "FrameAllocator.h"
+#include "cppShortcuts.h"
+
+// Buffer creation and the logical device
+#include "Window.h"
+
+// Sizing blocks
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// Every buffer can hold any kind of per frame data, including pixels copied into textures
+const VkBufferUsageFlags frameBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+	| VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the frame allocator class
+*/
+/*************************************************************************************************/
+FrameAllocator::FrameAllocator() : currentFrame(0), blockSize(0), uniformAlignment(256), usedBytes(0), highWaterMark(0)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the frame allocator class
+*/
+/*************************************************************************************************/
+FrameAllocator::~FrameAllocator()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes one block of memory for each frame in flight
+
+	\param framesInFlight
+		How many frames can be recorded before the oldest one is finished
+
+	\param blockSize_
+		How many bytes each frame starts with. Frames that need more get extra blocks
+
+	\param physicalDevice
+		The graphics card, used to find how uniform slices have to be aligned
+*/
+/*************************************************************************************************/
+void FrameAllocator::Init(int framesInFlight, VkDeviceSize blockSize_, VkPhysicalDevice physicalDevice)
+{
+	blockSize = blockSize_;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	uniformAlignment = properties.limits.minUniformBufferOffsetAlignment;
+
+	frames.resize(framesInFlight, { {}, 0, 0 });
+	for (Frame& frame : frames)
+	{
+		AddBlock(frame, blockSize);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts a new frame, giving back everything the frame allocated last time. Only call
+		once the frame's fence has been waited on
+
+	\param frame
+		The index of the frame in flight being recorded
+*/
+/*************************************************************************************************/
+void FrameAllocator::BeginFrame(int frame)
+{
+	currentFrame = frame;
+	Frame& newFrame = frames[currentFrame];
+
+	// A frame that spilled into extra blocks last time gets them merged into one, so the usual
+	// case is a single buffer that never has to be switched mid frame
+	if (newFrame.blocks.size() > 1)
+	{
+		VkDeviceSize totalSize = 0;
+		for (Block& block : newFrame.blocks)
+		{
+			totalSize += block.size;
+			_Window->DestroyBuffer(block.buffer, block.memory);
+		}
+		newFrame.blocks.clear();
+		AddBlock(newFrame, totalSize);
+
+		_Debug->Print(Debug::MessageType::Debug, "FrameAllocator: grew frame " + std::to_string(frame) + " to " + std::to_string(totalSize) + " bytes");
+	}
+
+	newFrame.currentBlock = 0;
+	newFrame.offset = 0;
+	usedBytes = 0;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Hands out a slice of the current frame's memory. The slice can be used as vertex,
+		index or uniform data, or copied from, until the frame comes around again
+
+	\param size
+		How many bytes are needed
+
+	\param alignment
+		What the slice's offset must be a multiple of. Use GetUniformAlignment for uniforms
+
+	\return
+		The slice
+*/
+/*************************************************************************************************/
+FrameAllocator::Allocation FrameAllocator::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+	Frame& frame = frames[currentFrame];
+
+	// Moves through the frame's blocks until one has room, making a new one at the end if needed
+	VkDeviceSize start = (frame.offset + alignment - 1) / alignment * alignment;
+	while (start + size > frame.blocks[frame.currentBlock].size)
+	{
+		usedBytes += frame.blocks[frame.currentBlock].size - frame.offset;
+		frame.currentBlock++;
+		frame.offset = 0;
+		start = 0;
+
+		if (frame.currentBlock == (int)frame.blocks.size())
+		{
+			AddBlock(frame, std::max(blockSize, size));
+		}
+	}
+
+	// Takes the slice
+	Block& block = frame.blocks[frame.currentBlock];
+	usedBytes += start + size - frame.offset;
+	frame.offset = start + size;
+	highWaterMark = std::max(highWaterMark, usedBytes);
+
+	return { block.buffer, start, block.mapped + start };
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Releases every block. The device must be idle
+*/
+/*************************************************************************************************/
+void FrameAllocator::Free()
+{
+	for (Frame& frame : frames)
+	{
+		for (Block& block : frame.blocks)
+		{
+			_Window->DestroyBuffer(block.buffer, block.memory);
+		}
+	}
+	frames.clear();
+
+	_Debug->Print(Debug::MessageType::Debug, "FrameAllocator: high water mark was " + std::to_string(highWaterMark) + " of " + std::to_string(blockSize) + " bytes per frame");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns how many bytes the current frame can use before it needs another block
+
+	\return
+		The size of all the frame's blocks together
+*/
+/*************************************************************************************************/
+VkDeviceSize FrameAllocator::GetCapacity()
+{
+	VkDeviceSize capacity = 0;
+	for (Block& block : frames[currentFrame].blocks)
+	{
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes a new block for a frame and maps it
+
+	\param frame
+		The frame the block is for
+
+	\param size
+		The size of the block in bytes
+*/
+/*************************************************************************************************/
+void FrameAllocator::AddBlock(Frame& frame, VkDeviceSize size)
+{
+	Block block;
+	block.size = size;
+	_Window->CreateBuffer(size, frameBufferUsage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, block.buffer, block.memory);
+
+	// The memory allocator keeps host visible memory mapped for as long as it exists
+	block.mapped = (unsigned char*)block.memory.mapped;
+
+	frame.blocks.push_back(block);
+}
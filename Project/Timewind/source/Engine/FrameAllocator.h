@@ -0,0 +1,279 @@
+/*************************************************************************************************/
+/*!
+\file FrameAllocator.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Hands out slices of persistently mapped memory for data that only lives for one frame, like
+	sprite and glyph instances. Each frame in flight has its own memory, which is reused
+	from the start once that frame's fence has signaled
+
+    Public Functions:
+        + FrameAllocator
+		+ ~FrameAllocator
+		+ Init
+		+ BeginFrame
+		+ Allocate
+		+ Free
+		+ GetUniformAlignment
+		+ GetUsedBytes
+		+ GetHighWaterMark
+		+ GetCapacity
+
+	Private Functions:
+		+ AddBlock
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_FrameAllocator_H_
+#define Syncopatience_FrameAllocator_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The blocks of each frame
+#include <vector>
+
+// The memory behind each block
+#include "MemoryAllocator.h"
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The frame allocator class
+*/
+/*************************************************************************************************/
+class FrameAllocator
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// A slice of a frame's memory
+	typedef struct
+	{
+		VkBuffer buffer;						// The buffer the slice is in
+		VkDeviceSize offset;					// Where in the buffer the slice starts
+		void* data;								// The slice's memory mapped for writing
+	}Allocation;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the frame allocator class
+	*/
+	/*************************************************************************************************/
+	FrameAllocator();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the frame allocator class
+	*/
+	/*************************************************************************************************/
+	~FrameAllocator();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes one block of memory for each frame in flight
+
+		\param framesInFlight
+			How many frames can be recorded before the oldest one is finished
+
+		\param blockSize_
+			How many bytes each frame starts with. Frames that need more get extra blocks
+
+		\param physicalDevice
+			The graphics card, used to find how uniform slices have to be aligned
+	*/
+	/*************************************************************************************************/
+	void Init(int framesInFlight, VkDeviceSize blockSize_, VkPhysicalDevice physicalDevice);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts a new frame, giving back everything the frame allocated last time. Only call
+			once the frame's fence has been waited on
+
+		\param frame
+			The index of the frame in flight being recorded
+	*/
+	/*************************************************************************************************/
+	void BeginFrame(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Hands out a slice of the current frame's memory. The slice can be used as vertex,
+			index or uniform data, or copied from, until the frame comes around again
+
+		\param size
+			How many bytes are needed
+
+		\param alignment
+			What the slice's offset must be a multiple of. Use GetUniformAlignment for uniforms
+
+		\return
+			The slice
+	*/
+	/*************************************************************************************************/
+	Allocation Allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Releases every block. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what uniform slices have to be aligned to on this card
+
+		\return
+			The alignment in bytes
+	*/
+	/*************************************************************************************************/
+	VkDeviceSize GetUniformAlignment() { return uniformAlignment; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many bytes the current frame has allocated so far, padding included
+
+		\return
+			The bytes used
+	*/
+	/*************************************************************************************************/
+	VkDeviceSize GetUsedBytes() { return usedBytes; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the most bytes any one frame has allocated, for sizing the blocks
+
+		\return
+			The high water mark in bytes
+	*/
+	/*************************************************************************************************/
+	VkDeviceSize GetHighWaterMark() { return highWaterMark; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many bytes the current frame can use before it needs another block
+
+		\return
+			The size of all the frame's blocks together
+	*/
+	/*************************************************************************************************/
+	VkDeviceSize GetCapacity();
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// One persistently mapped buffer
+	typedef struct
+	{
+		VkBuffer buffer;						// The buffer
+		MemoryAllocator::Allocation memory;		// The memory behind the buffer
+		unsigned char* mapped;					// The buffer's memory mapped for writing
+		VkDeviceSize size;						// The size of the buffer in bytes
+	}Block;
+
+	// The memory of one frame in flight
+	typedef struct
+	{
+		std::vector<Block> blocks;				// Every block the frame has needed so far, kept for reuse
+		int currentBlock;						// The block being filled
+		VkDeviceSize offset;					// How much of the current block is filled
+	}Frame;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	std::vector<Frame> frames;					// The memory of each frame in flight
+	int currentFrame;							// The frame being recorded
+	VkDeviceSize blockSize;						// The size of a normal block
+	VkDeviceSize uniformAlignment;				// What uniform slices have to be aligned to
+
+	VkDeviceSize usedBytes;						// Bytes allocated by the current frame
+	VkDeviceSize highWaterMark;					// The most bytes any frame has allocated
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes a new block for a frame and maps it
+
+		\param frame
+			The frame the block is for
+
+		\param size
+			The size of the block in bytes
+	*/
+	/*************************************************************************************************/
+	void AddBlock(Frame& frame, VkDeviceSize size);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_FrameAllocator_H_
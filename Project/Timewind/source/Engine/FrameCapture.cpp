@@ -0,0 +1,453 @@
+/*************************************************************************************************/
+/*!
+\file FrameCapture.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Copies chosen frames back from the GPU and writes them out as images. The copy is recorded
+	into the frame's own command buffer and read once the frame's fence has been waited on, so
+	capturing never stalls the frame that asked for it. Captures can also be checked against
+	golden frames written by an earlier run
+
+    Functions include:
+        + FrameCapture::FrameCapture
+		+ FrameCapture::~FrameCapture
+		+ FrameCapture::Init
+		+ FrameCapture::SetOutput
+		+ FrameCapture::SetGolden
+		+ FrameCapture::Request
+		+ FrameCapture::Record
+		+ FrameCapture::FrameFinished
+		+ FrameCapture::Finish
+		+ FrameCapture::Free
+		+ FrameCapture::WriteImage
+		+ FrameCapture::CompareImage
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "FrameCapture.h"
+#include "cppShortcuts.h"
+
+// Making the readback buffers
+#include "Window.h"
+
+// Writing the images
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+// Reading the golden frames
+#include <stb_image.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the frame capture class
+*/
+/*************************************************************************************************/
+FrameCapture::FrameCapture() : device(VK_NULL_HANDLE), extent(), imageFormat(VK_FORMAT_UNDEFINED), readbacks(), requestedFrames(),
+	directory("Captures"), format(Format::Png), frameNumber(0), goldenDirectory(), tolerance(0), comparisons(0), failedComparisons(0)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the frame capture class
+*/
+/*************************************************************************************************/
+FrameCapture::~FrameCapture()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes a readback buffer for each frame in flight
+
+	\param vkDevice
+		The logical device
+
+	\param framesInFlight
+		How many frames can be recorded before the oldest one is finished
+
+	\param extent_
+		The size of the images being captured
+
+	\param imageFormat_
+		The format of the images being captured. Only 4 byte RGBA and BGRA formats are supported
+*/
+/*************************************************************************************************/
+void FrameCapture::Init(VkDevice vkDevice, int framesInFlight, VkExtent2D extent_, VkFormat imageFormat_)
+{
+	device = vkDevice;
+	extent = extent_;
+	imageFormat = imageFormat_;
+
+	// Each frame in flight copies into its own buffer, so a frame can be captured while the one
+	// before it is still being read. Cached memory makes reading it back on the CPU much faster
+	VkDeviceSize bufferSize = (VkDeviceSize)extent.width * extent.height * 4;
+	readbacks.resize(framesInFlight);
+	for (Readback& readback : readbacks)
+	{
+		_Window->CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+			readback.buffer, readback.memory, VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+		readback.pendingFrame = 0;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets where captured frames are written and as what
+
+	\param directory_
+		The directory the images go in. Made if it doesn't exist
+
+	\param format_
+		The file type to write
+*/
+/*************************************************************************************************/
+void FrameCapture::SetOutput(const std::string& directory_, Format format_)
+{
+	directory = directory_;
+	format = format_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks each captured frame against the file of the same name in another directory,
+		e.g. frames captured with the reference CRT filter
+
+	\param goldenDirectory_
+		The directory holding the golden frames
+
+	\param tolerance_
+		The most any channel may differ by, in 8 bit steps
+*/
+/*************************************************************************************************/
+void FrameCapture::SetGolden(const std::string& goldenDirectory_, int tolerance_)
+{
+	goldenDirectory = goldenDirectory_;
+	tolerance = tolerance_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Asks for a frame to be captured
+
+	\param frameNumber_
+		The frame to capture, counting from 1 for the first frame drawn
+*/
+/*************************************************************************************************/
+void FrameCapture::Request(uint64_t frameNumber_)
+{
+	if (frameNumber_ <= frameNumber)
+	{
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: Frame " + std::to_string(frameNumber_) + " has already been drawn");
+		return;
+	}
+	requestedFrames.insert(frameNumber_);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Counts a frame and, if it was requested, records a copy of its final image into the
+		frame's readback buffer. Call once per frame after the last render pass ends
+
+	\param commandBuffer
+		The frame's command buffer
+
+	\param frame
+		The index of the frame in flight being recorded
+
+	\param image
+		The final image, in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+*/
+/*************************************************************************************************/
+void FrameCapture::Record(VkCommandBuffer commandBuffer, int frame, VkImage image)
+{
+	frameNumber++;
+	if (requestedFrames.erase(frameNumber) == 0)
+	{
+		return;
+	}
+
+	// Waits for the last render pass to finish writing the image
+	VkImageMemoryBarrier imageBarrier{};
+	imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	imageBarrier.image = image;
+	imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	imageBarrier.subresourceRange.levelCount = 1;
+	imageBarrier.subresourceRange.layerCount = 1;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &imageBarrier);
+
+	// Copies the whole image, tightly packed
+	Readback& readback = readbacks[frame];
+	VkBufferImageCopy region{};
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount = 1;
+	region.imageExtent = { extent.width, extent.height, 1 };
+	vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, readback.buffer, 1, &region);
+
+	// Makes the copy visible to the CPU once the frame's fence is signaled
+	VkBufferMemoryBarrier bufferBarrier{};
+	bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+	bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	bufferBarrier.buffer = readback.buffer;
+	bufferBarrier.size = VK_WHOLE_SIZE;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &bufferBarrier, 0, NULL);
+
+	readback.pendingFrame = frameNumber;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Writes out the frame's capture, if it had one. Only call once the frame's fence has
+		been waited on
+
+	\param frame
+		The index of the frame in flight that finished
+*/
+/*************************************************************************************************/
+void FrameCapture::FrameFinished(int frame)
+{
+	if (frame < (int)readbacks.size() && readbacks[frame].pendingFrame != 0)
+	{
+		WriteImage(readbacks[frame]);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Writes out every capture still waiting. The device must be idle
+*/
+/*************************************************************************************************/
+void FrameCapture::Finish()
+{
+	for (Readback& readback : readbacks)
+	{
+		if (readback.pendingFrame != 0)
+		{
+			WriteImage(readback);
+		}
+	}
+
+	// Anything left was asked for past the last frame drawn
+	for (uint64_t requestedFrame : requestedFrames)
+	{
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: Frame " + std::to_string(requestedFrame) + " was never drawn");
+	}
+	requestedFrames.clear();
+
+	if (!goldenDirectory.empty())
+	{
+		std::stringstream summary;
+		summary << "FrameCapture: " << comparisons - failedComparisons << " of " << comparisons << " frames matched " << goldenDirectory
+			<< " within " << tolerance;
+		_Debug->Print(failedComparisons == 0 ? Debug::MessageType::Debug : Debug::MessageType::Error, summary.str());
+		std::cout << summary.str() << std::endl;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys the readback buffers. The device must be idle
+*/
+/*************************************************************************************************/
+void FrameCapture::Free()
+{
+	for (Readback& readback : readbacks)
+	{
+		_Window->DestroyBuffer(readback.buffer, readback.memory);
+	}
+	readbacks.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Converts a readback buffer to RGB and writes it to a file
+
+	\param readback
+		The buffer holding the frame
+*/
+/*************************************************************************************************/
+void FrameCapture::WriteImage(Readback& readback)
+{
+	uint64_t capturedFrame = readback.pendingFrame;
+	readback.pendingFrame = 0;
+
+	// Drops the alpha, which the post process pass doesn't keep meaningful, and puts the
+	// channels in RGB order. The values are written as stored, so srgb images stay srgb
+	bool swapRedBlue = imageFormat == VK_FORMAT_B8G8R8A8_SRGB || imageFormat == VK_FORMAT_B8G8R8A8_UNORM;
+	size_t pixelCount = (size_t)extent.width * extent.height;
+	const uint8_t* source = (const uint8_t*)readback.memory.mapped;
+	std::vector<uint8_t> pixels(pixelCount * 3);
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		pixels[i * 3 + 0] = source[i * 4 + (swapRedBlue ? 2 : 0)];
+		pixels[i * 3 + 1] = source[i * 4 + 1];
+		pixels[i * 3 + 2] = source[i * 4 + (swapRedBlue ? 0 : 2)];
+	}
+
+	// Names files by frame so they sort in order
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+	std::stringstream leafName;
+	leafName << "frame_" << std::setw(6) << std::setfill('0') << capturedFrame << (format == Format::Png ? ".png" : ".ppm");
+	std::stringstream filename;
+	filename << directory << "/" << leafName.str();
+
+	bool written = false;
+	if (format == Format::Png)
+	{
+		written = stbi_write_png(filename.str().c_str(), (int)extent.width, (int)extent.height, 3, pixels.data(), (int)extent.width * 3) != 0;
+	}
+	else
+	{
+		std::ofstream file(filename.str(), std::ios::binary | std::ios::trunc);
+		file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
+		file.write((const char*)pixels.data(), pixels.size());
+		written = (bool)file;
+	}
+
+	if (written)
+	{
+		_Debug->Print(Debug::MessageType::Debug, "FrameCapture: Wrote " + filename.str());
+	}
+	else
+	{
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: Failed to write " + filename.str());
+	}
+
+	if (!goldenDirectory.empty())
+	{
+		CompareImage(leafName.str(), pixels);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Compares a captured frame against its golden frame and logs how far apart they are
+
+	\param leafName
+		The frame's file name, which the golden frame shares
+
+	\param pixels
+		The captured frame, as tightly packed RGB
+*/
+/*************************************************************************************************/
+void FrameCapture::CompareImage(const std::string& leafName, const std::vector<uint8_t>& pixels)
+{
+	comparisons++;
+
+	// stb reads both png and binary ppm, so either output format can be compared
+	std::string goldenName = goldenDirectory + "/" + leafName;
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	uint8_t* golden = stbi_load(goldenName.c_str(), &width, &height, &channels, 3);
+	if (!golden)
+	{
+		failedComparisons++;
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: No golden frame at " + goldenName);
+		return;
+	}
+	if (width != (int)extent.width || height != (int)extent.height)
+	{
+		failedComparisons++;
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: " + goldenName + " is " + std::to_string(width) + "x" + std::to_string(height)
+			+ ", the capture is " + std::to_string(extent.width) + "x" + std::to_string(extent.height));
+		stbi_image_free(golden);
+		return;
+	}
+
+	// Counts pixels rather than channels, so one bad pixel is one miss
+	int maxDifference = 0;
+	size_t pixelsOver = 0;
+	for (size_t i = 0; i < pixels.size(); i += 3)
+	{
+		bool over = false;
+		for (size_t channel = 0; channel < 3; channel++)
+		{
+			int difference = std::abs((int)pixels[i + channel] - (int)golden[i + channel]);
+			maxDifference = std::max(maxDifference, difference);
+			over |= difference > tolerance;
+		}
+		pixelsOver += over ? 1 : 0;
+	}
+	stbi_image_free(golden);
+
+	std::string result = leafName + " against " + goldenName + ": max difference " + std::to_string(maxDifference) + ", "
+		+ std::to_string(pixelsOver) + " pixels over " + std::to_string(tolerance);
+	if (pixelsOver == 0)
+	{
+		_Debug->Print(Debug::MessageType::Debug, "FrameCapture: Matched " + result);
+	}
+	else
+	{
+		failedComparisons++;
+		_Debug->Print(Debug::MessageType::Error, "FrameCapture: Mismatched " + result);
+	}
+}
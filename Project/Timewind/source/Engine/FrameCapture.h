@@ -0,0 +1,321 @@
+/*************************************************************************************************/
+/*!
+\file FrameCapture.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Copies chosen frames back from the GPU and writes them out as images. The copy is recorded
+	into the frame's own command buffer and read once the frame's fence has been waited on, so
+	capturing never stalls the frame that asked for it. Captures can also be checked against
+	golden frames written by an earlier run
+
+    Public Functions:
+        + FrameCapture
+		+ ~FrameCapture
+		+ Init
+		+ SetOutput
+		+ SetGolden
+		+ Request
+		+ Record
+		+ FrameFinished
+		+ Finish
+		+ Free
+		+ GetFrameNumber
+		+ GetFailedComparisons
+
+	Private Functions:
+		+ WriteImage
+		+ CompareImage
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_FrameCapture_H_
+#define Syncopatience_FrameCapture_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The readback buffers' memory
+#include "MemoryAllocator.h"
+
+// The requested frames and where they go
+#include <set>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The frame capture class
+*/
+/*************************************************************************************************/
+class FrameCapture
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	// The file type captured frames are written as
+	enum class Format
+	{
+		Png,									// Compressed, for looking at
+		Ppm										// Raw RGB with a tiny header, for comparing byte by byte
+	};
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the frame capture class
+	*/
+	/*************************************************************************************************/
+	FrameCapture();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the frame capture class
+	*/
+	/*************************************************************************************************/
+	~FrameCapture();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes a readback buffer for each frame in flight
+
+		\param vkDevice
+			The logical device
+
+		\param framesInFlight
+			How many frames can be recorded before the oldest one is finished
+
+		\param extent_
+			The size of the images being captured
+
+		\param imageFormat_
+			The format of the images being captured. Only 4 byte RGBA and BGRA formats are supported
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, int framesInFlight, VkExtent2D extent_, VkFormat imageFormat_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets where captured frames are written and as what
+
+		\param directory_
+			The directory the images go in. Made if it doesn't exist
+
+		\param format_
+			The file type to write
+	*/
+	/*************************************************************************************************/
+	void SetOutput(const std::string& directory_, Format format_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks each captured frame against the file of the same name in another directory,
+			e.g. frames captured with the reference CRT filter
+
+		\param goldenDirectory_
+			The directory holding the golden frames
+
+		\param tolerance_
+			The most any channel may differ by, in 8 bit steps
+	*/
+	/*************************************************************************************************/
+	void SetGolden(const std::string& goldenDirectory_, int tolerance_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Asks for a frame to be captured
+
+		\param frameNumber
+			The frame to capture, counting from 1 for the first frame drawn
+	*/
+	/*************************************************************************************************/
+	void Request(uint64_t frameNumber);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Counts a frame and, if it was requested, records a copy of its final image into the
+			frame's readback buffer. Call once per frame after the last render pass ends
+
+		\param commandBuffer
+			The frame's command buffer
+
+		\param frame
+			The index of the frame in flight being recorded
+
+		\param image
+			The final image, in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+	*/
+	/*************************************************************************************************/
+	void Record(VkCommandBuffer commandBuffer, int frame, VkImage image);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes out the frame's capture, if it had one. Only call once the frame's fence has
+			been waited on
+
+		\param frame
+			The index of the frame in flight that finished
+	*/
+	/*************************************************************************************************/
+	void FrameFinished(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes out every capture still waiting. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Finish();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys the readback buffers. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many frames have been recorded
+
+		\return
+			The number of the last frame recorded
+	*/
+	/*************************************************************************************************/
+	uint64_t GetFrameNumber() { return frameNumber; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many captured frames didn't match their golden frame, or had none
+
+		\return
+			The number of failed comparisons
+	*/
+	/*************************************************************************************************/
+	int GetFailedComparisons() { return failedComparisons; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// One frame in flight's copy of its final image
+	typedef struct
+	{
+		VkBuffer buffer;						// Where the image is copied to
+		MemoryAllocator::Allocation memory;		// The buffer's host visible memory
+		uint64_t pendingFrame;					// The frame copied into the buffer and not yet written, 0 if none
+	}Readback;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device
+	VkExtent2D extent;							// The size of the captured images
+	VkFormat imageFormat;						// The format of the captured images
+	std::vector<Readback> readbacks;			// Each frame in flight's readback buffer
+	std::set<uint64_t> requestedFrames;			// Frames still to be captured
+	std::string directory;						// Where captured frames are written
+	Format format;								// The file type captured frames are written as
+	uint64_t frameNumber;						// How many frames have been recorded
+
+	std::string goldenDirectory;				// Where the frames to compare against are, empty to not compare
+	int tolerance;								// The most a channel may differ from the golden frame by
+	int comparisons;							// Frames compared so far
+	int failedComparisons;						// Frames that didn't match
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Converts a readback buffer to RGB and writes it to a file
+
+		\param readback
+			The buffer holding the frame
+	*/
+	/*************************************************************************************************/
+	void WriteImage(Readback& readback);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Compares a captured frame against its golden frame and logs how far apart they are
+
+		\param leafName
+			The frame's file name, which the golden frame shares
+
+		\param pixels
+			The captured frame, as tightly packed RGB
+	*/
+	/*************************************************************************************************/
+	void CompareImage(const std::string& leafName, const std::vector<uint8_t>& pixels);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_FrameCapture_H_
@@ -120,41 +120,48 @@ void GameObjectManager::Update(double dt)
 /*************************************************************************************************/
 /*!
 	\brief
-		Draws the game objects in the manager to the screen.
+		Draws the game objects in the manager to the screen. Objects at priority 100 and up are
+		glitches, which are drawn to the glitch mask in the same walk
 */
 /*************************************************************************************************/
 void GameObjectManager::Draw()
 {
-	// Walks through the game object list
+	// Walks through the game object list. It's sorted by priority, so the glitches all come last
+	bool drawingGlitches = false;
 	for (std::multimap<int, GameObject*>::iterator it = gameObjectList.begin(); it != gameObjectList.end();)
 	{
-		if (it->first < 100)
+		if (it->first >= 100 && !drawingGlitches)
+		{
+			drawingGlitches = true;
+			_Window->SetGlitchDrawing(true);
+		}
+
+		if ((*it).second->GetActive())
 		{
-			if ((*it).second->GetActive())
+			// Checks if the object is text that should be drawn
+			if (!drawingGlitches && it->second->GetRender() == 2)
 			{
-				// Checks if the object is text that should be drawn
-				if (it->second->GetRender() == 2)
-				{
-					_Window->DrawTextObject((*it).second);
-				}
-				else
-				{
-					_Window->DrawGameObject((*it).second);
-					(*it).second->DrawChildObjects();
-				}
+				_Window->DrawTextObject((*it).second);
+			}
+			else
+			{
+				_Window->DrawGameObject((*it).second);
+				(*it).second->DrawChildObjects();
+			}
 
-				// Checks if the game object is only supposed to be drawn this frame
-				if ((*it).second->GetDrawThisFrame())
-				{
-					// Turns the game object off
-					(*it).second->SetRender(false);
-					(*it).second->DrawThisFrame(false);
-				}
+			// Checks if the game object is only supposed to be drawn this frame
+			if ((*it).second->GetDrawThisFrame())
+			{
+				// Turns the game object off
+				(*it).second->SetRender(false);
+				(*it).second->DrawThisFrame(false);
 			}
 		}
 
 		it++;
 	}
+
+	_Window->SetGlitchDrawing(false);
 }
 
 /*************************************************************************************************/
@@ -178,38 +185,6 @@ void GameObjectManager::Shutdown()
 	player = NULL;
 }
 
-/*************************************************************************************************/
-/*!
-	\brief
-		Draws the glitched game objects in the manager to the screen.
-*/
-/*************************************************************************************************/
-void GameObjectManager::DrawGlitches()
-{
-	// Walks through the game object list
-	for (std::multimap<int, GameObject*>::iterator it = gameObjectList.begin(); it != gameObjectList.end();)
-	{
-		if (it->first >= 100)
-		{
-			if ((*it).second->GetActive())
-			{
-				_Window->DrawGameObject((*it).second);
-				(*it).second->DrawChildObjects();
-
-				// Checks if the game object is only supposed to be drawn this frame
-				if ((*it).second->GetDrawThisFrame())
-				{
-					// Turns the game object off
-					(*it).second->SetRender(false);
-					(*it).second->DrawThisFrame(false);
-				}
-			}
-		}
-
-		it++;
-	}
-}
-
 
 /*************************************************************************************************/
 /*!
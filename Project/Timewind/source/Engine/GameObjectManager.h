@@ -126,14 +126,6 @@ public:
 	/*************************************************************************************************/
 	void Shutdown();
 
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Draws the glitched game objects in the manager to the screen.
-	*/
-	/*************************************************************************************************/
-	void DrawGlitches();
-
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -83,7 +83,7 @@ GameStateManager::GameStateManager() : System(SystemTypes::gameStateManager), cu
 /*************************************************************************************************/
 void GameStateManager::Init()
 {
-	glfwSetInputMode(_Window->GetVulkanWindowPtr(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+	_Window->SetCursorMode(GLFW_CURSOR_NORMAL);
 }
 
 /*************************************************************************************************/
@@ -211,7 +211,7 @@ void GameStateManager::SetGameState(GameStates newGameState)
 		_AudioManager->RestartAudio();
 	}
 
-	glfwSetInputMode(_Window->GetVulkanWindowPtr(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	_Window->SetCursorMode(GLFW_CURSOR_DISABLED);
 
 	// Logs that the game state has changed
 	switch (newGameState)
@@ -265,13 +265,13 @@ void GameStateManager::SetCurrentMenu(Menu* newMenu, bool isPlacing)
 		if (!isPlacing)
 		{
 			currentState = GameStates::Menu;
-			glfwSetInputMode(_Window->GetVulkanWindowPtr(), GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+			_Window->SetCursorMode(GLFW_CURSOR_NORMAL);
 			_Debug->Print(Debug::MessageType::Debug, "Game State Manager: Set game state: Menu");
 		}
 		else
 		{
 			currentState = GameStates::Placing;
-			glfwSetInputMode(_Window->GetVulkanWindowPtr(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+			_Window->SetCursorMode(GLFW_CURSOR_DISABLED);
 			_Debug->Print(Debug::MessageType::Debug, "Game State Manager: Set game state: Placing");
 		}
 	}
@@ -307,7 +307,7 @@ void GameStateManager::TurnOffCurrentMenu()
 	else
 	{
 		currentMenu = NULL;
-		glfwSetInputMode(_Window->GetVulkanWindowPtr(), GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+		_Window->SetCursorMode(GLFW_CURSOR_DISABLED);
 
 		_Debug->Print(Debug::MessageType::Debug, "Game State Manager: Popping game state");			//// !! Should make a helper function that just prints the game state !! ////
 
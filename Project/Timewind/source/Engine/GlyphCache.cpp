@@ -0,0 +1,481 @@
+/*************************************************************************************************/
+/*!
+\file GlyphCache.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Renders a font's glyphs the first time they're asked for and keeps them in fixed size cells
+	on atlas pages. Pages are only made as they fill up, the least recently drawn glyph gives up
+	its cell once they're all full, and each new glyph is copied into its cell as part of the
+	next frame. Only so many glyphs are rendered each frame, so a new string never holds a frame
+	up for long
+
+    Functions include:
+        + GlyphCache::GlyphCache
+		+ GlyphCache::~GlyphCache
+		+ GlyphCache::Init
+		+ GlyphCache::Find
+		+ GlyphCache::Touch
+		+ GlyphCache::GetStats
+		+ GlyphCache::Free
+		+ GlyphCache::OpenFace
+		+ GlyphCache::Rasterize
+		+ GlyphCache::TakeSlot
+		+ GlyphCache::StartFrame
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "GlyphCache.h"
+#include "cppShortcuts.h"
+
+// The frame count, and copying cells to their pages
+#include "Engine.h"
+#include "Window.h"
+#include "Texture.h"
+
+// Includes freetype
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+// Timing each frame's rendering
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// Width and height of each cell. Fits a 48 pixel glyph with its distance field's padding
+const uint32_t cellSize = 64;
+
+// Width and height of each page, and the cells that fit on one
+const uint32_t pageSize = 512;
+const uint32_t cellsPerRow = pageSize / cellSize;
+const uint32_t cellsPerPage = cellsPerRow * cellsPerRow;
+
+// The most pages a font makes before glyphs start giving up their cells
+const size_t maxPages = 4;
+
+// Empty pixels around each glyph in its cell, so filtering never reads a neighbor
+const uint32_t cellGap = 1;
+
+// The most glyphs rendered in one frame, and the most time spent on them. Whatever's left waits
+// for the next frame
+const int maxGlyphsPerFrame = 8;
+const double maxMillisecondsPerFrame = 2.0;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the glyph cache class
+*/
+/*************************************************************************************************/
+GlyphCache::GlyphCache() : fontData(), name(), pixelSize(0), spread(0), library(NULL), face(NULL), faceFailed(false), pages(), slots(), lookup(),
+	empty(), unavailable(), generation(0), frame(0), frameGlyphs(0), frameMilliseconds(0.0), stats()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the glyph cache class
+*/
+/*************************************************************************************************/
+GlyphCache::~GlyphCache()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Keeps the font file to render glyphs from. Nothing is rendered until a glyph is asked for
+
+	\param fontData_
+		The font file
+
+	\param name_
+		The font's filename, for the log
+
+	\param pixelSize_
+		The size glyphs are rendered at
+
+	\param spread_
+		How far the distance field reaches past each outline, in pixels
+*/
+/*************************************************************************************************/
+void GlyphCache::Init(const std::vector<uint8_t>& fontData_, const std::string& name_, uint32_t pixelSize_, uint32_t spread_)
+{
+	fontData = fontData_;
+	name = name_;
+	pixelSize = pixelSize_;
+	spread = spread_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds a glyph, rendering it if it isn't cached yet and this frame still has time for it
+
+	\param codepoint
+		The glyph's unicode codepoint
+
+	\param entry
+		Set to the glyph's metrics and page
+
+	\param slot
+		Set to the glyph's cell, or -1 if it doesn't have one
+
+	\return
+		Whether the glyph is ready. False means it has to be asked for again next frame
+*/
+/*************************************************************************************************/
+bool GlyphCache::Find(uint32_t codepoint, Entry& entry, int& slot)
+{
+	StartFrame();
+	slot = -1;
+
+	auto cached = lookup.find(codepoint);
+	if (cached != lookup.end())
+	{
+		slot = cached->second;
+		slots[slot].lastUsed = frame;
+		entry = slots[slot].entry;
+		return true;
+	}
+
+	auto blank = empty.find(codepoint);
+	if (blank != empty.end())
+	{
+		entry = blank->second;
+		return true;
+	}
+
+	// Glyphs that can't be drawn take no space, rather than being tried again every frame
+	entry = { glm::ivec2(0), glm::ivec2(0), glm::ivec2(0), 0, NULL };
+	if (unavailable.count(codepoint))
+	{
+		return true;
+	}
+
+	// The rest of the frame's glyphs wait, so a long new string only costs a few frames a little
+	if (frameGlyphs >= maxGlyphsPerFrame || frameMilliseconds >= maxMillisecondsPerFrame)
+	{
+		stats.deferred++;
+		return false;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool ready = Rasterize(codepoint, entry, slot);
+	frameMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (!ready)
+	{
+		stats.deferred++;
+	}
+	return ready;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Marks a glyph as drawn this frame, so its cell isn't given away before the frame is done
+
+	\param slot
+		The glyph's cell
+*/
+/*************************************************************************************************/
+void GlyphCache::Touch(int slot)
+{
+	StartFrame();
+	if (slot >= 0 && slot < (int)slots.size())
+	{
+		slots[slot].lastUsed = frame;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns what the cache has done
+
+	\return
+		The cache's counts and rendering times
+*/
+/*************************************************************************************************/
+GlyphCache::Stats GlyphCache::GetStats()
+{
+	Stats current = stats;
+	current.pages = (int)pages.size();
+	current.cachedGlyphs = (int)lookup.size();
+	return current;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Frees the pages and closes the font
+*/
+/*************************************************************************************************/
+void GlyphCache::Free()
+{
+	for (Texture* page : pages)
+	{
+		page->Free();
+		delete page;
+	}
+	pages.clear();
+	slots.clear();
+	lookup.clear();
+	empty.clear();
+	unavailable.clear();
+
+	if (face)
+	{
+		FT_Done_Face(face);
+		face = NULL;
+	}
+	if (library)
+	{
+		FT_Done_FreeType(library);
+		library = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Opens freetype and the font's face the first time a glyph is rendered
+
+	\return
+		Whether the face is open
+*/
+/*************************************************************************************************/
+bool GlyphCache::OpenFace()
+{
+	if (face || faceFailed)
+	{
+		return face != NULL;
+	}
+	faceFailed = true;
+
+	if (fontData.empty() || FT_Init_FreeType(&library))
+	{
+		_Debug->Print(Debug::MessageType::Error, "GlyphCache: Could not init FreeType for " + name);
+		library = NULL;
+		return false;
+	}
+
+	// Matches the spread of the font's own atlas, so cached glyphs look the same in the shader
+	FT_Int ftSpread = (FT_Int)spread;
+	FT_Property_Set(library, "sdf", "spread", &ftSpread);
+
+	// Freetype reads from the bytes for as long as the face is open, so they're kept
+	if (FT_New_Memory_Face(library, fontData.data(), (FT_Long)fontData.size(), 0, &face))
+	{
+		_Debug->Print(Debug::MessageType::Error, "GlyphCache: Failed to load " + name);
+		face = NULL;
+		FT_Done_FreeType(library);
+		library = NULL;
+		return false;
+	}
+	FT_Set_Pixel_Sizes(face, 0, pixelSize);
+
+	faceFailed = false;
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Renders a glyph's distance field into a free cell and queues the cell's copy to its page
+
+	\param codepoint
+		The glyph's unicode codepoint
+
+	\param entry
+		Set to the glyph's metrics and page
+
+	\param slot
+		Set to the glyph's cell, or -1 if it doesn't need one
+
+	\return
+		Whether the glyph is ready. False if every cell is being drawn from this frame
+*/
+/*************************************************************************************************/
+bool GlyphCache::Rasterize(uint32_t codepoint, Entry& entry, int& slot)
+{
+	slot = -1;
+	if (!OpenFace() || FT_Load_Char(face, codepoint, FT_LOAD_DEFAULT))
+	{
+		_Debug->Print(Debug::MessageType::Debug, "GlyphCache: Failed to load glyph " + std::to_string(codepoint) + " of " + name);
+		unavailable.insert(codepoint);
+		return true;
+	}
+	entry.advance = static_cast<unsigned int>(face->glyph->advance.x);
+
+	// Characters without an outline, like spaces, only have an advance
+	if (face->glyph->format != FT_GLYPH_FORMAT_OUTLINE || face->glyph->outline.n_points == 0)
+	{
+		empty[codepoint] = entry;
+		return true;
+	}
+
+	// Finds the cell before rendering, so no time is spent on a glyph that would have to wait anyway
+	int newSlot = TakeSlot();
+	if (newSlot < 0)
+	{
+		return false;
+	}
+
+	FT_Bitmap& bitmap = face->glyph->bitmap;
+	if (FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF) != 0 || bitmap.width == 0
+		|| bitmap.width + 2 * cellGap > cellSize || bitmap.rows + 2 * cellGap > cellSize)
+	{
+		// Still takes up its space in the text, it just isn't drawn
+		_Debug->Print(Debug::MessageType::Debug, "GlyphCache: Glyph " + std::to_string(codepoint) + " of " + name + " couldn't be rendered into a cell");
+		empty[codepoint] = entry;
+		return true;
+	}
+
+	// Fills the whole cell, so nothing of the glyph that had it before is left around the new one
+	Slot& cell = slots[newSlot];
+	uint32_t pageCell = (uint32_t)newSlot % cellsPerPage;
+	glm::ivec2 cellPosition((pageCell % cellsPerRow) * cellSize, (pageCell / cellsPerRow) * cellSize);
+	std::vector<uint8_t> pixels((size_t)cellSize * cellSize, 0);
+	for (unsigned int row = 0; row < bitmap.rows; row++)
+	{
+		memcpy(pixels.data() + (size_t)(row + cellGap) * cellSize + cellGap, bitmap.buffer + (ptrdiff_t)row * bitmap.pitch, bitmap.width);
+	}
+
+	entry.size = glm::ivec2(bitmap.width, bitmap.rows);
+	entry.bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+	entry.atlasPosition = cellPosition + glm::ivec2(cellGap);
+	entry.page = pages[newSlot / cellsPerPage];
+	_Window->UpdateTextureRegion(entry.page, pixels.data(), cellSize, { cellPosition.x, cellPosition.y }, { cellSize, cellSize });
+
+	cell.codepoint = codepoint;
+	cell.used = true;
+	cell.lastUsed = frame;
+	cell.entry = entry;
+	lookup[codepoint] = newSlot;
+	slot = newSlot;
+
+	frameGlyphs++;
+	stats.rasterized++;
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds a cell for a new glyph. Uses an empty cell, then a new page, then the cell of the
+		glyph drawn longest ago, as long as it wasn't drawn this frame
+
+	\return
+		The cell, or -1 if there isn't one this frame
+*/
+/*************************************************************************************************/
+int GlyphCache::TakeSlot()
+{
+	for (int i = 0; i < (int)slots.size(); i++)
+	{
+		if (!slots[i].used)
+		{
+			return i;
+		}
+	}
+
+	// A new page starts out cleared, and frames wait for it to be ready before drawing from it
+	if (pages.size() < maxPages)
+	{
+		std::vector<uint8_t> blank((size_t)pageSize * pageSize, 0);
+		pages.push_back(new Texture(pageSize, pageSize, blank.data()));
+
+		int firstSlot = (int)slots.size();
+		Slot emptySlot{};
+		slots.resize(slots.size() + cellsPerPage, emptySlot);
+		return firstSlot;
+	}
+
+	// Glyphs drawn this frame are still going to be read, so they keep their cells
+	int oldest = -1;
+	for (int i = 0; i < (int)slots.size(); i++)
+	{
+		if (slots[i].lastUsed < frame && (oldest < 0 || slots[i].lastUsed < slots[oldest].lastUsed))
+		{
+			oldest = i;
+		}
+	}
+
+	if (oldest >= 0)
+	{
+		lookup.erase(slots[oldest].codepoint);
+		slots[oldest].used = false;
+		generation++;
+		stats.evictions++;
+	}
+	return oldest;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finishes the last frame's timing and resets the budget if a new frame has started
+*/
+/*************************************************************************************************/
+void GlyphCache::StartFrame()
+{
+	unsigned long long currentFrame = Engine::createEngine()->GetFrameCount();
+	if (currentFrame == frame)
+	{
+		return;
+	}
+
+	if (frameGlyphs > 0)
+	{
+		stats.hitchFrames++;
+		stats.lastHitchMilliseconds = frameMilliseconds;
+		stats.worstHitchMilliseconds = std::max(stats.worstHitchMilliseconds, frameMilliseconds);
+		_Debug->Print(Debug::MessageType::Debug, "GlyphCache: Rendered " + std::to_string(frameGlyphs) + " glyphs of " + name + " in "
+			+ std::to_string(frameMilliseconds) + " ms (worst " + std::to_string(stats.worstHitchMilliseconds) + " ms)");
+	}
+
+	frame = currentFrame;
+	frameGlyphs = 0;
+	frameMilliseconds = 0.0;
+}
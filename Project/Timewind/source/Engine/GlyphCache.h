@@ -0,0 +1,323 @@
+/*************************************************************************************************/
+/*!
+\file GlyphCache.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Renders a font's glyphs the first time they're asked for and keeps them in fixed size cells
+	on atlas pages. Pages are only made as they fill up, the least recently drawn glyph gives up
+	its cell once they're all full, and each new glyph is copied into its cell as part of the
+	next frame. Only so many glyphs are rendered each frame, so a new string never holds a frame
+	up for long
+
+    Public Functions:
+        + GlyphCache
+		+ ~GlyphCache
+		+ Init
+		+ Find
+		+ Touch
+		+ GetGeneration
+		+ GetStats
+		+ Free
+
+	Private Functions:
+		+ OpenFace
+		+ Rasterize
+		+ TakeSlot
+		+ StartFrame
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_GlyphCache_H_
+#define Syncopatience_GlyphCache_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// The font file, the cells and finding glyphs in them
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+class Texture;
+
+// Freetype's handles, so its headers stay out of everything that includes fonts
+struct FT_LibraryRec_;
+struct FT_FaceRec_;
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The glyph cache class
+*/
+/*************************************************************************************************/
+class GlyphCache
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// A cached glyph, laid out like the font's own characters
+	typedef struct
+	{
+		glm::ivec2 size;						// Size of glyph, including the distance field's padding
+		glm::ivec2 bearing;						// Offset from baseline to left/top of glyph
+		glm::ivec2 atlasPosition;				// The top left corner of this glyph in its page
+		unsigned int advance;					// Offset to advance to next glyph, in 1/64ths of a pixel
+		Texture* page;							// The page the glyph is in, NULL if it has nothing to draw
+	}Entry;
+
+	// What the cache has done
+	typedef struct
+	{
+		int rasterized;							// Glyphs rendered since the font was loaded
+		int evictions;							// Glyphs that gave up their cell to a newer one
+		int deferred;							// Times a glyph had to wait for a later frame
+		int hitchFrames;						// Frames that rendered at least one glyph
+		double lastHitchMilliseconds;			// Time spent rendering glyphs in the last frame that did
+		double worstHitchMilliseconds;			// The most time any one frame spent rendering glyphs
+		int pages;								// Atlas pages made so far
+		int cachedGlyphs;						// Glyphs in the cells right now
+	}Stats;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the glyph cache class
+	*/
+	/*************************************************************************************************/
+	GlyphCache();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the glyph cache class
+	*/
+	/*************************************************************************************************/
+	~GlyphCache();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Keeps the font file to render glyphs from. Nothing is rendered until a glyph is asked for
+
+		\param fontData_
+			The font file
+
+		\param name_
+			The font's filename, for the log
+
+		\param pixelSize_
+			The size glyphs are rendered at
+
+		\param spread_
+			How far the distance field reaches past each outline, in pixels
+	*/
+	/*************************************************************************************************/
+	void Init(const std::vector<uint8_t>& fontData_, const std::string& name_, uint32_t pixelSize_, uint32_t spread_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds a glyph, rendering it if it isn't cached yet and this frame still has time for it
+
+		\param codepoint
+			The glyph's unicode codepoint
+
+		\param entry
+			Set to the glyph's metrics and page
+
+		\param slot
+			Set to the glyph's cell, or -1 if it doesn't have one
+
+		\return
+			Whether the glyph is ready. False means it has to be asked for again next frame
+	*/
+	/*************************************************************************************************/
+	bool Find(uint32_t codepoint, Entry& entry, int& slot);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Marks a glyph as drawn this frame, so its cell isn't given away before the frame is done
+
+		\param slot
+			The glyph's cell
+	*/
+	/*************************************************************************************************/
+	void Touch(int slot);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns a number that changes whenever a glyph loses its cell. Text laid out under an
+			older number has to be laid out again
+
+		\return
+			The generation
+	*/
+	/*************************************************************************************************/
+	unsigned int GetGeneration() { return generation; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what the cache has done
+
+		\return
+			The cache's counts and rendering times
+	*/
+	/*************************************************************************************************/
+	Stats GetStats();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Frees the pages and closes the font
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// One cell on a page
+	typedef struct
+	{
+		uint32_t codepoint;						// The glyph in the cell
+		bool used;								// Whether the cell holds a glyph
+		unsigned long long lastUsed;			// The last frame the glyph was drawn or rendered in
+		Entry entry;							// The glyph's metrics and page
+	}Slot;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	std::vector<uint8_t> fontData;				// The font file, which freetype reads from while the face is open
+	std::string name;							// The font's filename
+	uint32_t pixelSize;							// The size glyphs are rendered at
+	uint32_t spread;							// The distance field's reach, in pixels
+
+	FT_LibraryRec_* library;					// Freetype, opened on the first glyph
+	FT_FaceRec_* face;							// The font's face, opened on the first glyph
+	bool faceFailed;							// Whether the face couldn't be opened, so it isn't tried again
+
+	std::vector<Texture*> pages;				// The atlas pages, made as they're needed
+	std::vector<Slot> slots;					// Every cell on every page
+	std::unordered_map<uint32_t, int> lookup;	// The cell each cached glyph is in
+	std::unordered_map<uint32_t, Entry> empty;	// Glyphs without anything to draw, like spaces. They don't need a cell
+	std::unordered_set<uint32_t> unavailable;	// Glyphs the font doesn't have or that don't fit a cell
+
+	unsigned int generation;					// Changes whenever a glyph loses its cell
+	unsigned long long frame;					// The frame glyphs are being asked for in
+	int frameGlyphs;							// Glyphs rendered this frame
+	double frameMilliseconds;					// Time spent rendering glyphs this frame
+	Stats stats;								// What the cache has done
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Opens freetype and the font's face the first time a glyph is rendered
+
+		\return
+			Whether the face is open
+	*/
+	/*************************************************************************************************/
+	bool OpenFace();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Renders a glyph's distance field into a free cell and queues the cell's copy to its page
+
+		\param codepoint
+			The glyph's unicode codepoint
+
+		\param entry
+			Set to the glyph's metrics and page
+
+		\param slot
+			Set to the glyph's cell, or -1 if it doesn't need one
+
+		\return
+			Whether the glyph is ready. False if every cell is being drawn from this frame
+	*/
+	/*************************************************************************************************/
+	bool Rasterize(uint32_t codepoint, Entry& entry, int& slot);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds a cell for a new glyph. Uses an empty cell, then a new page, then the cell of the
+			glyph drawn longest ago, as long as it wasn't drawn this frame
+
+		\return
+			The cell, or -1 if there isn't one this frame
+	*/
+	/*************************************************************************************************/
+	int TakeSlot();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finishes the last frame's timing and resets the budget if a new frame has started
+	*/
+	/*************************************************************************************************/
+	void StartFrame();
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_GlyphCache_H_
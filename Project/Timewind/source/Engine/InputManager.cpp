@@ -98,9 +98,13 @@ void InputManager::Init()
 	keybinds.insert(std::pair(Inputs::F1, GLFW_KEY_F1));
 	keybinds.insert(std::pair(Inputs::F2, GLFW_KEY_F2));
 	keybinds.insert(std::pair(Inputs::F3, GLFW_KEY_F3));
+	keybinds.insert(std::pair(Inputs::F4, GLFW_KEY_F4));
 
-	// Grabs the cursor and uses it's current position as the starting for the program
-	glfwGetCursorPos(_Window->GetVulkanWindowPtr(), &mouseCoords.first, &mouseCoords.second);
+	// Grabs the cursor and uses it's current position as the starting for the program. Headless runs have no cursor
+	if (_Window->GetVulkanWindowPtr())
+	{
+		glfwGetCursorPos(_Window->GetVulkanWindowPtr(), &mouseCoords.first, &mouseCoords.second);
+	}
 }
 
 /*************************************************************************************************/
@@ -128,12 +132,20 @@ void InputManager::Update(double dt)
 	}
 
 	std::pair<double, double> oldMouseCoords = mouseCoords;
-	glfwGetCursorPos(_Window->GetVulkanWindowPtr(), &mouseCoords.first, &mouseCoords.second);
+	if (_Window->GetVulkanWindowPtr())
+	{
+		glfwGetCursorPos(_Window->GetVulkanWindowPtr(), &mouseCoords.first, &mouseCoords.second);
+	}
 	mouseDelta = { mouseCoords.first - oldMouseCoords.first, mouseCoords.second - oldMouseCoords.second };
 	if (CheckInputStatus(Inputs::F3) == InputStatus::Pressed)
 	{
 		std::cout << mouseCoords.first << ", " << mouseCoords.second << std::endl;
 	}
+	if (CheckInputStatus(Inputs::F2) == InputStatus::Pressed)
+	{
+		// Logs the next frame's render numbers, which aren't printed every frame
+		_Window->RequestFrameStats();
+	}
 
 	//if (CheckInputStatus(Inputs::Escape) == InputStatus::Pressed)
 	//{
@@ -237,10 +249,10 @@ InputManager::InputStatus InputManager::CheckInputStatus(std::vector<Inputs> inp
 /*************************************************************************************************/
 void InputManager::UpdateInputStatus(Inputs input)
 {
-	// Fetches the current state of the key	
+	// Fetches the current state of the key. Nothing is ever pressed without a window
 	int keyValue = 0;
 	auto range = keybinds.equal_range(input);
-	for (auto i = range.first; i != range.second; i++)
+	for (auto i = range.first; i != range.second && _Window->GetVulkanWindowPtr(); i++)
 	{
 		// Checks for a mouse button
 		if (i->second < 32)
@@ -81,6 +81,7 @@ public:
 		F1,
 		F2,
 		F3,
+		F4,
 		Max
 	};
 
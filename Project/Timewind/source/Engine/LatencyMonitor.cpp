@@ -0,0 +1,302 @@
+/*************************************************************************************************/
+/*!
+\file LatencyMonitor.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Measures how evenly frames are presented and how long each one takes from reading input to
+	being finished on the GPU. Each render setting is measured on its own, so settings can be
+	compared against each other
+
+    Functions include:
+        + LatencyMonitor::LatencyMonitor
+		+ LatencyMonitor::~LatencyMonitor
+		+ LatencyMonitor::Init
+		+ LatencyMonitor::Begin
+		+ LatencyMonitor::End
+		+ LatencyMonitor::InputSampled
+		+ LatencyMonitor::FrameStarted
+		+ LatencyMonitor::FrameFinished
+		+ LatencyMonitor::Presented
+		+ LatencyMonitor::GetStats
+		+ LatencyMonitor::Summarize
+		+ LatencyMonitor::Percentile
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "LatencyMonitor.h"
+#include "cppShortcuts.h"
+
+// Working out percentiles
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// Samples kept for each measurement, about a minute and a half at 60hz. Older ones are written over
+const size_t maxSamples = 6000;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the latency monitor class
+*/
+/*************************************************************************************************/
+LatencyMonitor::LatencyMonitor() : setting(), frames(), lastInput(std::chrono::steady_clock::now()), lastPresent(), presentedBefore(false),
+	frameCount(0), latencyCount(0), presentIntervals(), latencies(), results()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the latency monitor class
+*/
+/*************************************************************************************************/
+LatencyMonitor::~LatencyMonitor()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes room to track each frame in flight
+
+	\param frameSlots
+		The most frames that can be in flight at once
+*/
+/*************************************************************************************************/
+void LatencyMonitor::Init(int frameSlots)
+{
+	frames.assign(frameSlots, { lastInput, false });
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finishes measuring the current setting, if there is one, and starts measuring a new one
+
+	\param setting_
+		A description of the new setting
+*/
+/*************************************************************************************************/
+void LatencyMonitor::Begin(const std::string& setting_)
+{
+	End();
+	setting = setting_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finishes measuring the current setting and keeps what it measured
+*/
+/*************************************************************************************************/
+void LatencyMonitor::End()
+{
+	if (!setting.empty() && (frameCount > 0 || latencyCount > 0))
+	{
+		Stats stats = Summarize();
+		results.push_back(stats);
+
+		std::stringstream report;
+		report << std::fixed << std::setprecision(2) << "LatencyMonitor: " << stats.setting << ": " << stats.frameCount << " frames, "
+			<< stats.meanPresentInterval << " ms between presents (99% under " << stats.p99PresentInterval << "), "
+			<< stats.meanLatency << " ms from input to finished (99% under " << stats.p99Latency << ")";
+		_Debug->Print(Debug::MessageType::Debug, report.str());
+	}
+
+	// Frames already in flight were made with the old setting, so they aren't counted for the new one
+	setting.clear();
+	for (FrameSlot& frame : frames)
+	{
+		frame.pending = false;
+	}
+	presentedBefore = false;
+	frameCount = 0;
+	latencyCount = 0;
+	presentIntervals.clear();
+	latencies.clear();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Notes that input was just read. The next frame started is timed from here
+*/
+/*************************************************************************************************/
+void LatencyMonitor::InputSampled()
+{
+	lastInput = std::chrono::steady_clock::now();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts timing a frame from the last time input was read
+
+	\param frame
+		The index of the frame in flight being recorded
+*/
+/*************************************************************************************************/
+void LatencyMonitor::FrameStarted(int frame)
+{
+	frames[frame].inputTime = lastInput;
+	frames[frame].pending = true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Stops timing a frame. Call as soon as its fence is seen signaled. Does nothing if the
+		frame isn't being timed
+
+	\param frame
+		The index of the frame in flight that finished
+*/
+/*************************************************************************************************/
+void LatencyMonitor::FrameFinished(int frame)
+{
+	if (frame >= (int)frames.size() || !frames[frame].pending)
+	{
+		return;
+	}
+	frames[frame].pending = false;
+
+	double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frames[frame].inputTime).count();
+	if (latencies.size() < maxSamples)
+	{
+		latencies.push_back(latency);
+	}
+	else
+	{
+		latencies[latencyCount % maxSamples] = latency;
+	}
+	latencyCount++;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Notes that a frame was just handed to the presentation engine
+*/
+/*************************************************************************************************/
+void LatencyMonitor::Presented()
+{
+	TimePoint now = std::chrono::steady_clock::now();
+	if (presentedBefore)
+	{
+		double interval = std::chrono::duration<double, std::milli>(now - lastPresent).count();
+		if (presentIntervals.size() < maxSamples)
+		{
+			presentIntervals.push_back(interval);
+		}
+		else
+		{
+			presentIntervals[frameCount % maxSamples] = interval;
+		}
+	}
+	lastPresent = now;
+	presentedBefore = true;
+	frameCount++;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns what the current setting has measured so far
+
+	\return
+		The current setting's intervals and latency
+*/
+/*************************************************************************************************/
+LatencyMonitor::Stats LatencyMonitor::GetStats()
+{
+	return Summarize();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Works out the current setting's averages and percentiles
+
+	\return
+		The current setting's intervals and latency
+*/
+/*************************************************************************************************/
+LatencyMonitor::Stats LatencyMonitor::Summarize()
+{
+	Stats stats;
+	stats.setting = setting;
+	stats.frameCount = frameCount;
+	stats.meanPresentInterval = presentIntervals.empty() ? 0.0 : std::accumulate(presentIntervals.begin(), presentIntervals.end(), 0.0) / presentIntervals.size();
+	stats.p99PresentInterval = Percentile(presentIntervals, 0.99);
+	stats.meanLatency = latencies.empty() ? 0.0 : std::accumulate(latencies.begin(), latencies.end(), 0.0) / latencies.size();
+	stats.p99Latency = Percentile(latencies, 0.99);
+	return stats;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds the value a fraction of the samples are at or under
+
+	\param samples
+		The samples, copied so they can be reordered
+
+	\param fraction
+		The fraction, from 0 to 1
+
+	\return
+		The value, or 0 with no samples
+*/
+/*************************************************************************************************/
+double LatencyMonitor::Percentile(std::vector<double> samples, double fraction)
+{
+	if (samples.empty())
+	{
+		return 0.0;
+	}
+
+	size_t index = std::min((size_t)(fraction * (samples.size() - 1) + 0.5), samples.size() - 1);
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
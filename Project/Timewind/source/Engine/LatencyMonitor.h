@@ -0,0 +1,279 @@
+/*************************************************************************************************/
+/*!
+\file LatencyMonitor.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Measures how evenly frames are presented and how long each one takes from reading input to
+	being finished on the GPU. Each render setting is measured on its own, so settings can be
+	compared against each other
+
+    Public Functions:
+        + LatencyMonitor
+		+ ~LatencyMonitor
+		+ Init
+		+ Begin
+		+ End
+		+ InputSampled
+		+ FrameStarted
+		+ FrameFinished
+		+ Presented
+		+ GetStats
+		+ GetResults
+
+	Private Functions:
+		+ Summarize
+		+ Percentile
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_LatencyMonitor_H_
+#define Syncopatience_LatencyMonitor_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Timing frames and keeping their samples
+#include <chrono>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The latency monitor class
+*/
+/*************************************************************************************************/
+class LatencyMonitor
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// What one setting measured
+	typedef struct
+	{
+		std::string setting;					// The setting that was measured
+		int frameCount;							// Frames presented with the setting
+		double meanPresentInterval;				// Average milliseconds between presents
+		double p99PresentInterval;				// Milliseconds between presents that only 1% of frames went over
+		double meanLatency;						// Average milliseconds from reading input to the frame being finished
+		double p99Latency;						// Milliseconds of latency that only 1% of frames went over
+	}Stats;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the latency monitor class
+	*/
+	/*************************************************************************************************/
+	LatencyMonitor();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the latency monitor class
+	*/
+	/*************************************************************************************************/
+	~LatencyMonitor();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes room to track each frame in flight
+
+		\param frameSlots
+			The most frames that can be in flight at once
+	*/
+	/*************************************************************************************************/
+	void Init(int frameSlots);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finishes measuring the current setting, if there is one, and starts measuring a new one
+
+		\param setting_
+			A description of the new setting
+	*/
+	/*************************************************************************************************/
+	void Begin(const std::string& setting_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finishes measuring the current setting and keeps what it measured
+	*/
+	/*************************************************************************************************/
+	void End();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Notes that input was just read. The next frame started is timed from here
+	*/
+	/*************************************************************************************************/
+	void InputSampled();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts timing a frame from the last time input was read
+
+		\param frame
+			The index of the frame in flight being recorded
+	*/
+	/*************************************************************************************************/
+	void FrameStarted(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Stops timing a frame. Call as soon as its fence is seen signaled. Does nothing if the
+			frame isn't being timed
+
+		\param frame
+			The index of the frame in flight that finished
+	*/
+	/*************************************************************************************************/
+	void FrameFinished(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Notes that a frame was just handed to the presentation engine
+	*/
+	/*************************************************************************************************/
+	void Presented();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what the current setting has measured so far
+
+		\return
+			The current setting's intervals and latency
+	*/
+	/*************************************************************************************************/
+	Stats GetStats();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what every finished setting measured
+
+		\return
+			Each setting's intervals and latency, in the order they were measured
+	*/
+	/*************************************************************************************************/
+	const std::vector<Stats>& GetResults() { return results; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	// A frame in flight being timed
+	typedef struct
+	{
+		TimePoint inputTime;					// When the input the frame was made from was read
+		bool pending;							// Whether the frame is still being timed
+	}FrameSlot;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	std::string setting;						// The setting being measured, empty if none
+	std::vector<FrameSlot> frames;				// Each frame in flight's timing
+	TimePoint lastInput;						// When input was last read
+	TimePoint lastPresent;						// When a frame was last presented
+	bool presentedBefore;						// Whether lastPresent belongs to the current setting
+	int frameCount;								// Frames presented with the current setting
+	int latencyCount;							// Frames timed from input to finished with the current setting
+	std::vector<double> presentIntervals;		// The most recent milliseconds between presents with the current setting
+	std::vector<double> latencies;				// The most recent milliseconds from input to finished with the current setting
+	std::vector<Stats> results;					// Every finished setting
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Works out the current setting's averages and percentiles
+
+		\return
+			The current setting's intervals and latency
+	*/
+	/*************************************************************************************************/
+	Stats Summarize();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds the value a fraction of the samples are at or under
+
+		\param samples
+			The samples, copied so they can be reordered
+
+		\param fraction
+			The fraction, from 0 to 1
+
+		\return
+			The value, or 0 with no samples
+	*/
+	/*************************************************************************************************/
+	static double Percentile(std::vector<double> samples, double fraction);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_LatencyMonitor_H_
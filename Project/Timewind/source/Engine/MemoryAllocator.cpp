@@ -0,0 +1,563 @@
+/*************************************************************************************************/
+/*!
+\file MemoryAllocator.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Carves buffer and image memory out of a few large device allocations instead of giving every
+	resource its own. Each memory type gets blocks that are split with a buddy allocator, and
+	resources too big for a block get memory of their own
+
+    Functions include:
+        + MemoryAllocator::MemoryAllocator
+		+ MemoryAllocator::~MemoryAllocator
+		+ MemoryAllocator::Init
+		+ MemoryAllocator::Free
+		+ MemoryAllocator::Allocate
+		+ MemoryAllocator::Release
+		+ MemoryAllocator::Defragment
+		+ MemoryAllocator::PrintStatistics
+		+ MemoryAllocator::FindMemoryType
+		+ MemoryAllocator::FindPool
+		+ MemoryAllocator::AllocateDeviceMemory
+		+ MemoryAllocator::AllocateFromBlock
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "MemoryAllocator.h"
+#include "cppShortcuts.h"
+
+// Checking vulkan results
+#include "Window.h"
+
+// Sizing pieces
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// The largest a block gets. Smaller heaps get smaller blocks so one block is never a big share of the heap
+const VkDeviceSize maxBlockSize = 64 * 1024 * 1024;
+
+// The smallest block size, for tiny heaps
+const VkDeviceSize minBlockSize = 1024 * 1024;
+
+// The smallest piece a block is split into
+const VkDeviceSize minNodeSize = 256;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the memory allocator class
+*/
+/*************************************************************************************************/
+MemoryAllocator::MemoryAllocator() : device(NULL), memoryProperties(), bufferImageGranularity(1), pools(), statistics()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the memory allocator class
+*/
+/*************************************************************************************************/
+MemoryAllocator::~MemoryAllocator()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads the card's memory types and limits. No memory is taken until something asks for it
+
+	\param vkDevice
+		The logical device
+
+	\param physicalDevice
+		The graphics card
+*/
+/*************************************************************************************************/
+void MemoryAllocator::Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice)
+{
+	device = vkDevice;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	bufferImageGranularity = properties.limits.bufferImageGranularity;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Gives every block back to the driver. The device must be idle and every resource destroyed
+*/
+/*************************************************************************************************/
+void MemoryAllocator::Free()
+{
+	PrintStatistics();
+
+	// Anything still handed out (besides empty blocks) was never released
+	if (statistics.allocations > 0)
+	{
+		_Debug->Print(Debug::MessageType::Error, "MemoryAllocator: " + std::to_string(statistics.allocations) + " allocations were never released");
+	}
+
+	for (Pool& pool : pools)
+	{
+		for (Block& block : pool.blocks)
+		{
+			if (block.memory)
+			{
+				vkFreeMemory(device, block.memory, NULL);
+			}
+		}
+	}
+	pools.clear();
+	statistics = {};
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds memory for a buffer or image
+
+	\param requirements
+		The resource's memory requirements
+
+	\param required
+		Properties the memory must have
+
+	\param preferred
+		Properties the memory should have if the card has such a type, e.g. device local for
+		host visible data the GPU reads a lot
+
+	\param optimalImage
+		Whether the resource is an optimally tiled image, which can't share a page of
+		bufferImageGranularity with buffers
+
+	\return
+		The memory to bind the resource to
+*/
+/*************************************************************************************************/
+MemoryAllocator::Allocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred, bool optimalImage)
+{
+	// Tries for the preferred properties before settling for the required ones
+	int memoryType = FindMemoryType(requirements.memoryTypeBits, required | preferred);
+	if (memoryType < 0)
+	{
+		memoryType = FindMemoryType(requirements.memoryTypeBits, required);
+	}
+	if (memoryType < 0)
+	{
+		throw std::runtime_error("failed to find suitable memory type!");
+	}
+
+	// Pieces are aligned to their own size, so once the smallest piece covers a granularity page
+	// buffers and images can never share one. Otherwise images get blocks of their own
+	bool separateImages = optimalImage && bufferImageGranularity > minNodeSize;
+	int poolIndex = FindPool((uint32_t)memoryType, separateImages);
+	Pool& pool = pools[poolIndex];
+
+	// Rounds the piece up to a power of two, which also takes care of the alignment
+	VkDeviceSize nodeSize = minNodeSize;
+	while (nodeSize < requirements.size || nodeSize < requirements.alignment)
+	{
+		nodeSize *= 2;
+	}
+
+	Allocation allocation{};
+	allocation.pool = -1;
+	allocation.block = -1;
+
+	// Anything over half a block would waste most of one, so it gets memory of its own
+	if (nodeSize > pool.blockSize / 2)
+	{
+		unsigned char* mapped;
+		allocation.memory = AllocateDeviceMemory((uint32_t)memoryType, requirements.size, mapped);
+		allocation.offset = 0;
+		allocation.size = requirements.size;
+		allocation.mapped = mapped;
+
+		statistics.dedicatedAllocations++;
+		statistics.allocations++;
+		statistics.usedBytes += requirements.size;
+		return allocation;
+	}
+
+	// Finds which level of the block pieces this size are at
+	int level = 0;
+	for (VkDeviceSize size = pool.blockSize; size > nodeSize; size /= 2)
+	{
+		level++;
+	}
+
+	// Tries each block, then an empty slot, then a new block
+	VkDeviceSize offset = 0;
+	int blockIndex = -1;
+	for (size_t i = 0; i < pool.blocks.size() && blockIndex < 0; i++)
+	{
+		if (pool.blocks[i].memory && AllocateFromBlock(pool, pool.blocks[i], level, offset))
+		{
+			blockIndex = (int)i;
+		}
+	}
+	if (blockIndex < 0)
+	{
+		for (size_t i = 0; i < pool.blocks.size() && blockIndex < 0; i++)
+		{
+			if (!pool.blocks[i].memory)
+			{
+				blockIndex = (int)i;
+			}
+		}
+		if (blockIndex < 0)
+		{
+			blockIndex = (int)pool.blocks.size();
+			pool.blocks.push_back({});
+		}
+
+		// The new block starts as one free piece
+		Block& block = pool.blocks[blockIndex];
+		block.memory = AllocateDeviceMemory((uint32_t)memoryType, pool.blockSize, block.mapped);
+		block.freeNodes.assign(pool.levels, std::set<VkDeviceSize>());
+		block.freeNodes[0].insert(0);
+		block.allocations = 0;
+		statistics.blocks++;
+
+		AllocateFromBlock(pool, block, level, offset);
+	}
+
+	Block& block = pool.blocks[blockIndex];
+	allocation.memory = block.memory;
+	allocation.offset = offset;
+	allocation.size = nodeSize;
+	allocation.mapped = block.mapped ? block.mapped + offset : NULL;
+	allocation.pool = poolIndex;
+	allocation.block = blockIndex;
+	allocation.level = level;
+
+	statistics.allocations++;
+	statistics.usedBytes += nodeSize;
+	return allocation;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Gives memory back. The resource bound to it must already be destroyed
+
+	\param allocation
+		The memory to give back. Cleared afterwards so it can't be released twice
+*/
+/*************************************************************************************************/
+void MemoryAllocator::Release(Allocation& allocation)
+{
+	if (!allocation.memory)
+	{
+		return;
+	}
+
+	// Memory of its own goes straight back to the driver
+	if (allocation.pool < 0)
+	{
+		vkFreeMemory(device, allocation.memory, NULL);
+
+		statistics.deviceAllocations--;
+		statistics.dedicatedAllocations--;
+		statistics.reservedBytes -= allocation.size;
+	}
+	else
+	{
+		// Puts the piece back, merging it with its buddy for as long as the buddy is free too
+		Pool& pool = pools[allocation.pool];
+		Block& block = pool.blocks[allocation.block];
+		VkDeviceSize offset = allocation.offset;
+		int level = allocation.level;
+		while (level > 0)
+		{
+			VkDeviceSize buddy = offset ^ (pool.blockSize >> level);
+			std::set<VkDeviceSize>::iterator it = block.freeNodes[level].find(buddy);
+			if (it == block.freeNodes[level].end())
+			{
+				break;
+			}
+			block.freeNodes[level].erase(it);
+			offset = std::min(offset, buddy);
+			level--;
+		}
+		block.freeNodes[level].insert(offset);
+		block.allocations--;
+	}
+
+	statistics.allocations--;
+	statistics.usedBytes -= allocation.size;
+	allocation = {};
+	allocation.pool = -1;
+	allocation.block = -1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Gives blocks that have emptied out back to the driver, keeping one per pool so the next
+		allocation doesn't have to wait. Call after unloading a lot of resources, e.g. between scenes
+
+	\return
+		How many bytes were given back
+*/
+/*************************************************************************************************/
+VkDeviceSize MemoryAllocator::Defragment()
+{
+	VkDeviceSize freedBytes = 0;
+	for (Pool& pool : pools)
+	{
+		bool keptOne = false;
+		for (Block& block : pool.blocks)
+		{
+			if (!block.memory || block.allocations > 0)
+			{
+				continue;
+			}
+
+			if (!keptOne)
+			{
+				keptOne = true;
+				continue;
+			}
+
+			// Mapped memory is unmapped when it's freed
+			vkFreeMemory(device, block.memory, NULL);
+			block.memory = VK_NULL_HANDLE;
+			block.mapped = NULL;
+			block.freeNodes.clear();
+
+			statistics.blocks--;
+			statistics.deviceAllocations--;
+			statistics.reservedBytes -= pool.blockSize;
+			freedBytes += pool.blockSize;
+		}
+	}
+
+	if (freedBytes > 0)
+	{
+		_Debug->Print(Debug::MessageType::Debug, "MemoryAllocator: gave back " + std::to_string(freedBytes) + " bytes of empty blocks");
+	}
+	return freedBytes;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Prints the statistics to the debug log
+*/
+/*************************************************************************************************/
+void MemoryAllocator::PrintStatistics()
+{
+	_Debug->Print(Debug::MessageType::Debug, "MemoryAllocator: " + std::to_string(statistics.allocations) + " allocations in "
+		+ std::to_string(statistics.deviceAllocations) + " device allocations (peak " + std::to_string(statistics.peakDeviceAllocations) + ", "
+		+ std::to_string(statistics.blocks) + " blocks, " + std::to_string(statistics.dedicatedAllocations) + " dedicated), "
+		+ std::to_string(statistics.usedBytes) + " of " + std::to_string(statistics.reservedBytes) + " bytes used");
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds a memory type with the given properties
+
+	\param typeFilter
+		The memory types the resource can use, as bits
+
+	\param properties
+		The properties the type must have
+
+	\return
+		The memory type index, or -1 if there isn't one
+*/
+/*************************************************************************************************/
+int MemoryAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+		{
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds the pool for a memory type and resource kind, making it if it doesn't exist
+
+	\param memoryType
+		The memory type index
+
+	\param optimalImages
+		Whether the pool holds optimally tiled images
+
+	\return
+		The index of the pool
+*/
+/*************************************************************************************************/
+int MemoryAllocator::FindPool(uint32_t memoryType, bool optimalImages)
+{
+	for (size_t i = 0; i < pools.size(); i++)
+	{
+		if (pools[i].memoryType == memoryType && pools[i].optimalImages == optimalImages)
+		{
+			return (int)i;
+		}
+	}
+
+	// Keeps a block to at most an eighth of its heap
+	Pool pool;
+	pool.memoryType = memoryType;
+	pool.optimalImages = optimalImages;
+	pool.blockSize = maxBlockSize;
+	VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryType].heapIndex].size;
+	while (pool.blockSize > minBlockSize && pool.blockSize > heapSize / 8)
+	{
+		pool.blockSize /= 2;
+	}
+
+	// One level for every halving down to the smallest piece
+	pool.levels = 1;
+	for (VkDeviceSize size = pool.blockSize; size > minNodeSize; size /= 2)
+	{
+		pool.levels++;
+	}
+
+	pools.push_back(pool);
+	return (int)pools.size() - 1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Takes memory from the driver and maps it if it's host visible
+
+	\param memoryType
+		The memory type index
+
+	\param size
+		How many bytes to take
+
+	\param mapped
+		Set to the mapped memory, or NULL if the type isn't host visible
+
+	\return
+		The device memory
+*/
+/*************************************************************************************************/
+VkDeviceMemory MemoryAllocator::AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, unsigned char*& mapped)
+{
+	VkMemoryAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocInfo.allocationSize = size;
+	allocInfo.memoryTypeIndex = memoryType;
+
+	VkDeviceMemory memory;
+	_Window->CheckVulkanSuccess(vkAllocateMemory(device, &allocInfo, NULL, &memory), "failed to allocate device memory!");
+
+	// Host visible memory stays mapped for as long as it's alive, since it can only be mapped once
+	mapped = NULL;
+	if (memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+	{
+		void* data;
+		_Window->CheckVulkanSuccess(vkMapMemory(device, memory, 0, VK_WHOLE_SIZE, 0, &data), "failed to map device memory!");
+		mapped = (unsigned char*)data;
+	}
+
+	statistics.deviceAllocations++;
+	statistics.peakDeviceAllocations = std::max(statistics.peakDeviceAllocations, statistics.deviceAllocations);
+	statistics.reservedBytes += size;
+	return memory;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Splits a free piece out of a block
+
+	\param pool
+		The pool the block is in
+
+	\param block
+		The block to split
+
+	\param level
+		The level of the piece needed
+
+	\param offset
+		Set to where the piece starts
+
+	\return
+		Whether the block had room
+*/
+/*************************************************************************************************/
+bool MemoryAllocator::AllocateFromBlock(Pool& pool, Block& block, int level, VkDeviceSize& offset)
+{
+	// Finds the smallest free piece that's big enough
+	int found = level;
+	while (found >= 0 && block.freeNodes[found].empty())
+	{
+		found--;
+	}
+	if (found < 0)
+	{
+		return false;
+	}
+
+	// Takes the lowest one so the block fills from the front
+	offset = *block.freeNodes[found].begin();
+	block.freeNodes[found].erase(block.freeNodes[found].begin());
+
+	// Halves it until it's the right size, freeing the back half each time
+	while (found < level)
+	{
+		found++;
+		block.freeNodes[found].insert(offset + (pool.blockSize >> found));
+	}
+
+	block.allocations++;
+	return true;
+}
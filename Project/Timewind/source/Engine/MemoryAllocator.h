@@ -0,0 +1,348 @@
+/*************************************************************************************************/
+/*!
+\file MemoryAllocator.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Carves buffer and image memory out of a few large device allocations instead of giving every
+	resource its own. Each memory type gets blocks that are split with a buddy allocator, and
+	resources too big for a block get memory of their own
+
+    Public Functions:
+        + MemoryAllocator
+		+ ~MemoryAllocator
+		+ Init
+		+ Free
+		+ Allocate
+		+ Release
+		+ Defragment
+		+ GetStatistics
+		+ PrintStatistics
+
+	Private Functions:
+		+ FindMemoryType
+		+ FindPool
+		+ AllocateDeviceMemory
+		+ AllocateFromBlock
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_MemoryAllocator_H_
+#define Syncopatience_MemoryAllocator_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The pools, blocks and free lists
+#include <vector>
+#include <set>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The memory allocator class
+*/
+/*************************************************************************************************/
+class MemoryAllocator
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// A piece of device memory handed out to one buffer or image
+	typedef struct
+	{
+		VkDeviceMemory memory;					// The device memory the piece is in
+		VkDeviceSize offset;					// Where in the memory the piece starts, to bind the resource at
+		VkDeviceSize size;						// How many bytes the piece covers
+		void* mapped;							// The piece's memory mapped for writing, NULL if it isn't host visible
+		int pool;								// The pool the piece came from, -1 if it has memory of its own
+		int block;								// The block in the pool the piece came from
+		int level;								// How many times the block was halved to make the piece
+	}Allocation;
+
+	// How much memory is in use, for sizing blocks and spotting leaks
+	typedef struct
+	{
+		uint32_t deviceAllocations;				// Live vkAllocateMemory calls, which drivers often cap at 4096
+		uint32_t peakDeviceAllocations;			// The most device allocations there have ever been at once
+		uint32_t blocks;						// Blocks that pieces are carved from
+		uint32_t dedicatedAllocations;			// Resources with memory of their own
+		uint32_t allocations;					// Live pieces, dedicated ones included
+		VkDeviceSize reservedBytes;				// Bytes asked for from the driver
+		VkDeviceSize usedBytes;					// Bytes handed out, rounded up to the buddy sizes
+	}Statistics;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the memory allocator class
+	*/
+	/*************************************************************************************************/
+	MemoryAllocator();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the memory allocator class
+	*/
+	/*************************************************************************************************/
+	~MemoryAllocator();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads the card's memory types and limits. No memory is taken until something asks for it
+
+		\param vkDevice
+			The logical device
+
+		\param physicalDevice
+			The graphics card
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Gives every block back to the driver. The device must be idle and every resource destroyed
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds memory for a buffer or image
+
+		\param requirements
+			The resource's memory requirements
+
+		\param required
+			Properties the memory must have
+
+		\param preferred
+			Properties the memory should have if the card has such a type, e.g. device local for
+			host visible data the GPU reads a lot
+
+		\param optimalImage
+			Whether the resource is an optimally tiled image, which can't share a page of
+			bufferImageGranularity with buffers
+
+		\return
+			The memory to bind the resource to
+	*/
+	/*************************************************************************************************/
+	Allocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags required, VkMemoryPropertyFlags preferred = 0, bool optimalImage = false);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Gives memory back. The resource bound to it must already be destroyed
+
+		\param allocation
+			The memory to give back. Cleared afterwards so it can't be released twice
+	*/
+	/*************************************************************************************************/
+	void Release(Allocation& allocation);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Gives blocks that have emptied out back to the driver, keeping one per pool so the next
+			allocation doesn't have to wait. Call after unloading a lot of resources, e.g. between scenes
+
+		\return
+			How many bytes were given back
+	*/
+	/*************************************************************************************************/
+	VkDeviceSize Defragment();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how much memory is in use
+
+		\return
+			The statistics
+	*/
+	/*************************************************************************************************/
+	Statistics GetStatistics() { return statistics; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Prints the statistics to the debug log
+	*/
+	/*************************************************************************************************/
+	void PrintStatistics();
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// One large device allocation split into power of two pieces
+	typedef struct
+	{
+		VkDeviceMemory memory;					// The device memory, VK_NULL_HANDLE once given back
+		unsigned char* mapped;					// The memory mapped for writing, if it's host visible
+		std::vector<std::set<VkDeviceSize>> freeNodes;	// The offsets of free pieces at each level, level 0 being the whole block
+		uint32_t allocations;					// How many pieces are handed out
+	}Block;
+
+	// Every block of one memory type and resource kind
+	typedef struct
+	{
+		uint32_t memoryType;					// The memory type the blocks are
+		bool optimalImages;						// Whether the blocks hold optimally tiled images
+		VkDeviceSize blockSize;					// The size of each block, a power of two
+		int levels;								// How many times a block can be halved, plus one
+		std::vector<Block> blocks;				// The pool's blocks. Given back blocks keep their place so indices stay valid
+	}Pool;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device memory is taken from
+	VkPhysicalDeviceMemoryProperties memoryProperties;	// The card's memory types and heaps
+	VkDeviceSize bufferImageGranularity;		// How far apart buffers and optimal images have to be
+	std::vector<Pool> pools;					// One pool per memory type and resource kind in use
+	Statistics statistics;						// How much memory is in use
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds a memory type with the given properties
+
+		\param typeFilter
+			The memory types the resource can use, as bits
+
+		\param properties
+			The properties the type must have
+
+		\return
+			The memory type index, or -1 if there isn't one
+	*/
+	/*************************************************************************************************/
+	int FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds the pool for a memory type and resource kind, making it if it doesn't exist
+
+		\param memoryType
+			The memory type index
+
+		\param optimalImages
+			Whether the pool holds optimally tiled images
+
+		\return
+			The index of the pool
+	*/
+	/*************************************************************************************************/
+	int FindPool(uint32_t memoryType, bool optimalImages);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Takes memory from the driver and maps it if it's host visible
+
+		\param memoryType
+			The memory type index
+
+		\param size
+			How many bytes to take
+
+		\param mapped
+			Set to the mapped memory, or NULL if the type isn't host visible
+
+		\return
+			The device memory
+	*/
+	/*************************************************************************************************/
+	VkDeviceMemory AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, unsigned char*& mapped);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Splits a free piece out of a block
+
+		\param pool
+			The pool the block is in
+
+		\param block
+			The block to split
+
+		\param level
+			The level of the piece needed
+
+		\param offset
+			Set to where the piece starts
+
+		\return
+			Whether the block had room
+	*/
+	/*************************************************************************************************/
+	bool AllocateFromBlock(Pool& pool, Block& block, int level, VkDeviceSize& offset);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_MemoryAllocator_H_
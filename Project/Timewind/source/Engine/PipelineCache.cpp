@@ -0,0 +1,394 @@
+/*************************************************************************************************/
+/*!
+\file PipelineCache.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Keeps the vulkan pipeline cache on disk between runs so pipelines don't have to be compiled
+	from scratch every launch. The file is checked against the card and driver it was made on
+	and thrown away if it doesn't match or is damaged
+
+    Functions include:
+        + PipelineCache::PipelineCache
+		+ PipelineCache::~PipelineCache
+		+ PipelineCache::Create
+		+ PipelineCache::Save
+		+ PipelineCache::Destroy
+		+ PipelineCache::Load
+		+ PipelineCache::Validate
+		+ PipelineCache::WriteToFile
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "PipelineCache.h"
+#include "cppShortcuts.h"
+
+// Reading and writing the cache file
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+// Swapping the finished file into place
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+const uint32_t fnvOffsetBasis = 2166136261u;	// FNV-1a starting value
+const uint32_t fnvPrime = 16777619u;			// FNV-1a multiplier
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+static uint32_t HashBytes(const uint8_t* data, size_t size);
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the pipeline cache class
+*/
+/*************************************************************************************************/
+PipelineCache::PipelineCache() : device(VK_NULL_HANDLE), properties(), cache(VK_NULL_HANDLE), filename(), warm(false)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the pipeline cache class
+*/
+/*************************************************************************************************/
+PipelineCache::~PipelineCache()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes the vulkan pipeline cache, starting it from the file if the file is valid for
+		this card and driver
+
+	\param vkDevice
+		The logical device
+
+	\param physicalDevice
+		The graphics card, which the file has to match
+
+	\param filename_
+		The file the cache is kept in
+*/
+/*************************************************************************************************/
+void PipelineCache::Create(VkDevice vkDevice, VkPhysicalDevice physicalDevice, const std::string& filename_)
+{
+	device = vkDevice;
+	filename = filename_;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+	// Only hands the driver data that was made by this card and driver and arrived intact,
+	// since some drivers crash on bad cache data instead of ignoring it
+	std::vector<uint8_t> fileData;
+	std::string reason;
+	warm = Load(fileData) && Validate(fileData, reason);
+	if (!warm && !fileData.empty())
+	{
+		_Debug->Print(Debug::MessageType::Debug, "PipelineCache: Discarding " + filename + ", " + reason);
+		std::remove(filename.c_str());
+	}
+
+	VkPipelineCacheCreateInfo createInfo{};
+	createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	if (warm)
+	{
+		createInfo.initialDataSize = fileData.size() - sizeof(Header);
+		createInfo.pInitialData = fileData.data() + sizeof(Header);
+	}
+
+	// Falls back to an empty cache if the driver still won't take the data
+	if (vkCreatePipelineCache(device, &createInfo, NULL, &cache) != VK_SUCCESS)
+	{
+		if (!warm)
+		{
+			throw std::runtime_error("failed to create pipeline cache");
+		}
+
+		_Debug->Print(Debug::MessageType::Debug, "PipelineCache: The driver rejected " + filename + ", starting empty");
+		warm = false;
+		createInfo.initialDataSize = 0;
+		createInfo.pInitialData = NULL;
+		if (vkCreatePipelineCache(device, &createInfo, NULL, &cache) != VK_SUCCESS)
+		{
+			throw std::runtime_error("failed to create pipeline cache");
+		}
+	}
+
+	if (warm)
+	{
+		_Debug->Print(Debug::MessageType::Debug, "PipelineCache: Loaded " + std::to_string(fileData.size() - sizeof(Header)) + " bytes from " + filename);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Writes the cache to its file. Writes a temporary file first then renames it over
+		the old one so a half written cache is never left behind
+
+	\return
+		Whether the file was written
+*/
+/*************************************************************************************************/
+bool PipelineCache::Save()
+{
+	if (!cache)
+	{
+		return false;
+	}
+
+	// Asks for the size first, then the data
+	size_t dataSize = 0;
+	if (vkGetPipelineCacheData(device, cache, &dataSize, NULL) != VK_SUCCESS || dataSize == 0)
+	{
+		return false;
+	}
+	std::vector<uint8_t> cacheData(dataSize);
+	if (vkGetPipelineCacheData(device, cache, &dataSize, cacheData.data()) != VK_SUCCESS)
+	{
+		return false;
+	}
+	cacheData.resize(dataSize);
+
+	if (!WriteToFile(cacheData))
+	{
+		_Debug->Print(Debug::MessageType::Error, "PipelineCache: Failed to write " + filename);
+		return false;
+	}
+
+	_Debug->Print(Debug::MessageType::Debug, "PipelineCache: Saved " + std::to_string(dataSize) + " bytes to " + filename);
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys the vulkan pipeline cache
+*/
+/*************************************************************************************************/
+void PipelineCache::Destroy()
+{
+	vkDestroyPipelineCache(device, cache, NULL);
+	cache = VK_NULL_HANDLE;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads the cache file
+
+	\param fileData
+		Set to the whole file
+
+	\return
+		Whether the file could be read
+*/
+/*************************************************************************************************/
+bool PipelineCache::Load(std::vector<uint8_t>& fileData)
+{
+	// No file just means this is the first run on this machine
+	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+	if (!file)
+	{
+		return false;
+	}
+
+	std::streamoff fileSize = file.tellg();
+	if (fileSize <= 0)
+	{
+		return false;
+	}
+	fileData.resize((size_t)fileSize);
+	file.seekg(0);
+	file.read((char*)fileData.data(), fileSize);
+
+	return (bool)file;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks that the file was written for this card and driver and isn't damaged
+
+	\param fileData
+		The whole file
+
+	\param reason
+		Set to why the file was rejected
+
+	\return
+		Whether the file can be given to the driver
+*/
+/*************************************************************************************************/
+bool PipelineCache::Validate(const std::vector<uint8_t>& fileData, std::string& reason)
+{
+	// Checks our own header
+	if (fileData.size() < sizeof(Header))
+	{
+		reason = "file is too small for a header";
+		return false;
+	}
+	Header header;
+	memcpy(&header, fileData.data(), sizeof(Header));
+	if (header.magic != magic || header.version != version || header.headerSize != sizeof(Header))
+	{
+		reason = "not a pipeline cache or an older version";
+		return false;
+	}
+	if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID || header.driverVersion != properties.driverVersion
+		|| memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		reason = "made on a different card or driver";
+		return false;
+	}
+	if (header.dataSize != fileData.size() - sizeof(Header))
+	{
+		reason = "file is truncated";
+		return false;
+	}
+	const uint8_t* cacheData = fileData.data() + sizeof(Header);
+	if (HashBytes(cacheData, header.dataSize) != header.checksum)
+	{
+		reason = "checksum doesn't match";
+		return false;
+	}
+
+	// Checks the header vulkan puts at the start of its own data, in case the driver wrote
+	// something it wouldn't accept back. The spec lays it out as four 4 byte fields then the uuid
+	uint32_t vulkanHeader[4];
+	if (header.dataSize < sizeof(vulkanHeader) + VK_UUID_SIZE)
+	{
+		reason = "cache data is too small";
+		return false;
+	}
+	memcpy(vulkanHeader, cacheData, sizeof(vulkanHeader));
+	if (vulkanHeader[0] < sizeof(vulkanHeader) + VK_UUID_SIZE || vulkanHeader[1] != VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		|| vulkanHeader[2] != properties.vendorID || vulkanHeader[3] != properties.deviceID
+		|| memcmp(cacheData + sizeof(vulkanHeader), properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		reason = "cache data header doesn't match this card";
+		return false;
+	}
+
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Writes the header and cache data to a temporary file and swaps it into place
+
+	\param cacheData
+		The vulkan cache data
+
+	\return
+		Whether the file was written
+*/
+/*************************************************************************************************/
+bool PipelineCache::WriteToFile(const std::vector<uint8_t>& cacheData)
+{
+	Header header{};
+	header.magic = magic;
+	header.version = version;
+	header.headerSize = sizeof(Header);
+	header.vendorID = properties.vendorID;
+	header.deviceID = properties.deviceID;
+	header.driverVersion = properties.driverVersion;
+	memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+	header.dataSize = (uint32_t)cacheData.size();
+	header.checksum = HashBytes(cacheData.data(), cacheData.size());
+
+	// Writes everything to a temporary file
+	std::string tempFilename = filename + ".tmp";
+	{
+		std::ofstream outputFile(tempFilename, std::ios::binary | std::ios::trunc);
+		if (!outputFile)
+		{
+			return false;
+		}
+		outputFile.write((const char*)&header, sizeof(Header));
+		outputFile.write((const char*)cacheData.data(), cacheData.size());
+		if (!outputFile)
+		{
+			return false;
+		}
+	}
+
+	// Swaps the finished file into place
+#ifdef _WIN32
+	return MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(tempFilename.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Hashes the given bytes with FNV-1a
+
+	\param data
+		The bytes to hash
+
+	\param size
+		The number of bytes
+
+	\return
+		The hash
+*/
+/*************************************************************************************************/
+static uint32_t HashBytes(const uint8_t* data, size_t size)
+{
+	uint32_t hash = fnvOffsetBasis;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= fnvPrime;
+	}
+	return hash;
+}
@@ -0,0 +1,258 @@
+/*************************************************************************************************/
+/*!
+\file PipelineCache.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Keeps the vulkan pipeline cache on disk between runs so pipelines don't have to be compiled
+	from scratch every launch. The file is checked against the card and driver it was made on
+	and thrown away if it doesn't match or is damaged
+
+    Public Functions:
+        + PipelineCache
+		+ ~PipelineCache
+		+ Create
+		+ Save
+		+ Destroy
+		+ GetCache
+		+ IsWarm
+
+	Private Functions:
+		+ Load
+		+ Validate
+		+ WriteToFile
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_PipelineCache_H_
+#define Syncopatience_PipelineCache_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The file name and contents
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The pipeline cache class
+*/
+/*************************************************************************************************/
+class PipelineCache
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	static const uint32_t magic = 0x43505754;	// "TWPC" when read as bytes on little endian
+	static const uint32_t version = 1;			// Bumped whenever the header below changes
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// The header at the start of the cache file. Every field is 4 bytes or a multiple so there is no padding
+	typedef struct
+	{
+		uint32_t magic;							// Identifies the file as a pipeline cache
+		uint32_t version;						// The header version the file was written with
+		uint32_t headerSize;					// Size of this header in bytes
+		uint32_t vendorID;						// The vendor of the card the cache was made on
+		uint32_t deviceID;						// The card the cache was made on
+		uint32_t driverVersion;					// The driver the cache was made with
+		uint8_t pipelineCacheUUID[VK_UUID_SIZE];	// The driver's id for caches it can read
+		uint32_t dataSize;						// Size of the vulkan cache data after the header
+		uint32_t checksum;						// FNV-1a hash of the vulkan cache data
+	}Header;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the pipeline cache class
+	*/
+	/*************************************************************************************************/
+	PipelineCache();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the pipeline cache class
+	*/
+	/*************************************************************************************************/
+	~PipelineCache();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes the vulkan pipeline cache, starting it from the file if the file is valid for
+			this card and driver
+
+		\param vkDevice
+			The logical device
+
+		\param physicalDevice
+			The graphics card, which the file has to match
+
+		\param filename_
+			The file the cache is kept in
+	*/
+	/*************************************************************************************************/
+	void Create(VkDevice vkDevice, VkPhysicalDevice physicalDevice, const std::string& filename_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes the cache to its file. Writes a temporary file first then renames it over
+			the old one so a half written cache is never left behind
+
+		\return
+			Whether the file was written
+	*/
+	/*************************************************************************************************/
+	bool Save();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys the vulkan pipeline cache
+	*/
+	/*************************************************************************************************/
+	void Destroy();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the vulkan pipeline cache to make pipelines with
+
+		\return
+			The pipeline cache
+	*/
+	/*************************************************************************************************/
+	VkPipelineCache GetCache() { return cache; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns whether the cache was started from a valid file
+
+		\return
+			Whether the cache is warm
+	*/
+	/*************************************************************************************************/
+	bool IsWarm() { return warm; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device the cache belongs to
+	VkPhysicalDeviceProperties properties;		// The card's ids, which the file has to match
+	VkPipelineCache cache;						// The vulkan pipeline cache
+	std::string filename;						// The file the cache is kept in
+	bool warm;									// Whether the cache was started from the file
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads the cache file
+
+		\param fileData
+			Set to the whole file
+
+		\return
+			Whether the file could be read
+	*/
+	/*************************************************************************************************/
+	bool Load(std::vector<uint8_t>& fileData);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks that the file was written for this card and driver and isn't damaged
+
+		\param fileData
+			The whole file
+
+		\param reason
+			Set to why the file was rejected
+
+		\return
+			Whether the file can be given to the driver
+	*/
+	/*************************************************************************************************/
+	bool Validate(const std::vector<uint8_t>& fileData, std::string& reason);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes the header and cache data to a temporary file and swaps it into place
+
+		\param cacheData
+			The vulkan cache data
+
+		\return
+			Whether the file was written
+	*/
+	/*************************************************************************************************/
+	bool WriteToFile(const std::vector<uint8_t>& cacheData);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_PipelineCache_H_
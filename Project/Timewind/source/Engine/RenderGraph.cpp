@@ -0,0 +1,725 @@
+/*************************************************************************************************/
+/*!
+\file RenderGraph.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Runs the frame's render passes from a list of what each one reads and writes. The graph
+	drops passes nothing uses, works out every layout transition and barrier between them, and
+	owns the targets, letting targets that are never alive at the same time share memory
+
+    Functions include:
+        + RenderGraph::RenderGraph
+		+ RenderGraph::~RenderGraph
+		+ RenderGraph::Init
+		+ RenderGraph::AddTarget
+		+ RenderGraph::Import
+		+ RenderGraph::AddPass
+		+ RenderGraph::SetImportedImages
+		+ RenderGraph::Compile
+		+ RenderGraph::Execute
+		+ RenderGraph::Release
+		+ RenderGraph::Free
+		+ RenderGraph::GetImageView
+		+ RenderGraph::GetExtent
+		+ RenderGraph::RecordBarriers
+		+ RenderGraph::FindFinalState
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "RenderGraph.h"
+#include "cppShortcuts.h"
+
+// The passes' vulkan render passes
+#include "RenderPass.h"
+
+// Checking vulkan results and making the targets
+#include "Window.h"
+
+// Ordering targets by when they're first used
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the render graph class
+*/
+/*************************************************************************************************/
+RenderGraph::RenderGraph() : device(VK_NULL_HANDLE), sampler(VK_NULL_HANDLE), extent(), resources(), passes(), compiledPasses(), finalBarriers(), memorySlots(), stats()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the render graph class
+*/
+/*************************************************************************************************/
+RenderGraph::~RenderGraph()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets up the graph and the sampler its targets are read with
+
+	\param vkDevice
+		The logical device
+*/
+/*************************************************************************************************/
+void RenderGraph::Init(VkDevice vkDevice)
+{
+	device = vkDevice;
+
+	// Passes sampling smaller targets between texels rely on the linear filter
+	VkSamplerCreateInfo samplerInfo{};
+	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerInfo.magFilter = VK_FILTER_LINEAR;
+	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+	samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+	_Window->CheckVulkanSuccess(vkCreateSampler(device, &samplerInfo, NULL, &sampler), "failed to create render graph sampler!");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Declares a target the graph makes and owns. It only exists while passes use it, so its
+		memory can be shared with other targets
+
+	\param name
+		The target's name, for messages
+
+	\param format
+		The target's format
+
+	\param size
+		The target's size. Defaults to zero, which makes it the size of the screen
+
+	\return
+		The target
+*/
+/*************************************************************************************************/
+RenderGraph::Resource RenderGraph::AddTarget(const std::string& name, VkFormat format, VkExtent2D size)
+{
+	ResourceInfo resource{};
+	resource.name = name;
+	resource.format = format;
+	resource.imported = false;
+	resource.finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	resource.size = size;
+	resource.storage = false;
+	resource.firstUse = -1;
+	resource.lastUse = -1;
+	resource.memorySlot = -1;
+	resources.push_back(resource);
+
+	return (Resource)resources.size() - 1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Declares images made outside the graph, like the swap chain. Passes writing an
+		imported image are never culled
+
+	\param name
+		The image's name, for messages
+
+	\param format
+		The image's format
+
+	\param finalLayout
+		The layout the image is left in at the end of the frame
+
+	\return
+		The imported image
+*/
+/*************************************************************************************************/
+RenderGraph::Resource RenderGraph::Import(const std::string& name, VkFormat format, VkImageLayout finalLayout)
+{
+	Resource resource = AddTarget(name, format);
+	resources[resource].imported = true;
+	resources[resource].finalLayout = finalLayout;
+
+	return resource;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Adds a pass. Passes run in the order they're added
+
+	\param pass
+		The pass's render pass, resources and recording function
+*/
+/*************************************************************************************************/
+void RenderGraph::AddPass(const PassInfo& pass)
+{
+	if (!pass.compute && pass.clearValues.size() != pass.writes.size())
+	{
+		throw std::runtime_error("RenderGraph: " + pass.name + " needs a clear value for each resource it writes");
+	}
+
+	passes.push_back(pass);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Gives an imported resource its images. Execute picks one with the image index
+
+	\param resource
+		The imported resource
+
+	\param images
+		The images
+
+	\param imageViews
+		A view of each image. Still owned by the caller
+*/
+/*************************************************************************************************/
+void RenderGraph::SetImportedImages(Resource resource, const std::vector<VkImage>& images, const std::vector<VkImageView>& imageViews)
+{
+	resources[resource].images = images;
+	resources[resource].imageViews = imageViews;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Culls unused passes, works out every barrier, and makes the targets and framebuffers.
+		Call again with Release first whenever the size or the imported images change
+
+	\param extent_
+		The size of the screen, which targets without a size of their own follow
+*/
+/*************************************************************************************************/
+void RenderGraph::Compile(VkExtent2D extent_)
+{
+	extent = extent_;
+	stats = {};
+
+	// Walks backwards from the imported images. A pass is kept if something later reads what it
+	// writes before another pass clears it
+	std::vector<bool> needed(passes.size(), false);
+	std::vector<bool> readLater(resources.size(), false);
+	for (int i = (int)passes.size() - 1; i >= 0; i--)
+	{
+		for (Resource write : passes[i].writes)
+		{
+			if (resources[write].imported || readLater[write])
+			{
+				needed[i] = true;
+			}
+		}
+
+		if (!needed[i])
+		{
+			stats.culledPassCount++;
+			_Debug->Print(Debug::MessageType::Debug, "RenderGraph: Culled " + passes[i].name + ", nothing reads what it writes");
+			continue;
+		}
+
+		for (Resource write : passes[i].writes)
+		{
+			readLater[write] = false;
+		}
+		for (Resource read : passes[i].reads)
+		{
+			readLater[read] = true;
+		}
+	}
+
+	// Every resource starts the frame with nothing worth keeping, but the last frame, or a target
+	// that shared its memory, may still be drawing to it or reading it
+	UseState startState = { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+		VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+	UseState readState = { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+	UseState writeState = { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT };
+	UseState computeReadState = { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+	UseState computeWriteState = { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT };
+	std::vector<UseState> states(resources.size(), startState);
+	std::vector<bool> written(resources.size(), false);
+
+	// Steps through the kept passes, moving each resource into the layout the pass needs
+	for (ResourceInfo& resource : resources)
+	{
+		resource.firstUse = -1;
+		resource.lastUse = -1;
+		resource.memorySlot = -1;
+		resource.storage = false;
+	}
+	compiledPasses.clear();
+	for (size_t i = 0; i < passes.size(); i++)
+	{
+		if (!needed[i])
+		{
+			continue;
+		}
+
+		CompiledPass compiled{};
+		compiled.pass = (int)i;
+		int passIndex = (int)compiledPasses.size();
+		const UseState& passReadState = passes[i].compute ? computeReadState : readState;
+		const UseState& passWriteState = passes[i].compute ? computeWriteState : writeState;
+
+		for (Resource read : passes[i].reads)
+		{
+			if (!written[read])
+			{
+				throw std::runtime_error("RenderGraph: " + passes[i].name + " reads " + resources[read].name + " before any pass writes it");
+			}
+
+			// Passes reading the same thing one after another only need the first transition
+			if (states[read].layout != passReadState.layout || (states[read].stage & passReadState.stage) == 0)
+			{
+				compiled.barriers.push_back({ read, states[read], passReadState });
+				states[read] = passReadState;
+			}
+			resources[read].lastUse = passIndex;
+		}
+
+		compiled.extent = passes[i].writes.empty() ? extent : GetExtent(passes[i].writes[0]);
+		for (Resource write : passes[i].writes)
+		{
+			VkExtent2D writeExtent = GetExtent(write);
+			if (writeExtent.width != compiled.extent.width || writeExtent.height != compiled.extent.height)
+			{
+				throw std::runtime_error("RenderGraph: " + passes[i].name + " writes " + resources[write].name + ", which isn't the same size as its other writes");
+			}
+
+			// Always waits, since even a pass writing after a pass that wrote has to go second
+			compiled.barriers.push_back({ write, states[write], passWriteState });
+			states[write] = passWriteState;
+			written[write] = true;
+			if (passes[i].compute)
+			{
+				resources[write].storage = true;
+			}
+
+			if (resources[write].firstUse == -1)
+			{
+				resources[write].firstUse = passIndex;
+			}
+			resources[write].lastUse = passIndex;
+		}
+
+		compiledPasses.push_back(compiled);
+	}
+	stats.passCount = (int)compiledPasses.size();
+
+	// Leaves the imported images ready for whatever happens after the frame
+	finalBarriers.clear();
+	for (size_t i = 0; i < resources.size(); i++)
+	{
+		if (resources[i].imported && written[i])
+		{
+			finalBarriers.push_back({ (Resource)i, states[i], FindFinalState(resources[i].finalLayout) });
+		}
+	}
+
+	// Makes an image for each target a kept pass uses
+	std::vector<VkMemoryRequirements> requirements(resources.size());
+	std::vector<Resource> targets;
+	for (size_t i = 0; i < resources.size(); i++)
+	{
+		ResourceInfo& resource = resources[i];
+		if (resource.imported)
+		{
+			if (resource.firstUse != -1 && resource.images.empty())
+			{
+				throw std::runtime_error("RenderGraph: " + resource.name + " was never given its images");
+			}
+			continue;
+		}
+		if (resource.firstUse == -1)
+		{
+			continue;
+		}
+
+		VkExtent2D targetExtent = GetExtent((Resource)i);
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent = { targetExtent.width, targetExtent.height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = resource.format;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (resource.storage ? VK_IMAGE_USAGE_STORAGE_BIT : 0);
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		VkImage image;
+		_Window->CheckVulkanSuccess(vkCreateImage(device, &imageInfo, NULL, &image), "failed to create render graph target!");
+		resource.images.push_back(image);
+		vkGetImageMemoryRequirements(device, image, &requirements[i]);
+
+		targets.push_back((Resource)i);
+		stats.targetCount++;
+		stats.unaliasedBytes += requirements[i].size;
+	}
+
+	// Hands out memory in the order targets are first used. A target takes the first slot whose
+	// targets are all finished with by then, since its first write throws away what was there
+	std::stable_sort(targets.begin(), targets.end(), [this](Resource a, Resource b) { return resources[a].firstUse < resources[b].firstUse; });
+	for (Resource target : targets)
+	{
+		ResourceInfo& resource = resources[target];
+		const VkMemoryRequirements& targetRequirements = requirements[target];
+		for (size_t slot = 0; slot < memorySlots.size(); slot++)
+		{
+			MemorySlot& memorySlot = memorySlots[slot];
+			if (memorySlot.lastUse < resource.firstUse && (memorySlot.requirements.memoryTypeBits & targetRequirements.memoryTypeBits) != 0)
+			{
+				memorySlot.requirements.size = std::max(memorySlot.requirements.size, targetRequirements.size);
+				memorySlot.requirements.alignment = std::max(memorySlot.requirements.alignment, targetRequirements.alignment);
+				memorySlot.requirements.memoryTypeBits &= targetRequirements.memoryTypeBits;
+				memorySlot.lastUse = resource.lastUse;
+				resource.memorySlot = (int)slot;
+				break;
+			}
+		}
+
+		if (resource.memorySlot == -1)
+		{
+			MemorySlot memorySlot{};
+			memorySlot.requirements = targetRequirements;
+			memorySlot.lastUse = resource.lastUse;
+			memorySlots.push_back(memorySlot);
+			resource.memorySlot = (int)memorySlots.size() - 1;
+		}
+	}
+
+	for (MemorySlot& memorySlot : memorySlots)
+	{
+		memorySlot.memory = _Window->GetMemoryAllocator()->Allocate(memorySlot.requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, true);
+		stats.allocatedBytes += memorySlot.requirements.size;
+	}
+	stats.allocationCount = (int)memorySlots.size();
+
+	for (Resource target : targets)
+	{
+		ResourceInfo& resource = resources[target];
+		MemoryAllocator::Allocation& memory = memorySlots[resource.memorySlot].memory;
+		_Window->CheckVulkanSuccess(vkBindImageMemory(device, resource.images[0], memory.memory, memory.offset), "failed to bind render graph target memory!");
+		resource.imageViews.push_back(_Window->CreateImageView(resource.images[0], resource.format));
+	}
+
+	// Passes drawing to an imported image need a framebuffer for each of its images. Compute
+	// passes write their targets as storage images and need none
+	for (CompiledPass& compiled : compiledPasses)
+	{
+		PassInfo& pass = passes[compiled.pass];
+		if (pass.compute)
+		{
+			continue;
+		}
+
+		size_t framebufferCount = 1;
+		for (Resource write : pass.writes)
+		{
+			if (resources[write].imported)
+			{
+				framebufferCount = resources[write].images.size();
+			}
+		}
+
+		compiled.framebuffers.resize(framebufferCount);
+		for (size_t i = 0; i < framebufferCount; i++)
+		{
+			std::vector<VkImageView> attachments;
+			for (Resource write : pass.writes)
+			{
+				attachments.push_back(resources[write].imageViews[resources[write].imported ? i : 0]);
+			}
+
+			VkFramebufferCreateInfo framebufferInfo{};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = pass.renderPass->GetRenderPass();
+			framebufferInfo.attachmentCount = (uint32_t)attachments.size();
+			framebufferInfo.pAttachments = attachments.data();
+			framebufferInfo.width = compiled.extent.width;
+			framebufferInfo.height = compiled.extent.height;
+			framebufferInfo.layers = 1;
+			_Window->CheckVulkanSuccess(vkCreateFramebuffer(device, &framebufferInfo, NULL, &compiled.framebuffers[i]), "failed to create render graph framebuffer!");
+		}
+	}
+
+	_Debug->Print(Debug::MessageType::Debug, "RenderGraph: Compiled " + std::to_string(stats.passCount) + " passes, " + std::to_string(stats.targetCount) + " targets in "
+		+ std::to_string(stats.allocationCount) + " allocations");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Records every pass and the barriers between them
+
+	\param commandBuffer
+		The frame's primary command buffer
+
+	\param imageIndex
+		Which of the imported images to draw to
+*/
+/*************************************************************************************************/
+void RenderGraph::Execute(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+{
+	for (CompiledPass& compiled : compiledPasses)
+	{
+		PassInfo& pass = passes[compiled.pass];
+		RecordBarriers(commandBuffer, compiled.barriers, imageIndex);
+
+		if (pass.compute)
+		{
+			pass.record(commandBuffer, VK_NULL_HANDLE);
+			continue;
+		}
+
+		VkFramebuffer framebuffer = compiled.framebuffers[compiled.framebuffers.size() > 1 ? imageIndex : 0];
+
+		VkRenderPassBeginInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = pass.renderPass->GetRenderPass();
+		renderPassInfo.framebuffer = framebuffer;
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = compiled.extent;
+		if (pass.renderArea != NULL)
+		{
+			renderPassInfo.renderArea.extent.width = std::min(pass.renderArea->width, compiled.extent.width);
+			renderPassInfo.renderArea.extent.height = std::min(pass.renderArea->height, compiled.extent.height);
+		}
+		renderPassInfo.clearValueCount = (uint32_t)pass.clearValues.size();
+		renderPassInfo.pClearValues = pass.clearValues.data();
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, pass.contents);
+		pass.record(commandBuffer, framebuffer);
+		vkCmdEndRenderPass(commandBuffer);
+	}
+
+	RecordBarriers(commandBuffer, finalBarriers, imageIndex);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys the targets and framebuffers but keeps the passes. The device must be idle
+*/
+/*************************************************************************************************/
+void RenderGraph::Release()
+{
+	for (CompiledPass& compiled : compiledPasses)
+	{
+		for (VkFramebuffer framebuffer : compiled.framebuffers)
+		{
+			vkDestroyFramebuffer(device, framebuffer, NULL);
+		}
+	}
+	compiledPasses.clear();
+	finalBarriers.clear();
+
+	// Imported images belong to whoever gave them
+	for (ResourceInfo& resource : resources)
+	{
+		if (!resource.imported)
+		{
+			for (VkImageView imageView : resource.imageViews)
+			{
+				vkDestroyImageView(device, imageView, NULL);
+			}
+			for (VkImage image : resource.images)
+			{
+				vkDestroyImage(device, image, NULL);
+			}
+		}
+		resource.images.clear();
+		resource.imageViews.clear();
+	}
+
+	for (MemorySlot& memorySlot : memorySlots)
+	{
+		_Window->GetMemoryAllocator()->Release(memorySlot.memory);
+	}
+	memorySlots.clear();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys everything, including the sampler. The device must be idle
+*/
+/*************************************************************************************************/
+void RenderGraph::Free()
+{
+	Release();
+	passes.clear();
+	resources.clear();
+
+	vkDestroySampler(device, sampler, NULL);
+	sampler = VK_NULL_HANDLE;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the view of a target, for reading it in a descriptor set
+
+	\param resource
+		The target
+
+	\return
+		The target's view, or VK_NULL_HANDLE if no pass uses it
+*/
+/*************************************************************************************************/
+VkImageView RenderGraph::GetImageView(Resource resource)
+{
+	if (resources[resource].imageViews.empty())
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return resources[resource].imageViews[0];
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the size of a resource, which is also the size of the passes writing it
+
+	\param resource
+		The resource
+
+	\return
+		The resource's own size, or the graph's for screen sized targets and imported images
+*/
+/*************************************************************************************************/
+VkExtent2D RenderGraph::GetExtent(Resource resource)
+{
+	const ResourceInfo& info = resources[resource];
+	if (info.imported || info.size.width == 0 || info.size.height == 0)
+	{
+		return extent;
+	}
+
+	return info.size;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Records a set of transitions as a single pipeline barrier
+
+	\param commandBuffer
+		The frame's primary command buffer
+
+	\param barriers
+		The transitions
+
+	\param imageIndex
+		Which of the imported images is being drawn to
+*/
+/*************************************************************************************************/
+void RenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers, uint32_t imageIndex)
+{
+	if (barriers.empty())
+	{
+		return;
+	}
+
+	VkPipelineStageFlags srcStages = 0;
+	VkPipelineStageFlags dstStages = 0;
+	std::vector<VkImageMemoryBarrier> imageBarriers(barriers.size());
+	for (size_t i = 0; i < barriers.size(); i++)
+	{
+		const Barrier& barrier = barriers[i];
+		const ResourceInfo& resource = resources[barrier.resource];
+
+		VkImageMemoryBarrier& imageBarrier = imageBarriers[i];
+		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageBarrier.srcAccessMask = barrier.from.access;
+		imageBarrier.dstAccessMask = barrier.to.access;
+		imageBarrier.oldLayout = barrier.from.layout;
+		imageBarrier.newLayout = barrier.to.layout;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.image = resource.images[resource.imported ? imageIndex : 0];
+		imageBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		imageBarrier.subresourceRange.levelCount = 1;
+		imageBarrier.subresourceRange.layerCount = 1;
+
+		srcStages |= barrier.from.stage;
+		dstStages |= barrier.to.stage;
+	}
+
+	vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 0, NULL, 0, NULL, (uint32_t)imageBarriers.size(), imageBarriers.data());
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Works out what waits on an imported image once it's in its final layout
+
+	\param layout
+		The final layout
+
+	\return
+		The stage and access that use the image next
+*/
+/*************************************************************************************************/
+RenderGraph::UseState RenderGraph::FindFinalState(VkImageLayout layout)
+{
+	switch (layout)
+	{
+	case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+		return { layout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT };
+	case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+		return { layout, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT };
+	default:
+		// Presenting waits on the frame's semaphore, which already makes every write visible
+		return { layout, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0 };
+	}
+}
@@ -0,0 +1,438 @@
+/*************************************************************************************************/
+/*!
+\file RenderGraph.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Runs the frame's render passes from a list of what each one reads and writes. The graph
+	drops passes nothing uses, works out every layout transition and barrier between them, and
+	owns the targets, letting targets that are never alive at the same time share memory
+
+    Public Functions:
+        + RenderGraph
+		+ ~RenderGraph
+		+ Init
+		+ AddTarget
+		+ Import
+		+ AddPass
+		+ SetImportedImages
+		+ Compile
+		+ Execute
+		+ Release
+		+ Free
+		+ GetImageView
+		+ GetSampler
+		+ GetExtent
+		+ GetStats
+
+	Private Functions:
+		+ RecordBarriers
+		+ FindFinalState
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_RenderGraph_H_
+#define Syncopatience_RenderGraph_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The targets' memory
+#include "MemoryAllocator.h"
+
+// The passes and what they touch
+#include <vector>
+#include <string>
+#include <functional>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+// Dependency Reference
+class RenderPass;
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The render graph class
+*/
+/*************************************************************************************************/
+class RenderGraph
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// A target or imported image, as handed out by AddTarget and Import
+	typedef int Resource;
+
+	// Records a pass's draws. Called between the graph beginning and ending the pass
+	typedef std::function<void(VkCommandBuffer commandBuffer, VkFramebuffer framebuffer)> RecordFunction;
+
+	// Everything the graph needs to know about a pass
+	typedef struct
+	{
+		std::string name;						// Shown when the pass is culled or misused
+		RenderPass* renderPass;					// Its vulkan render pass must have one attachment per write
+		std::vector<Resource> reads;			// Resources the pass samples in its fragment or compute shader
+		std::vector<Resource> writes;			// Resources the pass draws to, in attachment order. All must be the same size
+		std::vector<VkClearValue> clearValues;	// What each write is cleared to. Not used by compute passes
+		VkSubpassContents contents;				// Whether the pass records inline or with secondary command buffers
+		bool compute;							// Dispatches a compute shader instead of beginning the render pass. Its writes are storage images
+		const VkExtent2D* renderArea;			// Read every frame to keep the pass to the top left of its writes, NULL to use all of them
+		RecordFunction record;					// Records the pass's draws, or its dispatches with no framebuffer
+	}PassInfo;
+
+	// What the compiled graph does each frame
+	typedef struct
+	{
+		int passCount;							// Passes run each frame
+		int culledPassCount;					// Passes dropped because nothing uses what they write
+		int targetCount;						// Targets that got an image
+		int allocationCount;					// Memory allocations the targets share
+		VkDeviceSize allocatedBytes;			// Memory the targets use
+		VkDeviceSize unaliasedBytes;			// Memory the targets would use without sharing
+	}Stats;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the render graph class
+	*/
+	/*************************************************************************************************/
+	RenderGraph();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the render graph class
+	*/
+	/*************************************************************************************************/
+	~RenderGraph();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets up the graph and the sampler its targets are read with
+
+		\param vkDevice
+			The logical device
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Declares a target the graph makes and owns. It only exists while passes use it, so its
+			memory can be shared with other targets
+
+		\param name
+			The target's name, for messages
+
+		\param format
+			The target's format
+
+		\param size
+			The target's size. Defaults to zero, which makes it the size of the screen
+
+		\return
+			The target
+	*/
+	/*************************************************************************************************/
+	Resource AddTarget(const std::string& name, VkFormat format, VkExtent2D size = { 0, 0 });
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Declares images made outside the graph, like the swap chain. Passes writing an
+			imported image are never culled
+
+		\param name
+			The image's name, for messages
+
+		\param format
+			The image's format
+
+		\param finalLayout
+			The layout the image is left in at the end of the frame
+
+		\return
+			The imported image
+	*/
+	/*************************************************************************************************/
+	Resource Import(const std::string& name, VkFormat format, VkImageLayout finalLayout);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Adds a pass. Passes run in the order they're added
+
+		\param pass
+			The pass's render pass, resources and recording function
+	*/
+	/*************************************************************************************************/
+	void AddPass(const PassInfo& pass);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Gives an imported resource its images. Execute picks one with the image index
+
+		\param resource
+			The imported resource
+
+		\param images
+			The images
+
+		\param imageViews
+			A view of each image. Still owned by the caller
+	*/
+	/*************************************************************************************************/
+	void SetImportedImages(Resource resource, const std::vector<VkImage>& images, const std::vector<VkImageView>& imageViews);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Culls unused passes, works out every barrier, and makes the targets and framebuffers.
+			Call again with Release first whenever the size or the imported images change
+
+		\param extent_
+			The size of the targets and of every pass
+	*/
+	/*************************************************************************************************/
+	void Compile(VkExtent2D extent_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Records every pass and the barriers between them
+
+		\param commandBuffer
+			The frame's primary command buffer
+
+		\param imageIndex
+			Which of the imported images to draw to
+	*/
+	/*************************************************************************************************/
+	void Execute(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys the targets and framebuffers but keeps the passes. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Release();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys everything, including the sampler. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the view of a target, for reading it in a descriptor set
+
+		\param resource
+			The target
+
+		\return
+			The target's view, or VK_NULL_HANDLE if no pass uses it
+	*/
+	/*************************************************************************************************/
+	VkImageView GetImageView(Resource resource);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the sampler targets are read with
+
+		\return
+			The sampler
+	*/
+	/*************************************************************************************************/
+	VkSampler GetSampler() { return sampler; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the size of a resource, which is also the size of the passes writing it
+
+		\param resource
+			The resource
+
+		\return
+			The resource's own size, or the graph's for screen sized targets and imported images
+	*/
+	/*************************************************************************************************/
+	VkExtent2D GetExtent(Resource resource);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what the compiled graph does each frame
+
+		\return
+			The pass counts and target memory
+	*/
+	/*************************************************************************************************/
+	const Stats& GetStats() { return stats; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// Where a resource was last used, which the next barrier has to wait on
+	typedef struct
+	{
+		VkImageLayout layout;					// The layout the resource is in
+		VkPipelineStageFlags stage;				// The stages that last used it
+		VkAccessFlags access;					// The writes that need to be made visible
+	}UseState;
+
+	// A target or imported image
+	typedef struct
+	{
+		std::string name;						// The resource's name, for messages
+		VkFormat format;						// The resource's format
+		bool imported;							// Whether the images come from outside the graph
+		VkImageLayout finalLayout;				// The layout imported images are left in
+		VkExtent2D size;						// The target's size, zero to follow the graph's
+		bool storage;							// Whether a compute pass writes the target
+		std::vector<VkImage> images;			// The target's image, or one for each imported image
+		std::vector<VkImageView> imageViews;	// A view of each image
+		int firstUse;							// The first compiled pass to use the target, -1 if none
+		int lastUse;							// The last compiled pass to use the target
+		int memorySlot;							// The memory the target shares, -1 if it has none
+	}ResourceInfo;
+
+	// One layout transition and the wait that comes with it
+	typedef struct
+	{
+		Resource resource;						// The resource being transitioned
+		UseState from;							// How it was last used
+		UseState to;							// How it's about to be used
+	}Barrier;
+
+	// A pass that survived culling
+	typedef struct
+	{
+		int pass;								// The pass it runs
+		VkExtent2D extent;						// The size of what the pass writes
+		std::vector<Barrier> barriers;			// Transitions recorded before the pass begins
+		std::vector<VkFramebuffer> framebuffers;// One framebuffer, or one for each imported image it writes
+	}CompiledPass;
+
+	// Memory shared by targets that are never alive at the same time
+	typedef struct
+	{
+		VkMemoryRequirements requirements;		// Big enough and aligned enough for every target in it
+		int lastUse;							// The last compiled pass any of its targets are used in
+		MemoryAllocator::Allocation memory;		// The memory itself
+	}MemorySlot;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device
+	VkSampler sampler;							// Reads targets in later passes
+	VkExtent2D extent;							// The size of the targets
+	std::vector<ResourceInfo> resources;		// Every target and imported image
+	std::vector<PassInfo> passes;				// Every pass, in the order they run
+	std::vector<CompiledPass> compiledPasses;	// The passes that run, with their barriers
+	std::vector<Barrier> finalBarriers;			// Leaves imported images in their final layout
+	std::vector<MemorySlot> memorySlots;		// The memory the targets share
+	Stats stats;								// What the compiled graph does each frame
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Records a set of transitions as a single pipeline barrier
+
+		\param commandBuffer
+			The frame's primary command buffer
+
+		\param barriers
+			The transitions
+
+		\param imageIndex
+			Which of the imported images is being drawn to
+	*/
+	/*************************************************************************************************/
+	void RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers, uint32_t imageIndex);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Works out what waits on an imported image once it's in its final layout
+
+		\param layout
+			The final layout
+
+		\return
+			The stage and access that use the image next
+	*/
+	/*************************************************************************************************/
+	static UseState FindFinalState(VkImageLayout layout);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_RenderGraph_H_
@@ -28,16 +28,27 @@ Copyright (c) 2025 Aiden Cvengros
 // Includes vertex so we can draw triangles
 #include "Vertex.h"
 
-// Includes the texture class so the render pass can output to a texture
-#include "Texture.h"
+// Includes the sprite batch so sprite pipelines can read its instances
+#include "SpriteBatch.h"
 
 // Includes the window class so we can communicate the render pass the main window
 #include "Window.h"
 
+// Reading the fragment shader's outputs
+#include <cstring>
+#include <unordered_set>
+
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
+// The parts of SPIR-V needed to find a shader's outputs
+const size_t spirvHeaderWords = 5;				// Magic, version, generator, bound and schema
+const uint32_t spirvOpDecorate = 71;
+const uint32_t spirvOpVariable = 59;
+const uint32_t spirvDecorationLocation = 30;
+const uint32_t spirvStorageClassOutput = 3;
+
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
 //-------------------------------------------------------------------------------------------------
@@ -70,10 +81,9 @@ Copyright (c) 2025 Aiden Cvengros
 		FILL
 */
 /*************************************************************************************************/
-RenderPass::RenderPass() : singleOutput(false),
-	imageViews(0), outputTexture(NULL),
-	renderPass(NULL), descriptorSetLayout(NULL), pipelineLayout(NULL), graphicsPipeline(NULL),
-	framebuffers(0), uniformBuffers(0), uniformBuffersMemory(0), descriptorSets(0)
+RenderPass::RenderPass() :
+	renderPass(NULL), attachmentCount(0), descriptorSetLayout(NULL), pipelineLayout(NULL), graphicsPipeline(NULL),
+	uniformBuffers(0), uniformBuffersMemory(0), descriptorSets(0)
 {
 
 }
@@ -89,106 +99,55 @@ RenderPass::~RenderPass()
 	
 }
 
-/*************************************************************************************************/
-/*!
-		\brief
-			Creates the texture the render pass is writing to. If this function is not called, the render pass will not write to a texture
-
-		\param textureWidth
-			The width of the texture
-
-		\param textureHeight
-			The height of the texture
-
-		\param textureFormat
-			The color format for the texture
-*/
-/*************************************************************************************************/
-void RenderPass::CreateTexture(int textureWidth, int textureHeight, VkFormat textureFormat)
-{
-	// Error check
-	if (outputTexture)
-	{
-		delete outputTexture;
-	}
-
-	// Creates the texture
-	outputTexture = new Texture(textureWidth, textureHeight, textureFormat);
-
-	// Sets that this render pass outputs to a single texture
-	singleOutput = true;
-}
-
 /*************************************************************************************************/
 /*!
 	\brief
-		Creates the vulkan render pass object
-
-	\param onScreen
-		Whether this render pass is outputting to the screen or not
+		Creates the vulkan render pass object. Its attachments start and end in
+		VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, the render graph moves them in and out of it
 
 	\param vkDevice
 		The virtual vulkan device for this render pass to work off of
 
-	\param textureFormat
-		The color format for the texture
+	\param attachmentFormats
+		The color format of each attachment the pass draws to, in order
 */
 /*************************************************************************************************/
-void RenderPass::CreateRenderPass(bool onScreen, VkDevice vkDevice, VkFormat textureFormat)
+void RenderPass::CreateRenderPass(VkDevice vkDevice, const std::vector<VkFormat>& attachmentFormats)
 {
-	// Sets up a single color buffer for the swap chain
-	VkAttachmentDescription colorAttachment{};
-	colorAttachment.format = textureFormat;
-	colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-	colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-	colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-	colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-	// Sets the reference to the color attachment for subpasses to use
-	VkAttachmentReference colorAttachmentRef{};
-	colorAttachmentRef.attachment = 0;
-	colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	// Sets up a color buffer for each target. Every one is cleared, so nothing is loaded
+	attachmentCount = (uint32_t)attachmentFormats.size();
+	std::vector<VkAttachmentDescription> colorAttachments(attachmentFormats.size());
+	std::vector<VkAttachmentReference> colorAttachmentRefs(attachmentFormats.size());
+	for (size_t i = 0; i < attachmentFormats.size(); i++)
+	{
+		colorAttachments[i].format = attachmentFormats[i];
+		colorAttachments[i].samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachments[i].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachments[i].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachments[i].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachments[i].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachments[i].initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachments[i].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		// Sets the reference to the color attachment for subpasses to use
+		colorAttachmentRefs[i].attachment = (uint32_t)i;
+		colorAttachmentRefs[i].layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	}
 
 	// Sets up the graphics subpass
 	VkSubpassDescription subpass{};
 	subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-	subpass.colorAttachmentCount = 1;
-	subpass.pColorAttachments = &colorAttachmentRef;
-
-	// Creates the subpass dependency so we can get our image before we start rendering
-	VkSubpassDependency dependency{};
-	dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-	dependency.dstSubpass = 0;
-	dependency.srcAccessMask = 0;
+	subpass.colorAttachmentCount = (uint32_t)colorAttachmentRefs.size();
+	subpass.pColorAttachments = colorAttachmentRefs.data();
 
-	// Sets up the render pass
+	// Sets up the render pass. There are no subpass dependencies, the render graph records
+	// a barrier before the pass for everything it touches
 	VkRenderPassCreateInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-	renderPassInfo.attachmentCount = 1;
-	renderPassInfo.pAttachments = &colorAttachment;
+	renderPassInfo.attachmentCount = (uint32_t)colorAttachments.size();
+	renderPassInfo.pAttachments = colorAttachments.data();
 	renderPassInfo.subpassCount = 1;
 	renderPassInfo.pSubpasses = &subpass;
-	renderPassInfo.dependencyCount = 1;
-	renderPassInfo.pDependencies = &dependency;
-
-	if (onScreen)
-	{
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-	}
-	else
-	{
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-	}
 
 	// Checks that the render pass was created correctly
 	_Window->CheckVulkanSuccess(vkCreateRenderPass(vkDevice, &renderPassInfo, nullptr, &renderPass), "failed to create render pass!");
@@ -258,9 +217,16 @@ void RenderPass::CreateDescriptorSetLayout(VkDevice vkDevice, VkShaderStageFlags
 
 	\param pushConstantRange
 		The push constant range for the pipeline. Defaults to empty
+
+	\param spriteInstances
+		Whether the pipeline also reads sprite batch instances from vertex binding 1. Defaults to false
+
+	\param specialization
+		The fragment shader's specialization constants. Defaults to none
 */
 /*************************************************************************************************/
-void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string vertexShader, std::string fragmentShader, std::vector<VkDescriptorSetLayout> additionalDescriptorSets, VkPushConstantRange* pushConstantRange)
+void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string vertexShader, std::string fragmentShader, std::vector<VkDescriptorSetLayout> additionalDescriptorSets, VkPushConstantRange* pushConstantRange, bool spriteInstances,
+	const VkSpecializationInfo* specialization)
 {
 	// Reads in the shaders
 	File vertShaderCode(vertexShader.c_str(), true, false);
@@ -270,6 +236,17 @@ void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pip
 	VkShaderModule vertShaderModule = CreateShaderModule(vkDevice, vertShaderCode.GetReadData());
 	VkShaderModule fragShaderModule = CreateShaderModule(vkDevice, fragShaderCode.GetReadData());
 
+	// Attachments the shader doesn't write are left undefined, which means the binary is older
+	// than the pass it's being used with
+	uint32_t fragmentOutputs = CountFragmentOutputs(fragShaderCode.GetReadData());
+	if (fragmentOutputs < attachmentCount)
+	{
+		vkDestroyShaderModule(vkDevice, fragShaderModule, nullptr);
+		vkDestroyShaderModule(vkDevice, vertShaderModule, nullptr);
+		throw std::runtime_error(fragmentShader + " writes " + std::to_string(fragmentOutputs) + " outputs but its pass has " + std::to_string(attachmentCount)
+			+ " attachments. It needs compiling again with CompileShaders.bat");
+	}
+
 	// Creates the vertex shader stage information
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 	vertShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -283,13 +260,23 @@ void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pip
 	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
 	fragShaderStageInfo.module = fragShaderModule;
 	fragShaderStageInfo.pName = "main";
+	fragShaderStageInfo.pSpecializationInfo = specialization;
 
 	// Saves the shader stages in an array
 	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
 	// Gets the vertex description structs
-	auto bindingDescription = Vertex::getBindingDescription();
-	auto attributeDescriptions = Vertex::getAttributeDescriptions();
+	std::vector<VkVertexInputBindingDescription> bindingDescriptions = { Vertex::getBindingDescription() };
+	auto vertexAttributes = Vertex::getAttributeDescriptions();
+	std::vector<VkVertexInputAttributeDescription> attributeDescriptions(vertexAttributes.begin(), vertexAttributes.end());
+
+	// Sprite pipelines step through the batch's instances alongside the quad's vertices
+	if (spriteInstances)
+	{
+		bindingDescriptions.push_back(SpriteBatch::GetBindingDescription());
+		auto instanceAttributes = SpriteBatch::GetAttributeDescriptions();
+		attributeDescriptions.insert(attributeDescriptions.end(), instanceAttributes.begin(), instanceAttributes.end());
+	}
 
 	// Tells the graphics pipeline to use a list of individual triangles
 	VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
@@ -320,23 +307,34 @@ void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pip
 	multisampling.sampleShadingEnable = VK_FALSE;
 	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;										// DIFFERS BETWEEN TUTORIALS!!!!!!!!
 
-	// Sets the color blend attachment
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_TRUE;
-	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-
-	// Sets up the color blend constants (currently no blending)
+	// Sets the color blend for each attachment
+	std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(attachmentCount > 0 ? attachmentCount : 1);
+	for (size_t i = 0; i < colorBlendAttachments.size(); i++)
+	{
+		VkPipelineColorBlendAttachmentState& colorBlendAttachment = colorBlendAttachments[i];
+		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		colorBlendAttachment.blendEnable = VK_TRUE;
+		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+		// Later attachments keep their alpha where a draw writes nothing to them, so a shader
+		// writing vec4(0) to one leaves it as it was
+		if (i > 0)
+		{
+			colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		}
+	}
+
+	// Sets up the color blend constants
 	VkPipelineColorBlendStateCreateInfo colorBlending{};
 	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
 	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
+	colorBlending.attachmentCount = (uint32_t)colorBlendAttachments.size();
+	colorBlending.pAttachments = colorBlendAttachments.data();
 
 	// The list of things that should be dynamic
 	std::vector<VkDynamicState> dynamicStates =
@@ -367,9 +365,9 @@ void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pip
 	// Sets the vertex description structs
 	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertexInputInfo.vertexBindingDescriptionCount = 1;
+	vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescriptions.size());
 	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+	vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
 	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 
 	// Creates the graphics pipeline
@@ -399,77 +397,51 @@ void RenderPass::CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pip
 /*************************************************************************************************/
 /*!
 	\brief
-		Assigns the given swap chain framebuffers to the render pass
+		Creates a compute pipeline in place of the graphics pipeline, for passes that run a
+		compute shader rather than a vulkan render pass. It uses the pass's descriptor set
+		layout the same way
 
 	\param vkDevice
 		The virtual vulkan device for this render pass to work off of
 
-	\param swapChainFramebuffers
-		The framebuffers for the window's swap chain system
+	\param pipelineCache
+		The memory cache that stores all pipelines
+
+	\param computeShader
+		The compute shader address for the pipeline
 
-	\param swapChainExtent
-		The extent of the framebuffers
+	\param specialization
+		The compute shader's specialization constants. Defaults to none
 */
 /*************************************************************************************************/
-void RenderPass::SetSwapChainFramebuffers(VkDevice& vkDevice, std::vector<VkFramebuffer>& swapChainFramebuffers, VkExtent2D swapChainExtent)
+void RenderPass::CreateComputePipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string computeShader, const VkSpecializationInfo* specialization)
 {
-	// Sets the number of frame buffers
-	swapChainFramebuffers.resize(imageViews.size());
+	// Reads in the shader
+	File compShaderCode(computeShader.c_str(), true, false);
+	VkShaderModule compShaderModule = CreateShaderModule(vkDevice, compShaderCode.GetReadData());
 
-	// Makes a frame buffer for each slot in the vector
-	for (size_t i = 0; i < imageViews.size(); i++)
-	{
-		// Creates the framebuffer info struct do set the details of the swap chain framebuffers
-		VkFramebufferCreateInfo framebufferInfo{};
-		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-		framebufferInfo.renderPass = renderPass;
-		framebufferInfo.attachmentCount = 1;
-		framebufferInfo.pAttachments = &imageViews[i];
-		framebufferInfo.width = swapChainExtent.width;
-		framebufferInfo.height = swapChainExtent.height;
-		framebufferInfo.layers = 1;
-
-		_Window->CheckVulkanSuccess(vkCreateFramebuffer(vkDevice, &framebufferInfo, nullptr, &swapChainFramebuffers[i]), "failed to create framebuffer!");
-		_Debug->Print(Debug::MessageType::Debug, "Render Pass: Created swap chain pass framebuffer");
-	}
-}
-
-/*************************************************************************************************/
-/*!
-	\brief
-		Creates the framebuffers for the render pass
-
-	\param vkDevice
-		The virtual vulkan device for this render pass to work off of
+	// Creates the pipeline layout from the pass's only descriptor set
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = 1;
+	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+	_Window->CheckVulkanSuccess(vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, NULL, &pipelineLayout), "failed to create compute pipeline layout");
+
+	// Creates the compute pipeline
+	VkComputePipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	pipelineInfo.stage.module = compShaderModule;
+	pipelineInfo.stage.pName = "main";
+	pipelineInfo.stage.pSpecializationInfo = specialization;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	\param swapChainExtent
-		The extent of the framebuffers
-*/
-/*************************************************************************************************/
-void RenderPass::SetFramebuffers(VkDevice& vkDevice, VkExtent2D extent)
-{
-	// If we already have framebuffers, deletes them
-	for (size_t i = 0; i < framebuffers.size(); i++)
-	{
-		vkDestroyFramebuffer(vkDevice, framebuffers[i], NULL);
-		_Debug->Print(Debug::MessageType::Debug, "Render Pass: Destroyed framebuffer");
-	}
+	_Window->CheckVulkanSuccess(vkCreateComputePipelines(vkDevice, pipelineCache, 1, &pipelineInfo, NULL, &graphicsPipeline), "failed to create compute pipeline");
 
-	// Sets the number of frame buffers																!!! Currently Hardcoded to 1
-	framebuffers.resize(1);
-
-	// Creates the framebuffer info struct do set the details of the swap chain framebuffers
-	VkFramebufferCreateInfo framebufferInfo{};
-	framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-	framebufferInfo.renderPass = renderPass;
-	framebufferInfo.attachmentCount = 1;
-	framebufferInfo.pAttachments = &outputTexture->GetImageView();
-	framebufferInfo.width = extent.width;
-	framebufferInfo.height = extent.height;
-	framebufferInfo.layers = 1;
-
-	_Window->CheckVulkanSuccess(vkCreateFramebuffer(vkDevice, &framebufferInfo, nullptr, &framebuffers[0]), "failed to create framebuffer!");
-	_Debug->Print(Debug::MessageType::Debug, "Render Pass: Created framebuffer");
+	// Cleans up the shader module
+	vkDestroyShaderModule(vkDevice, compShaderModule, NULL);
 }
 
 /*************************************************************************************************/
@@ -484,7 +456,7 @@ void RenderPass::SetFramebuffers(VkDevice& vkDevice, VkExtent2D extent)
 		The size of the uniform buffer object
 
 	\param bufferQuantity
-		The number of uniform buffers to create
+		The number of uniform buffers to create, one for each frame in flight. Each stays mapped until the pass is destroyed
 */
 /*************************************************************************************************/
 void RenderPass::CreateUniformBuffers(VkDevice& vkDevice, VkDeviceSize bufferSize, int bufferQuantity)
@@ -585,48 +557,13 @@ void RenderPass::UpdateDescriptorSetUniformBuffer(VkDevice& vkDevice, int buffer
 		The uniform buffer data. Uses a void pointer because different uniform buffers are different structs
 
 	\param currentFrame
-		The frame that is being calculated. Defaults to zero for render passes that don't have multiple frames set up.
+		The frame in flight being recorded. Its buffer is only written once the frame's fence has been waited on
 */
 /*************************************************************************************************/
 void RenderPass::UpdateUniformBuffer(VkDevice& vkDevice, int bufferSize, void* uniformBuffer, int currentFrame)
 {
-	// Copies all the uniform buffer data in
-	void* data;
-	vkMapMemory(vkDevice, uniformBuffersMemory[currentFrame], 0, bufferSize, 0, &data);
-	memcpy(data, uniformBuffer, bufferSize);
-	vkUnmapMemory(vkDevice, uniformBuffersMemory[currentFrame]);
-}
-
-/*************************************************************************************************/
-/*!
-	\brief
-		Destroys the output texture of the render pass (if there is one). Otherwise destroys the image view object.
-
-	\param vkDevice
-		The virtual vulkan device for this render pass to work off of
-*/
-/*************************************************************************************************/
-void RenderPass::DestroyTexture(VkDevice& vkDevice)
-{
-	// If there's an output texture
-	if (outputTexture)
-	{
-		// Destroys the texture object
-		delete outputTexture;
-		outputTexture = NULL;
-	}
-	// Otherwise
-	else
-	{
-		// Clears the image view object
-		// Destroys all the image views
-		for (size_t i = 0; i < imageViews.size(); i++)
-		{
-			vkDestroyImageView(vkDevice, imageViews[i], nullptr);
-		}
-
-		imageViews.clear();
-	}
+	// Copies all the uniform buffer data into the frame's own buffer, so frames still on the GPU keep theirs
+	memcpy(uniformBuffersMemory[currentFrame].mapped, uniformBuffer, bufferSize);
 }
 
 /*************************************************************************************************/
@@ -648,15 +585,7 @@ void RenderPass::DestroyRenderPass(VkDevice& vkDevice)
 	// Cleans up the uniform buffer objects
 	for (size_t i = 0; i < uniformBuffers.size(); i++)
 	{
-		vkDestroyBuffer(vkDevice, uniformBuffers[i], NULL);
-		vkFreeMemory(vkDevice, uniformBuffersMemory[i], NULL);
-	}
-
-	// Cleans up the uniform buffer objects
-	for (size_t i = 0; i < framebuffers.size(); i++)
-	{
-		vkDestroyFramebuffer(vkDevice, framebuffers[i], NULL);
-		_Debug->Print(Debug::MessageType::Debug, "Render Pass: Destroyed framebuffer");
+		_Window->DestroyBuffer(uniformBuffers[i], uniformBuffersMemory[i]);
 	}
 
 	// Destroys the descriptor sets
@@ -699,3 +628,61 @@ VkShaderModule RenderPass::CreateShaderModule(VkDevice vkDevice, const std::vect
 	// Returns the shader module
 	return shaderModule;
 }
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Counts the color outputs a fragment shader writes, so a binary built from an older
+		source is caught before the pass draws with it
+
+	\param code
+		The shader's SPIR-V, already accepted by vkCreateShaderModule
+
+	\return
+		How many output variables have a location
+*/
+/*********************************************************************************************/
+uint32_t RenderPass::CountFragmentOutputs(const std::vector<char>& code)
+{
+	size_t wordCount = code.size() / sizeof(uint32_t);
+	if (wordCount <= spirvHeaderWords)
+	{
+		return 0;
+	}
+	std::vector<uint32_t> words(wordCount);
+	memcpy(words.data(), code.data(), wordCount * sizeof(uint32_t));
+
+	// Each instruction starts with its length in words in the high half and its opcode in the low
+	std::unordered_set<uint32_t> located;
+	std::vector<uint32_t> outputs;
+	for (size_t i = spirvHeaderWords; i < wordCount;)
+	{
+		uint32_t length = words[i] >> 16;
+		uint32_t opcode = words[i] & 0xFFFF;
+		if (length == 0 || i + length > wordCount)
+		{
+			break;
+		}
+
+		if (opcode == spirvOpDecorate && length >= 3 && words[i + 2] == spirvDecorationLocation)
+		{
+			located.insert(words[i + 1]);
+		}
+		else if (opcode == spirvOpVariable && length >= 4 && words[i + 3] == spirvStorageClassOutput)
+		{
+			outputs.push_back(words[i + 2]);
+		}
+		i += length;
+	}
+
+	// Built in outputs, like the fragment depth, have no location
+	uint32_t count = 0;
+	for (uint32_t output : outputs)
+	{
+		if (located.count(output))
+		{
+			count++;
+		}
+	}
+	return count;
+}
@@ -34,13 +34,13 @@ Copyright (c) 2025 Aiden Cvengros
 // Includes vectors for lists of input variables
 #include <vector>
 
+// The memory behind the uniform buffers
+#include "MemoryAllocator.h"
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
 
-// Dependency Reference
-class Texture;
-
 //-------------------------------------------------------------------------------------------------
 // Public Constants
 //-------------------------------------------------------------------------------------------------
@@ -93,36 +93,17 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Creates the texture the render pass is writing to. If this function is not called, the render pass will not write to a texture
-
-		\param textureWidth
-			The width of the texture
-
-		\param textureHeight
-			The height of the texture
-
-		\param textureFormat
-			The color format for the texture
-	*/
-	/*************************************************************************************************/
-	void CreateTexture(int textureWidth, int textureHeight, VkFormat textureFormat);
-
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Creates the vulkan render pass object
-
-		\param onScreen
-			Whether this render pass is outputting to the screen or not
+			Creates the vulkan render pass object. Its attachments start and end in
+			VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, the render graph moves them in and out of it
 
 		\param vkDevice
 			The virtual vulkan device for this render pass to work off of
 
-		\param textureFormat
-			The color format for the texture
+		\param attachmentFormats
+			The color format of each attachment the pass draws to, in order
 	*/
 	/*************************************************************************************************/
-	void CreateRenderPass(bool onScreen, VkDevice vkDevice, VkFormat textureFormat);
+	void CreateRenderPass(VkDevice vkDevice, const std::vector<VkFormat>& attachmentFormats);
 
 	/*************************************************************************************************/
 	/*!
@@ -163,40 +144,38 @@ public:
 
 		\param pushConstantRange
 			The push constant range for the pipeline. Defaults to empty
-	*/
-	/*************************************************************************************************/
-	void CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string vertexShader, std::string fragmentShader, std::vector<VkDescriptorSetLayout> additionalDescriptorSets, VkPushConstantRange* pushConstantRange = NULL);
-
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Creates the swap chain framebuffers (only needed if this render pass interacts with the swap chain)
 
-		\param vkDevice
-			The virtual vulkan device for this render pass to work off of
+		\param spriteInstances
+			Whether the pipeline also reads sprite batch instances from vertex binding 1. Defaults to false
 
-		\param swapChainFramebuffers
-			The framebuffers for the window's swap chain system
-
-		\param swapChainExtent
-			The extent of the framebuffers
+		\param specialization
+			The fragment shader's specialization constants. Defaults to none
 	*/
 	/*************************************************************************************************/
-	void SetSwapChainFramebuffers(VkDevice& vkDevice, std::vector<VkFramebuffer>& swapChainFramebuffers, VkExtent2D swapChainExtent);
+	void CreateGraphicsPipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string vertexShader, std::string fragmentShader, std::vector<VkDescriptorSetLayout> additionalDescriptorSets, VkPushConstantRange* pushConstantRange = NULL, bool spriteInstances = false,
+		const VkSpecializationInfo* specialization = NULL);
 
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Creates the framebuffers for this render pass
+			Creates a compute pipeline in place of the graphics pipeline, for passes that run a
+			compute shader rather than a vulkan render pass. It uses the pass's descriptor set
+			layout the same way
 
 		\param vkDevice
 			The virtual vulkan device for this render pass to work off of
 
-		\param extent
-			The extent of the framebuffers
+		\param pipelineCache
+			The memory cache that stores all pipelines
+
+		\param computeShader
+			The compute shader address for the pipeline
+
+		\param specialization
+			The compute shader's specialization constants. Defaults to none
 	*/
 	/*************************************************************************************************/
-	void SetFramebuffers(VkDevice& vkDevice, VkExtent2D extent);
+	void CreateComputePipeline(VkDevice& vkDevice, VkPipelineCache& pipelineCache, std::string computeShader, const VkSpecializationInfo* specialization = NULL);
 
 	/*************************************************************************************************/
 	/*!
@@ -210,7 +189,7 @@ public:
 			The size of the uniform buffer object
 
 		\param bufferQuantity
-			The number of uniform buffers to create
+			The number of uniform buffers to create, one for each frame in flight. Each stays mapped until the pass is destroyed
 	*/
 	/*************************************************************************************************/
 	void CreateUniformBuffers(VkDevice& vkDevice, VkDeviceSize bufferSize, int bufferQuantity);
@@ -261,21 +240,10 @@ public:
 			The uniform buffer data. Uses a void pointer because different uniform buffers are different structs
 
 		\param currentFrame
-			The frame that is being calculated. Defaults to zero for render passes that don't have multiple frames set up.
+			The frame in flight being recorded. Its buffer is only written once the frame's fence has been waited on
 	*/
 	/*************************************************************************************************/
-	void UpdateUniformBuffer(VkDevice& vkDevice, int bufferSize, void* uniformBuffer, int currentFrame = 0);
-
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Destroys the output texture of the render pass (if there is one). Otherwise destroys the image view object.
-
-		\param vkDevice
-			The virtual vulkan device for this render pass to work off of
-	*/
-	/*************************************************************************************************/
-	void DestroyTexture(VkDevice& vkDevice);
+	void UpdateUniformBuffer(VkDevice& vkDevice, int bufferSize, void* uniformBuffer, int currentFrame);
 
 	/*************************************************************************************************/
 	/*!
@@ -288,14 +256,6 @@ public:
 	/*************************************************************************************************/
 	void DestroyRenderPass(VkDevice& vkDevice);
 
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Adds the given image view object for the render pass
-	*/
-	/*************************************************************************************************/
-	void AddImageView(VkImageView newImageView) { imageViews.push_back(newImageView); }
-
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -307,17 +267,6 @@ public:
 	/*************************************************************************************************/
 	std::vector<VkBuffer> GetUniformBuffers() { return uniformBuffers; }
 
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Returns the texture object this render pass outputs to
-
-		\return
-			The output texture object
-	*/
-	/*************************************************************************************************/
-	Texture* GetOutputTexture() { return outputTexture; }
-
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -329,17 +278,6 @@ public:
 	/*************************************************************************************************/
 	VkRenderPass& GetRenderPass() { return renderPass; }
 
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Returns the render pass framebuffers
-
-		\return
-			The list of framebuffers
-	*/
-	/*************************************************************************************************/
-	std::vector<VkFramebuffer>& GetFramebuffers() { return framebuffers; }
-
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -386,16 +324,13 @@ private:
 	// Private Variables
 	//---------------------------------------------------------------------------------------------
 
-	bool singleOutput;									// Whether this render pass always outputs to a single output (outputTexture) or multiple (imageViews)
-	std::vector<VkImageView> imageViews;				// The image view is the part in memory that visuals get written to
-	Texture* outputTexture;								// Output texture. Will be null if this render pass outputs to screen
-	VkRenderPass renderPass;							// The render pass for the offscreen buffers
+	VkRenderPass renderPass;							// The vulkan render pass, whose targets the render graph owns
+	uint32_t attachmentCount;							// How many color attachments the pass draws to
 	VkDescriptorSetLayout descriptorSetLayout;			// The descriptor set layout for the fisheye shader
-	VkPipelineLayout pipelineLayout;					// The graphics pipeline layout for the fisheye render pass
-	VkPipeline graphicsPipeline;						// The graphics pipeline for the fisheye render pass
-	std::vector<VkFramebuffer> framebuffers;			// The offscreen framebuffer
+	VkPipelineLayout pipelineLayout;					// The pipeline layout for the render pass
+	VkPipeline graphicsPipeline;						// The pipeline for the render pass, or its compute pipeline
 	std::vector<VkBuffer> uniformBuffers;				// The uniform buffer for the fisheye shader
-	std::vector<VkDeviceMemory> uniformBuffersMemory;	// The memory storing unform buffer data for the fisheye shader
+	std::vector<MemoryAllocator::Allocation> uniformBuffersMemory;	// The memory storing unform buffer data, mapped for as long as it exists
 	std::vector<VkDescriptorSet> descriptorSets;		// The descriptor set for the fisheye shader
 	
 	//---------------------------------------------------------------------------------------------
@@ -418,6 +353,21 @@ private:
 	*/
 	/*********************************************************************************************/
 	VkShaderModule CreateShaderModule(VkDevice vkDevice, const std::vector<char>& code);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Counts the color outputs a fragment shader writes, so a binary built from an older
+			source is caught before the pass draws with it
+
+		\param code
+			The shader's SPIR-V, already accepted by vkCreateShaderModule
+
+		\return
+			How many output variables have a location
+	*/
+	/*********************************************************************************************/
+	static uint32_t CountFragmentOutputs(const std::vector<char>& code);
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -0,0 +1,389 @@
+/*************************************************************************************************/
+/*!
+\file ResolutionScaler.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Times each frame on the GPU and picks how much of the screen's resolution the scene is drawn
+	at. The scale drops when frames run over budget and only climbs back once they're well under
+	it, so it doesn't flicker between two sizes
+
+    Functions include:
+        + ResolutionScaler::ResolutionScaler
+		+ ResolutionScaler::~ResolutionScaler
+		+ ResolutionScaler::Init
+		+ ResolutionScaler::SetEnabled
+		+ ResolutionScaler::SetBounds
+		+ ResolutionScaler::SetTarget
+		+ ResolutionScaler::BeginFrame
+		+ ResolutionScaler::EndFrame
+		+ ResolutionScaler::FrameFinished
+		+ ResolutionScaler::Free
+		+ ResolutionScaler::GetScaledExtent
+		+ ResolutionScaler::GetStats
+		+ ResolutionScaler::Adjust
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "ResolutionScaler.h"
+#include "cppShortcuts.h"
+
+// Checking vulkan results
+#include "Window.h"
+
+// Clamping the scale
+#include <algorithm>
+#include <cmath>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// Half the screen's width and height, a quarter of its pixels
+const float defaultMinScale = 0.5f;
+
+// Leaves some of a 60hz frame for presenting
+const double defaultTargetMilliseconds = 14.0;
+
+// How far the scale moves at once. Keeps the sizes it lands on few
+const float scaleStep = 0.05f;
+
+// Frames have to be this far under the target before the scale climbs again
+const double raiseFraction = 0.8;
+
+// How much of each new frame's time goes into the average
+const double smoothing = 0.1;
+
+// Frames to wait after a change before judging the new scale. Covers the frames already in
+// flight at the old scale and lets the average catch up
+const int framesToSettle = 20;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the resolution scaler class
+*/
+/*************************************************************************************************/
+ResolutionScaler::ResolutionScaler() : device(VK_NULL_HANDLE), queryPool(VK_NULL_HANDLE), timestampPeriod(0.0), timestampMask(0), pending(), enabled(true),
+	minScale(defaultMinScale), maxScale(1.0f), targetMilliseconds(defaultTargetMilliseconds), scale(1.0f), gpuMilliseconds(0.0), settleFrames(0), scaleChanges(0)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the resolution scaler class
+*/
+/*************************************************************************************************/
+ResolutionScaler::~ResolutionScaler()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Makes a pair of timestamp queries for each frame in flight
+
+	\param vkDevice
+		The logical device
+
+	\param physicalDevice
+		The graphics card, for how fast its timestamps tick
+
+	\param graphicsFamily
+		The queue family the frames are submitted to
+
+	\param framesInFlight
+		How many frames can be recorded before the oldest one is finished
+*/
+/*************************************************************************************************/
+void ResolutionScaler::Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, int framesInFlight)
+{
+	device = vkDevice;
+	pending.assign(framesInFlight, false);
+
+	// Some queues can't write timestamps at all, which leaves the scene at full size
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, NULL);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+	uint32_t validBits = graphicsFamily < familyCount ? families[graphicsFamily].timestampValidBits : 0;
+	if (validBits == 0)
+	{
+		_Debug->Print(Debug::MessageType::Error, "ResolutionScaler: The graphics queue can't time frames, drawing the scene at full size");
+		scale = maxScale;
+		return;
+	}
+	timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	timestampPeriod = properties.limits.timestampPeriod;
+
+	VkQueryPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	poolInfo.queryCount = static_cast<uint32_t>(framesInFlight) * 2;
+	_Window->CheckVulkanSuccess(vkCreateQueryPool(device, &poolInfo, NULL, &queryPool), "failed to create timestamp query pool!");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Turns the scaling on or off. Off keeps the scene at the maximum scale
+
+	\param enabled_
+		Whether the scale follows the GPU time
+*/
+/*************************************************************************************************/
+void ResolutionScaler::SetEnabled(bool enabled_)
+{
+	enabled = enabled_;
+	if (!enabled)
+	{
+		scale = maxScale;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets how far the scale can move
+
+	\param minScale_
+		The smallest fraction of the screen the scene is drawn at
+
+	\param maxScale_
+		The largest fraction of the screen the scene is drawn at, at most 1
+*/
+/*************************************************************************************************/
+void ResolutionScaler::SetBounds(float minScale_, float maxScale_)
+{
+	// The scene's targets are screen sized, so it can't be drawn any bigger
+	maxScale = std::clamp(maxScale_, scaleStep, 1.0f);
+	minScale = std::clamp(minScale_, scaleStep, maxScale);
+	scale = enabled ? std::clamp(scale, minScale, maxScale) : maxScale;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets the GPU time the scale is chasing
+
+	\param milliseconds
+		How long a frame should take on the GPU
+*/
+/*************************************************************************************************/
+void ResolutionScaler::SetTarget(double milliseconds)
+{
+	targetMilliseconds = milliseconds;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts timing a frame. Call right after the frame's command buffer is begun
+
+	\param commandBuffer
+		The frame's command buffer
+
+	\param frame
+		The index of the frame in flight being recorded
+*/
+/*************************************************************************************************/
+void ResolutionScaler::BeginFrame(VkCommandBuffer commandBuffer, int frame)
+{
+	if (queryPool == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	// Queries have to be reset before they're written again, outside any render pass
+	vkCmdResetQueryPool(commandBuffer, queryPool, frame * 2, 2);
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, frame * 2);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Stops timing a frame. Call after the frame's last pass is recorded
+
+	\param commandBuffer
+		The frame's command buffer
+
+	\param frame
+		The index of the frame in flight being recorded
+*/
+/*************************************************************************************************/
+void ResolutionScaler::EndFrame(VkCommandBuffer commandBuffer, int frame)
+{
+	if (queryPool == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, frame * 2 + 1);
+	pending[frame] = true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads the frame's GPU time and moves the scale if it needs to. Only call once the
+		frame's fence has been waited on
+
+	\param frame
+		The index of the frame in flight that finished
+*/
+/*************************************************************************************************/
+void ResolutionScaler::FrameFinished(int frame)
+{
+	if (frame >= (int)pending.size() || !pending[frame])
+	{
+		return;
+	}
+	pending[frame] = false;
+
+	// The fence means both timestamps are written, so this never waits
+	uint64_t timestamps[2] = {};
+	VkResult result = vkGetQueryPoolResults(device, queryPool, frame * 2, 2, sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+	if (result != VK_SUCCESS)
+	{
+		return;
+	}
+
+	double frameMilliseconds = (double)((timestamps[1] - timestamps[0]) & timestampMask) * timestampPeriod / 1000000.0;
+	gpuMilliseconds = gpuMilliseconds == 0.0 ? frameMilliseconds : gpuMilliseconds + (frameMilliseconds - gpuMilliseconds) * smoothing;
+
+	if (enabled)
+	{
+		Adjust();
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys the timestamp queries. The device must be idle
+*/
+/*************************************************************************************************/
+void ResolutionScaler::Free()
+{
+	if (queryPool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device, queryPool, NULL);
+		queryPool = VK_NULL_HANDLE;
+	}
+	pending.clear();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the size the scene is drawn at for a screen size
+
+	\param extent
+		The screen's size
+
+	\return
+		The screen's size at the current scale, never smaller than a pixel
+*/
+/*************************************************************************************************/
+VkExtent2D ResolutionScaler::GetScaledExtent(VkExtent2D extent)
+{
+	VkExtent2D scaledExtent;
+	scaledExtent.width = std::max(1u, (uint32_t)std::lround(extent.width * scale));
+	scaledExtent.height = std::max(1u, (uint32_t)std::lround(extent.height * scale));
+	return scaledExtent;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns what the scaler is doing
+
+	\return
+		The scale and the GPU time it's following
+*/
+/*************************************************************************************************/
+ResolutionScaler::Stats ResolutionScaler::GetStats()
+{
+	Stats stats;
+	stats.scale = scale;
+	stats.gpuMilliseconds = gpuMilliseconds;
+	stats.targetMilliseconds = targetMilliseconds;
+	stats.scaleChanges = scaleChanges;
+	stats.timed = queryPool != VK_NULL_HANDLE;
+	return stats;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Moves the scale a step if the smoothed GPU time is outside the target's band
+*/
+/*************************************************************************************************/
+void ResolutionScaler::Adjust()
+{
+	// Frames still in flight were drawn at the old scale, so they say nothing about the new one
+	if (settleFrames > 0)
+	{
+		settleFrames--;
+		return;
+	}
+
+	// Over budget drops the scale, and only being well under it raises it again. Anything in
+	// between leaves it where it is
+	float newScale = scale;
+	if (gpuMilliseconds > targetMilliseconds)
+	{
+		newScale = std::max(scale - scaleStep, minScale);
+	}
+	else if (gpuMilliseconds < targetMilliseconds * raiseFraction)
+	{
+		newScale = std::min(scale + scaleStep, maxScale);
+	}
+
+	if (newScale != scale)
+	{
+		scale = newScale;
+		settleFrames = framesToSettle;
+		scaleChanges++;
+		_Debug->Print(Debug::MessageType::Debug, "ResolutionScaler: Drawing the scene at " + std::to_string((int)std::lround(scale * 100.0f)) + "% after "
+			+ std::to_string(gpuMilliseconds) + " ms frames");
+	}
+}
@@ -0,0 +1,305 @@
+/*************************************************************************************************/
+/*!
+\file ResolutionScaler.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Times each frame on the GPU and picks how much of the screen's resolution the scene is drawn
+	at. The scale drops when frames run over budget and only climbs back once they're well under
+	it, so it doesn't flicker between two sizes
+
+    Public Functions:
+        + ResolutionScaler
+		+ ~ResolutionScaler
+		+ Init
+		+ SetEnabled
+		+ SetBounds
+		+ SetTarget
+		+ BeginFrame
+		+ EndFrame
+		+ FrameFinished
+		+ Free
+		+ GetScaledExtent
+		+ GetScale
+		+ GetStats
+
+	Private Functions:
+		+ Adjust
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_ResolutionScaler_H_
+#define Syncopatience_ResolutionScaler_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// Each frame in flight's timing
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The resolution scaler class
+*/
+/*************************************************************************************************/
+class ResolutionScaler
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// What the scaler is doing
+	typedef struct
+	{
+		float scale;							// The fraction of the screen's width and height the scene is drawn at
+		double gpuMilliseconds;					// The smoothed GPU time of recent frames
+		double targetMilliseconds;				// The GPU time the scale is chasing
+		int scaleChanges;						// How many times the scale has moved
+		bool timed;								// Whether the GPU can time frames. The scale stays at its maximum if not
+	}Stats;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the resolution scaler class
+	*/
+	/*************************************************************************************************/
+	ResolutionScaler();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the resolution scaler class
+	*/
+	/*************************************************************************************************/
+	~ResolutionScaler();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Makes a pair of timestamp queries for each frame in flight
+
+		\param vkDevice
+			The logical device
+
+		\param physicalDevice
+			The graphics card, for how fast its timestamps tick
+
+		\param graphicsFamily
+			The queue family the frames are submitted to
+
+		\param framesInFlight
+			How many frames can be recorded before the oldest one is finished
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice, uint32_t graphicsFamily, int framesInFlight);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Turns the scaling on or off. Off keeps the scene at the maximum scale
+
+		\param enabled_
+			Whether the scale follows the GPU time
+	*/
+	/*************************************************************************************************/
+	void SetEnabled(bool enabled_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets how far the scale can move
+
+		\param minScale_
+			The smallest fraction of the screen the scene is drawn at
+
+		\param maxScale_
+			The largest fraction of the screen the scene is drawn at, at most 1
+	*/
+	/*************************************************************************************************/
+	void SetBounds(float minScale_, float maxScale_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets the GPU time the scale is chasing
+
+		\param milliseconds
+			How long a frame should take on the GPU
+	*/
+	/*************************************************************************************************/
+	void SetTarget(double milliseconds);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts timing a frame. Call right after the frame's command buffer is begun
+
+		\param commandBuffer
+			The frame's command buffer
+
+		\param frame
+			The index of the frame in flight being recorded
+	*/
+	/*************************************************************************************************/
+	void BeginFrame(VkCommandBuffer commandBuffer, int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Stops timing a frame. Call after the frame's last pass is recorded
+
+		\param commandBuffer
+			The frame's command buffer
+
+		\param frame
+			The index of the frame in flight being recorded
+	*/
+	/*************************************************************************************************/
+	void EndFrame(VkCommandBuffer commandBuffer, int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads the frame's GPU time and moves the scale if it needs to. Only call once the
+			frame's fence has been waited on
+
+		\param frame
+			The index of the frame in flight that finished
+	*/
+	/*************************************************************************************************/
+	void FrameFinished(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys the timestamp queries. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the size the scene is drawn at for a screen size
+
+		\param extent
+			The screen's size
+
+		\return
+			The screen's size at the current scale, never smaller than a pixel
+	*/
+	/*************************************************************************************************/
+	VkExtent2D GetScaledExtent(VkExtent2D extent);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the fraction of the screen's width and height the scene is drawn at
+
+		\return
+			The current scale
+	*/
+	/*************************************************************************************************/
+	float GetScale() { return scale; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns what the scaler is doing
+
+		\return
+			The scale and the GPU time it's following
+	*/
+	/*************************************************************************************************/
+	Stats GetStats();
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device
+	VkQueryPool queryPool;						// A start and end timestamp for each frame in flight
+	double timestampPeriod;						// Nanoseconds per timestamp tick
+	uint64_t timestampMask;						// The bits of a timestamp the queue actually writes
+	std::vector<bool> pending;					// Whether each frame in flight has a time to read
+	bool enabled;								// Whether the scale follows the GPU time
+	float minScale;								// The smallest the scale can go
+	float maxScale;								// The largest the scale can go
+	double targetMilliseconds;					// The GPU time the scale is chasing
+	float scale;								// The fraction of the screen the scene is drawn at
+	double gpuMilliseconds;						// The smoothed GPU time, 0 until the first frame is read
+	int settleFrames;							// Frames left before the scale can move again
+	int scaleChanges;							// How many times the scale has moved
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Moves the scale a step if the smoothed GPU time is outside the target's band
+	*/
+	/*************************************************************************************************/
+	void Adjust();
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_ResolutionScaler_H_
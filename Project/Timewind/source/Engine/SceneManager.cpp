@@ -32,6 +32,12 @@ Copyright (c) 2023 Aiden Cvengros
 // Additional Includes
 #include "AudioManager.h"
 
+// Packs each scene's sprites into atlas pages as it loads
+#include "TextureManager.h"
+
+// Starts texture uploads once a scene has loaded
+#include "Window.h"
+
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
@@ -89,8 +95,13 @@ SceneManager::SceneManager() : System(SystemTypes::sceneManager)
 /*************************************************************************************************/
 void SceneManager::Init()
 {
-	// Starts by loading the initial scene
+	// Starts by loading the initial scene, packing its sprites together once it's done
+	_TextureManager->BeginAtlasBatch();
 	sceneList[currentSceneIndex]->LoadScene();
+	_TextureManager->PackAtlases();
+
+	// Starts the scene's texture uploads now instead of when the first frame is submitted
+	_Window->GetTextureUploader()->Submit();
 }
 
 /*************************************************************************************************/
@@ -111,8 +122,11 @@ void SceneManager::Update(double dt)
 		sceneList[currentSceneIndex]->UnloadScene();
 		_AudioManager->ClearMusic();
 
-		// Loads the next scene
+		// Loads the next scene, packing its sprites together once it's done
+		_TextureManager->BeginAtlasBatch();
 		sceneList[nextSceneIndex]->LoadScene();
+		_TextureManager->PackAtlases();
+		_Window->GetTextureUploader()->Submit();
 
 		// Corrects the current scene index
 		currentSceneIndex = nextSceneIndex;
@@ -0,0 +1,351 @@
+/*************************************************************************************************/
+/*!
+\file SpriteBatch.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Collects the sprites drawn each frame and records them as instanced draws. Every sprite is
+	one instance of the shared quad, so the number of draw calls follows the number of texture
+	switches instead of the number of objects. Large flushes are split across the command
+	recorder's threads, each recording its share into a secondary command buffer
+
+    Functions include:
+        + SpriteBatch::SpriteBatch
+		+ SpriteBatch::~SpriteBatch
+		+ SpriteBatch::Init
+		+ SpriteBatch::BeginFrame
+		+ SpriteBatch::Add
+		+ SpriteBatch::Flush
+		+ SpriteBatch::Free
+		+ SpriteBatch::SetTransform
+		+ SpriteBatch::GetBindingDescription
+		+ SpriteBatch::GetAttributeDescriptions
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "SpriteBatch.h"
+#include "cppShortcuts.h"
+
+// Where instances are written and recorded
+#include "FrameAllocator.h"
+#include "CommandRecorder.h"
+
+// Sorting each priority run by texture
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the sprite batch class
+*/
+/*************************************************************************************************/
+SpriteBatch::SpriteBatch() : frameAllocator(NULL), commandRecorder(NULL), quadVertexBuffer(NULL), quadIndexBuffer(NULL), quadIndexCount(0), spriteCount(0), drawCallCount(0)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the sprite batch class
+*/
+/*************************************************************************************************/
+SpriteBatch::~SpriteBatch()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets up the batch
+
+	\param frameAllocator_
+		Where each frame's instances are written
+
+	\param commandRecorder_
+		The threads and secondary command buffers flushes are recorded with
+
+	\param quadVertexBuffer_
+		The vertex buffer of the quad every sprite is drawn with
+
+	\param quadIndexBuffer_
+		The 16 bit index buffer of the quad
+
+	\param quadIndexCount_
+		The number of indices in the quad
+*/
+/*************************************************************************************************/
+void SpriteBatch::Init(FrameAllocator* frameAllocator_, CommandRecorder* commandRecorder_, VkBuffer quadVertexBuffer_, VkBuffer quadIndexBuffer_, uint32_t quadIndexCount_)
+{
+	frameAllocator = frameAllocator_;
+	commandRecorder = commandRecorder_;
+	quadVertexBuffer = quadVertexBuffer_;
+	quadIndexBuffer = quadIndexBuffer_;
+	quadIndexCount = quadIndexCount_;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Starts a new frame, after the frame allocator has moved on to it
+*/
+/*************************************************************************************************/
+void SpriteBatch::BeginFrame()
+{
+	// Anything left over belonged to a frame that was never finished
+	queuedSprites.clear();
+	spriteCount = 0;
+	drawCallCount = 0;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Queues a sprite to be drawn on the next flush
+
+	\param instance
+		The sprite's instance data
+
+	\param texture
+		The descriptor set of the sprite's texture. The same for every sprite when using the texture table
+
+	\param drawPriority
+		The sprite's draw priority. Sprites are only reordered among neighbors with the same priority
+*/
+/*************************************************************************************************/
+void SpriteBatch::Add(const Instance& instance, VkDescriptorSet texture, int drawPriority)
+{
+	queuedSprites.push_back({ instance, texture, drawPriority });
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Records everything queued into the command recorder's current pass. Sorts each run of
+		sprites with the same priority by texture, splits the list into contiguous ranges for
+		the recording threads, then runs their secondary command buffers in order
+
+	\param commandBuffer
+		The primary command buffer being recorded, inside a pass begun for secondary command buffers
+*/
+/*************************************************************************************************/
+void SpriteBatch::Flush(VkCommandBuffer commandBuffer)
+{
+	if (queuedSprites.empty())
+	{
+		return;
+	}
+
+	// Sprites are drawn in the order they came in, except that neighbors with the same priority can
+	// be grouped by texture since nothing says which of them goes on top. Systems draw in their own
+	// order, so sprites are never moved past a different priority. The sort is stable, so a text's
+	// glyphs stay in order
+	size_t runStart = 0;
+	for (size_t i = 1; i <= queuedSprites.size(); i++)
+	{
+		if (i == queuedSprites.size() || queuedSprites[i].drawPriority != queuedSprites[runStart].drawPriority)
+		{
+			std::stable_sort(queuedSprites.begin() + runStart, queuedSprites.begin() + i,
+				[](const QueuedSprite& a, const QueuedSprite& b) { return a.texture < b.texture; });
+			runStart = i;
+		}
+	}
+
+	// Every instance goes in one slice, so each draw picks its sprites out with the first instance
+	// index. The slice is taken here since the frame allocator is only used from the main thread
+	FrameAllocator::Allocation allocation = frameAllocator->Allocate(sizeof(Instance) * queuedSprites.size());
+	Instance* mappedInstances = (Instance*)allocation.data;
+
+	// Hands each thread an equal contiguous range, but only as many threads as there's work for
+	size_t spriteTotal = queuedSprites.size();
+	size_t taskCount = (spriteTotal + SPRITES_PER_THREAD - 1) / SPRITES_PER_THREAD;
+	if (taskCount > (size_t)commandRecorder->GetWorkerCount())
+	{
+		taskCount = (size_t)commandRecorder->GetWorkerCount();
+	}
+	std::vector<VkCommandBuffer> secondaryBuffers(taskCount);
+	std::vector<int> taskDrawCalls(taskCount, 0);
+
+	commandRecorder->Run((int)taskCount, [&](int task)
+	{
+		size_t first = spriteTotal * task / taskCount;
+		size_t last = spriteTotal * (task + 1) / taskCount;
+		VkPipelineLayout pipelineLayout = commandRecorder->GetPassState().pipelineLayout;
+
+		// Each thread writes its own range of the instances
+		for (size_t i = first; i < last; i++)
+		{
+			mappedInstances[i] = queuedSprites[i].instance;
+		}
+
+		VkCommandBuffer secondaryBuffer = commandRecorder->BeginSecondary(task);
+		VkDeviceSize quadOffset = 0;
+		vkCmdBindVertexBuffers(secondaryBuffer, 0, 1, &quadVertexBuffer, &quadOffset);
+		vkCmdBindVertexBuffers(secondaryBuffer, 1, 1, &allocation.buffer, &allocation.offset);
+		vkCmdBindIndexBuffer(secondaryBuffer, quadIndexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+		// Draws each texture's sprites together
+		size_t next = first;
+		while (next < last)
+		{
+			const QueuedSprite& sprite = queuedSprites[next];
+			vkCmdBindDescriptorSets(secondaryBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &sprite.texture, 0, NULL);
+
+			size_t end = next;
+			while (end < last && queuedSprites[end].texture == sprite.texture)
+			{
+				end++;
+			}
+			vkCmdDrawIndexed(secondaryBuffer, quadIndexCount, (uint32_t)(end - next), 0, 0, (uint32_t)next);
+			next = end;
+
+			taskDrawCalls[task]++;
+		}
+
+		vkEndCommandBuffer(secondaryBuffer);
+		secondaryBuffers[task] = secondaryBuffer;
+	});
+
+	// Runs the ranges in the order they were in the list
+	vkCmdExecuteCommands(commandBuffer, (uint32_t)secondaryBuffers.size(), secondaryBuffers.data());
+
+	for (int taskDrawCall : taskDrawCalls)
+	{
+		drawCallCount += taskDrawCall;
+	}
+	spriteCount += (int)queuedSprites.size();
+	queuedSprites.clear();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Drops anything still queued
+*/
+/*************************************************************************************************/
+void SpriteBatch::Free()
+{
+	queuedSprites.clear();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Fills in an instance's transform rows from a transformation matrix
+
+	\param instance
+		The instance to fill in
+
+	\param transform
+		The transformation matrix. Only the affine part is kept
+*/
+/*************************************************************************************************/
+void SpriteBatch::SetTransform(Instance& instance, const glm::mat4& transform)
+{
+	// glm is column major, so each row is picked out of the four columns
+	for (int row = 0; row < 3; row++)
+	{
+		instance.transformRows[row] = glm::vec4(transform[0][row], transform[1][row], transform[2][row], transform[3][row]);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Gets the description that tells vulkan how to step through the instance buffer
+
+	\return
+		The description struct
+*/
+/*************************************************************************************************/
+VkVertexInputBindingDescription SpriteBatch::GetBindingDescription()
+{
+	// Instances sit in binding 1 next to the quad's vertices and advance once per sprite
+	VkVertexInputBindingDescription bindingDescription{};
+	bindingDescription.binding = 1;
+	bindingDescription.stride = sizeof(Instance);
+	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+	return bindingDescription;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Defines how instances are laid out in memory
+
+	\return
+		The description structs (transform rows, color, uv rect, then draw mode, overlay layer and texture slot)
+*/
+/*************************************************************************************************/
+std::array<VkVertexInputAttributeDescription, 6> SpriteBatch::GetAttributeDescriptions()
+{
+	std::array<VkVertexInputAttributeDescription, 6> attributeDescriptions{};
+
+	// The three transform rows follow the vertex attributes at locations 3 to 5
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		attributeDescriptions[i].binding = 1;
+		attributeDescriptions[i].location = 3 + i;
+		attributeDescriptions[i].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		attributeDescriptions[i].offset = offsetof(Instance, transformRows) + sizeof(glm::vec4) * i;
+	}
+
+	// The color as a vec4
+	attributeDescriptions[3].binding = 1;
+	attributeDescriptions[3].location = 6;
+	attributeDescriptions[3].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+	attributeDescriptions[3].offset = offsetof(Instance, color);
+
+	// The uv rect as a vec4
+	attributeDescriptions[4].binding = 1;
+	attributeDescriptions[4].location = 7;
+	attributeDescriptions[4].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+	attributeDescriptions[4].offset = offsetof(Instance, uvRect);
+
+	// The draw mode, overlay layer and texture slot together as a uvec3
+	attributeDescriptions[5].binding = 1;
+	attributeDescriptions[5].location = 8;
+	attributeDescriptions[5].format = VK_FORMAT_R32G32B32_UINT;
+	attributeDescriptions[5].offset = offsetof(Instance, drawMode);
+
+	return attributeDescriptions;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
@@ -0,0 +1,295 @@
+/*************************************************************************************************/
+/*!
+\file SpriteBatch.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Collects the sprites drawn each frame and records them as instanced draws. Every sprite is
+	one instance of the shared quad, so the number of draw calls follows the number of texture
+	switches instead of the number of objects. Large flushes are split across the command
+	recorder's threads, each recording its share into a secondary command buffer
+
+    Public Functions:
+        + SpriteBatch
+		+ ~SpriteBatch
+		+ Init
+		+ BeginFrame
+		+ Add
+		+ Flush
+		+ Free
+		+ SetTransform
+		+ GetBindingDescription
+		+ GetAttributeDescriptions
+		+ GetSpriteCount
+		+ GetDrawCallCount
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_SpriteBatch_H_
+#define Syncopatience_SpriteBatch_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glm libraries for the instance transforms
+#include <glm/glm.hpp>
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The queued sprites and instance memory
+#include <vector>
+#include <array>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+class FrameAllocator;
+class CommandRecorder;
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The sprite batch class
+*/
+/*************************************************************************************************/
+class SpriteBatch
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// The per sprite data the 2d vertex shader reads. Laid out to match SpriteBatch::GetAttributeDescriptions
+	typedef struct
+	{
+		glm::vec4 transformRows[3];				// The top three rows of the sprite's affine transform
+		glm::vec4 color;						// The color the sprite is tinted
+		glm::vec4 uvRect;						// The offset (xy) and size (zw) of the part of the texture the sprite shows
+		uint32_t drawMode;						// How the shaders treat the sprite (see Window::DrawMode)
+		uint32_t overlayLayer;					// Which tile debug overlay layer is drawn, only used by the overlay
+		uint32_t textureSlot;					// The sprite's slot in the texture table, ignored without the table
+		uint32_t padding;						// Keeps the stride a multiple of 16 bytes
+	}Instance;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the sprite batch class
+	*/
+	/*************************************************************************************************/
+	SpriteBatch();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the sprite batch class
+	*/
+	/*************************************************************************************************/
+	~SpriteBatch();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets up the batch
+
+		\param frameAllocator_
+			Where each frame's instances are written
+
+		\param commandRecorder_
+			The threads and secondary command buffers flushes are recorded with
+
+		\param quadVertexBuffer_
+			The vertex buffer of the quad every sprite is drawn with
+
+		\param quadIndexBuffer_
+			The 16 bit index buffer of the quad
+
+		\param quadIndexCount_
+			The number of indices in the quad
+	*/
+	/*************************************************************************************************/
+	void Init(FrameAllocator* frameAllocator_, CommandRecorder* commandRecorder_, VkBuffer quadVertexBuffer_, VkBuffer quadIndexBuffer_, uint32_t quadIndexCount_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Starts a new frame, after the frame allocator has moved on to it
+	*/
+	/*************************************************************************************************/
+	void BeginFrame();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Queues a sprite to be drawn on the next flush
+
+		\param instance
+			The sprite's instance data
+
+		\param texture
+			The descriptor set of the sprite's texture. The same for every sprite when using the texture table
+
+		\param drawPriority
+			The sprite's draw priority. Sprites are only reordered among neighbors with the same priority
+	*/
+	/*************************************************************************************************/
+	void Add(const Instance& instance, VkDescriptorSet texture, int drawPriority);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Records everything queued into the command recorder's current pass. Sorts each run of
+			sprites with the same priority by texture, splits the list into contiguous ranges for
+			the recording threads, then runs their secondary command buffers in order
+
+		\param commandBuffer
+			The primary command buffer being recorded, inside a pass begun for secondary command buffers
+	*/
+	/*************************************************************************************************/
+	void Flush(VkCommandBuffer commandBuffer);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Drops anything still queued
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Fills in an instance's transform rows from a transformation matrix
+
+		\param instance
+			The instance to fill in
+
+		\param transform
+			The transformation matrix. Only the affine part is kept
+	*/
+	/*************************************************************************************************/
+	static void SetTransform(Instance& instance, const glm::mat4& transform);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Gets the description that tells vulkan how to step through the instance buffer
+
+		\return
+			The description struct
+	*/
+	/*************************************************************************************************/
+	static VkVertexInputBindingDescription GetBindingDescription();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Defines how instances are laid out in memory
+
+		\return
+			The description structs (transform rows, color, uv rect, then draw mode, overlay layer and texture slot)
+	*/
+	/*************************************************************************************************/
+	static std::array<VkVertexInputAttributeDescription, 6> GetAttributeDescriptions();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many sprites were drawn since the frame began
+
+		\return
+			The sprite count
+	*/
+	/*************************************************************************************************/
+	int GetSpriteCount() { return spriteCount; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many draw calls were recorded since the frame began
+
+		\return
+			The draw call count
+	*/
+	/*************************************************************************************************/
+	int GetDrawCallCount() { return drawCallCount; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	const size_t SPRITES_PER_THREAD = 2048;		// Fewest sprites worth handing a recording thread
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// A sprite waiting for the next flush
+	typedef struct
+	{
+		Instance instance;						// The sprite's instance data
+		VkDescriptorSet texture;				// The sprite's texture
+		int drawPriority;						// The sprite's draw priority
+	}QueuedSprite;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	std::vector<QueuedSprite> queuedSprites;	// Sprites waiting for the next flush
+	FrameAllocator* frameAllocator;				// Where each frame's instances are written
+	CommandRecorder* commandRecorder;			// The threads flushes are recorded on
+
+	VkBuffer quadVertexBuffer;					// The quad every sprite is drawn with
+	VkBuffer quadIndexBuffer;					// The quad's indices
+	uint32_t quadIndexCount;					// The number of indices in the quad
+
+	int spriteCount;							// Sprites drawn since the frame began
+	int drawCallCount;							// Draw calls recorded since the frame began
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_SpriteBatch_H_
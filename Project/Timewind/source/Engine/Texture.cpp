@@ -72,7 +72,8 @@ Texture::Texture(std::string filename_)
 	// Loads in the texture
 	int texWidth, texHeight, texChannels;
 	stbi_uc* pixels = stbi_load(filename.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-	VkDeviceSize imageSize = (uint64_t)texWidth * texHeight * 4;
+	width = texWidth;
+	height = texHeight;
 
 	// Checks that an image was loaded in this way
 	if (!pixels)
@@ -80,29 +81,14 @@ Texture::Texture(std::string filename_)
 		std::cout << "Failed to load image: " << filename << std::endl;
 	}
 
-	// Creates a buffer in memory for the texture buffer
-	_Window->CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, textureBuffer, textureBufferMemory);
-
-	// Copies the image data over to the buffer
-	void* data;
-	vkMapMemory(_Window->GetLogicalDevice(), textureBufferMemory, 0, imageSize, 0, &data);
-	memcpy(data, pixels, static_cast<size_t>(imageSize));
-	vkUnmapMemory(_Window->GetLogicalDevice(), textureBufferMemory);
-
-	// Frees up stb image
-	stbi_image_free(pixels);
-
 	// Creates the image object
 	CreateImage(texWidth, texHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
 
-	// Transitions the texture buffer data to the image
-	TransitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	CopyBufferToImage(textureBuffer, textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-	TransitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	// Stages the pixels in the uploader's current batch, which copies them so stb image can let go
+	_Window->GetTextureUploader()->Upload(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, pixels, (uint32_t)texWidth, 4, { 0, 0 }, { (uint32_t)texWidth, (uint32_t)texHeight });
 
-	// Cleans up the texture buffer
-	vkDestroyBuffer(_Window->GetLogicalDevice(), textureBuffer, NULL);
-	vkFreeMemory(_Window->GetLogicalDevice(), textureBufferMemory, NULL);
+	// Frees up stb image
+	stbi_image_free(pixels);
 
 	// Constructs the image view object
 	textureImageView = _Window->CreateImageView(textureImage, VK_FORMAT_R8G8B8A8_SRGB);
@@ -136,20 +122,14 @@ Texture::Texture(std::string filename_)
 /*************************************************************************************************/
 Texture::Texture(int textureWidth, int textureHeight, VkFormat imageFormat)
 {
-	// Creates a buffer in memory for the texture buffer
-	_Window->CreateBuffer(textureWidth * textureHeight * 4, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, textureBuffer, textureBufferMemory);
+	width = textureWidth;
+	height = textureHeight;
 
 	// Creates the image object
 	CreateImage(textureWidth, textureHeight, imageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
 
-	// Transitions the texture buffer data to the image
-	TransitionImageLayout(textureImage, imageFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	CopyBufferToImage(textureBuffer, textureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
-	TransitionImageLayout(textureImage, imageFormat, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	// Cleans up the texture buffer
-	vkDestroyBuffer(_Window->GetLogicalDevice(), textureBuffer, NULL);
-	vkFreeMemory(_Window->GetLogicalDevice(), textureBufferMemory, NULL);
+	// There are no pixels yet, so the uploader only moves the image into a readable layout
+	_Window->GetTextureUploader()->Upload(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, NULL, 0, 4, { 0, 0 }, { (uint32_t)textureWidth, (uint32_t)textureHeight });
 
 	// Constructs the image view object
 	textureImageView = _Window->CreateImageView(textureImage, imageFormat);
@@ -188,27 +168,16 @@ Texture::Texture(int textureWidth, int textureHeight, VkFormat imageFormat)
 /*************************************************************************************************/
 Texture::Texture(int textureWidth, int textureHeight, uint8_t* buffer)
 {
-	// Creates a buffer in memory for the texture buffer
-	VkDeviceSize imageSize = textureWidth * textureHeight;
-	_Window->CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, textureBuffer, textureBufferMemory);
-
-	// Copies the image data over to the buffer
-	void* data;
-	vkMapMemory(_Window->GetLogicalDevice(), textureBufferMemory, 0, imageSize, 0, &data);
-	memcpy(data, buffer, static_cast<size_t>(imageSize));
-	vkUnmapMemory(_Window->GetLogicalDevice(), textureBufferMemory);
+	// Single channel, one byte per pixel
+	width = textureWidth;
+	height = textureHeight;
+	pixelSize = 1;
 
 	// Creates the image object
 	CreateImage(textureWidth, textureHeight, VK_FORMAT_R8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
 
-	// Transitions the texture buffer data to the image
-	TransitionImageLayout(textureImage, VK_FORMAT_R8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	CopyBufferToImage(textureBuffer, textureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
-	TransitionImageLayout(textureImage, VK_FORMAT_R8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-	// Cleans up the texture buffer
-	vkDestroyBuffer(_Window->GetLogicalDevice(), textureBuffer, NULL);
-	vkFreeMemory(_Window->GetLogicalDevice(), textureBufferMemory, NULL);
+	// Stages the pixels in the uploader's current batch
+	_Window->GetTextureUploader()->Upload(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, buffer, (uint32_t)textureWidth, 1, { 0, 0 }, { (uint32_t)textureWidth, (uint32_t)textureHeight });
 
 	// Constructs the image view object
 	textureImageView = _Window->CreateImageView(textureImage, VK_FORMAT_R8_UNORM);
@@ -219,12 +188,36 @@ Texture::Texture(int textureWidth, int textureHeight, uint8_t* buffer)
 	// Creates descriptor sets for the texture
 	CreateTextureDescriptorSet();
 
+	// Now that the texture has been created, turns off the freed flag
+	freed = false;
+
 	std::stringstream debugString;
 	debugString << "Texture: New texture loaded " << textureWidth << "x" << textureHeight;
 	_Debug->Print(Debug::MessageType::Debug, debugString.str());
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for a texture that lives in a texture atlas page. Holds no vulkan objects
+		of its own and draws from its page once the texture manager packs it
+
+	\param filename_
+		The name and location of the texture file
 
+	\param textureWidth
+		The width of the texture in pixels
+
+	\param textureHeight
+		The height of the texture in pixels
+*/
+/*************************************************************************************************/
+Texture::Texture(std::string filename_, int textureWidth, int textureHeight) : filename(filename_), width(textureWidth), height(textureHeight),
+	textureImage(NULL), textureImageMemory(), textureImageView(NULL), textureSampler(NULL),
+	descriptorSet(NULL), freed(true)
+{
+	// The page owns everything on the gpu, so there is nothing for this texture to free
+}
 
 /*************************************************************************************************/
 /*!
@@ -249,11 +242,21 @@ void Texture::Free()
 	// Checks that the texture hasn't already been freed
 	if (freed == false)
 	{
-		// Ends the render pass
+		// Ends the render pass, and finishes any upload that may still be writing to the image
 		_Window->WaitForDrawFinished();
-
-		// Cleans up the descriptor sets
-		vkFreeDescriptorSets(_Window->GetLogicalDevice(), _Window->GetDescriptorPool(), 1, &descriptorSet);
+		_Window->GetTextureUploader()->WaitIdle();
+		_Window->DropTextureUpdates(this);
+
+		// Cleans up the descriptor set, or gives back the texture's slot in the texture table
+		if (textureSlot >= 0)
+		{
+			_Window->GetTextureTable()->Unregister((uint32_t)textureSlot);
+			textureSlot = -1;
+		}
+		else
+		{
+			vkFreeDescriptorSets(_Window->GetLogicalDevice(), _Window->GetDescriptorPool(), 1, &descriptorSet);
+		}
 
 		// Cleans up the texture image view objects
 		vkDestroySampler(_Window->GetLogicalDevice(), textureSampler, NULL);
@@ -261,7 +264,7 @@ void Texture::Free()
 
 		// Cleans up the texture objects
 		vkDestroyImage(_Window->GetLogicalDevice(), textureImage, NULL);
-		vkFreeMemory(_Window->GetLogicalDevice(), textureImageMemory, NULL);
+		_Window->GetMemoryAllocator()->Release(textureImageMemory);
 
 		// Sets the freed flag
 		freed = true;
@@ -273,6 +276,66 @@ void Texture::Free()
 	}
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Overwrites a rectangle of a texture made from a buffer or an empty texture. Only the
+		rectangle is uploaded, so small changes to a large texture stay cheap. The new pixels
+		show up from the next frame drawn
+
+	\param buffer
+		The pixels of the whole texture, in the texture's own format
+
+	\param bufferWidth
+		The width in pixels of each row of the buffer
+
+	\param xOffset
+		The left edge of the rectangle
+
+	\param yOffset
+		The top edge of the rectangle
+
+	\param regionWidth
+		The width of the rectangle
+
+	\param regionHeight
+		The height of the rectangle
+*/
+/*************************************************************************************************/
+void Texture::UpdatePixels(const uint8_t* buffer, int bufferWidth, int xOffset, int yOffset, int regionWidth, int regionHeight)
+{
+	// Nothing to upload
+	if (regionWidth <= 0 || regionHeight <= 0)
+	{
+		return;
+	}
+
+	// Only the rectangle is copied, at the start of the next frame's command buffer. Barriers there
+	// keep it behind the frames still sampling the texture, so nothing here waits for the GPU
+	const uint8_t* regionStart = buffer + ((size_t)yOffset * bufferWidth + xOffset) * pixelSize;
+	_Window->UpdateTextureRegion(this, regionStart, (uint32_t)bufferWidth, { xOffset, yOffset }, { (uint32_t)regionWidth, (uint32_t)regionHeight });
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the descriptor set to bind when drawing with the texture
+
+	\return
+		The texture table when it's in use, otherwise the texture's own (or its atlas page's) set
+*/
+/*************************************************************************************************/
+VkDescriptorSet* Texture::GetDescriptorSet()
+{
+	// Every texture shares the table, so sprites with different textures still batch together
+	if (_Window->GetTextureTable()->IsEnabled())
+	{
+		return _Window->GetTextureTable()->GetDescriptorSet();
+	}
+
+	return atlasPage ? atlasPage->GetDescriptorSet() : &descriptorSet;
+}
+
 //-------------------------------------------------------------------------------------------------
 // Private Function Definitions
 //-------------------------------------------------------------------------------------------------
@@ -304,7 +367,7 @@ void Texture::Free()
 			Output: The image texture
 
 		\param imageMemory
-			Output: The image pointer in memory
+			Output: The memory the image is bound to
 	*/
 	/*********************************************************************************************/
 void Texture::CreateImage(
@@ -314,7 +377,7 @@ void Texture::CreateImage(
 	VkImageUsageFlags usage,
 	VkMemoryPropertyFlags properties,
 	VkImage& image,
-	VkDeviceMemory& imageMemory)
+	MemoryAllocator::Allocation& imageMemory)
 {
 	// Creates the texture image object info struct
 	VkImageCreateInfo imageInfo{};
@@ -329,7 +392,12 @@ void Texture::CreateImage(
 	imageInfo.tiling = tiling;
 	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 	imageInfo.usage = usage;
-	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	// Shares the image with the transfer queue when uploads run there, so no ownership transfer is needed
+	const std::vector<uint32_t>& sharingFamilies = _Window->GetTextureUploader()->GetSharingFamilies();
+	imageInfo.sharingMode = sharingFamilies.empty() ? VK_SHARING_MODE_EXCLUSIVE : VK_SHARING_MODE_CONCURRENT;
+	imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharingFamilies.size());
+	imageInfo.pQueueFamilyIndices = sharingFamilies.data();
 	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 
 	// Creates the texture image object
@@ -342,144 +410,11 @@ void Texture::CreateImage(
 	VkMemoryRequirements memRequirements;
 	vkGetImageMemoryRequirements(_Window->GetLogicalDevice(), image, &memRequirements);
 
-	// Allocates the memory for the texture image
-	VkMemoryAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = _Window->FindMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-	// Allocates the memory
-	if (vkAllocateMemory(_Window->GetLogicalDevice(), &allocInfo, NULL, &imageMemory) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to allocate image memory!");
-	}
+	// Takes a piece of one of the memory allocator's blocks, kept apart from buffers if the card needs it
+	imageMemory = _Window->GetMemoryAllocator()->Allocate(memRequirements, properties, 0, tiling == VK_IMAGE_TILING_OPTIMAL);
 
 	// Binds the texture image into memory
-	vkBindImageMemory(_Window->GetLogicalDevice(), image, imageMemory, 0);
-}
-
-/*********************************************************************************************/
-/*!
-	\brief
-		Makes sure image data is formatted correctly to be written to the screen
-
-	\param image
-		The image being formatted
-
-	\param format
-		The format for the image
-
-	\param oldLayout
-		The old data layout
-
-	\param newLayout
-		The new data layout
-*/
-/*********************************************************************************************/
-void Texture::TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
-{
-	// Starts the command buffer
-	VkCommandBuffer commandBuffer = _Window->BeginSingleTimeCommands();
-
-	// Defines the data barrier to be overcome
-	VkImageMemoryBarrier barrier{};
-	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-	barrier.oldLayout = oldLayout;
-	barrier.newLayout = newLayout;
-	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-	barrier.image = image;
-	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	barrier.subresourceRange.baseMipLevel = 0;
-	barrier.subresourceRange.levelCount = 1;
-	barrier.subresourceRange.baseArrayLayer = 0;
-	barrier.subresourceRange.layerCount = 1;
-
-	// Sets the start and end points
-	VkPipelineStageFlags sourceStage;
-	VkPipelineStageFlags destinationStage;
-
-	// Determines undefined transition
-	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-	{
-		// Sets the transition properties for undefined
-		barrier.srcAccessMask = 0;
-		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-	}
-	// Determines destination transition
-	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-	{
-		// Sets the transition properties for destination transitions
-		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-	}
-	// Otherwise we can't handle the image
-	else
-	{
-		throw std::invalid_argument("unsupported layout transition!");
-	}
-
-	// Trans Rights
-	vkCmdPipelineBarrier(
-		commandBuffer,
-		sourceStage, destinationStage,
-		0,
-		0, NULL,
-		0, NULL,
-		1, &barrier);
-
-	// Closes the command buffer
-	_Window->EndSingleTimeCommands(commandBuffer);
-}
-
-/*********************************************************************************************/
-/*!
-	\brief
-		Converts the given buffer data into a Vulkan image
-
-	\param buffer
-		The given buffer data
-
-	\param image
-		The vulkan image converted to
-
-	\param width
-		The width the image
-
-	\param height
-		The height of the image
-*/
-/*********************************************************************************************/
-void Texture::CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
-{
-	// Opens a command buffer
-	VkCommandBuffer commandBuffer_ = _Window->BeginSingleTimeCommands();
-
-	// Defines what part of the buffer to copy
-	VkBufferImageCopy region{};
-	region.bufferOffset = 0;
-	region.bufferRowLength = 0;
-	region.bufferImageHeight = 0;
-	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-	region.imageSubresource.mipLevel = 0;
-	region.imageSubresource.baseArrayLayer = 0;
-	region.imageSubresource.layerCount = 1;
-	region.imageOffset = { 0, 0, 0 };
-	region.imageExtent = {
-		width,
-		height,
-		1
-	};
-
-	// Copies the buffer
-	vkCmdCopyBufferToImage(commandBuffer_, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-	// Closes the command buffer
-	_Window->EndSingleTimeCommands(commandBuffer_);
+	_Window->CheckVulkanSuccess(vkBindImageMemory(_Window->GetLogicalDevice(), image, imageMemory.memory, imageMemory.offset), "failed to bind image memory!");
 }
 
 /*********************************************************************************************/
@@ -520,11 +455,19 @@ void Texture::CreateTextureSampler()
 /*********************************************************************************************/
 /*!
 	\brief
-		Creates a descriptor set for the texture
+		Creates a descriptor set for the texture, or registers it in the texture table when that's in use
 */
 /*********************************************************************************************/
 void Texture::CreateTextureDescriptorSet()
 {
+	// With the texture table the texture only needs a slot in it
+	if (_Window->GetTextureTable()->IsEnabled())
+	{
+		textureSlot = (int)_Window->GetTextureTable()->Register(textureImageView, textureSampler);
+		descriptorSet = VK_NULL_HANDLE;
+		return;
+	}
+
 	// Creates an info block to allocate the descriptor set structure
 	VkDescriptorSetAllocateInfo allocInfo{};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
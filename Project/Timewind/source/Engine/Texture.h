@@ -28,6 +28,9 @@ Copyright (c) 2023 Aiden Cvengros
 // has the string class for filenames
 #include <string>
 
+// Includes glm for the atlas uv rect
+#include <glm/glm.hpp>
+
 // Includes glfw library for texture management
 #define VK_USE_PLATFORM_WIN32_KHR
 #define GLFW_INCLUDE_VULKAN
@@ -35,6 +38,9 @@ Copyright (c) 2023 Aiden Cvengros
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
 
+// The memory behind the texture's buffers and image
+#include "MemoryAllocator.h"
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
@@ -120,6 +126,24 @@ public:
 	/*************************************************************************************************/
 	Texture(int textureWidth, int textureHeight, uint8_t* buffer);
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for a texture that lives in a texture atlas page. Holds no vulkan objects
+			of its own and draws from its page once the texture manager packs it
+
+		\param filename_
+			The name and location of the texture file
+
+		\param textureWidth
+			The width of the texture in pixels
+
+		\param textureHeight
+			The height of the texture in pixels
+	*/
+	/*************************************************************************************************/
+	Texture(std::string filename_, int textureWidth, int textureHeight);
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -139,13 +163,99 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Returns whether the game object should be rendered
+			Overwrites a rectangle of a texture made from a buffer or an empty texture. Only the
+			rectangle is uploaded, so small changes to a large texture stay cheap. The new pixels
+			show up from the next frame drawn
+
+		\param buffer
+			The pixels of the whole texture, in the texture's own format
+
+		\param bufferWidth
+			The width in pixels of each row of the buffer
+
+		\param xOffset
+			The left edge of the rectangle
+
+		\param yOffset
+			The top edge of the rectangle
+
+		\param regionWidth
+			The width of the rectangle
+
+		\param regionHeight
+			The height of the rectangle
+	*/
+	/*************************************************************************************************/
+	void UpdatePixels(const uint8_t* buffer, int bufferWidth, int xOffset, int yOffset, int regionWidth, int regionHeight);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the descriptor set to bind when drawing with the texture
+
+		\return
+			The texture table when it's in use, otherwise the texture's own (or its atlas page's) set
+	*/
+	/*************************************************************************************************/
+	VkDescriptorSet* GetDescriptorSet();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the texture's slot in the window's texture table
+
+		\return
+			The slot the shaders read the texture from. Always 0 without the texture table
+	*/
+	/*************************************************************************************************/
+	uint32_t GetTextureSlot() { return atlasPage ? atlasPage->GetTextureSlot() : (textureSlot < 0 ? 0 : (uint32_t)textureSlot); }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Places the texture in an atlas page
+
+		\param atlasPage_
+			The page the texture was packed into
+
+		\param uvRect_
+			The offset (xy) and size (zw) of the texture within the page in uv coordinates
+	*/
+	/*************************************************************************************************/
+	void SetAtlasRegion(Texture* atlasPage_, glm::vec4 uvRect_) { atlasPage = atlasPage_; uvRect = uvRect_; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the part of the descriptor set's image this texture covers
+
+		\return
+			The offset (xy) and size (zw) in uv coordinates. The whole image unless packed in an atlas
+	*/
+	/*************************************************************************************************/
+	glm::vec4 GetUVRect() { return uvRect; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the width of the texture
+
+		\return
+			The width in pixels
+	*/
+	/*************************************************************************************************/
+	int GetWidth() { return width; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the height of the texture
 
 		\return
-			Whether the game object should be rendered
+			The height in pixels
 	*/
 	/*************************************************************************************************/
-	VkDescriptorSet* GetDescriptorSet() { return &descriptorSet; }
+	int GetHeight() { return height; }
 
 	/*************************************************************************************************/
 	/*!
@@ -158,6 +268,28 @@ public:
 	/*************************************************************************************************/
 	VkImageView& GetImageView() { return textureImageView; }
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the texture's image object
+
+		\return
+			The texture's image, NULL for textures drawn from an atlas page
+	*/
+	/*************************************************************************************************/
+	VkImage GetImage() { return textureImage; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many bytes each of the texture's pixels takes
+
+		\return
+			The pixel size
+	*/
+	/*************************************************************************************************/
+	int GetPixelSize() { return pixelSize; }
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -195,16 +327,21 @@ private:
 	//---------------------------------------------------------------------------------------------
 	
 	std::string filename;						// The name of the texture file
+	int width = 0;								// The width of the texture in pixels
+	int height = 0;								// The height of the texture in pixels
+	int pixelSize = 4;							// The number of bytes in each pixel
+
+	Texture* atlasPage = NULL;					// The atlas page this texture was packed into, if any
+	glm::vec4 uvRect = { 0.0f, 0.0f, 1.0f, 1.0f };	// The part of the image this texture covers
 
-	VkBuffer textureBuffer;						// The buffer that holds loaded textures
-	VkDeviceMemory textureBufferMemory;			// The memory pointer for the texture buffer
 	VkImage textureImage;						// The image texture
-	VkDeviceMemory textureImageMemory;			// The memory pointer to the image texture
+	MemoryAllocator::Allocation textureImageMemory;	// The memory for the image texture
 
 	VkImageView textureImageView;				// The image view object for textures
 	VkSampler textureSampler;					// The texture image sampler
 	
-	VkDescriptorSet descriptorSet;				// The base descriptor set memory
+	VkDescriptorSet descriptorSet;				// The base descriptor set memory, only used without the texture table
+	int textureSlot = -1;						// The texture's slot in the texture table, -1 if it isn't in it
 
 	bool freed;									// Ticks true if the texture has been freed
 
@@ -239,7 +376,7 @@ private:
 			Output: The image texture
 
 		\param imageMemory
-			Output: The image pointer in memory
+			Output: The memory the image is bound to
 	*/
 	/*********************************************************************************************/
 	void CreateImage(
@@ -249,47 +386,7 @@ private:
 		VkImageUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkImage& image,
-		VkDeviceMemory& imageMemory);
-
-	/*********************************************************************************************/
-	/*!
-		\brief
-			Makes sure image data is formatted correctly to be written to the screen
-	
-		\param image
-			The image being formatted
-	
-		\param format
-			The format for the image
-	
-		\param oldLayout
-			The old data layout
-	
-		\param newLayout
-			The new data layout
-	*/
-	/*********************************************************************************************/
-	void TransitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-
-	/*********************************************************************************************/
-	/*!
-		\brief
-			Converts the given buffer data into a Vulkan image
-	
-		\param buffer
-			The given buffer data
-	
-		\param image
-			The vulkan image converted to
-	
-		\param width
-			The width the image
-	
-		\param height
-			The height of the image
-	*/
-	/*********************************************************************************************/
-	void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
+		MemoryAllocator::Allocation& imageMemory);
 
 	/*********************************************************************************************/
 	/*!
@@ -302,7 +399,7 @@ private:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Creates a descriptor set for the texture
+			Creates a descriptor set for the texture, or registers it in the texture table when that's in use
 	*/
 	/*********************************************************************************************/
 	void CreateTextureDescriptorSet();
@@ -5,11 +5,18 @@
 \par email: ajcvengros\@gmail.com
 \date 2024.5.7
 \brief
-    Manages textures and ensures that multiple textures of the same file don't get created
+    Manages textures and ensures that multiple textures of the same file don't get created. Small
+	sprites are packed into shared atlas pages so objects using different sprites can still be
+	drawn together
 
     Functions include:
         + System::System
 		+ Systme::~System
+		+ TextureManager::BeginAtlasBatch
+		+ TextureManager::PackAtlases
+		+ TextureManager::FindAtlasSpot
+		+ TextureManager::PlaceInAtlas
+		+ TextureManager::CopyIntoAtlas
 
 Copyright (c) 2023 Aiden Cvengros
 */
@@ -26,12 +33,30 @@ Copyright (c) 2023 Aiden Cvengros
 // Additional includes
 #include "Texture.h"
 #include "Font.h"
+#include "Window.h"
 #include <sstream>
 
+// Reads sprites from disk to pack them
+#include <stb_image.h>
+
+// Sorting sprites before packing
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
+// The width and height of each atlas page in pixels
+const int atlasPageSize = 1024;
+
+// Sprites bigger than this in either direction keep a texture of their own
+const int maxAtlasSpriteSize = 256;
+
+// The pixels repeated around each sprite in a page so filtering doesn't bleed between sprites
+const int atlasPadding = 2;
+
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
 //-------------------------------------------------------------------------------------------------
@@ -58,7 +83,7 @@ Copyright (c) 2023 Aiden Cvengros
 		Constructor for the texture manager class
 */
 /*************************************************************************************************/
-TextureManager::TextureManager() : System(SystemTypes::textureManager), textureList(), defaultFont(NULL)
+TextureManager::TextureManager() : System(SystemTypes::textureManager), textureList(), defaultFont(NULL), batchingAtlas(false)
 {
 	
 }
@@ -88,7 +113,7 @@ void TextureManager::Init()
 /*************************************************************************************************/
 /*!
 	\brief
-		Empties the texture list
+		Empties the texture list. Fonts are kept, since every scene uses the same few
 */
 /*************************************************************************************************/
 void TextureManager::Clear()
@@ -101,18 +126,26 @@ void TextureManager::Clear()
 		it++;
 	}
 
-	// Walks through the font list
-	for (auto it = fontList.begin(); it != fontList.end();)
+	// Drops any sprites that never got packed
+	for (PendingSprite& sprite : pendingSprites)
 	{
-		// Frees the font
-		delete* it;
-		it++;
+		stbi_image_free(sprite.pixels);
 	}
+	pendingSprites.clear();
+
+	// Frees the atlas pages now that nothing is drawing from them
+	for (AtlasPage& page : atlasPages)
+	{
+		delete page.texture;
+	}
+	atlasPages.clear();
 
 	// Clears the texture list
 	textureList.clear();
-	fontList.clear();
-	defaultFont = NULL;
+
+	// Most of the memory was textures, so blocks that emptied out go back to the driver
+	_Window->GetMemoryAllocator()->Defragment();
+	_Window->GetMemoryAllocator()->PrintStatistics();
 
 	_Debug->Print(Debug::MessageType::Debug, "Texture manager cleared");
 }
@@ -126,6 +159,16 @@ void TextureManager::Clear()
 void TextureManager::Shutdown()
 {
 	Clear();
+
+	// Walks through the font list
+	for (auto it = fontList.begin(); it != fontList.end();)
+	{
+		// Frees the font
+		delete* it;
+		it++;
+	}
+	fontList.clear();
+	defaultFont = NULL;
 }
 
 /*************************************************************************************************/
@@ -164,6 +207,28 @@ Texture* TextureManager::AddTexture(std::string filename_)
 	// If the file has not been loaded yet
 	else
 	{
+		// Small sprites go in an atlas page instead of getting their own texture
+		int texWidth, texHeight, texChannels;
+		if (stbi_info(filename_.c_str(), &texWidth, &texHeight, &texChannels) && texWidth <= maxAtlasSpriteSize && texHeight <= maxAtlasSpriteSize)
+		{
+			stbi_uc* pixels = stbi_load(filename_.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+			if (pixels)
+			{
+				// Hands out the texture now and places it in a page on the next pack
+				Texture* newTexture = new Texture(filename_, texWidth, texHeight);
+				textureList.push_back(newTexture);
+				pendingSprites.push_back({ newTexture, pixels });
+
+				// Outside of a batch the sprite has to be usable right away
+				if (!batchingAtlas)
+				{
+					PackAtlases();
+				}
+
+				return newTexture;
+			}
+		}
+
 		// Creates the new texture
 		Texture* newTexture = new Texture(filename_);
 
@@ -219,6 +284,268 @@ Font* TextureManager::AddFont(std::string filename_)
 	}
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Holds small sprites added from here on until PackAtlases, so a whole scene's sprites are
+		packed together instead of one at a time
+*/
+/*************************************************************************************************/
+void TextureManager::BeginAtlasBatch()
+{
+	batchingAtlas = true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Packs every sprite waiting for an atlas, tallest first, into the free space of the
+		existing pages, making new pages as needed. Ends the batch started by BeginAtlasBatch
+*/
+/*************************************************************************************************/
+void TextureManager::PackAtlases()
+{
+	batchingAtlas = false;
+	if (pendingSprites.empty())
+	{
+		return;
+	}
+
+	// Packing the tallest sprites first keeps the skyline flat
+	std::stable_sort(pendingSprites.begin(), pendingSprites.end(), [](const PendingSprite& a, const PendingSprite& b)
+		{ return a.texture->GetHeight() > b.texture->GetHeight(); });
+
+	// The rows of each page that need uploading
+	std::vector<int> dirtyTop(atlasPages.size(), INT_MAX);
+	std::vector<int> dirtyBottom(atlasPages.size(), 0);
+	int pagesBefore = (int)atlasPages.size();
+
+	for (PendingSprite& sprite : pendingSprites)
+	{
+		int slotWidth = sprite.texture->GetWidth() + atlasPadding * 2;
+		int slotHeight = sprite.texture->GetHeight() + atlasPadding * 2;
+
+		// Looks for room in the pages that already exist
+		int pageIndex = 0;
+		int segment = -1;
+		int slotX = 0;
+		int slotY = 0;
+		for (; pageIndex < (int)atlasPages.size(); pageIndex++)
+		{
+			segment = FindAtlasSpot(atlasPages[pageIndex], slotWidth, slotHeight, slotX, slotY);
+			if (segment >= 0)
+			{
+				break;
+			}
+		}
+
+		// Starts a new page if none of them had room
+		if (segment < 0)
+		{
+			AtlasPage newPage;
+			newPage.texture = new Texture(atlasPageSize, atlasPageSize, VK_FORMAT_R8G8B8A8_SRGB);
+			newPage.pixels.assign((size_t)atlasPageSize * atlasPageSize * 4, 0);
+			newPage.skyline.push_back({ 0, 0, atlasPageSize });
+			atlasPages.push_back(newPage);
+			dirtyTop.push_back(INT_MAX);
+			dirtyBottom.push_back(0);
+
+			pageIndex = (int)atlasPages.size() - 1;
+			segment = FindAtlasSpot(atlasPages[pageIndex], slotWidth, slotHeight, slotX, slotY);
+		}
+
+		// Claims the slot and copies the sprite in
+		AtlasPage& page = atlasPages[pageIndex];
+		PlaceInAtlas(page, segment, slotY, slotWidth, slotHeight);
+		CopyIntoAtlas(page, sprite, slotX, slotY);
+		dirtyTop[pageIndex] = std::min(dirtyTop[pageIndex], slotY);
+		dirtyBottom[pageIndex] = std::max(dirtyBottom[pageIndex], slotY + slotHeight);
+
+		// Points the texture at the sprite inside the padding
+		float pageSize = (float)atlasPageSize;
+		sprite.texture->SetAtlasRegion(page.texture, { (slotX + atlasPadding) / pageSize, (slotY + atlasPadding) / pageSize,
+			sprite.texture->GetWidth() / pageSize, sprite.texture->GetHeight() / pageSize });
+
+		stbi_image_free(sprite.pixels);
+	}
+
+	// Uploads the changed rows of each page in one go
+	for (int i = 0; i < (int)atlasPages.size(); i++)
+	{
+		if (dirtyTop[i] < dirtyBottom[i])
+		{
+			atlasPages[i].texture->UpdatePixels(atlasPages[i].pixels.data(), atlasPageSize, 0, dirtyTop[i], atlasPageSize, dirtyBottom[i] - dirtyTop[i]);
+		}
+	}
+
+	std::stringstream debugString;
+	debugString << "TextureManager: Packed " << pendingSprites.size() << " sprites into the atlas (" << atlasPages.size() - pagesBefore << " new pages, " << atlasPages.size() << " total)";
+	_Debug->Print(Debug::MessageType::Debug, debugString.str());
+
+	pendingSprites.clear();
+}
+
 //-------------------------------------------------------------------------------------------------
 // Private Function Definitions
 //-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds the highest spot on a page's skyline a rectangle fits in
+
+	\param page
+		The page to search
+
+	\param slotWidth
+		The width of the rectangle
+
+	\param slotHeight
+		The height of the rectangle
+
+	\param slotX
+		Set to the left edge of the spot
+
+	\param slotY
+		Set to the top edge of the spot
+
+	\return
+		The skyline segment the spot starts at, -1 if the rectangle doesn't fit
+*/
+/*************************************************************************************************/
+int TextureManager::FindAtlasSpot(AtlasPage& page, int slotWidth, int slotHeight, int& slotX, int& slotY)
+{
+	int bestSegment = -1;
+	int bestY = INT_MAX;
+
+	// Tries the rectangle's left edge at the start of each segment
+	for (int i = 0; i < (int)page.skyline.size(); i++)
+	{
+		int x = page.skyline[i].x;
+		if (x + slotWidth > atlasPageSize)
+		{
+			break;
+		}
+
+		// The rectangle has to sit below every segment it spans
+		int y = 0;
+		int widthLeft = slotWidth;
+		for (int j = i; widthLeft > 0; j++)
+		{
+			y = std::max(y, page.skyline[j].y);
+			widthLeft -= page.skyline[j].width;
+		}
+
+		// Keeps the spot that leaves the page filled the least far down
+		if (y + slotHeight <= atlasPageSize && y < bestY)
+		{
+			bestSegment = i;
+			bestY = y;
+			slotX = x;
+			slotY = y;
+		}
+	}
+
+	return bestSegment;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Lowers a page's skyline under a rectangle that was just placed
+
+	\param page
+		The page the rectangle was placed in
+
+	\param segment
+		The skyline segment the rectangle starts at
+
+	\param slotY
+		The top edge of the rectangle
+
+	\param slotWidth
+		The width of the rectangle
+
+	\param slotHeight
+		The height of the rectangle
+*/
+/*************************************************************************************************/
+void TextureManager::PlaceInAtlas(AtlasPage& page, int segment, int slotY, int slotWidth, int slotHeight)
+{
+	// The rectangle's bottom becomes a new segment
+	int slotX = page.skyline[segment].x;
+	page.skyline.insert(page.skyline.begin() + segment, { slotX, slotY + slotHeight, slotWidth });
+
+	// Trims or removes the segments the rectangle now covers
+	int slotRight = slotX + slotWidth;
+	int next = segment + 1;
+	while (next < (int)page.skyline.size() && page.skyline[next].x < slotRight)
+	{
+		int covered = slotRight - page.skyline[next].x;
+		if (covered >= page.skyline[next].width)
+		{
+			page.skyline.erase(page.skyline.begin() + next);
+		}
+		else
+		{
+			page.skyline[next].x += covered;
+			page.skyline[next].width -= covered;
+			break;
+		}
+	}
+
+	// Merges neighbors that ended up at the same height
+	for (int i = 0; i + 1 < (int)page.skyline.size();)
+	{
+		if (page.skyline[i].y == page.skyline[i + 1].y)
+		{
+			page.skyline[i].width += page.skyline[i + 1].width;
+			page.skyline.erase(page.skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Copies a sprite's pixels into a page, repeating its edges outward into the padding so
+		filtering at the sprite's border never picks up its neighbors
+
+	\param page
+		The page to copy into
+
+	\param sprite
+		The sprite being copied
+
+	\param slotX
+		The left edge of the sprite's slot, including padding
+
+	\param slotY
+		The top edge of the sprite's slot, including padding
+*/
+/*************************************************************************************************/
+void TextureManager::CopyIntoAtlas(AtlasPage& page, PendingSprite& sprite, int slotX, int slotY)
+{
+	int spriteWidth = sprite.texture->GetWidth();
+	int spriteHeight = sprite.texture->GetHeight();
+
+	// Each row of the slot takes the nearest row of the sprite
+	for (int row = -atlasPadding; row < spriteHeight + atlasPadding; row++)
+	{
+		int sourceRow = std::clamp(row, 0, spriteHeight - 1);
+		const uint8_t* source = sprite.pixels + (size_t)sourceRow * spriteWidth * 4;
+		uint8_t* destination = page.pixels.data() + ((size_t)(slotY + atlasPadding + row) * atlasPageSize + slotX + atlasPadding) * 4;
+
+		// Copies the sprite's row, then repeats its end pixels into the padding on each side
+		memcpy(destination, source, (size_t)spriteWidth * 4);
+		for (int column = 1; column <= atlasPadding; column++)
+		{
+			memcpy(destination - column * 4, source, 4);
+			memcpy(destination + (size_t)(spriteWidth - 1 + column) * 4, source + (size_t)(spriteWidth - 1) * 4, 4);
+		}
+	}
+}
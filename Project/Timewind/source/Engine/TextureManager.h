@@ -5,7 +5,9 @@
 \par email: ajcvengros\@gmail.com
 \date 2024.5.7
 \brief
-    Manages textures and ensures that multiple textures of the same file don't get created
+    Manages textures and ensures that multiple textures of the same file don't get created. Small
+	sprites are packed into shared atlas pages so objects using different sprites can still be
+	drawn together
 
     Public Functions:
         + System
@@ -14,8 +16,18 @@
 		+ Update
 		+ Draw
 		+ Shutdown
+		+ Clear
+		+ AddTexture
+		+ AddFont
+		+ GetDefaultFont
+		+ SetDefaultFont
+		+ BeginAtlasBatch
+		+ PackAtlases
 		
 	Private Functions:
+		+ FindAtlasSpot
+		+ PlaceInAtlas
+		+ CopyIntoAtlas
 
 Copyright (c) 2023 Aiden Cvengros
 */
@@ -38,6 +50,10 @@ Copyright (c) 2023 Aiden Cvengros
 // The list class to hold all the textures
 #include <list>
 
+// The atlas pages and the sprites waiting to be packed
+#include <vector>
+#include <cstdint>
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
@@ -125,7 +141,7 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Empties the texture list
+			Empties the texture list. Fonts are kept, since every scene uses the same few
 	*/
 	/*************************************************************************************************/
 	void Clear();
@@ -188,6 +204,24 @@ public:
 	/*************************************************************************************************/
 	void SetDefaultFont(Font* newFont) { defaultFont = newFont; }
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Holds small sprites added from here on until PackAtlases, so a whole scene's sprites are
+			packed together instead of one at a time
+	*/
+	/*************************************************************************************************/
+	void BeginAtlasBatch();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Packs every sprite waiting for an atlas, tallest first, into the free space of the
+			existing pages, making new pages as needed. Ends the batch started by BeginAtlasBatch
+	*/
+	/*************************************************************************************************/
+	void PackAtlases();
+
 private:
 	//---------------------------------------------------------------------------------------------
 	// Private Consts
@@ -197,6 +231,29 @@ private:
 	// Private Structures
 	//---------------------------------------------------------------------------------------------
 
+	// A stretch of an atlas page's skyline. Everything above y is taken from x to x + width
+	typedef struct
+	{
+		int x;									// The left edge of the stretch
+		int y;									// How far down the page is filled
+		int width;								// The width of the stretch
+	}SkylineSegment;
+
+	// A texture atlas page and the cpu copy of its pixels
+	typedef struct
+	{
+		Texture* texture;						// The page's gpu texture
+		std::vector<uint8_t> pixels;			// The page's pixels, four bytes each, stored row by row
+		std::vector<SkylineSegment> skyline;	// The bottom edge of the packed sprites, left to right
+	}AtlasPage;
+
+	// A sprite loaded from disk that hasn't been placed in a page yet
+	typedef struct
+	{
+		Texture* texture;						// The texture handed out for the sprite
+		uint8_t* pixels;						// The sprite's pixels from stb image
+	}PendingSprite;
+
 	//---------------------------------------------------------------------------------------------
 	// Private Variables
 	//---------------------------------------------------------------------------------------------
@@ -206,9 +263,83 @@ private:
 
 	Font* defaultFont;							// The default font to be used
 
+	std::vector<AtlasPage> atlasPages;			// The atlas pages of the loaded sprites
+	std::vector<PendingSprite> pendingSprites;	// Sprites waiting for the next pack
+	bool batchingAtlas;							// Whether sprites are being held for a batch
+
 	//---------------------------------------------------------------------------------------------
 	// Private Function Declarations
 	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds the highest spot on a page's skyline a rectangle fits in
+
+		\param page
+			The page to search
+
+		\param slotWidth
+			The width of the rectangle
+
+		\param slotHeight
+			The height of the rectangle
+
+		\param slotX
+			Set to the left edge of the spot
+
+		\param slotY
+			Set to the top edge of the spot
+
+		\return
+			The skyline segment the spot starts at, -1 if the rectangle doesn't fit
+	*/
+	/*************************************************************************************************/
+	int FindAtlasSpot(AtlasPage& page, int slotWidth, int slotHeight, int& slotX, int& slotY);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Lowers a page's skyline under a rectangle that was just placed
+
+		\param page
+			The page the rectangle was placed in
+
+		\param segment
+			The skyline segment the rectangle starts at
+
+		\param slotY
+			The top edge of the rectangle
+
+		\param slotWidth
+			The width of the rectangle
+
+		\param slotHeight
+			The height of the rectangle
+	*/
+	/*************************************************************************************************/
+	void PlaceInAtlas(AtlasPage& page, int segment, int slotY, int slotWidth, int slotHeight);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Copies a sprite's pixels into a page, repeating its edges outward into the padding so
+			filtering at the sprite's border never picks up its neighbors
+
+		\param page
+			The page to copy into
+
+		\param sprite
+			The sprite being copied
+
+		\param slotX
+			The left edge of the sprite's slot, including padding
+
+		\param slotY
+			The top edge of the sprite's slot, including padding
+	*/
+	/*************************************************************************************************/
+	void CopyIntoAtlas(AtlasPage& page, PendingSprite& sprite, int slotX, int slotY);
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -0,0 +1,331 @@
+/*************************************************************************************************/
+/*!
+\file TextureTable.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    A single descriptor set holding an array of every loaded texture. Textures are registered
+	into stable slots and sprites pick theirs by index, so the set is bound once per pass no
+	matter how many textures are drawn. Needs descriptor indexing support on the device
+
+    Functions include:
+        + TextureTable::TextureTable
+		+ TextureTable::~TextureTable
+		+ TextureTable::Init
+		+ TextureTable::Free
+		+ TextureTable::Register
+		+ TextureTable::Unregister
+		+ TextureTable::IsSupported
+		+ TextureTable::GetRequiredFeatures
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "TextureTable.h"
+#include "cppShortcuts.h"
+
+// Checking vulkan results
+#include "Window.h"
+
+// Clamping the table to the card's limits
+#include <algorithm>
+#include <cstring>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// The most textures the table holds, if the card allows that many
+const uint32_t maxTextureSlots = 4096;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the texture table class
+*/
+/*************************************************************************************************/
+TextureTable::TextureTable() : device(VK_NULL_HANDLE), descriptorSetLayout(VK_NULL_HANDLE), descriptorPool(VK_NULL_HANDLE), descriptorSet(VK_NULL_HANDLE),
+	capacity(0), nextUnusedSlot(0), freeSlots()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the texture table class
+*/
+/*************************************************************************************************/
+TextureTable::~TextureTable()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Creates the descriptor set layout, pool and set the table lives in. The logical device
+		must have been made with the descriptor indexing features IsSupported checks for
+
+	\param vkDevice
+		The logical device
+
+	\param physicalDevice
+		The graphics card, used to find how many textures the table can hold
+*/
+/*************************************************************************************************/
+void TextureTable::Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice)
+{
+	device = vkDevice;
+
+	// Sizes the table to what the card allows for sets that are updated after binding
+	VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+	indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+	VkPhysicalDeviceProperties2 properties{};
+	properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties.pNext = &indexingProperties;
+	vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+	capacity = std::min({ maxTextureSlots,
+		indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+		indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+		indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers });
+
+	// One binding holding the whole array. Slots can be empty, and written while the set is bound
+	// as long as the frames in flight don't use them
+	VkDescriptorSetLayoutBinding textureBinding{};
+	textureBinding.binding = 0;
+	textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	textureBinding.descriptorCount = capacity;
+	textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+	textureBinding.pImmutableSamplers = NULL;
+
+	VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+		VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+	bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	bindingFlagsInfo.bindingCount = 1;
+	bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = &bindingFlagsInfo;
+	layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &textureBinding;
+	_Window->CheckVulkanSuccess(vkCreateDescriptorSetLayout(device, &layoutInfo, NULL, &descriptorSetLayout), "failed to create texture table layout!");
+
+	// The pool only ever holds the table
+	VkDescriptorPoolSize poolSize{};
+	poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSize.descriptorCount = capacity;
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	poolInfo.maxSets = 1;
+	_Window->CheckVulkanSuccess(vkCreateDescriptorPool(device, &poolInfo, NULL, &descriptorPool), "failed to create texture table pool!");
+
+	// Makes the table
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = descriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &descriptorSetLayout;
+	_Window->CheckVulkanSuccess(vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet), "failed to allocate texture table!");
+
+	_Debug->Print(Debug::MessageType::Debug, "TextureTable: Bindless textures on with " + std::to_string(capacity) + " slots");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys the table. Every texture must have been unregistered or freed
+*/
+/*************************************************************************************************/
+void TextureTable::Free()
+{
+	if (device == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	// Destroying the pool frees the table with it
+	vkDestroyDescriptorPool(device, descriptorPool, NULL);
+	vkDestroyDescriptorSetLayout(device, descriptorSetLayout, NULL);
+	descriptorPool = VK_NULL_HANDLE;
+	descriptorSetLayout = VK_NULL_HANDLE;
+	descriptorSet = VK_NULL_HANDLE;
+	device = VK_NULL_HANDLE;
+
+	freeSlots.clear();
+	nextUnusedSlot = 0;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Puts a texture in the first free slot of the table
+
+	\param imageView
+		The texture's image view
+
+	\param sampler
+		The texture's sampler
+
+	\return
+		The slot the texture was put in
+*/
+/*************************************************************************************************/
+uint32_t TextureTable::Register(VkImageView imageView, VkSampler sampler)
+{
+	// Reuses a given back slot before handing out a new one
+	uint32_t slot;
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else if (nextUnusedSlot < capacity)
+	{
+		slot = nextUnusedSlot++;
+	}
+	else
+	{
+		throw std::runtime_error("texture table is full!");
+	}
+
+	// Writes the texture into its slot
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = imageView;
+	imageInfo.sampler = sampler;
+
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = descriptorSet;
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = slot;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
+	vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, NULL);
+
+	return slot;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Frees a slot to be reused. The texture must not be used by any frame still in flight
+
+	\param slot
+		The slot to free
+*/
+/*************************************************************************************************/
+void TextureTable::Unregister(uint32_t slot)
+{
+	// The old descriptor stays until the slot is reused, which is fine since the table is partially bound
+	freeSlots.push_back(slot);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks whether a graphics card supports everything the table needs
+
+	\param physicalDevice
+		The graphics card to check
+
+	\return
+		Whether the table can be used on the card
+*/
+/*************************************************************************************************/
+bool TextureTable::IsSupported(VkPhysicalDevice physicalDevice)
+{
+	// Querying the features needs vulkan 1.1
+	VkPhysicalDeviceProperties properties;
+	vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	if (properties.apiVersion < VK_API_VERSION_1_1)
+	{
+		return false;
+	}
+
+	// Looks for the descriptor indexing extension
+	uint32_t extensionCount;
+	vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionCount, NULL);
+	std::vector<VkExtensionProperties> extensions(extensionCount);
+	vkEnumerateDeviceExtensionProperties(physicalDevice, NULL, &extensionCount, extensions.data());
+	bool hasExtension = std::any_of(extensions.begin(), extensions.end(), [](const VkExtensionProperties& extension)
+		{ return strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0; });
+	if (!hasExtension)
+	{
+		return false;
+	}
+
+	// Checks the individual features the table uses
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+	indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	VkPhysicalDeviceFeatures2 features{};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	features.pNext = &indexingFeatures;
+	vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+	return indexingFeatures.shaderSampledImageArrayNonUniformIndexing && indexingFeatures.runtimeDescriptorArray &&
+		indexingFeatures.descriptorBindingPartiallyBound && indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Fills in the descriptor indexing features the table needs, to be chained onto the
+		logical device's create info
+
+	\param features
+		The feature struct to fill in
+*/
+/*************************************************************************************************/
+void TextureTable::GetRequiredFeatures(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features)
+{
+	features = {};
+	features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+	features.runtimeDescriptorArray = VK_TRUE;
+	features.descriptorBindingPartiallyBound = VK_TRUE;
+	features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
@@ -0,0 +1,259 @@
+/*************************************************************************************************/
+/*!
+\file TextureTable.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    A single descriptor set holding an array of every loaded texture. Textures are registered
+	into stable slots and sprites pick theirs by index, so the set is bound once per pass no
+	matter how many textures are drawn. Needs descriptor indexing support on the device
+
+    Public Functions:
+        + TextureTable
+		+ ~TextureTable
+		+ Init
+		+ Free
+		+ Register
+		+ Unregister
+		+ IsEnabled
+		+ GetDescriptorSet
+		+ GetDescriptorSetLayout
+		+ GetCapacity
+		+ IsSupported
+		+ GetRequiredFeatures
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_TextureTable_H_
+#define Syncopatience_TextureTable_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The list of free slots
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The texture table class
+*/
+/*************************************************************************************************/
+class TextureTable
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the texture table class
+	*/
+	/*************************************************************************************************/
+	TextureTable();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the texture table class
+	*/
+	/*************************************************************************************************/
+	~TextureTable();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Creates the descriptor set layout, pool and set the table lives in. The logical device
+			must have been made with the descriptor indexing features IsSupported checks for
+
+		\param vkDevice
+			The logical device
+
+		\param physicalDevice
+			The graphics card, used to find how many textures the table can hold
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, VkPhysicalDevice physicalDevice);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys the table. Every texture must have been unregistered or freed
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Puts a texture in the first free slot of the table
+
+		\param imageView
+			The texture's image view
+
+		\param sampler
+			The texture's sampler
+
+		\return
+			The slot the texture was put in
+	*/
+	/*************************************************************************************************/
+	uint32_t Register(VkImageView imageView, VkSampler sampler);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Frees a slot to be reused. The texture must not be used by any frame still in flight
+
+		\param slot
+			The slot to free
+	*/
+	/*************************************************************************************************/
+	void Unregister(uint32_t slot);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns whether the table was made, i.e. whether textures should be registered in it
+
+		\return
+			Whether the table is in use
+	*/
+	/*************************************************************************************************/
+	bool IsEnabled() { return descriptorSet != VK_NULL_HANDLE; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the table's descriptor set
+
+		\return
+			The descriptor set holding every registered texture
+	*/
+	/*************************************************************************************************/
+	VkDescriptorSet* GetDescriptorSet() { return &descriptorSet; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the layout of the table's descriptor set
+
+		\return
+			The descriptor set layout
+	*/
+	/*************************************************************************************************/
+	VkDescriptorSetLayout GetDescriptorSetLayout() { return descriptorSetLayout; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many textures the table can hold
+
+		\return
+			The number of slots
+	*/
+	/*************************************************************************************************/
+	uint32_t GetCapacity() { return capacity; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks whether a graphics card supports everything the table needs
+
+		\param physicalDevice
+			The graphics card to check
+
+		\return
+			Whether the table can be used on the card
+	*/
+	/*************************************************************************************************/
+	static bool IsSupported(VkPhysicalDevice physicalDevice);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Fills in the descriptor indexing features the table needs, to be chained onto the
+			logical device's create info
+
+		\param features
+			The feature struct to fill in
+	*/
+	/*************************************************************************************************/
+	static void GetRequiredFeatures(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features);
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device the table was made on
+	VkDescriptorSetLayout descriptorSetLayout;	// The layout with one large texture array
+	VkDescriptorPool descriptorPool;			// The pool the table's set comes from
+	VkDescriptorSet descriptorSet;				// The table itself
+
+	uint32_t capacity;							// How many slots the table has
+	uint32_t nextUnusedSlot;					// The first slot that has never been handed out
+	std::vector<uint32_t> freeSlots;			// Slots that were handed out and given back
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_TextureTable_H_
@@ -0,0 +1,509 @@
+/*************************************************************************************************/
+/*!
+\file TextureUploader.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Uploads texture pixels in batches instead of one blocking submission per texture. Uploads
+	are staged together in one buffer, recorded into one command buffer and submitted on a
+	transfer-only queue when the card has one. Frames wait for the batches on the GPU, so
+	loading a scene never waits on the upload itself
+
+    Functions include:
+        + TextureUploader::TextureUploader
+		+ TextureUploader::~TextureUploader
+		+ TextureUploader::Init
+		+ TextureUploader::Upload
+		+ TextureUploader::Submit
+		+ TextureUploader::TakeWaitSemaphores
+		+ TextureUploader::FrameFinished
+		+ TextureUploader::WaitIdle
+		+ TextureUploader::Free
+		+ TextureUploader::OpenBatch
+		+ TextureUploader::RecycleBatch
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "TextureUploader.h"
+#include "cppShortcuts.h"
+
+// Buffer creation and the debug log
+#include "Window.h"
+
+// Finding each image's first and repeated copies
+#include <set>
+
+// Copies region rows into the staging buffer
+#include <cstring>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the texture uploader class
+*/
+/*************************************************************************************************/
+TextureUploader::TextureUploader() : device(VK_NULL_HANDLE), queue(VK_NULL_HANDLE), commandPool(VK_NULL_HANDLE), openBatch(-1)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the texture uploader class
+*/
+/*************************************************************************************************/
+TextureUploader::~TextureUploader()
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Picks the queue uploads run on and makes its command pool
+
+	\param vkDevice
+		The logical device
+
+	\param graphicsFamily_
+		The queue family frames are drawn on
+
+	\param graphicsQueue
+		The graphics queue, used when there's no transfer queue
+
+	\param transferFamily
+		A queue family that only does transfers, or -1 if the card doesn't have one
+
+	\param transferQueue
+		The queue of the transfer family, if there is one
+*/
+/*************************************************************************************************/
+void TextureUploader::Init(VkDevice vkDevice, uint32_t graphicsFamily_, VkQueue graphicsQueue, int transferFamily, VkQueue transferQueue)
+{
+	device = vkDevice;
+
+	// A transfer queue runs on the card's copy engine alongside drawing. Images are shared
+	// between both families so they never need ownership handed over
+	uint32_t uploadFamily = graphicsFamily_;
+	queue = graphicsQueue;
+	if (transferFamily >= 0 && (uint32_t)transferFamily != graphicsFamily_)
+	{
+		uploadFamily = (uint32_t)transferFamily;
+		queue = transferQueue;
+		sharingFamilies = { graphicsFamily_, uploadFamily };
+	}
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = uploadFamily;
+	_Window->CheckVulkanSuccess(vkCreateCommandPool(device, &poolInfo, NULL, &commandPool), "failed to create upload command pool!");
+
+	_Debug->Print(Debug::MessageType::Debug, std::string("TextureUploader: Uploading on the ") + (UsesTransferQueue() ? "transfer" : "graphics") + " queue");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Adds a rectangle of pixels to the current batch. The pixels are copied straight away,
+		so the caller can free them once this returns. The image ends up shader readable
+
+	\param image
+		The image to write to
+
+	\param oldLayout
+		The image's layout now. Undefined for new images, shader read only for ones being updated
+
+	\param pixels
+		The pixels of the source, or NULL to only move a new image into its layout
+
+	\param rowLength
+		The width in pixels of each row of the source
+
+	\param pixelSize
+		The number of bytes in each pixel
+
+	\param offset
+		The top left of the rectangle, both in the source and in the image
+
+	\param extent
+		The size of the rectangle
+*/
+/*************************************************************************************************/
+void TextureUploader::Upload(VkImage image, VkImageLayout oldLayout, const uint8_t* pixels, uint32_t rowLength, uint32_t pixelSize, VkOffset2D offset, VkExtent2D extent)
+{
+	VkDeviceSize size = pixels ? (VkDeviceSize)extent.width * extent.height * pixelSize : 0;
+	Batch& batch = OpenBatch(size);
+
+	Copy copy{};
+	copy.image = image;
+	copy.oldLayout = oldLayout;
+	copy.hasPixels = pixels != NULL;
+
+	if (copy.hasPixels)
+	{
+		// Packs the rows of the rectangle into the staging buffer
+		VkDeviceSize start = (batch.stagingOffset + COPY_ALIGNMENT - 1) / COPY_ALIGNMENT * COPY_ALIGNMENT;
+		uint8_t* staging = (uint8_t*)batch.stagingMemory.mapped + start;
+		size_t rowSize = (size_t)extent.width * pixelSize;
+		for (uint32_t i = 0; i < extent.height; i++)
+		{
+			memcpy(staging + i * rowSize, pixels + ((size_t)(offset.y + i) * rowLength + offset.x) * pixelSize, rowSize);
+		}
+		batch.stagingOffset = start + size;
+
+		copy.region.bufferOffset = start;
+		copy.region.bufferRowLength = 0;
+		copy.region.bufferImageHeight = 0;
+		copy.region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copy.region.imageSubresource.mipLevel = 0;
+		copy.region.imageSubresource.baseArrayLayer = 0;
+		copy.region.imageSubresource.layerCount = 1;
+		copy.region.imageOffset = { offset.x, offset.y, 0 };
+		copy.region.imageExtent = { extent.width, extent.height, 1 };
+	}
+
+	batch.copies.push_back(copy);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Records and submits the current batch without waiting for it. Called before each frame
+		is submitted, and after scene loads so the uploads start as soon as possible
+*/
+/*************************************************************************************************/
+void TextureUploader::Submit()
+{
+	// Nothing has been uploaded since the last submit
+	if (openBatch < 0)
+	{
+		return;
+	}
+	Batch& batch = batches[openBatch];
+	openBatch = -1;
+
+	// Every image changes layout once before its first copy and once after its last
+	std::vector<VkImageMemoryBarrier> toTransfer;
+	std::vector<VkImageMemoryBarrier> toShader;
+	std::set<VkImage> images;
+	for (const Copy& copy : batch.copies)
+	{
+		if (!images.insert(copy.image).second)
+		{
+			continue;
+		}
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = copy.image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		// Images being updated may have been written by an earlier batch. Draws reading them
+		// have already finished, since updates wait for the graphics queue first
+		barrier.oldLayout = copy.oldLayout;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = copy.oldLayout == VK_IMAGE_LAYOUT_UNDEFINED ? 0 : VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		toTransfer.push_back(barrier);
+
+		// Frames get the results through the batch's semaphore, so this only has to keep
+		// later batches behind the layout change
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+		toShader.push_back(barrier);
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+
+	vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		0, NULL, 0, NULL, (uint32_t)toTransfer.size(), toTransfer.data());
+
+	// Copies into an image that was already written this batch wait for the earlier copies,
+	// since the rectangles may overlap
+	std::set<VkImage> written;
+	for (const Copy& copy : batch.copies)
+	{
+		if (!copy.hasPixels)
+		{
+			continue;
+		}
+
+		if (!written.insert(copy.image).second)
+		{
+			VkMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, NULL, 0, NULL);
+
+			written.clear();
+			written.insert(copy.image);
+		}
+
+		vkCmdCopyBufferToImage(batch.commandBuffer, batch.stagingBuffer, copy.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.region);
+	}
+
+	vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+		0, NULL, 0, NULL, (uint32_t)toShader.size(), toShader.data());
+
+	_Window->CheckVulkanSuccess(vkEndCommandBuffer(batch.commandBuffer), "failed to record upload command buffer!");
+
+	// Submits without waiting. The fence says when the batch can be reused and the semaphore
+	// holds back the first frame that could sample the images
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &batch.commandBuffer;
+	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.pSignalSemaphores = &batch.semaphore;
+	_Window->CheckVulkanSuccess(vkQueueSubmit(queue, 1, &submitInfo, batch.fence), "failed to submit texture uploads!");
+
+	batch.state = BatchState::Submitted;
+
+	_Debug->Print(Debug::MessageType::Debug, "TextureUploader: Submitted " + std::to_string(batch.copies.size()) + " uploads to "
+		+ std::to_string(images.size()) + " images, " + std::to_string(batch.stagingOffset) + " staging bytes");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Hands the frame being submitted every batch it hasn't waited on yet, so the frame
+		doesn't sample a texture before its upload is done
+
+	\param frame
+		The index of the frame in flight being submitted
+
+	\param semaphores
+		The frame's wait semaphores, added to
+
+	\param stages
+		The stages each wait semaphore blocks, added to
+*/
+/*************************************************************************************************/
+void TextureUploader::TakeWaitSemaphores(int frame, std::vector<VkSemaphore>& semaphores, std::vector<VkPipelineStageFlags>& stages)
+{
+	for (Batch& batch : batches)
+	{
+		if (batch.state == BatchState::Submitted)
+		{
+			// Uploaded images are sampled by fragment shaders, drawn into as render targets or have
+			// regions copied into them at the start of the frame
+			semaphores.push_back(batch.semaphore);
+			stages.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+			batch.state = BatchState::Waiting;
+			batch.waitFrame = frame;
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reuses the batches a frame waited on. Only call once the frame's fence has been waited on
+
+	\param frame
+		The index of the frame in flight that finished
+*/
+/*************************************************************************************************/
+void TextureUploader::FrameFinished(int frame)
+{
+	for (Batch& batch : batches)
+	{
+		// The frame waited on the batch's semaphore, so the batch finished before it did
+		if (batch.state == BatchState::Waiting && batch.waitFrame == frame && vkGetFenceStatus(device, batch.fence) == VK_SUCCESS)
+		{
+			RecycleBatch(batch);
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Submits the current batch and waits for every upload to finish, e.g. before an
+		image that may still be uploading is destroyed
+*/
+/*************************************************************************************************/
+void TextureUploader::WaitIdle()
+{
+	Submit();
+	vkQueueWaitIdle(queue);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destroys every batch and the command pool. The device must be idle
+*/
+/*************************************************************************************************/
+void TextureUploader::Free()
+{
+	WaitIdle();
+
+	for (Batch& batch : batches)
+	{
+		if (batch.stagingBuffer)
+		{
+			_Window->DestroyBuffer(batch.stagingBuffer, batch.stagingMemory);
+		}
+		vkDestroyFence(device, batch.fence, NULL);
+		vkDestroySemaphore(device, batch.semaphore, NULL);
+	}
+	batches.clear();
+
+	// Frees every batch's command buffer with it
+	vkDestroyCommandPool(device, commandPool, NULL);
+	commandPool = VK_NULL_HANDLE;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the batch taking uploads, submitting it and starting another if it can't fit
+		more pixels
+
+	\param size
+		The number of bytes the next upload needs in the staging buffer
+
+	\return
+		The open batch
+*/
+/*************************************************************************************************/
+TextureUploader::Batch& TextureUploader::OpenBatch(VkDeviceSize size)
+{
+	// Keeps filling the open batch while the upload fits
+	if (openBatch >= 0)
+	{
+		Batch& batch = batches[openBatch];
+		VkDeviceSize start = (batch.stagingOffset + COPY_ALIGNMENT - 1) / COPY_ALIGNMENT * COPY_ALIGNMENT;
+		if (start + size <= batch.stagingSize)
+		{
+			return batch;
+		}
+		Submit();
+	}
+
+	// Reuses a finished batch, or makes a new one
+	for (openBatch = 0; openBatch < (int)batches.size(); openBatch++)
+	{
+		if (batches[openBatch].state == BatchState::Free)
+		{
+			break;
+		}
+	}
+	if (openBatch == (int)batches.size())
+	{
+		Batch newBatch{};
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.commandPool = commandPool;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandBufferCount = 1;
+		_Window->CheckVulkanSuccess(vkAllocateCommandBuffers(device, &allocInfo, &newBatch.commandBuffer), "failed to allocate upload command buffer!");
+
+		VkFenceCreateInfo fenceInfo{};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		_Window->CheckVulkanSuccess(vkCreateFence(device, &fenceInfo, NULL, &newBatch.fence), "failed to create upload fence!");
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		_Window->CheckVulkanSuccess(vkCreateSemaphore(device, &semaphoreInfo, NULL, &newBatch.semaphore), "failed to create upload semaphore!");
+
+		newBatch.stagingBuffer = VK_NULL_HANDLE;
+		newBatch.waitFrame = -1;
+		batches.push_back(newBatch);
+	}
+
+	// Gives the batch a staging buffer big enough for the upload
+	Batch& batch = batches[openBatch];
+	if (batch.stagingSize < size || batch.stagingSize == 0)
+	{
+		if (batch.stagingBuffer)
+		{
+			_Window->DestroyBuffer(batch.stagingBuffer, batch.stagingMemory);
+		}
+		batch.stagingSize = size > STAGING_SIZE ? size : STAGING_SIZE;
+		_Window->CreateBuffer(batch.stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, batch.stagingBuffer, batch.stagingMemory);
+	}
+
+	batch.state = BatchState::Open;
+	return batch;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Resets a finished batch so it can take uploads again
+
+	\param batch
+		The batch to reset
+*/
+/*************************************************************************************************/
+void TextureUploader::RecycleBatch(Batch& batch)
+{
+	vkResetFences(device, 1, &batch.fence);
+	vkResetCommandBuffer(batch.commandBuffer, 0);
+
+	// Staging buffers made for one oversized upload aren't kept around
+	if (batch.stagingSize > STAGING_SIZE)
+	{
+		_Window->DestroyBuffer(batch.stagingBuffer, batch.stagingMemory);
+		batch.stagingBuffer = VK_NULL_HANDLE;
+		batch.stagingSize = 0;
+	}
+
+	batch.stagingOffset = 0;
+	batch.copies.clear();
+	batch.state = BatchState::Free;
+	batch.waitFrame = -1;
+}
@@ -0,0 +1,339 @@
+/*************************************************************************************************/
+/*!
+\file TextureUploader.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Uploads texture pixels in batches instead of one blocking submission per texture. Uploads
+	are staged together in one buffer, recorded into one command buffer and submitted on a
+	transfer-only queue when the card has one. Frames wait for the batches on the GPU, so
+	loading a scene never waits on the upload itself
+
+    Public Functions:
+        + TextureUploader
+		+ ~TextureUploader
+		+ Init
+		+ Upload
+		+ Submit
+		+ TakeWaitSemaphores
+		+ FrameFinished
+		+ WaitIdle
+		+ Free
+		+ GetSharingFamilies
+		+ UsesTransferQueue
+
+	Private Functions:
+		+ OpenBatch
+		+ RecycleBatch
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_TextureUploader_H_
+#define Syncopatience_TextureUploader_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base include
+#include "stdafx.h"
+
+// Includes glfw libraries for vulkan
+#define VK_USE_PLATFORM_WIN32_KHR
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// The batches and their copies
+#include <vector>
+
+// The memory behind the staging buffers
+#include "MemoryAllocator.h"
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The texture uploader class
+*/
+/*************************************************************************************************/
+class TextureUploader
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the texture uploader class
+	*/
+	/*************************************************************************************************/
+	TextureUploader();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the texture uploader class
+	*/
+	/*************************************************************************************************/
+	~TextureUploader();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Picks the queue uploads run on and makes its command pool
+
+		\param vkDevice
+			The logical device
+
+		\param graphicsFamily_
+			The queue family frames are drawn on
+
+		\param graphicsQueue
+			The graphics queue, used when there's no transfer queue
+
+		\param transferFamily
+			A queue family that only does transfers, or -1 if the card doesn't have one
+
+		\param transferQueue
+			The queue of the transfer family, if there is one
+	*/
+	/*************************************************************************************************/
+	void Init(VkDevice vkDevice, uint32_t graphicsFamily_, VkQueue graphicsQueue, int transferFamily, VkQueue transferQueue);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Adds a rectangle of pixels to the current batch. The pixels are copied straight away,
+			so the caller can free them once this returns. The image ends up shader readable
+
+		\param image
+			The image to write to
+
+		\param oldLayout
+			The image's layout now. Undefined for new images, shader read only for ones being updated
+
+		\param pixels
+			The pixels of the source, or NULL to only move a new image into its layout
+
+		\param rowLength
+			The width in pixels of each row of the source
+
+		\param pixelSize
+			The number of bytes in each pixel
+
+		\param offset
+			The top left of the rectangle, both in the source and in the image
+
+		\param extent
+			The size of the rectangle
+	*/
+	/*************************************************************************************************/
+	void Upload(VkImage image, VkImageLayout oldLayout, const uint8_t* pixels, uint32_t rowLength, uint32_t pixelSize, VkOffset2D offset, VkExtent2D extent);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Records and submits the current batch without waiting for it. Called before each frame
+			is submitted, and after scene loads so the uploads start as soon as possible
+	*/
+	/*************************************************************************************************/
+	void Submit();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Hands the frame being submitted every batch it hasn't waited on yet, so the frame
+			doesn't sample a texture before its upload is done
+
+		\param frame
+			The index of the frame in flight being submitted
+
+		\param semaphores
+			The frame's wait semaphores, added to
+
+		\param stages
+			The stages each wait semaphore blocks, added to
+	*/
+	/*************************************************************************************************/
+	void TakeWaitSemaphores(int frame, std::vector<VkSemaphore>& semaphores, std::vector<VkPipelineStageFlags>& stages);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reuses the batches a frame waited on. Only call once the frame's fence has been waited on
+
+		\param frame
+			The index of the frame in flight that finished
+	*/
+	/*************************************************************************************************/
+	void FrameFinished(int frame);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Submits the current batch and waits for every upload to finish, e.g. before an
+			image that may still be uploading is destroyed
+	*/
+	/*************************************************************************************************/
+	void WaitIdle();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destroys every batch and the command pool. The device must be idle
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the queue families images have to be shared between
+
+		\return
+			The graphics and transfer families, or nothing if uploads run on the graphics queue
+	*/
+	/*************************************************************************************************/
+	const std::vector<uint32_t>& GetSharingFamilies() { return sharingFamilies; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns whether uploads run on a transfer queue of their own
+
+		\return
+			Whether there is a transfer queue
+	*/
+	/*************************************************************************************************/
+	bool UsesTransferQueue() { return !sharingFamilies.empty(); }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	// The size of a batch's staging buffer. Bigger uploads get a buffer of their own size
+	static const VkDeviceSize STAGING_SIZE = 16 * 1024 * 1024;
+
+	// What each upload's offset in the staging buffer is aligned to, which covers every texel size
+	static const VkDeviceSize COPY_ALIGNMENT = 16;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// Where a batch is in its life
+	enum class BatchState
+	{
+		Free,									// Waiting to be reused
+		Open,									// Taking uploads
+		Submitted,								// Running, but no frame waits on it yet
+		Waiting									// A frame in flight waits on it
+	};
+
+	// One rectangle of pixels going into an image
+	typedef struct
+	{
+		VkImage image;							// The image being written
+		VkImageLayout oldLayout;				// The image's layout before the batch
+		bool hasPixels;							// Whether there is anything to copy, or only the layout changes
+		VkBufferImageCopy region;				// Where the pixels are in the staging buffer and image
+	}Copy;
+
+	// Uploads that are submitted together
+	typedef struct
+	{
+		VkCommandBuffer commandBuffer;			// The command buffer the uploads are recorded into
+		VkFence fence;							// Signaled once the uploads are done
+		VkSemaphore semaphore;					// Signaled once the uploads are done, for a frame to wait on
+		VkBuffer stagingBuffer;					// The buffer every upload's pixels are staged in
+		MemoryAllocator::Allocation stagingMemory;	// The memory behind the staging buffer, kept mapped
+		VkDeviceSize stagingSize;				// The size of the staging buffer
+		VkDeviceSize stagingOffset;				// How much of the staging buffer is filled
+		std::vector<Copy> copies;				// The uploads in the order they were added
+		BatchState state;						// Where the batch is in its life
+		int waitFrame;							// The frame in flight that waits on the batch
+	}Batch;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	VkDevice device;							// The logical device
+	VkQueue queue;								// The queue uploads are submitted on
+	VkCommandPool commandPool;					// The pool for the upload queue's family
+	std::vector<uint32_t> sharingFamilies;		// The families images are shared between, empty without a transfer queue
+
+	std::vector<Batch> batches;					// Every batch, reused once they're done
+	int openBatch;								// The batch taking uploads, -1 if there isn't one
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the batch taking uploads, submitting it and starting another if it can't fit
+			more pixels
+
+		\param size
+			The number of bytes the next upload needs in the staging buffer
+
+		\return
+			The open batch
+	*/
+	/*************************************************************************************************/
+	Batch& OpenBatch(VkDeviceSize size);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Resets a finished batch so it can take uploads again
+
+		\param batch
+			The batch to reset
+	*/
+	/*************************************************************************************************/
+	void RecycleBatch(Batch& batch);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_TextureUploader_H_
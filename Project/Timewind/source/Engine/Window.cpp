@@ -33,6 +33,13 @@ Copyright (c) 2023 Aiden Cvengros
 
 // Includes for mathing
 #include <algorithm>
+#include <climits>
+#include <cmath>
+#include <thread>
+#include <chrono>
+
+// Copies pixels and vertex data into mapped memory
+#include <cstring>
 
 // Functionality for running and drawing to the window
 #include "Vertex.h"
@@ -111,41 +118,94 @@ Window::~Window()
 /*********************************************************************************************/
 void Window::Init()
 {
-	// Sets up glfw
-	glfwInit();
+	// Keeps the frames in flight to what the engine is set up for
+	if (framesInFlight < MIN_FRAMES_IN_FLIGHT || framesInFlight > MAX_FRAMES_IN_FLIGHT)
+	{
+		_Debug->Print(Debug::MessageType::Error, "Window: " + std::to_string(framesInFlight) + " frames in flight isn't supported, using " + std::to_string(MIN_FRAMES_IN_FLIGHT));
+		framesInFlight = MIN_FRAMES_IN_FLIGHT;
+	}
+	renderConfig.framesInFlight = framesInFlight;
 
-	// Tells glfw that we aren't using OpenGL
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+	std::chrono::steady_clock::time_point initStart = std::chrono::steady_clock::now();
 
-	// Creates the window
-	window = glfwCreateWindow(width, height, name.c_str() , NULL, NULL);
+	// Headless runs never touch the window system, so they work on machines without a display
+	if (!headless)
+	{
+		// Sets up glfw
+		glfwInit();
 
-	// Sets the window pointer and resize callback function
-	glfwSetWindowUserPointer(window, this);
-	glfwSetFramebufferSizeCallback(window, FramebufferResizeCallback);
+		// Tells glfw that we aren't using OpenGL
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+
+		// Creates the window
+		window = glfwCreateWindow(width, height, name.c_str() , NULL, NULL);
+
+		// Sets the window pointer and resize callback function
+		glfwSetWindowUserPointer(window, this);
+		glfwSetFramebufferSizeCallback(window, FramebufferResizeCallback);
+	}
 
 	// Initializes the Vulkan instance
 	CreateVulkanInstance();
 	SetupDebugMessenger();
-	InitializeSurface();
+	if (!headless)
+	{
+		InitializeSurface();
+	}
 	PickPhysicalDevice();
 	CreateLogicalDevice();
+	memoryAllocator.Init(logicalDevice, physicalCard);
 	CreateSwapChain();
 	CreateCommandPool();
+	InitTextureUploader();
 	CreateDescriptorPool();
 	CreateDescriptorSetLayout();
+	if (bindlessTextures)
+	{
+		textureTable.Init(logicalDevice, physicalCard);
+	}
 	CreateImageViews();
 	CreateRenderPass();
 	CreateGraphicsPipeline();
-	CreateFramebuffers();
+	CreateRenderGraph();
+	CompileRenderGraph();
 	CreateUniformBuffers();
 	CreateDescriptorSets();
 	CreateSyncObjects();
 
+	// Records on as many threads as the machine has cores, up to a limit
+	int recordingThreads = (int)std::thread::hardware_concurrency();
+	recordingThreads = std::clamp(recordingThreads, 1, MAX_RECORDING_THREADS);
+	commandRecorder.Init(logicalDevice, FindQueueFamilies(physicalCard).graphicsFamily.value(), MAX_FRAMES_IN_FLIGHT, recordingThreads);
+
+	// Times every frame so the scene can be drawn smaller when the GPU falls behind. Headless
+	// captures have to match from run to run, so they're always drawn at full size
+	resolutionScaler.Init(logicalDevice, physicalCard, FindQueueFamilies(physicalCard).graphicsFamily.value(), MAX_FRAMES_IN_FLIGHT);
+	if (headless)
+	{
+		resolutionScaler.SetEnabled(false);
+	}
+
+	// Gives the sprite batch the quad every sprite is drawn with and somewhere to put the instances
+	frameAllocator.Init(MAX_FRAMES_IN_FLIGHT, FRAME_MEMORY_SIZE, physicalCard);
+	spriteBatch.Init(&frameAllocator, &commandRecorder, vertexBuffer, indexBuffer, static_cast<uint32_t>(defaultRectIndices.size()));
+
+	// Headless frames can only be seen by reading them back
+	if (headless)
+	{
+		frameCapture.Init(logicalDevice, MAX_FRAMES_IN_FLIGHT, swapChainExtent, swapChainImageFormat);
+	}
+
+	// Starts measuring the first render config
+	latencyMonitor.Init(MAX_FRAMES_IN_FLIGHT);
+	latencyMonitor.Begin(DescribeRenderConfig());
+
 	// Creates a blank texture as a default option for objects without sprites
 	blankTexture = new Texture("Assets/Sprites/Blank.png");
 
-	_Debug->Print(Debug::MessageType::Debug, "Window initialized");
+	double initMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initStart).count();
+	_Debug->Print(Debug::MessageType::Debug, std::string("Window initialized ") + (headless ? "headless " : "") + "in " + std::to_string((int)initMilliseconds) + " ms with a "
+		+ (pipelineCache.IsWarm() ? "warm" : "cold") + " pipeline cache");
 }
 
 /*********************************************************************************************/
@@ -160,7 +220,13 @@ void Window::Init()
 void Window::Update(double dt)
 {
 	// Updates window checks
-	glfwPollEvents();
+	if (window)
+	{
+		glfwPollEvents();
+	}
+
+	// The frame drawn next is made from the input just read
+	latencyMonitor.InputSampled();
 }
 
 /*********************************************************************************************/
@@ -173,107 +239,74 @@ void Window::Draw()
 {
 	_Debug->Print(Debug::MessageType::Debug, "Window::Draw start");
 
+	// A new render config is applied between frames
+	if (renderConfigChanged)
+	{
+		RecreateSwapChain();
+	}
+
+	// Notes every frame the GPU has finished since the last one, rather than when its fence
+	// comes around to be waited on
+	for (int i = 0; i < framesInFlight; i++)
+	{
+		if (vkGetFenceStatus(logicalDevice, inFlightFence[i]) == VK_SUCCESS)
+		{
+			latencyMonitor.FrameFinished(i);
+		}
+	}
+
 	// Makes sure that the previous frame has finished before drawing the next one
 	vkWaitForFences(logicalDevice, 1, &inFlightFence[currentFrame], VK_TRUE, UINT64_MAX);
+	latencyMonitor.FrameFinished(currentFrame);
 
-	// Gets the next image from the swap chain
-	VkResult result = vkAcquireNextImageKHR(logicalDevice, swapChain, UINT64_MAX, availableSemaphore[currentFrame], VK_NULL_HANDLE, &imageIndex);
+	// Texture uploads and readbacks the frame waited on are finished too
+	textureUploader.FrameFinished(currentFrame);
+	frameCapture.FrameFinished(currentFrame);
+	resolutionScaler.FrameFinished(currentFrame);
 
-	// Checks if the swap chain needs to be rebuilt or if something went wrong with the new image
-	if (result == VK_ERROR_OUT_OF_DATE_KHR)
+	// Headless frames each have their own image, which the fence above has already freed up
+	if (headless)
 	{
-		RecreateSwapChain();
-		return;
+		imageIndex = currentFrame;
 	}
-	else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+	else
 	{
-		throw std::runtime_error("failed to acquire swap chain image!");
+		// Gets the next image from the swap chain
+		VkResult result = vkAcquireNextImageKHR(logicalDevice, swapChain, UINT64_MAX, availableSemaphore[currentFrame], VK_NULL_HANDLE, &imageIndex);
+
+		// Checks if the swap chain needs to be rebuilt or if something went wrong with the new image
+		if (result == VK_ERROR_OUT_OF_DATE_KHR)
+		{
+			RecreateSwapChain();
+			return;
+		}
+		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+		{
+			throw std::runtime_error("failed to acquire swap chain image!");
+		}
 	}
 
-	// Updates the uniform buffer matrices
+	// Picks the scene's size from how long recent frames took, then updates the uniform buffer matrices
+	sceneExtent = resolutionScaler.GetScaledExtent(swapChainExtent);
 	UpdateUniformBuffers(currentFrame);
 
 	// Sets a new fence for synchronization
 	vkResetFences(logicalDevice, 1, &inFlightFence[currentFrame]);
+	latencyMonitor.FrameStarted(currentFrame);
+
+	// The frame's memory is free to reuse now that its fence has been waited on
+	frameAllocator.BeginFrame(currentFrame);
+	commandRecorder.BeginFrame(currentFrame);
+	spriteBatch.BeginFrame();
+
 	// Starts the new command buffer (follow here for draw command)
 	vkResetCommandBuffer(commandBuffer[currentFrame], 0);
 	SetupCommandBuffer(commandBuffer[currentFrame], imageIndex);
-
-	// Sets the info for the render pass
-	VkRenderPassBeginInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = baseScenePass.GetRenderPass();
-	renderPassInfo.framebuffer = baseScenePass.GetFramebuffers()[0];
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapChainExtent;
-
-	// Sets the render size
-	VkClearValue clearColor = { {{0.05f, 0.5f, 0.8f, 1.0f}} };
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearColor;
-
-	// Start of the render pass
-	vkCmdBeginRenderPass(commandBuffer[currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-	// Binds the render pass
-	vkCmdBindPipeline(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, baseScenePass.GetGraphicsPipeline());
-
-	// Sets the viewport for the render pass
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(swapChainExtent.width);
-	viewport.height = static_cast<float>(swapChainExtent.height);
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-	vkCmdSetViewport(commandBuffer[currentFrame], 0, 1, &viewport);
-
-	// Sets the scissor state for the render pass
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = swapChainExtent;
-	vkCmdSetScissor(commandBuffer[currentFrame], 0, 1, &scissor);
-
-	// Binds the descriptor sets
-	vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, baseScenePass.GetGraphicsPipelineLayout(), 0, 1, &baseScenePass.GetDescriptorSets()[0], 0, NULL);
+	resolutionScaler.BeginFrame(commandBuffer[currentFrame], currentFrame);
 
 	_Debug->Print(Debug::MessageType::Debug, "Window::Draw end");
 }
 
-/*********************************************************************************************/
-/*!
-	\brief
-		Begins the mask render pass drawing sequence
-*/
-/*************************************************************************************************/
-void Window::DrawMaskRenderPass()
-{
-	// Ends the previous render pass
-	vkCmdEndRenderPass(commandBuffer[currentFrame]);
-
-	// Sets the info for the render pass
-	VkRenderPassBeginInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = glitchMaskPass.GetRenderPass();
-	renderPassInfo.framebuffer = glitchMaskPass.GetFramebuffers()[0];
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapChainExtent;
-
-	// Sets the render size
-	VkClearValue clearColor = { {1.0f, 1.0f, 1.0f, 0.0f} };
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearColor;
-
-	// Start of the render pass
-	vkCmdBeginRenderPass(commandBuffer[currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-	// Binds the render pass
-	vkCmdBindPipeline(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, glitchMaskPass.GetGraphicsPipeline());
-
-	// Binds the descriptor sets
-	vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, glitchMaskPass.GetGraphicsPipelineLayout(), 0, 1, &glitchMaskPass.GetDescriptorSets()[0], 0, NULL);
-}
-
 /*********************************************************************************************/
 /*!
 	\brief
@@ -288,28 +321,20 @@ void Window::DrawGameObject(GameObject* gameObject)
 	// If the game object is supposed to be rendered
 	if (gameObject->GetRender())
 	{
-		// Sets the dynamic offset and draws the first object
-		glm::mat4 tempMat = gameObject->GetTranformationMatrix();
-		glm::vec4 tempColor = gameObject->GetColor();
-		VkBool32 simpleTexture = false;
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &tempMat);
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 64, sizeof(glm::vec4), &tempColor);
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 80, sizeof(VkBool32), &simpleTexture);
-
-		// Checks if the game object has a texture
-		if (gameObject->GetTexture())
-		{
-			// Binds the texture descriptor set and color
-			vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, baseScenePass.GetGraphicsPipelineLayout(), 1, 1, gameObject->GetTexture()->GetDescriptorSet(), 0, NULL);
-		}
-		// Otherwise uses the default blank texture
-		else
-		{
-			vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, baseScenePass.GetGraphicsPipelineLayout(), 1, 1, blankTexture->GetDescriptorSet(), 0, NULL);
-		}
-
-		// Records the draw command to the command buffer
-		RecordCommandBuffer(commandBuffer[currentFrame]);
+		// Fills in the object's instance
+		SpriteBatch::Instance instance{};
+		SpriteBatch::SetTransform(instance, gameObject->GetTranformationMatrix());
+		instance.color = gameObject->GetColor();
+		instance.drawMode = (uint32_t)(drawingGlitches ? DrawMode::Glitch : DrawMode::Sprite);
+
+		// Uses the default blank texture if the game object doesn't have one. Sprites packed in an
+		// atlas page only cover part of it
+		Texture* texture = gameObject->GetTexture() ? gameObject->GetTexture() : blankTexture;
+		instance.uvRect = texture->GetUVRect();
+		instance.textureSlot = texture->GetTextureSlot();
+
+		// Queues the object to be drawn with the rest of its texture
+		spriteBatch.Add(instance, *texture->GetDescriptorSet(), gameObject->GetDrawPriority());
 	}
 }
 
@@ -330,29 +355,119 @@ void Window::DrawTextObject(GameObject* gameObject)
 	// If the game object is supposed to be rendered
 	if (textObject->GetRender() && textObject->GetText().length() > 0)
 	{
-		// Sets the dynamic offset and draws the first object
-		glm::mat4 tempMat = textObject->GetTranformationMatrix();
-		glm::vec4 tempColor = textObject->GetColor();
-		VkBool32 simpleTexture = true;
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4), &tempMat);
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 64, sizeof(glm::vec4), &tempColor);
-		vkCmdPushConstants(commandBuffer[currentFrame], baseScenePass.GetGraphicsPipelineLayout(), VK_SHADER_STAGE_VERTEX_BIT, 80, sizeof(VkBool32), &simpleTexture);
-		
-		// Binds the texture descriptor set and color
-		vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, baseScenePass.GetGraphicsPipelineLayout(), 1, 1, textObject->GetFont()->GetTexture()->GetDescriptorSet(), 0, NULL);
+		// Picks up characters the font's glyph cache has rendered since, or cells it gave away
+		textObject->Refresh();
+		Font* font = textObject->GetFont();
+
+		// Every glyph shares the text's color
+		SpriteBatch::Instance instance{};
+		instance.color = textObject->GetColor();
+		instance.drawMode = (uint32_t)DrawMode::Text;
+
+		// Each glyph is a sprite of its piece of the font, so text lands in the same instanced draws
+		// as the sprites and other text around it with the same priority
+		glm::mat4 transform = textObject->GetTranformationMatrix();
+		for (const Text::Glyph& glyph : textObject->GetGlyphs())
+		{
+			glm::mat4 glyphTransform = transform;
+			glyphTransform[3] = transform * glm::vec4(glyph.center, 0.0f, 1.0f);
+			glyphTransform[0] *= glyph.size.x;
+			glyphTransform[1] *= glyph.size.y;
+			SpriteBatch::SetTransform(instance, glyphTransform);
+			instance.uvRect = glyph.uvRect;
+			instance.textureSlot = glyph.texture->GetTextureSlot();
+			spriteBatch.Add(instance, *glyph.texture->GetDescriptorSet(), textObject->GetDrawPriority());
+
+			// Keeps the glyph's cell from being given away before this frame is drawn
+			if (glyph.cacheSlot >= 0)
+			{
+				font->TouchGlyph(glyph.cacheSlot);
+			}
+		}
+	}
+}
 
-		// Records the draw command to the command buffer
-		// Sets the vertex buffers
-		VkBuffer vertexBuffers[] = { textObject->GetVertexBuffer() };
-		VkDeviceSize offsets[] = { 0 };
-		vkCmdBindVertexBuffers(commandBuffer[currentFrame], 0, 1, vertexBuffers, offsets);
+/*********************************************************************************************/
+/*!
+	\brief
+		Draws a layer of the tile debug overlay as a single quad covering the map
 
-		// Sets the index buffer
-		vkCmdBindIndexBuffer(commandBuffer[currentFrame], textObject->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+	\param overlayTexture
+		The single channel texture holding a value for each tile
 
-		// THE MOTHAFUCKIN' DRAW CALL
-		vkCmdDrawIndexed(commandBuffer[currentFrame], textObject->GetIndexCount(), 1, 0, 0, 0);
+	\param transform
+		The transformation matrix that places the quad over the map
+
+	\param overlayLayer
+		Which layer the texture holds, so the shader knows how to color its values
+
+	\param alpha
+		How opaque the overlay is
+*/
+/*********************************************************************************************/
+void Window::DrawTileOverlay(Texture* overlayTexture, glm::mat4 transform, uint32_t overlayLayer, float alpha)
+{
+	// Fills in the overlay's instance. The shader reads the tile values itself so only the alpha of the color is used
+	SpriteBatch::Instance instance{};
+	SpriteBatch::SetTransform(instance, transform);
+	instance.color = { 1.0f, 1.0f, 1.0f, alpha };
+	instance.uvRect = { 0.0f, 0.0f, 1.0f, 1.0f };
+	instance.drawMode = (uint32_t)DrawMode::TileOverlay;
+	instance.overlayLayer = overlayLayer;
+	instance.textureSlot = overlayTexture->GetTextureSlot();
+
+	// Queues the whole map as one quad. Its priority is never shared, so nothing gets sorted past it
+	spriteBatch.Add(instance, *overlayTexture->GetDescriptorSet(), INT_MIN);
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Queues new pixels for part of a texture. They're copied in at the start of this frame's
+		command buffer, so the texture changes without waiting for the GPU
+
+	\param texture
+		The texture to write to
+
+	\param pixels
+		The region's first pixel. Copied, so they can be thrown away once this returns
+
+	\param rowLength
+		The width in pixels of each row of the source, which can be wider than the region
+
+	\param offset
+		The region's top left corner in the texture
+
+	\param extent
+		The region's width and height
+*/
+/*********************************************************************************************/
+void Window::UpdateTextureRegion(Texture* texture, const uint8_t* pixels, uint32_t rowLength, VkOffset2D offset, VkExtent2D extent)
+{
+	// Packs the region's rows together, which is how they're copied to the image
+	size_t pixelSize = (size_t)texture->GetPixelSize();
+	size_t rowSize = (size_t)extent.width * pixelSize;
+	TextureUpdate update = { texture, std::vector<uint8_t>(rowSize * extent.height), offset, extent };
+	for (uint32_t row = 0; row < extent.height; row++)
+	{
+		memcpy(update.pixels.data() + row * rowSize, pixels + (size_t)row * rowLength * pixelSize, rowSize);
 	}
+	textureUpdates.push_back(std::move(update));
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Forgets any queued pixels for a texture, so nothing is written to it once it's freed
+
+	\param texture
+		The texture being freed
+*/
+/*********************************************************************************************/
+void Window::DropTextureUpdates(Texture* texture)
+{
+	textureUpdates.erase(std::remove_if(textureUpdates.begin(), textureUpdates.end(),
+		[texture](const TextureUpdate& update) { return update.texture == texture; }), textureUpdates.end());
 }
 
 /*********************************************************************************************/
@@ -363,11 +478,25 @@ void Window::DrawTextObject(GameObject* gameObject)
 /*********************************************************************************************/
 void Window::CleanupDraw()
 {
-	// Ends the render pass
-	vkCmdEndRenderPass(commandBuffer[currentFrame]);
+	// Copies in any new texture regions before the passes that read them
+	RecordTextureUpdates(commandBuffer[currentFrame]);
+
+	// Records every pass, with the barriers between them
+	renderGraph.Execute(commandBuffer[currentFrame], imageIndex);
+	resolutionScaler.EndFrame(commandBuffer[currentFrame], currentFrame);
+
+	// Only logs the frame's numbers when asked, the log file is written on every print
+	if (frameStatsRequested)
+	{
+		PrintFrameStats();
+		frameStatsRequested = false;
+	}
 
-	// Runs the post processing shaders
-	RunFisheyeRenderPass();
+	// Copies the finished frame back if it was asked for
+	if (headless)
+	{
+		frameCapture.Record(commandBuffer[currentFrame], currentFrame, swapChainImages[imageIndex]);
+	}
 
 	// Checks that everything happened correctly
 	CheckVulkanSuccess(vkEndCommandBuffer(commandBuffer[currentFrame]), "failed to record command buffer!");
@@ -376,12 +505,22 @@ void Window::CleanupDraw()
 	VkSubmitInfo submitInfo{};
 	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-	// Sets up the available semaphore
-	VkSemaphore waitSemaphores[] = { availableSemaphore[currentFrame] };
-	VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = waitSemaphores;
-	submitInfo.pWaitDstStageMask = waitStages;
+	// Sets up the available semaphore. Headless images don't come from the presentation engine so there's nothing to wait on
+	std::vector<VkSemaphore> waitSemaphores;
+	std::vector<VkPipelineStageFlags> waitStages;
+	if (!headless)
+	{
+		waitSemaphores.push_back(availableSemaphore[currentFrame]);
+		waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+	}
+
+	// Starts any texture uploads still waiting and holds the frame back until they're done
+	textureUploader.Submit();
+	textureUploader.TakeWaitSemaphores(currentFrame, waitSemaphores, waitStages);
+
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+	submitInfo.pWaitSemaphores = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = waitStages.data();
 
 	// Gives the graphics pipeline the command buffer
 	submitInfo.commandBufferCount = 1;
@@ -389,12 +528,19 @@ void Window::CleanupDraw()
 
 	// Sets up the finished semaphore
 	VkSemaphore signalSemaphores[] = { finishedSemaphore[currentFrame] };
-	submitInfo.signalSemaphoreCount = 1;
+	submitInfo.signalSemaphoreCount = headless ? 0 : 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
 	// Submits the command buffer to the graphics queue
 	CheckVulkanSuccess(vkQueueSubmit(graphicsQueue, 1, &submitInfo, inFlightFence[currentFrame]), "failed to submit draw command buffer!");
 
+	// Headless frames are done once they're submitted, the fence covers reading them back
+	if (headless)
+	{
+		currentFrame = (currentFrame + 1) % framesInFlight;
+		return;
+	}
+
 	// Creates the presentation struct
 	VkPresentInfoKHR presentInfo{};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -407,6 +553,7 @@ void Window::CleanupDraw()
 
 	// Submits the image to the swap chain
 	VkResult result = vkQueuePresentKHR(presentQueue, &presentInfo);
+	latencyMonitor.Presented();
 
 	// Checks if the window size is out of date
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized)
@@ -422,7 +569,7 @@ void Window::CleanupDraw()
 	}
 
 	// Increments the current frame index
-	currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+	currentFrame = (currentFrame + 1) % framesInFlight;
 }
 
 /*********************************************************************************************/
@@ -436,35 +583,48 @@ void Window::Shutdown()
 	// Waits for any existing draw operations to be finished
 	vkDeviceWaitIdle(logicalDevice);
 
+	// Reports the last render config's measurements
+	latencyMonitor.End();
+
+	// Writes out any frames still waiting to be read back
+	frameCapture.Finish();
+	frameCapture.Free();
+	resolutionScaler.Free();
+
 	// Deletes the blank texture
 	delete blankTexture;
 
-	// Cleans up the swap chain
+	// Frees the per frame memory and stops the recording threads
+	spriteBatch.Free();
+	frameAllocator.Free();
+	commandRecorder.Free();
+
+	// Cleans up the swap chain, then the rest of the render graph
 	CleanupSwapChain();
+	renderGraph.Free();
 
 	// Destroys the render passes
 	baseScenePass.DestroyRenderPass(logicalDevice);
-	glitchMaskPass.DestroyRenderPass(logicalDevice);
 	postProcessPass.DestroyRenderPass(logicalDevice);
+	crtResolvePass.DestroyRenderPass(logicalDevice);
+	crtFilterPass.DestroyRenderPass(logicalDevice);
+	crtComputePass.DestroyRenderPass(logicalDevice);
 
-	// Cleans up the render pass, pipeline layout, and pipeline variables
-	vkDestroyPipelineCache(logicalDevice, pipelineCache, NULL);
+	// Keeps the compiled pipelines for next launch, then cleans up the cache
+	pipelineCache.Save();
+	pipelineCache.Destroy();
 
 	// Destroys the descriptor sets
 	vkDestroyDescriptorPool(logicalDevice, descriptorPool, NULL);
 	vkDestroyDescriptorSetLayout(logicalDevice, textureDescriptorSetLayout, NULL);
 
 	// Destroys the index buffer
-	vkUnmapMemory(logicalDevice, indexBufferMemory);
-	vkDestroyBuffer(logicalDevice, indexBuffer, NULL);
-	vkFreeMemory(logicalDevice, indexBufferMemory, NULL);
+	DestroyBuffer(indexBuffer, indexBufferMemory);
 
 	// Destroys the vertex buffer
-	vkUnmapMemory(logicalDevice, vertexBufferMemory);
-	vkDestroyBuffer(logicalDevice, vertexBuffer, NULL);
-	vkFreeMemory(logicalDevice, vertexBufferMemory, NULL);
+	DestroyBuffer(vertexBuffer, vertexBufferMemory);
 
-	// Loops to destroy the semaphores for each active frame
+	// Loops to destroy the semaphores for each frame
 	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
 		// Destroys the synchronization objects
@@ -476,6 +636,15 @@ void Window::Shutdown()
 	// Destroys the command pool
 	vkDestroyCommandPool(logicalDevice, commandPool, NULL);
 
+	// Destroys the upload batches now that every texture is gone
+	textureUploader.Free();
+
+	// Destroys the texture table now that every texture is gone
+	textureTable.Free();
+
+	// Gives back the memory blocks now that every buffer and image is gone
+	memoryAllocator.Free();
+
 	// Destroys the Vulkan instance
 	vkDestroyDevice(logicalDevice, NULL);
 	
@@ -490,8 +659,110 @@ void Window::Shutdown()
 	vkDestroyInstance(vulkanInstance, NULL);
 
 	// Destroys the window and turns off glfw
-	glfwDestroyWindow(window);
-	glfwTerminate();
+	if (window)
+	{
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Returns whether the window has been asked to close
+
+	\return
+		Whether the game should stop
+*/
+/*********************************************************************************************/
+bool Window::ShouldClose()
+{
+	return closeRequested || (window && glfwWindowShouldClose(window));
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Asks the window to close at the end of the frame
+*/
+/*********************************************************************************************/
+void Window::Close()
+{
+	closeRequested = true;
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Sets how much of the CRT look is drawn. Passes the chosen quality doesn't need are
+		dropped from the render graph, so changing it rebuilds the graph
+
+	\param quality
+		The CRT quality
+
+	\param useCompute
+		Whether the full quality's horizontal filter runs as a compute shader. Defaults to false
+*/
+/*********************************************************************************************/
+void Window::SetCrtQuality(CrtQuality quality, bool useCompute)
+{
+	if (quality == crtQuality && useCompute == crtCompute)
+	{
+		return;
+	}
+	crtQuality = quality;
+	crtCompute = useCompute;
+
+	// Before Init, the graph is just declared with the new quality
+	if (logicalDevice != NULL)
+	{
+		RebuildRenderGraph();
+	}
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Sets how frames are queued and presented. Once running, the swap chain is remade with
+		it at the start of the next frame, without restarting
+
+	\param config
+		The present mode, frames in flight and swap chain image count
+*/
+/*********************************************************************************************/
+void Window::SetRenderConfig(const RenderConfig& config)
+{
+	renderConfig = config;
+	if (renderConfig.framesInFlight < MIN_FRAMES_IN_FLIGHT || renderConfig.framesInFlight > MAX_FRAMES_IN_FLIGHT)
+	{
+		_Debug->Print(Debug::MessageType::Error, "Window: " + std::to_string(renderConfig.framesInFlight) + " frames in flight isn't supported, using " + std::to_string(framesInFlight));
+		renderConfig.framesInFlight = framesInFlight;
+	}
+
+	// Before Init, the swap chain is just made with the new config
+	if (logicalDevice == NULL)
+	{
+		framesInFlight = renderConfig.framesInFlight;
+		return;
+	}
+	renderConfigChanged = true;
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Sets how the cursor behaves over the window. Does nothing when headless
+
+	\param mode
+		The glfw cursor mode, e.g. GLFW_CURSOR_DISABLED
+*/
+/*********************************************************************************************/
+void Window::SetCursorMode(int mode)
+{
+	if (window)
+	{
+		glfwSetInputMode(window, GLFW_CURSOR, mode);
+	}
 }
 
 /*********************************************************************************************/
@@ -661,7 +932,7 @@ VkResult Window::CheckVulkanSuccess(VkResult functionResult, std::string errorMe
 		The buffer to be created
 
 	\param bufferMemory
-		The pointer to the buffer
+		The memory the buffer is bound to
 
 	\param bufferFlags
 		The properties of the buffer
@@ -673,20 +944,18 @@ VkResult Window::CheckVulkanSuccess(VkResult functionResult, std::string errorMe
 		The data to be written to the new buffer
 */
 /*********************************************************************************************/
-void Window::CreateVulkanBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkBufferUsageFlags bufferFlags, VkDeviceSize bufferSize, void* rawData)
+void Window::CreateVulkanBuffer(VkBuffer& buffer, MemoryAllocator::Allocation& bufferMemory, VkBufferUsageFlags bufferFlags, VkDeviceSize bufferSize, void* rawData)
 {
 	//// Creates a staging buffer
 	//VkBuffer stagingBuffer;
 	//VkDeviceMemory stagingBufferMemory;
 	//CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
 
-	// Creates the vertex buffer
-	CreateBuffer(bufferSize, bufferFlags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, buffer, bufferMemory);
+	// Creates the vertex buffer in host visible memory, device local too if the card has memory that's both
+	CreateBuffer(bufferSize, bufferFlags, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffer, bufferMemory, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
-	// Writes the vertex data into the staging buffer
-	void* data;
-	vkMapMemory(logicalDevice, bufferMemory, 0, bufferSize, 0, &data);
-	memcpy(data, rawData, (size_t)bufferSize);
+	// Writes the vertex data into the already mapped memory
+	memcpy(bufferMemory.mapped, rawData, (size_t)bufferSize);
 	//vkUnmapMemory(logicalDevice, stagingBufferMemory);
 
 	// Copies the staging buffer data to the vertex buffer
@@ -718,7 +987,7 @@ void Window::CreateVulkanInstance()
 	applicationInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);									// !!! Needs accurate game version !!!
 	applicationInfo.pEngineName = "Custom Engine made by Aiden Cvengros";
 	applicationInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);										// !!! Needs accurate engine version !!!
-	applicationInfo.apiVersion = VK_API_VERSION_1_0;
+	applicationInfo.apiVersion = VK_API_VERSION_1_1;
 
 	// Sets the information struct for creating the Vulkan instance
 	VkInstanceCreateInfo vulkanInstanceInfo{};
@@ -903,21 +1172,15 @@ VkResult Window::CreateDebugUtilsMessengerEXT(
 /*********************************************************************************************/
 bool Window::IsDeviceSuitable(VkPhysicalDevice device_)
 {
-	// Destroys each of the frame buffers
-	for (auto framebuffer : swapChainFramebuffers)
-	{
-		vkDestroyFramebuffer(logicalDevice, framebuffer, nullptr);
-	}
-
 	// Finds if there is a valid device queue
 	QueueFamilyIndices indices = FindQueueFamilies(device_);
 
 	// Checks whether the necessary extensions are supported by the device
 	bool extensionsSupported = CheckDeviceExtensionSupport(device_);
 
-	// Checks if swap chain is suitable for the game
-	bool swapChainAdequate = false;
-	if (extensionsSupported)
+	// Checks if swap chain is suitable for the game. Headless runs don't have one
+	bool swapChainAdequate = headless;
+	if (extensionsSupported && !headless)
 	{
 		SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(device_);
 		swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -963,9 +1226,16 @@ Window::QueueFamilyIndices Window::FindQueueFamilies(VkPhysicalDevice device)
 			indices.graphicsFamily = queueTypeIndex;
 		}
 
-		// Gets whether the device can render a surface
+		// Gets whether the device can render a surface. Headless runs never present, so the graphics queue stands in
 		VkBool32 presentSupport = false;
-		vkGetPhysicalDeviceSurfaceSupportKHR(device, queueTypeIndex, surface, &presentSupport);
+		if (headless)
+		{
+			presentSupport = indices.graphicsFamily.has_value();
+		}
+		else
+		{
+			vkGetPhysicalDeviceSurfaceSupportKHR(device, queueTypeIndex, surface, &presentSupport);
+		}
 
 		// If the device can render a surface, save it
 		if (presentSupport)
@@ -983,6 +1253,17 @@ Window::QueueFamilyIndices Window::FindQueueFamilies(VkPhysicalDevice device)
 		queueTypeIndex++;
 	}
 
+	// Looks for a family that can only copy, which is the card's dedicated copy engine
+	for (uint32_t i = 0; i < queueFamilyCount; i++)
+	{
+		VkQueueFlags flags = queueFamilies[i].queueFlags;
+		if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)))
+		{
+			indices.transferFamily = i;
+			break;
+		}
+	}
+
 	// Returns the queue family indices struct
 	return indices;
 }
@@ -1009,8 +1290,12 @@ bool Window::CheckDeviceExtensionSupport(VkPhysicalDevice device)
 	std::vector<VkExtensionProperties> availableExtensions(extensionCount);
 	vkEnumerateDeviceExtensionProperties(device, NULL, &extensionCount, availableExtensions.data());
 
-	// Gets a list of the different extensions we need
-	std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+	// Gets a list of the different extensions we need. Headless runs don't need the swap chain
+	std::set<std::string> requiredExtensions;
+	if (!headless)
+	{
+		requiredExtensions.insert(deviceExtensions.begin(), deviceExtensions.end());
+	}
 
 	// Checks if all of those extensions are present
 	for (const auto& extension : availableExtensions)
@@ -1076,14 +1361,35 @@ void Window::RecreateSwapChain()
 	// Waits for the previous frame to finish drawing
 	vkDeviceWaitIdle(logicalDevice);
 
+	// Every frame is finished, so the frame count can change. What the frames were holding on
+	// to is handed back first, and the next frame starts from the first
+	if (renderConfig.framesInFlight != framesInFlight)
+	{
+		for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+		{
+			textureUploader.FrameFinished(i);
+			frameCapture.FrameFinished(i);
+			resolutionScaler.FrameFinished(i);
+		}
+		framesInFlight = renderConfig.framesInFlight;
+		currentFrame = 0;
+	}
+
 	// Cleans up the old swap chain
 	CleanupSwapChain();
 
 	// Remakes the swap chain, image views, and frame buffers
 	CreateSwapChain();
 	CreateImageViews();
-	CreateFramebuffers();
+	CompileRenderGraph();
 	UpdateDescriptorSets();
+
+	// Measures the new render config on its own
+	if (renderConfigChanged)
+	{
+		renderConfigChanged = false;
+		latencyMonitor.Begin(DescribeRenderConfig());
+	}
 }
 
 /*********************************************************************************************/
@@ -1094,20 +1400,31 @@ void Window::RecreateSwapChain()
 /*********************************************************************************************/
 void Window::CleanupSwapChain()
 {
-	// Destroys the texture parts of the render passes
-	baseScenePass.DestroyTexture(logicalDevice);
-	glitchMaskPass.DestroyTexture(logicalDevice);
-	postProcessPass.DestroyTexture(logicalDevice);
+	// Destroys the render graph's targets and framebuffers, which are all sized to the swap chain
+	renderGraph.Release();
 
-	// Destroys all the frame buffers
-	for (size_t i = 0; i < swapChainFramebuffers.size(); i++)
+	// Destroys the swap chain image views
+	for (size_t i = 0; i < swapChainImageViews.size(); i++)
 	{
-		vkDestroyFramebuffer(logicalDevice, swapChainFramebuffers[i], nullptr);
-		_Debug->Print(Debug::MessageType::Debug, "Window: Destroyed swap chain framebuffers");
+		vkDestroyImageView(logicalDevice, swapChainImageViews[i], nullptr);
 	}
+	swapChainImageViews.clear();
 
-	// Destroys the swap chain
-	vkDestroySwapchainKHR(logicalDevice, swapChain, nullptr);
+	// Destroys the swap chain, or the images standing in for it
+	if (headless)
+	{
+		for (size_t i = 0; i < swapChainImages.size(); i++)
+		{
+			vkDestroyImage(logicalDevice, swapChainImages[i], NULL);
+			memoryAllocator.Release(offscreenImageMemory[i]);
+		}
+		swapChainImages.clear();
+		offscreenImageMemory.clear();
+	}
+	else
+	{
+		vkDestroySwapchainKHR(logicalDevice, swapChain, nullptr);
+	}
 }
 
 /*********************************************************************************************/
@@ -1152,6 +1469,10 @@ void Window::CreateLogicalDevice()
 	// Creates the structs that hold the info for the virtual command queues
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 	std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFamily.value(), indices.presentFamily.value() };
+	if (indices.transferFamily.has_value())
+	{
+		uniqueQueueFamilies.insert(indices.transferFamily.value());
+	}
 
 	// Populates the queue info structs
 	float queuePriority = 1.0f;
@@ -1170,14 +1491,29 @@ void Window::CreateLogicalDevice()
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+	// Turns on descriptor indexing for the bindless texture table if the card has it
+	std::vector<const char*> enabledExtensions = headless ? std::vector<const char*>() : deviceExtensions;
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+	bindlessTextures = TextureTable::IsSupported(physicalCard);
+	if (bindlessTextures)
+	{
+		TextureTable::GetRequiredFeatures(indexingFeatures);
+		enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+	}
+	else
+	{
+		_Debug->Print(Debug::MessageType::Debug, "Window: Descriptor indexing not supported, textures use their own descriptor sets");
+	}
+
 	// The info struct for the command queues and extensions the device is using
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 	createInfo.pEnabledFeatures = &deviceFeatures;
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+	createInfo.pNext = bindlessTextures ? &indexingFeatures : NULL;
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(enabledExtensions.size());
+	createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 
 	// If the validation layers are on
 	if (enableValidationLayers)
@@ -1198,6 +1534,10 @@ void Window::CreateLogicalDevice()
 	// Sets up the command queues on the new logical device
 	vkGetDeviceQueue(logicalDevice, indices.graphicsFamily.value(), 0, &graphicsQueue);
 	vkGetDeviceQueue(logicalDevice, indices.presentFamily.value(), 0, &presentQueue);
+	if (indices.transferFamily.has_value())
+	{
+		vkGetDeviceQueue(logicalDevice, indices.transferFamily.value(), 0, &transferQueue);
+	}
 }
 
 /*********************************************************************************************/
@@ -1257,13 +1597,15 @@ bool Window::CheckValidationLayerSupport()
 /*********************************************************************************************/
 std::vector<const char*> Window::GetRequiredExtensions()
 {
-	// Fetches the required extensions
-	uint32_t glfwExtensionCount = 0;
-	const char** glfwExtensions;
-	glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-
-	// Combines the extensions to be returned
-	std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	// Fetches the extensions glfw needs for the window surface, which headless runs don't have
+	std::vector<const char*> extensions;
+	if (!headless)
+	{
+		uint32_t glfwExtensionCount = 0;
+		const char** glfwExtensions;
+		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+	}
 
 	// If validations are on, we also need the validation layers extension
 	if (enableValidationLayers)
@@ -1283,16 +1625,25 @@ std::vector<const char*> Window::GetRequiredExtensions()
 /*********************************************************************************************/
 void Window::CreateSwapChain()
 {
+	// Headless runs draw into images of their own instead
+	if (headless)
+	{
+		CreateOffscreenImages();
+		return;
+	}
+
 	// Gets the swap chain support details
 	SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(physicalCard);
 
 	// Uses those details to find the format, presentation mode, and dimensions of the swap chain
 	VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
-	VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
+	presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
 	VkExtent2D extent = ChooseSwapExtent(swapChainSupport.capabilities);
 	
-	// Sets the number of images that will be available in the swap chain queue to one over the card's minimum
-	uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+	// Sets the number of images that will be available in the swap chain queue to what the render
+	// config asks for, or one over the card's minimum
+	uint32_t imageCount = renderConfig.swapChainImages > 0 ? renderConfig.swapChainImages : swapChainSupport.capabilities.minImageCount + 1;
+	imageCount = std::max(imageCount, swapChainSupport.capabilities.minImageCount);
 
 	// Ensures the image count isn't past the card's maximum
 	if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
@@ -1353,6 +1704,45 @@ void Window::CreateSwapChain()
 	swapChainExtent = extent;
 }
 
+/*********************************************************************************************/
+/*!
+	\brief
+		Creates the images the post process pass draws to when headless, one per frame in flight
+*/
+/*********************************************************************************************/
+void Window::CreateOffscreenImages()
+{
+	// Matches the format a window would most likely get so the shaders output the same values
+	swapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+	swapChainExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+
+	// The images are read back after drawing, so they need to be copy sources as well as attachments
+	VkImageCreateInfo imageInfo{};
+	imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.extent = { swapChainExtent.width, swapChainExtent.height, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.format = swapChainImageFormat;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	swapChainImages.resize(framesInFlight);
+	offscreenImageMemory.resize(framesInFlight);
+	for (int i = 0; i < framesInFlight; i++)
+	{
+		CheckVulkanSuccess(vkCreateImage(logicalDevice, &imageInfo, NULL, &swapChainImages[i]), "failed to create offscreen image!");
+
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(logicalDevice, swapChainImages[i], &memRequirements);
+		offscreenImageMemory[i] = memoryAllocator.Allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, true);
+		CheckVulkanSuccess(vkBindImageMemory(logicalDevice, swapChainImages[i], offscreenImageMemory[i].memory, offscreenImageMemory[i].offset), "failed to bind offscreen image memory!");
+	}
+}
+
 /*********************************************************************************************/
 /*!
 	\brief
@@ -1361,15 +1751,11 @@ void Window::CreateSwapChain()
 /*********************************************************************************************/
 void Window::CreateImageViews()
 {
-	// Ties the swap chain to the post process pass because it draws directly to the screen
+	// The post process pass draws straight to these. The offscreen targets belong to the render graph
 	for (size_t i = 0; i < swapChainImages.size(); i++)
 	{
-		postProcessPass.AddImageView(CreateImageView(swapChainImages[i], swapChainImageFormat));
+		swapChainImageViews.push_back(CreateImageView(swapChainImages[i], swapChainImageFormat));
 	}
-	
-	// Creates the textures the offscreen render passes are writing to
-	baseScenePass.CreateTexture(swapChainExtent.width, swapChainExtent.height, swapChainImageFormat);
-	glitchMaskPass.CreateTexture(swapChainExtent.width, swapChainExtent.height, swapChainImageFormat);
 }
 
 /*********************************************************************************************/
@@ -1380,24 +1766,41 @@ void Window::CreateImageViews()
 /*********************************************************************************************/
 void Window::CreateGraphicsPipeline()
 {
-	// Creates the pipeline cache to track different pipeline stages
-	VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
-	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-	if (vkCreatePipelineCache(logicalDevice, &pipelineCacheCreateInfo, NULL, &pipelineCache) != VK_SUCCESS)
-	{
-		throw std::runtime_error("failed to create pipeline cache");
-	}
+	// Creates the pipeline cache, starting from last run's pipelines if they were saved on this card
+	std::chrono::steady_clock::time_point pipelineStart = std::chrono::steady_clock::now();
+	pipelineCache.Create(logicalDevice, physicalCard, PIPELINE_CACHE_FILE);
+	VkPipelineCache cache = pipelineCache.GetCache();
 
-	// Sets the push constants for the pipeline
-	VkPushConstantRange psRange;
-	psRange.offset = 0;
-	psRange.size = sizeof(glm::mat4) + sizeof(glm::vec4) + 4;
-	psRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+	// With the texture table, set 1 is the whole table and the fragment shader picks each sprite's slot from it
+	VkDescriptorSetLayout spriteTextureLayout = bindlessTextures ? textureTable.GetDescriptorSetLayout() : textureDescriptorSetLayout;
+	std::string spriteFragmentShader = bindlessTextures ? "source/Shaders/2d_bindless_frag.spv" : "source/Shaders/2d_frag.spv";
 
-	// Creates the graphics pipelines
-	postProcessPass.CreateGraphicsPipeline(logicalDevice, pipelineCache, "source/Shaders/post_process_vert.spv", "source/Shaders/fisheye_frag.spv", {});
-	glitchMaskPass.CreateGraphicsPipeline(logicalDevice, pipelineCache, "source/Shaders/2d_vert.spv", "source/Shaders/2d_frag.spv", { textureDescriptorSetLayout }, &psRange);
-	baseScenePass.CreateGraphicsPipeline(logicalDevice, pipelineCache, "source/Shaders/2d_vert.spv", "source/Shaders/2d_frag.spv", { textureDescriptorSetLayout }, &psRange);
+	// The CRT shaders are specialized to the emulated screen, so its size lives in one place
+	struct
+	{
+		float virtualWidth;
+		float virtualHeight;
+		int32_t filterPhases;
+	} crtConstants = { (float)CRT_VIRTUAL_WIDTH, (float)CRT_VIRTUAL_HEIGHT, CRT_FILTER_PHASES };
+	std::array<VkSpecializationMapEntry, 3> crtConstantEntries{};
+	crtConstantEntries[0] = { 0, offsetof(decltype(crtConstants), virtualWidth), sizeof(float) };
+	crtConstantEntries[1] = { 1, offsetof(decltype(crtConstants), virtualHeight), sizeof(float) };
+	crtConstantEntries[2] = { 2, offsetof(decltype(crtConstants), filterPhases), sizeof(int32_t) };
+	VkSpecializationInfo crtSpecialization{};
+	crtSpecialization.mapEntryCount = (uint32_t)crtConstantEntries.size();
+	crtSpecialization.pMapEntries = crtConstantEntries.data();
+	crtSpecialization.dataSize = sizeof(crtConstants);
+	crtSpecialization.pData = &crtConstants;
+
+	// Creates the graphics pipelines. The 2d pipelines read each sprite's data from the sprite batch's instances
+	postProcessPass.CreateGraphicsPipeline(logicalDevice, cache, "source/Shaders/post_process_vert.spv", "source/Shaders/fisheye_frag.spv", {}, NULL, false, &crtSpecialization);
+	crtResolvePass.CreateGraphicsPipeline(logicalDevice, cache, "source/Shaders/post_process_vert.spv", "source/Shaders/crt_resolve_frag.spv", {}, NULL, false, &crtSpecialization);
+	crtFilterPass.CreateGraphicsPipeline(logicalDevice, cache, "source/Shaders/post_process_vert.spv", "source/Shaders/crt_filter_frag.spv", {}, NULL, false, &crtSpecialization);
+	crtComputePass.CreateComputePipeline(logicalDevice, cache, "source/Shaders/crt_filter_comp.spv", &crtSpecialization);
+	baseScenePass.CreateGraphicsPipeline(logicalDevice, cache, "source/Shaders/2d_vert.spv", spriteFragmentShader, { spriteTextureLayout }, NULL, true);
+
+	_Debug->Print(Debug::MessageType::Debug, "Window: Built pipelines in " + std::to_string(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pipelineStart).count()) + " ms with a "
+		+ (pipelineCache.IsWarm() ? "warm" : "cold") + " pipeline cache");
 }
 
 /*********************************************************************************************/
@@ -1431,30 +1834,80 @@ VkSurfaceFormatKHR Window::ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFo
 /*********************************************************************************************/
 /*!
 	\brief
-		Selects a swap chain presentation format
+		Selects the present mode the render config asks for, or fifo if the surface doesn't
+		have it
 
 	\param availablePresentModes
-		The list of formats to choose from
+		The list of modes to choose from
 
 	\return
-		The format we want
+		The mode to make the swap chain with
 */
 /*********************************************************************************************/
 VkPresentModeKHR Window::ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 {
-	// Goes through each available mode
+	// In the order of PresentMode
+	const VkPresentModeKHR presentModes[] = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR };
+	VkPresentModeKHR wantedMode = presentModes[(int)renderConfig.presentMode];
+
+	// Goes through each available mode for the one the render config wants
 	for (const auto& availablePresentMode : availablePresentModes)
 	{
-		// We want the mailbox triple-buffered mode
-		if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+		if (availablePresentMode == wantedMode)
 		{
 			return availablePresentMode;
 		}
 	}
 
+	// Every surface has fifo
+	_Debug->Print(Debug::MessageType::Debug, "Window: " + PresentModeName(wantedMode) + " isn't supported, using " + PresentModeName(VK_PRESENT_MODE_FIFO_KHR));
 	return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+/*********************************************************************************************/
+/*!
+	\brief
+		Names a present mode, for messages
+
+	\param mode
+		The present mode
+
+	\return
+		The mode's name
+*/
+/*********************************************************************************************/
+std::string Window::PresentModeName(VkPresentModeKHR mode)
+{
+	switch (mode)
+	{
+	case VK_PRESENT_MODE_MAILBOX_KHR:
+		return "mailbox";
+	case VK_PRESENT_MODE_IMMEDIATE_KHR:
+		return "immediate";
+	case VK_PRESENT_MODE_FIFO_KHR:
+		return "fifo";
+	case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+		return "fifo relaxed";
+	default:
+		return "present mode " + std::to_string((int)mode);
+	}
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Describes the render config the swap chain was actually made with, for measuring it
+
+	\return
+		The present mode, frames in flight and swap chain image count
+*/
+/*********************************************************************************************/
+std::string Window::DescribeRenderConfig()
+{
+	std::string description = headless ? std::string("headless") : PresentModeName(presentMode);
+	return description + ", " + std::to_string(framesInFlight) + " frames in flight, " + std::to_string(swapChainImages.size()) + " images";
+}
+
 /*********************************************************************************************/
 /*!
 	\brief
@@ -1499,26 +1952,126 @@ VkExtent2D Window::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities
 /*********************************************************************************************/
 void Window::CreateRenderPass()
 {
-	// Creates the render pass
-	postProcessPass.CreateRenderPass(true, logicalDevice, swapChainImageFormat);
-	glitchMaskPass.CreateRenderPass(false, logicalDevice, swapChainImageFormat);
-	baseScenePass.CreateRenderPass(false, logicalDevice, swapChainImageFormat);
+	// Creates the render passes. The base scene pass draws the scene and the glitch mask at once,
+	// and the CRT filter both of its filtered rows. The compute filter needs no render pass
+	postProcessPass.CreateRenderPass(logicalDevice, { swapChainImageFormat });
+	baseScenePass.CreateRenderPass(logicalDevice, { swapChainImageFormat, swapChainImageFormat });
+	crtResolvePass.CreateRenderPass(logicalDevice, { CRT_TARGET_FORMAT });
+	crtFilterPass.CreateRenderPass(logicalDevice, { CRT_TARGET_FORMAT, CRT_TARGET_FORMAT });
 }
 
 /*********************************************************************************************/
 /*!
 	\brief
-		Creates the frame buffers for the swap chain
+		Declares the frame's targets and passes to the render graph. Each pass lists what it
+		reads and writes, and the graph works out the rest
 */
 /*********************************************************************************************/
-void Window::CreateFramebuffers()
+void Window::CreateRenderGraph()
 {
-	// Creates the framebuffers for the offscreen render passes
-	baseScenePass.SetFramebuffers(logicalDevice, swapChainExtent);
-	glitchMaskPass.SetFramebuffers(logicalDevice, swapChainExtent);
+	renderGraph.Init(logicalDevice);
+
+	// The screen is left ready to present, or to be read back when there's no window. The CRT
+	// targets are sized to the emulated screen, with the filtered rows holding every phase
+	sceneTarget = renderGraph.AddTarget("scene", swapChainImageFormat);
+	glitchMaskTarget = renderGraph.AddTarget("glitch mask", swapChainImageFormat);
+	screenTarget = renderGraph.Import("screen", swapChainImageFormat, headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	virtualSceneTarget = renderGraph.AddTarget("virtual scene", CRT_TARGET_FORMAT, { CRT_VIRTUAL_WIDTH, CRT_VIRTUAL_HEIGHT });
+	filteredRows5Target = renderGraph.AddTarget("filtered rows 5", CRT_TARGET_FORMAT, { CRT_VIRTUAL_WIDTH * CRT_FILTER_PHASES, CRT_VIRTUAL_HEIGHT });
+	filteredRows3Target = renderGraph.AddTarget("filtered rows 3", CRT_TARGET_FORMAT, { CRT_VIRTUAL_WIDTH * CRT_FILTER_PHASES, CRT_VIRTUAL_HEIGHT });
+
+	// The base scene is recorded on the sprite recording threads. Glitches are drawn in the same
+	// pass, to the mask in its second attachment. Both are only drawn as big as the resolution
+	// scaler allows
+	RenderGraph::PassInfo scenePass{};
+	scenePass.name = "base scene";
+	scenePass.renderPass = &baseScenePass;
+	scenePass.writes = { sceneTarget, glitchMaskTarget };
+	scenePass.clearValues = { { {{0.05f, 0.5f, 0.8f, 1.0f}} }, { {{1.0f, 1.0f, 1.0f, 0.0f}} } };
+	scenePass.contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+	scenePass.renderArea = &sceneExtent;
+	scenePass.record = [this](VkCommandBuffer commandBuffer_, VkFramebuffer framebuffer) { RecordSpritePass(baseScenePass, spriteBatch, commandBuffer_, framebuffer); };
+	renderGraph.AddPass(scenePass);
+
+	// Post effects read what the passes before them wrote. The CRT passes are always declared,
+	// and the graph drops the ones the chosen quality doesn't read
+	RenderGraph::PassInfo resolvePass{};
+	resolvePass.name = "crt resolve";
+	resolvePass.renderPass = &crtResolvePass;
+	resolvePass.reads = { sceneTarget };
+	resolvePass.writes = { virtualSceneTarget };
+	resolvePass.clearValues = { { {{0.0f, 0.0f, 0.0f, 1.0f}} } };
+	resolvePass.contents = VK_SUBPASS_CONTENTS_INLINE;
+	resolvePass.record = [this](VkCommandBuffer commandBuffer_, VkFramebuffer framebuffer) { RecordFullscreenPass(crtResolvePass, commandBuffer_, renderGraph.GetExtent(virtualSceneTarget)); };
+	renderGraph.AddPass(resolvePass);
+
+	RenderGraph::PassInfo filterPass{};
+	filterPass.name = "crt filter";
+	filterPass.reads = { virtualSceneTarget };
+	filterPass.writes = { filteredRows5Target, filteredRows3Target };
+	if (crtCompute)
+	{
+		filterPass.renderPass = &crtComputePass;
+		filterPass.compute = true;
+		filterPass.record = [this](VkCommandBuffer commandBuffer_, VkFramebuffer framebuffer) { RecordCrtFilterCompute(commandBuffer_); };
+	}
+	else
+	{
+		filterPass.renderPass = &crtFilterPass;
+		filterPass.clearValues = { { {{0.0f, 0.0f, 0.0f, 1.0f}} }, { {{0.0f, 0.0f, 0.0f, 1.0f}} } };
+		filterPass.contents = VK_SUBPASS_CONTENTS_INLINE;
+		filterPass.record = [this](VkCommandBuffer commandBuffer_, VkFramebuffer framebuffer) { RecordFullscreenPass(crtFilterPass, commandBuffer_, renderGraph.GetExtent(filteredRows5Target)); };
+	}
+	renderGraph.AddPass(filterPass);
 
-	// The post process pass is tied to the framebuffers so it gets a separate call
-	postProcessPass.SetSwapChainFramebuffers(logicalDevice, swapChainFramebuffers, swapChainExtent);
+	RenderGraph::PassInfo fisheyePass{};
+	fisheyePass.name = "fisheye";
+	fisheyePass.renderPass = &postProcessPass;
+	fisheyePass.reads = { sceneTarget, glitchMaskTarget };
+	if (crtQuality == CrtQuality::Full)
+	{
+		fisheyePass.reads.push_back(filteredRows5Target);
+		fisheyePass.reads.push_back(filteredRows3Target);
+	}
+	else if (crtQuality == CrtQuality::Scanline)
+	{
+		fisheyePass.reads.push_back(virtualSceneTarget);
+	}
+	fisheyePass.writes = { screenTarget };
+	fisheyePass.clearValues = { { {{0.0f, 0.1f, 0.2f, 1.0f}} } };
+	fisheyePass.contents = VK_SUBPASS_CONTENTS_INLINE;
+	fisheyePass.record = [this](VkCommandBuffer commandBuffer_, VkFramebuffer framebuffer) { RecordFullscreenPass(postProcessPass, commandBuffer_, swapChainExtent); };
+	renderGraph.AddPass(fisheyePass);
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Gives the render graph the swap chain images and has it make its targets and
+		framebuffers at the swap chain's size
+*/
+/*********************************************************************************************/
+void Window::CompileRenderGraph()
+{
+	renderGraph.SetImportedImages(screenTarget, swapChainImages, swapChainImageViews);
+	renderGraph.Compile(swapChainExtent);
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Declares and compiles the render graph again, for when its passes change. Waits for
+		the device to be idle
+*/
+/*********************************************************************************************/
+void Window::RebuildRenderGraph()
+{
+	vkDeviceWaitIdle(logicalDevice);
+
+	renderGraph.Free();
+	CreateRenderGraph();
+	CompileRenderGraph();
+	UpdateDescriptorSets();
 }
 
 /*********************************************************************************************/
@@ -1559,6 +2112,19 @@ void Window::CreateCommandPool()
 	CheckVulkanSuccess(vkAllocateCommandBuffers(logicalDevice, &allocInfo, commandBuffer.data()), "failed to allocate command buffers!");
 }
 
+/*********************************************************************************************/
+/*!
+	\brief
+		Sets up the texture uploader on the transfer queue, or the graphics queue if there isn't one
+*/
+/*********************************************************************************************/
+void Window::InitTextureUploader()
+{
+	QueueFamilyIndices indices = FindQueueFamilies(physicalCard);
+	int transferFamily = indices.transferFamily.has_value() ? (int)indices.transferFamily.value() : -1;
+	textureUploader.Init(logicalDevice, indices.graphicsFamily.value(), graphicsQueue, transferFamily, transferQueue);
+}
+
 /*********************************************************************************************/
 /*!
 	\brief
@@ -1584,24 +2150,113 @@ void Window::SetupCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageInd
 /*********************************************************************************************/
 /*!
 	\brief
-		Private function to record a graphics command
+		Records a sprite batch into a render pass the render graph has begun
+
+	\param pass
+		The render pass being recorded, for its pipeline and descriptor sets
+
+	\param batch
+		The sprites queued for the pass
 
 	\param commandBuffer
-		The command buffer to record the command to
+		The command buffer the pass was begun in
+
+	\param framebuffer
+		The framebuffer the pass was begun with
 */
 /*********************************************************************************************/
-void Window::RecordCommandBuffer(VkCommandBuffer commandBuffer)
+void Window::RecordSpritePass(RenderPass& pass, SpriteBatch& batch, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer)
 {
-	// Sets the vertex buffers
-	VkBuffer vertexBuffers[] = { vertexBuffer };
-	VkDeviceSize offsets[] = { 0 };
-	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	// Gives the recording threads the pipeline, viewport and descriptor sets to bind. The
+	// viewport only covers the part of the targets the resolution scaler picked
+	CommandRecorder::PassState passState{};
+	passState.renderPass = pass.GetRenderPass();
+	passState.framebuffer = framebuffer;
+	passState.pipeline = pass.GetGraphicsPipeline();
+	passState.pipelineLayout = pass.GetGraphicsPipelineLayout();
+	passState.frameSet = pass.GetDescriptorSets()[currentFrame];
+	passState.extent = sceneExtent;
+	commandRecorder.BeginPass(passState);
+
+	batch.Flush(commandBuffer);
+}
 
-	// Sets the index buffer
-	vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+/*********************************************************************************************/
+/*!
+	\brief
+		Records the copies for every queued texture region, each between barriers that keep
+		it from overlapping the draws reading the texture
 
-	// THE MOTHAFUCKIN' DRAW CALL
-	vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(defaultRectIndices.size()), 1, 0, 0, 0);
+	\param commandBuffer
+		The frame's command buffer, outside of any render pass
+*/
+/*********************************************************************************************/
+void Window::RecordTextureUpdates(VkCommandBuffer commandBuffer)
+{
+	for (const TextureUpdate& update : textureUpdates)
+	{
+		// The pixels ride along in the frame's memory, which lives until the frame is finished
+		FrameAllocator::Allocation allocation = frameAllocator.Allocate(update.pixels.size());
+		memcpy(allocation.data, update.pixels.data(), update.pixels.size());
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = update.texture->GetImage();
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		// Earlier frames may still be drawing from the texture, so the copy waits for them
+		barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = allocation.offset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { update.offset.x, update.offset.y, 0 };
+		region.imageExtent = { update.extent.width, update.extent.height, 1 };
+		vkCmdCopyBufferToImage(commandBuffer, allocation.buffer, update.texture->GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+		// And this frame's draws wait for the copy
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 0, NULL, 1, &barrier);
+	}
+	textureUpdates.clear();
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Prints the frame's sprite, memory, pass and scaling numbers to the debug log
+*/
+/*********************************************************************************************/
+void Window::PrintFrameStats()
+{
+	_Debug->Print(Debug::MessageType::Debug, "Window: " + std::to_string(spriteBatch.GetSpriteCount()) + " sprites in " + std::to_string(spriteBatch.GetDrawCallCount()) + " draw calls, "
+		+ std::to_string(frameAllocator.GetUsedBytes()) + " of " + std::to_string(frameAllocator.GetCapacity()) + " frame bytes (peak " + std::to_string(frameAllocator.GetHighWaterMark()) + ")");
+
+	const RenderGraph::Stats& graphStats = renderGraph.GetStats();
+	_Debug->Print(Debug::MessageType::Debug, "Window: " + std::to_string(graphStats.passCount) + " render passes (" + std::to_string(graphStats.culledPassCount) + " culled), "
+		+ std::to_string(graphStats.targetCount) + " targets in " + std::to_string(graphStats.allocatedBytes) + " bytes (" + std::to_string(graphStats.unaliasedBytes) + " unaliased)");
+
+	ResolutionScaler::Stats scalerStats = resolutionScaler.GetStats();
+	_Debug->Print(Debug::MessageType::Debug, "Window: Scene drawn at " + std::to_string(sceneExtent.width) + "x" + std::to_string(sceneExtent.height) + " ("
+		+ std::to_string(scalerStats.scale) + " scale), " + std::to_string(scalerStats.gpuMilliseconds) + " ms on the GPU");
 }
 
 /*********************************************************************************************/
@@ -1689,7 +2344,10 @@ uint32_t Window::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags prope
 			Return value for the resulting buffer
 
 		\param bufferMemory
-			Pointer to the buffer in memory
+			Return value for the memory the buffer is bound to. Host visible memory is already mapped
+
+		\param preferredProperties
+			Properties the memory should have if the card has such a type
 	*/
 	/*********************************************************************************************/
 void Window::CreateBuffer(
@@ -1697,7 +2355,8 @@ void Window::CreateBuffer(
 	VkBufferUsageFlags usage,
 	VkMemoryPropertyFlags properties,
 	VkBuffer& buffer,
-	VkDeviceMemory& bufferMemory)
+	MemoryAllocator::Allocation& bufferMemory,
+	VkMemoryPropertyFlags preferredProperties)
 {
 	// Creates the vertex buffer
 	VkBufferCreateInfo bufferInfo{};
@@ -1713,17 +2372,30 @@ void Window::CreateBuffer(
 	VkMemoryRequirements memRequirements;
  	vkGetBufferMemoryRequirements(logicalDevice, buffer, &memRequirements);
 
-	// Info block for allocating graphics memory
-	VkMemoryAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocInfo.allocationSize = memRequirements.size;
-	allocInfo.memoryTypeIndex = FindMemoryType(memRequirements.memoryTypeBits, properties);
-
-	// Checks that memory allocates correctly
-	CheckVulkanSuccess(vkAllocateMemory(logicalDevice, &allocInfo, NULL, &bufferMemory), "failed to allocate buffer memory!");
+	// Takes a piece of one of the allocator's blocks
+	bufferMemory = memoryAllocator.Allocate(memRequirements, properties, preferredProperties);
 
 	// Binds the vertex buffer to the allocated memory
-	vkBindBufferMemory(logicalDevice, buffer, bufferMemory, 0);
+	CheckVulkanSuccess(vkBindBufferMemory(logicalDevice, buffer, bufferMemory.memory, bufferMemory.offset), "failed to bind buffer memory!");
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Destroys a buffer made with CreateBuffer and gives back its memory
+
+	\param buffer
+		The buffer to destroy. Set to null afterwards
+
+	\param bufferMemory
+		The buffer's memory
+*/
+/*********************************************************************************************/
+void Window::DestroyBuffer(VkBuffer& buffer, MemoryAllocator::Allocation& bufferMemory)
+{
+	vkDestroyBuffer(logicalDevice, buffer, NULL);
+	memoryAllocator.Release(bufferMemory);
+	buffer = NULL;
 }
 
 /*********************************************************************************************/
@@ -1764,10 +2436,15 @@ void Window::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize siz
 void Window::CreateDescriptorSetLayout()
 {
 	// Creates the first layer of the descriptor set layout for the render passes
-	std::vector<VkDescriptorType> postProcessDescriptor{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER };
+	// The post process pass reads the scene, the glitch mask, both filtered rows and the virtual scene
+	std::vector<VkDescriptorType> postProcessDescriptor{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER };
 	postProcessPass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_FRAGMENT_BIT, postProcessDescriptor);
-	glitchMaskPass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_VERTEX_BIT, { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER });
 	baseScenePass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_VERTEX_BIT, { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER });
+	crtResolvePass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_FRAGMENT_BIT, { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER });
+	crtFilterPass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_FRAGMENT_BIT, { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER });
+	crtComputePass.CreateDescriptorSetLayout(logicalDevice, VK_SHADER_STAGE_COMPUTE_BIT,
+		{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE });
 
 	// Creates the sampler layout
 	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
@@ -1797,12 +2474,60 @@ void Window::CreateUniformBuffers()
 	VkDeviceSize fisheyeUniformBufferSize = sizeof(FisheyeUniformBufferObject);
 	VkDeviceSize defaultUniformBufferSize = sizeof(UniformBufferObject);
 
-	// The scene render pass and the glitch mask render pass use a single default uniform buffer
-	baseScenePass.CreateUniformBuffers(logicalDevice, defaultUniformBufferSize, 1);
-	glitchMaskPass.CreateUniformBuffers(logicalDevice, defaultUniformBufferSize, 1);
-
-	// The onscreen render pass has a fisheye ubo for each swap chain framebuffer
+	// Every render pass has a ubo for each frame that can be in flight, so a frame never writes over one the GPU is still reading
+	baseScenePass.CreateUniformBuffers(logicalDevice, defaultUniformBufferSize, MAX_FRAMES_IN_FLIGHT);
 	postProcessPass.CreateUniformBuffers(logicalDevice, fisheyeUniformBufferSize, MAX_FRAMES_IN_FLIGHT);
+	crtResolvePass.CreateUniformBuffers(logicalDevice, sizeof(CrtResolveUniformBufferObject), MAX_FRAMES_IN_FLIGHT);
+	crtFilterPass.CreateUniformBuffers(logicalDevice, sizeof(CrtFilterUniformBufferObject), MAX_FRAMES_IN_FLIGHT);
+	crtComputePass.CreateUniformBuffers(logicalDevice, sizeof(CrtFilterUniformBufferObject), MAX_FRAMES_IN_FLIGHT);
+
+	// The filter's weights never change, so they're only written once
+	FillCrtFilterWeights();
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Fills every frame's CRT filter uniform buffers with the horizontal filter's weights
+*/
+/*********************************************************************************************/
+void Window::FillCrtFilterWeights()
+{
+	if (CRT_FILTER_PHASES < 2 || CRT_FILTER_PHASES > CRT_MAX_FILTER_PHASES)
+	{
+		throw std::runtime_error("Window: The CRT filter needs between 2 and " + std::to_string(CRT_MAX_FILTER_PHASES) + " phases");
+	}
+
+	// The phases run from the left edge of an emulated pixel to its right. Each tap's weight is
+	// the same gaussian the filter always used, from how far the tap is from that spot
+	CrtFilterUniformBufferObject cubo{};
+	for (int phase = 0; phase < CRT_FILTER_PHASES; phase++)
+	{
+		float distance = 0.5f - (float)phase / (float)(CRT_FILTER_PHASES - 1);
+		float weights5[5];
+		float weights3[3];
+		float total5 = 0.0f;
+		float total3 = 0.0f;
+		for (int tap = -2; tap <= 2; tap++)
+		{
+			weights5[tap + 2] = std::exp2(-3.0f * (distance + tap) * (distance + tap));
+			total5 += weights5[tap + 2];
+			if (tap >= -1 && tap <= 1)
+			{
+				weights3[tap + 1] = weights5[tap + 2];
+				total3 += weights3[tap + 1];
+			}
+		}
+
+		cubo.weights[phase * 2] = glm::vec4(weights5[0] / total5, weights5[1] / total5, weights5[2] / total5, weights5[3] / total5);
+		cubo.weights[phase * 2 + 1] = glm::vec4(weights5[4] / total5, weights3[0] / total3, weights3[1] / total3, weights3[2] / total3);
+	}
+
+	for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		crtFilterPass.UpdateUniformBuffer(logicalDevice, sizeof(cubo), &cubo, i);
+		crtComputePass.UpdateUniformBuffer(logicalDevice, sizeof(cubo), &cubo, i);
+	}
 }
 
 /*********************************************************************************************/
@@ -1829,11 +2554,19 @@ void Window::UpdateUniformBuffers(uint32_t currentImage)
 	fubo.fisheyeStrength = 0.23f;
 	fubo.screenWidth = (float)swapChainExtent.width;
 	fubo.screenHeight = (float)swapChainExtent.height;
+	fubo.crtQuality = (uint32_t)crtQuality;
+
+	// The post passes only read the part of the scene that was drawn to, stretching it back
+	// over the screen
+	glm::vec2 renderScale((float)sceneExtent.width / (float)swapChainExtent.width, (float)sceneExtent.height / (float)swapChainExtent.height);
+	fubo.renderScale = renderScale;
+	CrtResolveUniformBufferObject rubo{};
+	rubo.renderScale = renderScale;
 
 	// Sets the uniform buffers
-	baseScenePass.UpdateUniformBuffer(logicalDevice, sizeof(ubo), &ubo);
-	glitchMaskPass.UpdateUniformBuffer(logicalDevice, sizeof(ubo), &ubo);
+	baseScenePass.UpdateUniformBuffer(logicalDevice, sizeof(ubo), &ubo, currentFrame);
 	postProcessPass.UpdateUniformBuffer(logicalDevice, sizeof(fubo), &fubo, currentFrame);
+	crtResolvePass.UpdateUniformBuffer(logicalDevice, sizeof(rubo), &rubo, currentFrame);
 }
 
 /*********************************************************************************************/
@@ -1844,12 +2577,15 @@ void Window::UpdateUniformBuffers(uint32_t currentImage)
 /*********************************************************************************************/
 void Window::CreateDescriptorPool()
 {
-	// Defines the number of descriptors in the pools
-	std::array<VkDescriptorPoolSize, 2> poolSizes{};
+	// Defines the number of descriptors in the pools. The render passes' sets take 5 uniform
+	// buffers, 8 samplers and 2 storage images each frame, on top of the textures
+	std::array<VkDescriptorPoolSize, 3> poolSizes{};
 	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) + 8;
+	poolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 5 + 8;
 	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[1].descriptorCount = 64;
+	poolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 8 + 64;
+	poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+	poolSizes[2].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 2;
 
 	// Sets the pool info based on the pool size
 	VkDescriptorPoolCreateInfo poolInfo{};
@@ -1857,7 +2593,7 @@ void Window::CreateDescriptorPool()
 	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) + 64 + 8;
+	poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT) * 5 + 64 + 8;
 
 	// Creates the descriptor pool
 	CheckVulkanSuccess(vkCreateDescriptorPool(logicalDevice, &poolInfo, NULL, &descriptorPool), "failed to create descriptor pool!");
@@ -1872,9 +2608,11 @@ void Window::CreateDescriptorPool()
 void Window::CreateDescriptorSets()
 {
 	// Creates the descriptor sets for the render passes
-	baseScenePass.CreateDescriptorSet(logicalDevice, descriptorPool, 1);
-	glitchMaskPass.CreateDescriptorSet(logicalDevice, descriptorPool, 1);
+	baseScenePass.CreateDescriptorSet(logicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
 	postProcessPass.CreateDescriptorSet(logicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
+	crtResolvePass.CreateDescriptorSet(logicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
+	crtFilterPass.CreateDescriptorSet(logicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
+	crtComputePass.CreateDescriptorSet(logicalDevice, descriptorPool, MAX_FRAMES_IN_FLIGHT);
 	
 	// Updates the newly created descriptor sets
 	UpdateDescriptorSets();
@@ -1890,8 +2628,10 @@ void Window::UpdateDescriptorSets()
 {
 	// Updates the uniform buffers of the descriptor sets
 	baseScenePass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(UniformBufferObject));
-	glitchMaskPass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(UniformBufferObject));
 	postProcessPass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(FisheyeUniformBufferObject));
+	crtResolvePass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(CrtResolveUniformBufferObject));
+	crtFilterPass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(CrtFilterUniformBufferObject));
+	crtComputePass.UpdateDescriptorSetUniformBuffer(logicalDevice, sizeof(CrtFilterUniformBufferObject));
 
 	// The post process pass has other descriptor sets besides the uniform buffer that need to be manually set
 	for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -1908,16 +2648,73 @@ void Window::UpdateDescriptorSets()
 		// The first additional descriptor is the base scene pass's output
 		VkDescriptorImageInfo imageInfo{};
 		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		imageInfo.imageView = baseScenePass.GetOutputTexture()->GetImageView();
-		imageInfo.sampler = baseScenePass.GetOutputTexture()->GetSampler();
+		imageInfo.imageView = renderGraph.GetImageView(sceneTarget);
+		imageInfo.sampler = renderGraph.GetSampler();
 		descriptorWrite.pImageInfo = &imageInfo;
 		vkUpdateDescriptorSets(logicalDevice, 1, &descriptorWrite, 0, NULL);
 
 		// The second descriptor is the glitch mask output
-		imageInfo.imageView = glitchMaskPass.GetOutputTexture()->GetImageView();
-		imageInfo.sampler = glitchMaskPass.GetOutputTexture()->GetSampler();
+		imageInfo.imageView = renderGraph.GetImageView(glitchMaskTarget);
 		descriptorWrite.dstBinding = 2;
 		vkUpdateDescriptorSets(logicalDevice, 1, &descriptorWrite, 0, NULL);
+
+		// Then the CRT targets. The ones the chosen quality dropped have no image, so the scene
+		// stands in for them, since the shader never reads them
+		std::array<RenderGraph::Resource, 3> crtTargets = { filteredRows5Target, filteredRows3Target, virtualSceneTarget };
+		for (size_t target = 0; target < crtTargets.size(); target++)
+		{
+			VkImageView crtView = renderGraph.GetImageView(crtTargets[target]);
+			imageInfo.imageView = crtView != VK_NULL_HANDLE ? crtView : renderGraph.GetImageView(sceneTarget);
+			descriptorWrite.dstBinding = 3 + (uint32_t)target;
+			vkUpdateDescriptorSets(logicalDevice, 1, &descriptorWrite, 0, NULL);
+		}
+
+		// The CRT passes' own sets are only bound when their pass runs
+		VkImageView virtualSceneView = renderGraph.GetImageView(virtualSceneTarget);
+		if (virtualSceneView == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		imageInfo.imageView = renderGraph.GetImageView(sceneTarget);
+		descriptorWrite.dstSet = crtResolvePass.GetDescriptorSets()[i];
+		descriptorWrite.dstBinding = 1;
+		vkUpdateDescriptorSets(logicalDevice, 1, &descriptorWrite, 0, NULL);
+
+		VkImageView rows5View = renderGraph.GetImageView(filteredRows5Target);
+		if (rows5View == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		// Both filters sample the virtual scene. The compute one writes the rows as storage images
+		imageInfo.imageView = virtualSceneView;
+		descriptorWrite.dstSet = crtCompute ? crtComputePass.GetDescriptorSets()[i] : crtFilterPass.GetDescriptorSets()[i];
+		descriptorWrite.dstBinding = 1;
+		vkUpdateDescriptorSets(logicalDevice, 1, &descriptorWrite, 0, NULL);
+
+		if (crtCompute)
+		{
+			VkDescriptorImageInfo storageInfos[2]{};
+			storageInfos[0].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+			storageInfos[0].imageView = rows5View;
+			storageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+			storageInfos[1].imageView = renderGraph.GetImageView(filteredRows3Target);
+
+			VkWriteDescriptorSet storageWrite{};
+			storageWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			storageWrite.dstSet = crtComputePass.GetDescriptorSets()[i];
+			storageWrite.dstBinding = 2;
+			storageWrite.dstArrayElement = 0;
+			storageWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+			storageWrite.descriptorCount = 1;
+			storageWrite.pImageInfo = &storageInfos[0];
+			vkUpdateDescriptorSets(logicalDevice, 1, &storageWrite, 0, NULL);
+
+			storageWrite.dstBinding = 3;
+			storageWrite.pImageInfo = &storageInfos[1];
+			vkUpdateDescriptorSets(logicalDevice, 1, &storageWrite, 0, NULL);
+		}
 	}
 }
 
@@ -1975,38 +2772,61 @@ VkImageView Window::CreateImageView(VkImage image, VkFormat format)
 /*********************************************************************************************/
 /*!
 	\brief
-		Runs the render pass for the post process shaders
+		Records a full screen triangle with a post process pass's shaders into the pass the
+		render graph has begun
+
+	\param pass
+		The render pass whose pipeline and frame descriptor set are used
+
+	\param commandBuffer_
+		The command buffer the pass was begun in
+
+	\param extent
+		The size of what the pass draws to
 */
 /*********************************************************************************************/
-void Window::RunFisheyeRenderPass()
+void Window::RecordFullscreenPass(RenderPass& pass, VkCommandBuffer commandBuffer_, VkExtent2D extent)
 {
-	// Sets the info for the post-processing render pass
-	VkRenderPassBeginInfo renderPassInfo{};
-	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-	renderPassInfo.renderPass = postProcessPass.GetRenderPass();
-	renderPassInfo.framebuffer = swapChainFramebuffers[imageIndex];
-	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapChainExtent;
-	VkClearValue clearColor = { {{0.0f, 0.1f, 0.2f, 1.0f}} };
-	renderPassInfo.clearValueCount = 1;
-	renderPassInfo.pClearValues = &clearColor;
-	
-	// Starts the render pass
-	vkCmdBeginRenderPass(commandBuffer[currentFrame], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
 	// Sets the vertex buffers
 	VkBuffer vertexBuffers[] = { vertexBuffer };
 	VkDeviceSize offsets[] = { 0 };
-	vkCmdBindVertexBuffers(commandBuffer[currentFrame], 0, 1, vertexBuffers, offsets);
+	vkCmdBindVertexBuffers(commandBuffer_, 0, 1, vertexBuffers, offsets);
 
 	// Sets the index buffer
-	vkCmdBindIndexBuffer(commandBuffer[currentFrame], indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+	vkCmdBindIndexBuffer(commandBuffer_, indexBuffer, 0, VK_INDEX_TYPE_UINT16);
 
-	// Sets the fisheye lense pass
-	vkCmdBindDescriptorSets(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, postProcessPass.GetGraphicsPipelineLayout(), 0, 1, &postProcessPass.GetDescriptorSets()[currentFrame], 0, NULL);
-	vkCmdBindPipeline(commandBuffer[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, postProcessPass.GetGraphicsPipeline());
-	vkCmdDraw(commandBuffer[currentFrame], 3, 1, 0, 0);
+	// Covers the whole target, whatever size it is
+	VkViewport viewport{};
+	viewport.width = static_cast<float>(extent.width);
+	viewport.height = static_cast<float>(extent.height);
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer_, 0, 1, &viewport);
 
-	// Ends the render pass
-	vkCmdEndRenderPass(commandBuffer[currentFrame]);
+	VkRect2D scissor{};
+	scissor.extent = extent;
+	vkCmdSetScissor(commandBuffer_, 0, 1, &scissor);
+
+	// Sets the pass's shaders
+	vkCmdBindDescriptorSets(commandBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pass.GetGraphicsPipelineLayout(), 0, 1, &pass.GetDescriptorSets()[currentFrame], 0, NULL);
+	vkCmdBindPipeline(commandBuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, pass.GetGraphicsPipeline());
+	vkCmdDraw(commandBuffer_, 3, 1, 0, 0);
+}
+
+/*********************************************************************************************/
+/*!
+	\brief
+		Records the compute version of the CRT filter's horizontal pass
+
+	\param commandBuffer_
+		The frame's primary command buffer
+*/
+/*********************************************************************************************/
+void Window::RecordCrtFilterCompute(VkCommandBuffer commandBuffer_)
+{
+	// Each group filters a 64 pixel run of one emulated row, matching crt_filter_comp.comp
+	const uint32_t tileWidth = 64;
+
+	vkCmdBindPipeline(commandBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, crtComputePass.GetGraphicsPipeline());
+	vkCmdBindDescriptorSets(commandBuffer_, VK_PIPELINE_BIND_POINT_COMPUTE, crtComputePass.GetGraphicsPipelineLayout(), 0, 1, &crtComputePass.GetDescriptorSets()[currentFrame], 0, NULL);
+	vkCmdDispatch(commandBuffer_, (CRT_VIRTUAL_WIDTH + tileWidth - 1) / tileWidth, CRT_VIRTUAL_HEIGHT, 1);
 }
@@ -42,6 +42,17 @@ Copyright (c) 2023 Aiden Cvengros
 
 // The render pass class needs to be included because the render passes are flat members of the window class
 #include "RenderPass.h"
+#include "SpriteBatch.h"
+#include "TextureTable.h"
+#include "FrameAllocator.h"
+#include "MemoryAllocator.h"
+#include "TextureUploader.h"
+#include "PipelineCache.h"
+#include "CommandRecorder.h"
+#include "FrameCapture.h"
+#include "RenderGraph.h"
+#include "ResolutionScaler.h"
+#include "LatencyMonitor.h"
 #include "Vertex.h"
 
 // Includes glfw libraries for callback functions
@@ -84,11 +95,55 @@ public:
 	// Public Consts
 	//---------------------------------------------------------------------------------------------
 	
-	const int MAX_FRAMES_IN_FLIGHT = 2;
+	const int MIN_FRAMES_IN_FLIGHT = 1;					// Fewest frames in flight, where the CPU waits for each frame before starting the next
+	static const int MAX_FRAMES_IN_FLIGHT = 3;			// Most frames that can be queued up, trading latency for throughput. Every frame's objects are made for this many
+	const VkDeviceSize FRAME_MEMORY_SIZE = 1024 * 1024;	// Bytes of instance memory each frame in flight starts with
+	const std::string PIPELINE_CACHE_FILE = "pipeline_cache.bin";	// Where compiled pipelines are kept between runs
+	const int MAX_RECORDING_THREADS = 8;				// Most threads that record sprites at once
+	const uint32_t CRT_VIRTUAL_WIDTH = 320;				// Width of the emulated screen the CRT filter works at
+	const uint32_t CRT_VIRTUAL_HEIGHT = 240;			// Height of the emulated screen the CRT filter works at
+	const int CRT_FILTER_PHASES = 12;					// Positions across each emulated pixel the horizontal filter is worked out at
+	static const int CRT_MAX_FILTER_PHASES = 16;		// Phases the filter's weight table has room for, the same as in the shaders
+	const VkFormat CRT_TARGET_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;	// Keeps colors linear and precise between the CRT passes
+
+	// How the 2d shaders treat what's being drawn. Pushed to the shaders alongside each object
+	enum class DrawMode
+	{
+		Sprite,									// A regular textured sprite
+		Text,									// Text, read from the font's distance field atlas
+		TileOverlay,							// The tile debug overlay, one texel per map tile
+		Glitch									// A glitched sprite, drawn only to the glitch mask
+	};
+
+	// How much of the CRT look the post process pass draws. Matches the fisheye shader
+	enum class CrtQuality
+	{
+		Full,									// Blurred scanlines and shadow mask, from the separably filtered emulated screen
+		Scanline,								// Scanlines and shadow mask over the nearest emulated pixel, with no blur
+		Off,									// The scene as drawn, still curved by the fisheye
+		Reference								// The original single pass filter, every tap fetched and weighted per pixel. For golden frames to check Full against
+	};
+
+	// How finished frames are handed to the screen
+	enum class PresentMode
+	{
+		Mailbox,								// Shows the newest frame at each refresh without tearing, dropping the rest
+		Immediate,								// Shows frames as soon as they're done. Lowest latency, but tears
+		Fifo,									// Queues frames for each refresh. Always supported, and the smoothest for recording
+		FifoRelaxed								// Like Fifo, but a late frame is shown right away instead of waiting a refresh
+	};
 
 	//---------------------------------------------------------------------------------------------
 	// Public Structures
 	//---------------------------------------------------------------------------------------------
+
+	// How frames are queued and presented
+	typedef struct
+	{
+		PresentMode presentMode;				// The present mode wanted. Fifo is used if the surface doesn't have it
+		int framesInFlight;						// Frames the CPU can record ahead of the GPU, from MIN_FRAMES_IN_FLIGHT to MAX_FRAMES_IN_FLIGHT
+		uint32_t swapChainImages;				// Images to ask the swap chain for, 0 for one more than the surface's minimum
+	}RenderConfig;
 	
 	//---------------------------------------------------------------------------------------------
 	// Public Variables
@@ -111,19 +166,28 @@ public:
 
 		\param initWindowName
 			The string for the window title
+
+		\param initFramesInFlight
+			How many frames can be recorded before the oldest one is finished, from MIN_FRAMES_IN_FLIGHT to MAX_FRAMES_IN_FLIGHT
+
+		\param initHeadless
+			Whether to render into images of our own with no window, surface or swap chain
 	*/
 	/*********************************************************************************************/
-	Window(int initWidth, int initHeight, std::string initWindowName) :
+	Window(int initWidth, int initHeight, std::string initWindowName, int initFramesInFlight = 2, bool initHeadless = false) :
 		System(SystemTypes::window),
 		window(NULL), vulkanInstance(NULL), physicalCard(NULL), logicalDevice(NULL),
 		graphicsQueue(NULL), surface(NULL), presentQueue(NULL), commandPool(NULL), commandBuffer(),
-		imageIndex(0), textureDescriptorSetLayout(NULL), descriptorPool(NULL), pipelineCache(NULL), debugMessenger(NULL),
-		swapChain(NULL), swapChainImages(0), swapChainImageFormat(), swapChainExtent(), swapChainFramebuffers(),
+		imageIndex(0), textureDescriptorSetLayout(NULL), descriptorPool(NULL), pipelineCache(), debugMessenger(NULL),
+		swapChain(NULL), swapChainImages(0), swapChainImageFormat(), swapChainExtent(), swapChainImageViews(),
 		camera(NULL), blankTexture(NULL),
-		baseScenePass(), glitchMaskPass(), postProcessPass(),
-		vertexBuffer(NULL), vertexBufferMemory(NULL), indexBuffer(NULL), indexBufferMemory(NULL),
+		baseScenePass(), postProcessPass(), crtResolvePass(), crtFilterPass(), crtComputePass(), renderGraph(), sceneTarget(-1), glitchMaskTarget(-1), screenTarget(-1),
+		virtualSceneTarget(-1), filteredRows5Target(-1), filteredRows3Target(-1), crtQuality(CrtQuality::Full), crtCompute(false), sceneExtent(), drawingGlitches(false),
+		renderConfig{ PresentMode::Mailbox, initFramesInFlight, 0 }, renderConfigChanged(false), presentMode(VK_PRESENT_MODE_FIFO_KHR),
+		vertexBuffer(NULL), vertexBufferMemory(), indexBuffer(NULL), indexBufferMemory(),
 		availableSemaphore(), finishedSemaphore(), inFlightFence(),
-		currentFrame(0), framebufferResized(false), width(initWidth), height(initHeight), name(initWindowName) 
+		framesInFlight(initFramesInFlight), currentFrame(0), framebufferResized(false), width(initWidth), height(initHeight), name(initWindowName),
+		headless(initHeadless), closeRequested(false), frameStatsRequested(false)
 	{
 	}
 
@@ -165,13 +229,14 @@ public:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Begins the mask render pass drawing sequence
+			Sets whether objects drawn from now on are glitches. Glitches go to the glitch mask,
+			the second target of the base scene pass, instead of the scene itself
 
-		\param
-			The window being drawn to
+		\param glitch
+			Whether the objects are glitches
 	*/
 	/*************************************************************************************************/
-	void DrawMaskRenderPass();
+	void SetGlitchDrawing(bool glitch) { drawingGlitches = glitch; }
 
 	/*********************************************************************************************/
 	/*!
@@ -195,6 +260,61 @@ public:
 /*********************************************************************************************/
 	void DrawTextObject(GameObject* gameObject);
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Draws a layer of the tile debug overlay as a single quad covering the map
+
+		\param overlayTexture
+			The single channel texture holding a value for each tile
+
+		\param transform
+			The transformation matrix that places the quad over the map
+
+		\param overlayLayer
+			Which layer the texture holds, so the shader knows how to color its values
+
+		\param alpha
+			How opaque the overlay is
+	*/
+	/*********************************************************************************************/
+	void DrawTileOverlay(Texture* overlayTexture, glm::mat4 transform, uint32_t overlayLayer, float alpha);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Queues new pixels for part of a texture. They're copied in at the start of this frame's
+			command buffer, so the texture changes without waiting for the GPU
+
+		\param texture
+			The texture to write to
+
+		\param pixels
+			The region's first pixel. Copied, so they can be thrown away once this returns
+
+		\param rowLength
+			The width in pixels of each row of the source, which can be wider than the region
+
+		\param offset
+			The region's top left corner in the texture
+
+		\param extent
+			The region's width and height
+	*/
+	/*********************************************************************************************/
+	void UpdateTextureRegion(Texture* texture, const uint8_t* pixels, uint32_t rowLength, VkOffset2D offset, VkExtent2D extent);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Forgets any queued pixels for a texture, so nothing is written to it once it's freed
+
+		\param texture
+			The texture being freed
+	*/
+	/*********************************************************************************************/
+	void DropTextureUpdates(Texture* texture);
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -222,6 +342,120 @@ public:
 	/*********************************************************************************************/
 	GLFWwindow* GetVulkanWindowPtr() { return window; }
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns whether the window renders offscreen with no window system
+
+		\return
+			Whether the window is headless
+	*/
+	/*********************************************************************************************/
+	bool IsHeadless() { return headless; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Sets how much of the CRT look is drawn. Passes the chosen quality doesn't need are
+			dropped from the render graph, so changing it rebuilds the graph
+
+		\param quality
+			The CRT quality
+
+		\param useCompute
+			Whether the full quality's horizontal filter runs as a compute shader. Defaults to false
+	*/
+	/*********************************************************************************************/
+	void SetCrtQuality(CrtQuality quality, bool useCompute = false);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns how much of the CRT look is drawn
+
+		\return
+			The CRT quality
+	*/
+	/*********************************************************************************************/
+	CrtQuality GetCrtQuality() { return crtQuality; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Sets how frames are queued and presented. Once running, the swap chain is remade
+			with it at the start of the next frame, without restarting
+
+		\param config
+			The present mode, frames in flight and swap chain image count
+	*/
+	/*********************************************************************************************/
+	void SetRenderConfig(const RenderConfig& config);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns how frames are queued and presented
+
+		\return
+			The render config last set
+	*/
+	/*********************************************************************************************/
+	RenderConfig GetRenderConfig() { return renderConfig; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the render config that keeps the time from input to screen shortest, for
+			speed runs
+
+		\return
+			Mailbox with one frame in flight
+	*/
+	/*********************************************************************************************/
+	static RenderConfig LowLatencyConfig() { return { PresentMode::Mailbox, 1, 0 }; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the render config that keeps the GPU busiest and frames evenly spaced, for
+			recording
+
+		\return
+			Fifo with every frame in flight and a deeper swap chain
+	*/
+	/*********************************************************************************************/
+	static RenderConfig ThroughputConfig() { return { PresentMode::Fifo, MAX_FRAMES_IN_FLIGHT, 4 }; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns whether the window has been asked to close
+
+		\return
+			Whether the game should stop
+	*/
+	/*********************************************************************************************/
+	bool ShouldClose();
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Asks the window to close at the end of the frame
+	*/
+	/*********************************************************************************************/
+	void Close();
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Sets how the cursor behaves over the window. Does nothing when headless
+
+		\param mode
+			The glfw cursor mode, e.g. GLFW_CURSOR_DISABLED
+	*/
+	/*********************************************************************************************/
+	void SetCursorMode(int mode);
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -310,6 +544,17 @@ public:
 	/*********************************************************************************************/
 	VkPhysicalDevice GetPhysicalDevice() { return physicalCard; }
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns how many frames can be recorded before the oldest one is finished
+
+		\return
+			The number of frames in flight
+	*/
+	/*********************************************************************************************/
+	int GetFramesInFlight() { return framesInFlight; }
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -343,6 +588,115 @@ public:
 	/*********************************************************************************************/
 	VkDescriptorSetLayout* GetTextureDescriptorSetLayout() { return &textureDescriptorSetLayout; }
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the bindless texture table. Only enabled on cards with descriptor indexing,
+			otherwise each texture gets its own descriptor set
+
+		\return
+			The texture table
+	*/
+	/*********************************************************************************************/
+	TextureTable* GetTextureTable() { return &textureTable; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the allocator every buffer and image gets its memory from
+
+		\return
+			The memory allocator
+	*/
+	/*********************************************************************************************/
+	MemoryAllocator* GetMemoryAllocator() { return &memoryAllocator; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the uploader every texture's pixels go through
+
+		\return
+			The texture uploader
+	*/
+	/*********************************************************************************************/
+	TextureUploader* GetTextureUploader() { return &textureUploader; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the frame capture, which only has images to read back when headless
+
+		\return
+			The frame capture
+	*/
+	/*********************************************************************************************/
+	FrameCapture* GetFrameCapture() { return &frameCapture; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the resolution scaler, which picks the size the scene is drawn at
+
+		\return
+			The resolution scaler
+	*/
+	/*********************************************************************************************/
+	ResolutionScaler* GetResolutionScaler() { return &resolutionScaler; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the latency monitor, which measures each render config
+
+		\return
+			The latency monitor
+	*/
+	/*********************************************************************************************/
+	LatencyMonitor* GetLatencyMonitor() { return &latencyMonitor; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the sprite batch, which counts the last frame's sprites and draw calls
+
+		\return
+			The sprite batch
+	*/
+	/*********************************************************************************************/
+	SpriteBatch* GetSpriteBatch() { return &spriteBatch; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the allocator for data that only lives for one frame
+
+		\return
+			The frame allocator
+	*/
+	/*********************************************************************************************/
+	FrameAllocator* GetFrameAllocator() { return &frameAllocator; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Returns the render graph, which counts the frame's passes and target memory
+
+		\return
+			The render graph
+	*/
+	/*********************************************************************************************/
+	RenderGraph* GetRenderGraph() { return &renderGraph; }
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Prints the next frame's sprite, memory, pass and scaling numbers to the debug log once
+			it's recorded
+	*/
+	/*********************************************************************************************/
+	void RequestFrameStats() { frameStatsRequested = true; }
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -361,7 +715,10 @@ public:
 			Return value for the resulting buffer
 
 		\param bufferMemory
-			Pointer to the buffer in memory
+			Return value for the memory the buffer is bound to. Host visible memory is already mapped
+
+		\param preferredProperties
+			Properties the memory should have if the card has such a type
 	*/
 	/*********************************************************************************************/
 	void CreateBuffer(
@@ -369,7 +726,22 @@ public:
 		VkBufferUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkBuffer& buffer,
-		VkDeviceMemory& bufferMemory);
+		MemoryAllocator::Allocation& bufferMemory,
+		VkMemoryPropertyFlags preferredProperties = 0);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Destroys a buffer made with CreateBuffer and gives back its memory
+
+		\param buffer
+			The buffer to destroy. Set to null afterwards
+
+		\param bufferMemory
+			The buffer's memory
+	*/
+	/*********************************************************************************************/
+	void DestroyBuffer(VkBuffer& buffer, MemoryAllocator::Allocation& bufferMemory);
 
 	/*********************************************************************************************/
 	/*!
@@ -461,7 +833,7 @@ public:
 			The buffer to be created
 
 		\param bufferMemory
-			The pointer to the buffer
+			The memory the buffer is bound to
 
 		\param bufferFlags
 			The properties of the buffer
@@ -473,7 +845,7 @@ public:
 			The data to be written to the new buffer
 	*/
 	/*********************************************************************************************/
-	void CreateVulkanBuffer(VkBuffer& buffer, VkDeviceMemory& bufferMemory, VkBufferUsageFlags bufferFlags, VkDeviceSize bufferSize, void* rawData);
+	void CreateVulkanBuffer(VkBuffer& buffer, MemoryAllocator::Allocation& bufferMemory, VkBufferUsageFlags bufferFlags, VkDeviceSize bufferSize, void* rawData);
 	
 private:
 	//---------------------------------------------------------------------------------------------
@@ -504,6 +876,7 @@ private:
 	{
 		std::optional<uint32_t> graphicsFamily;	// The queue type for graphics queues
 		std::optional<uint32_t> presentFamily;	// The queue type for presentation queues
+		std::optional<uint32_t> transferFamily;	// A queue type that only copies, for uploading textures alongside drawing
 
 		/*****************************************************************************************/
 		/*!
@@ -517,6 +890,20 @@ private:
 		bool IsComplete() { return graphicsFamily.has_value() && presentFamily.has_value(); }
 	};
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			New pixels for part of a texture, waiting to be copied in with the next frame
+	*/
+	/*********************************************************************************************/
+	struct TextureUpdate
+	{
+		Texture* texture;								// The texture to write to
+		std::vector<uint8_t> pixels;					// The region's pixels, tightly packed
+		VkOffset2D offset;								// The region's top left corner
+		VkExtent2D extent;								// The region's width and height
+	};
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -557,6 +944,31 @@ private:
 		float fisheyeStrength;
 		float screenWidth;
 		float screenHeight;
+		uint32_t crtQuality;
+		glm::vec2 renderScale;							// How much of the scene and glitch mask the scene pass drew to
+	};
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			The uniform buffer object for resolving the scene to the emulated screen
+	*/
+	/*********************************************************************************************/
+	struct CrtResolveUniformBufferObject
+	{
+		glm::vec2 renderScale;							// How much of the scene the scene pass drew to
+	};
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			The uniform buffer object for the CRT filter. Holds the horizontal filter's weights
+			for each phase, normalized, since they never change
+	*/
+	/*********************************************************************************************/
+	struct CrtFilterUniformBufferObject
+	{
+		glm::vec4 weights[CRT_MAX_FILTER_PHASES * 2];	// 5 tap weights for -2 to 1, then the 5 tap weight for 2 and 3 tap weights for -1 to 1
 	};
 	
 	//---------------------------------------------------------------------------------------------
@@ -572,12 +984,13 @@ private:
 	VkQueue graphicsQueue;								// Holds the command queue for the logical device
 	VkSurfaceKHR surface;								// The virtual screen surface to be drawn to
 	VkQueue presentQueue;								// Holds the command queue for drawing to the surface
+	VkQueue transferQueue = NULL;						// The command queue for texture uploads, if the card has a transfer-only family
 	VkCommandPool commandPool;							// Holds the list of commands for the graphics system
 	std::vector<VkCommandBuffer> commandBuffer;			// Gets the commands
 	uint32_t imageIndex;								// Keeps track of which image the swap chain is on
 	VkDescriptorSetLayout textureDescriptorSetLayout;	// Specifies the layout for texture descriptors.
 	VkDescriptorPool descriptorPool;					// The descriptor pool
-	VkPipelineCache pipelineCache;						// The cache to track different stages of the graphics pipeline
+	PipelineCache pipelineCache;						// The cache to track different stages of the graphics pipeline, kept on disk between runs
 	VkDebugUtilsMessengerEXT debugMessenger;			// The debug messenger
 
 	// Swap Chain objects
@@ -585,22 +998,50 @@ private:
 	std::vector<VkImage> swapChainImages;				// The frame buffers being drawn to
 	VkFormat swapChainImageFormat;						// The image format (should be srgb)
 	VkExtent2D swapChainExtent;							// Holds the dimensions of the frame buffers
-	std::vector<VkFramebuffer> swapChainFramebuffers;	// The framebuffers for the swap chain
+	std::vector<VkImageView> swapChainImageViews;		// The views the post process pass draws the swap chain images through
+	std::vector<MemoryAllocator::Allocation> offscreenImageMemory;	// Memory for the images standing in for the swap chain when headless
 	
 	// Game Dependencies
 	Camera* camera;										// The main camera object
 	Texture* blankTexture;								// Default texture used to draw game objects without a texture
 
 	// Render Passes
-	RenderPass baseScenePass;							// The render pass for drawing the base scene
-	RenderPass glitchMaskPass;							// The render pass that creates the mask for where to render glitch effects
+	RenderPass baseScenePass;							// The render pass for drawing the base scene and the glitch mask
 	RenderPass postProcessPass;							// The post-processing render pass
+	RenderPass crtResolvePass;							// Draws the scene at the emulated screen's resolution
+	RenderPass crtFilterPass;							// Filters the emulated screen's rows horizontally
+	RenderPass crtComputePass;							// The compute shader version of the horizontal filter
+	RenderGraph renderGraph;							// Runs the render passes and owns the targets between them
+	RenderGraph::Resource sceneTarget;					// The base scene, read by the post process pass
+	RenderGraph::Resource glitchMaskTarget;				// Where glitch effects go, read by the post process pass
+	RenderGraph::Resource screenTarget;					// The swap chain image being drawn to
+	RenderGraph::Resource virtualSceneTarget;			// The scene at the emulated screen's resolution
+	RenderGraph::Resource filteredRows5Target;			// Each emulated row through the 5 tap filter, for the nearest line
+	RenderGraph::Resource filteredRows3Target;			// Each emulated row through the 3 tap filter, for the lines beside it
+	CrtQuality crtQuality;								// How much of the CRT look is drawn
+	bool crtCompute;									// Whether the horizontal filter runs as a compute shader
+	VkExtent2D sceneExtent;								// The top left of the scene and glitch mask drawn to this frame
+	SpriteBatch spriteBatch;							// Collects the frame's sprites into instanced draws
+	bool drawingGlitches;								// Whether objects being drawn go to the glitch mask
+	FrameAllocator frameAllocator;						// Memory for data that only lives for one frame
+	std::vector<TextureUpdate> textureUpdates;			// Texture regions to copy in at the start of the next frame
+	TextureTable textureTable;							// Every texture in one descriptor set, when the card supports it
+	MemoryAllocator memoryAllocator;					// Where every buffer and image gets its memory
+	TextureUploader textureUploader;					// Batches texture uploads so they don't block
+	CommandRecorder commandRecorder;					// Records sprites on several threads into secondary command buffers
+	FrameCapture frameCapture;							// Reads chosen frames back to disk when headless
+	ResolutionScaler resolutionScaler;					// Times frames on the GPU and picks the scene's size from them
+	RenderConfig renderConfig;							// How frames are queued and presented
+	bool renderConfigChanged;							// Whether the swap chain still has to be remade with the render config
+	VkPresentModeKHR presentMode;						// The present mode the swap chain was made with
+	LatencyMonitor latencyMonitor;						// Measures present intervals and latency for each render config
+	bool bindlessTextures = false;						// Whether the logical device was made with descriptor indexing
 
 	// Memory Buffers
 	VkBuffer vertexBuffer;								// The vertex buffer
-	VkDeviceMemory vertexBufferMemory;					// The memory pointer for the vertex buffer
+	MemoryAllocator::Allocation vertexBufferMemory;		// The memory for the vertex buffer
 	VkBuffer indexBuffer;								// The indices corresponding to vertices in the vertex buffer
-	VkDeviceMemory indexBufferMemory;					// The memory pointer for the index buffer
+	MemoryAllocator::Allocation indexBufferMemory;		// The memory for the index buffer
 
 	// Thread Syncing
 	std::vector<VkSemaphore> availableSemaphore;		// The semaphore for checking if the buffer is available
@@ -608,11 +1049,15 @@ private:
 	std::vector<VkFence> inFlightFence;					// The fence to make sure only one frame happens at a time
 
 	// Window variables
-	uint32_t currentFrame = 0;							// Keeps track of the frame count
+	int framesInFlight;									// How many frames are in flight at once. Each of the MAX_FRAMES_IN_FLIGHT has its own command buffer, sync objects and uniforms
+	uint32_t currentFrame = 0;							// The frame in flight being recorded
 	bool framebufferResized = false;					// Manually tells the program to recreate the swap chain
 	int width;											// The width of the window
 	int height;											// The height of the window
 	std::string name;									// The name of the window
+	bool headless;										// Whether there's no window, surface or swap chain
+	bool closeRequested;								// Set by Close, since a headless window has no glfw flag
+	bool frameStatsRequested;							// Whether the next frame's numbers get printed
 
 	// Holds the list of graphics device extensions that we want
 	const std::vector<const char*> deviceExtensions =
@@ -802,6 +1247,14 @@ private:
 	/*********************************************************************************************/
 	void CreateSwapChain();
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Creates the images the post process pass draws to when headless, one per frame in flight
+	*/
+	/*********************************************************************************************/
+	void CreateOffscreenImages();
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -863,17 +1316,43 @@ private:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Selects a swap chain presentation format
+			Selects the present mode the render config asks for, or fifo if the surface doesn't
+			have it
 
 		\param availablePresentModes
-			The list of formats to choose from
+			The list of modes to choose from
 
 		\return
-			The format we want
+			The mode to make the swap chain with
 	*/
 	/*********************************************************************************************/
 	VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Names a present mode, for messages
+
+		\param mode
+			The present mode
+
+		\return
+			The mode's name
+	*/
+	/*********************************************************************************************/
+	static std::string PresentModeName(VkPresentModeKHR mode);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Describes the render config the swap chain was actually made with, for measuring it
+
+		\return
+			The present mode, frames in flight and swap chain image count
+	*/
+	/*********************************************************************************************/
+	std::string DescribeRenderConfig();
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -899,10 +1378,29 @@ private:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Creates the frame buffers for the swap chain
+			Declares the frame's targets and passes to the render graph. Each pass lists what it
+			reads and writes, and the graph works out the rest
+	*/
+	/*********************************************************************************************/
+	void CreateRenderGraph();
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Gives the render graph the swap chain images and has it make its targets and
+			framebuffers at the swap chain's size
+	*/
+	/*********************************************************************************************/
+	void CompileRenderGraph();
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Declares and compiles the render graph again, for when its passes change. Waits for
+			the device to be idle
 	*/
 	/*********************************************************************************************/
-	void CreateFramebuffers();
+	void RebuildRenderGraph();
 
 	/*********************************************************************************************/
 	/*!
@@ -912,6 +1410,14 @@ private:
 	/*********************************************************************************************/
 	void CreateCommandPool();
 
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Sets up the texture uploader on the transfer queue, or the graphics queue if there isn't one
+	*/
+	/*********************************************************************************************/
+	void InitTextureUploader();
+
 	/*********************************************************************************************/
 	/*!
 		\brief
@@ -929,13 +1435,42 @@ private:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Private function to record a graphics command
+			Records a sprite batch into a render pass the render graph has begun
+
+		\param pass
+			The render pass being recorded, for its pipeline and descriptor sets
+
+		\param batch
+			The sprites queued for the pass
 
 		\param commandBuffer
-			The command buffer to record the command to
+			The command buffer the pass was begun in
+
+		\param framebuffer
+			The framebuffer the pass was begun with
+	*/
+	/*********************************************************************************************/
+	void RecordSpritePass(RenderPass& pass, SpriteBatch& batch, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Records the copies for every queued texture region, each between barriers that keep
+			it from overlapping the draws reading the texture
+
+		\param commandBuffer
+			The frame's command buffer, outside of any render pass
 	*/
 	/*********************************************************************************************/
-	void RecordCommandBuffer(VkCommandBuffer commandBuffer);
+	void RecordTextureUpdates(VkCommandBuffer commandBuffer);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Prints the frame's sprite, memory, pass and scaling numbers to the debug log
+	*/
+	/*********************************************************************************************/
+	void PrintFrameStats();
 
 	/*********************************************************************************************/
 	/*!
@@ -1016,10 +1551,39 @@ private:
 	/*********************************************************************************************/
 	/*!
 		\brief
-			Runs the render pass for the post process shaders
+			Fills every frame's CRT filter uniform buffers with the horizontal filter's weights
+	*/
+	/*********************************************************************************************/
+	void FillCrtFilterWeights();
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Records a full screen triangle with a post process pass's shaders into the pass the
+			render graph has begun
+
+		\param pass
+			The render pass whose pipeline and frame descriptor set are used
+
+		\param commandBuffer_
+			The command buffer the pass was begun in
+
+		\param extent
+			The size of what the pass draws to
+	*/
+	/*********************************************************************************************/
+	void RecordFullscreenPass(RenderPass& pass, VkCommandBuffer commandBuffer_, VkExtent2D extent);
+
+	/*********************************************************************************************/
+	/*!
+		\brief
+			Records the compute version of the CRT filter's horizontal pass
+
+		\param commandBuffer_
+			The frame's primary command buffer
 	*/
 	/*********************************************************************************************/
-	void RunFisheyeRenderPass();
+	void RecordCrtFilterCompute(VkCommandBuffer commandBuffer_);
 };
 
 //-------------------------------------------------------------------------------------------------
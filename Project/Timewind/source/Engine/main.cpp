@@ -9,6 +9,7 @@
 
     Functions include:
         + main
+		+ ParseLaunchOptions
 
 Copyright (c) 2023 Aiden Cvengros
 */
@@ -21,6 +22,13 @@ Copyright (c) 2023 Aiden Cvengros
 // Includes the engine class to start and run the game engine
 #include "Engine.h"
 
+// The render profiles the command line can pick
+#include "Window.h"
+
+// Reading the command line
+#include <cstring>
+#include <sstream>
+
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
@@ -43,6 +51,8 @@ Engine* gameEngine;								// The game engine
 // Private Function Declarations
 //-------------------------------------------------------------------------------------------------
 
+static Engine::LaunchOptions ParseLaunchOptions(int argc, char* argv[]);
+
 //-------------------------------------------------------------------------------------------------
 // Public Function Definitions
 //-------------------------------------------------------------------------------------------------
@@ -51,13 +61,22 @@ Engine* gameEngine;								// The game engine
 /*!
 	\brief
 		The starting function of the program
+
+	\param argc
+		The number of command line arguments
+
+	\param argv
+		The command line arguments
 		
 	\return
 		Returns any error code if the program failed or 0 if the program suceeded.
 */
 /*************************************************************************************************/
-int main()
+int main(int argc, char* argv[])
 {
+	// Reads how the game was asked to run
+	Engine::SetLaunchOptions(ParseLaunchOptions(argc, argv));
+
 	// Creates the game engine
 	gameEngine = Engine::createEngine();
 
@@ -67,6 +86,12 @@ int main()
 	// Shuts down the engine and all its systems
 	gameEngine->Shutdown();
 
+	// Fails the run if captures didn't match the frames they were compared against
+	if (gameEngine->GetWindow()->GetFrameCapture()->GetFailedComparisons() > 0)
+	{
+		return 1;
+	}
+
 	// Returns 0 if everything went well
 	return 0;
 }
@@ -74,3 +99,159 @@ int main()
 //-------------------------------------------------------------------------------------------------
 // Private Function Definitions
 //-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads the launch options from the command line. Understands
+			--headless				Renders offscreen with no window
+			--frames N				Quits after N frames
+			--capture A,B,C			Writes out frames A, B and C (headless only)
+			--capture-dir DIR		Where captured frames are written
+			--ppm					Writes captures as raw PPM instead of PNG
+			--compare DIR			Checks captures against the ones of the same name in DIR
+			--tolerance N			The most a channel may differ by when comparing, 1 by default
+			--crt full|scanline|off|reference	How much of the CRT look is drawn
+			--crt-compute			Runs the CRT filter's horizontal pass as a compute shader
+			--fixed-resolution		Always draws the scene at full size
+			--present MODE			Presents with mailbox, immediate, fifo or relaxed
+			--frames-in-flight N	Lets the CPU record N frames ahead of the GPU, from 1 to 3
+			--swap-images N			Asks the swap chain for N images
+			--profile latency|throughput	Sets all three for speed runs or for recording
+
+	\param argc
+		The number of command line arguments
+
+	\param argv
+		The command line arguments
+
+	\return
+		The launch options
+*/
+/*************************************************************************************************/
+static Engine::LaunchOptions ParseLaunchOptions(int argc, char* argv[])
+{
+	Engine::LaunchOptions options = { false, 0, {}, "Captures", false, 0, false, false, 0, 2, 0, "", 1 };
+
+	for (int i = 1; i < argc; i++)
+	{
+		// Options that take a value read the next argument
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			options.headless = true;
+		}
+		else if (strcmp(argv[i], "--frames") == 0 && hasValue)
+		{
+			options.frameLimit = std::stoull(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--capture") == 0 && hasValue)
+		{
+			std::stringstream frameList(argv[++i]);
+			std::string frame;
+			while (std::getline(frameList, frame, ','))
+			{
+				options.captureFrames.push_back(std::stoull(frame));
+			}
+		}
+		else if (strcmp(argv[i], "--capture-dir") == 0 && hasValue)
+		{
+			options.captureDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--ppm") == 0)
+		{
+			options.capturePpm = true;
+		}
+		else if (strcmp(argv[i], "--compare") == 0 && hasValue)
+		{
+			options.goldenDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--tolerance") == 0 && hasValue)
+		{
+			options.goldenTolerance = std::stoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--crt") == 0 && hasValue)
+		{
+			// In the order of Window::CrtQuality
+			const char* qualities[] = { "full", "scanline", "off", "reference" };
+			int quality = 0;
+			i++;
+			while (quality < 4 && strcmp(argv[i], qualities[quality]) != 0)
+			{
+				quality++;
+			}
+
+			if (quality < 4)
+			{
+				options.crtQuality = quality;
+			}
+			else
+			{
+				std::cout << "Ignoring unknown CRT quality " << argv[i] << std::endl;
+			}
+		}
+		else if (strcmp(argv[i], "--crt-compute") == 0)
+		{
+			options.crtCompute = true;
+		}
+		else if (strcmp(argv[i], "--fixed-resolution") == 0)
+		{
+			options.fixedResolution = true;
+		}
+		else if (strcmp(argv[i], "--present") == 0 && hasValue)
+		{
+			// In the order of Window::PresentMode
+			const char* presentModes[] = { "mailbox", "immediate", "fifo", "relaxed" };
+			int presentMode = 0;
+			i++;
+			while (presentMode < 4 && strcmp(argv[i], presentModes[presentMode]) != 0)
+			{
+				presentMode++;
+			}
+
+			if (presentMode < 4)
+			{
+				options.presentMode = presentMode;
+			}
+			else
+			{
+				std::cout << "Ignoring unknown present mode " << argv[i] << std::endl;
+			}
+		}
+		else if (strcmp(argv[i], "--frames-in-flight") == 0 && hasValue)
+		{
+			options.framesInFlight = std::stoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--swap-images") == 0 && hasValue)
+		{
+			options.swapChainImages = std::stoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--profile") == 0 && hasValue)
+		{
+			i++;
+			Window::RenderConfig profile{};
+			if (strcmp(argv[i], "latency") == 0)
+			{
+				profile = Window::LowLatencyConfig();
+			}
+			else if (strcmp(argv[i], "throughput") == 0)
+			{
+				profile = Window::ThroughputConfig();
+			}
+			else
+			{
+				std::cout << "Ignoring unknown profile " << argv[i] << std::endl;
+				continue;
+			}
+			options.presentMode = (int)profile.presentMode;
+			options.framesInFlight = profile.framesInFlight;
+			options.swapChainImages = (int)profile.swapChainImages;
+		}
+		else
+		{
+			std::cout << "Ignoring unknown option " << argv[i] << std::endl;
+		}
+	}
+
+	return options;
+}
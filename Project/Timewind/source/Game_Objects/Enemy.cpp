@@ -35,6 +35,8 @@ Copyright (c) 2023 Aiden Cvengros
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
+const double enemyMoveSpeed = 0.4;	// How long the enemy takes to step one tile toward the player
+
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
 //-------------------------------------------------------------------------------------------------
@@ -84,7 +86,7 @@ Copyright (c) 2023 Aiden Cvengros
 /*************************************************************************************************/
 Enemy::Enemy(glm::vec2 pos, float rot, glm::vec2 sca, int drawPriority_, Texture* texture_, std::pair<int, int> mapCoords) :
 	GameObject(pos, rot, sca, drawPriority_, false, texture_, { 1.0f, 1.0f, 1.0f, 1.0f }, mapCoords),
-	attackTimer(0.0)
+	attackTimer(0.0), followsPlayer(false)
 {
 	healthPool = new Pool({ pos.x, pos.y + 0.5 }, rot, sca, 40, true, { 1.0, 0.0, 0.0, 0.7 });
 	healthPool->SetRender(true);
@@ -120,6 +122,15 @@ void Enemy::Update(double dt, InputManager* inputManager)
 	{
 		MoveToUpdate(dt);
 	}
+	// Otherwise steps along the flow field toward the player, if this enemy does that
+	else if (followsPlayer)
+	{
+		std::pair<int, int> enemyPosition = GetMapCoords();
+		if (StepTowardPlayer(enemyPosition, enemyMoveSpeed))
+		{
+			SetMapCoords(enemyPosition);
+		}
+	}
 }
 
 /*************************************************************************************************/
@@ -177,8 +188,15 @@ bool Enemy::MoveEnemy(std::pair<int, int>& enemyPosition, int horizontalMove, in
 		SetIsFacingRight(false);
 	}
 
+	// Enemies are solid to the player, but the map would let one step onto the player's tile and erase them
+	std::pair<int, int> newPosition = { enemyPosition.first + horizontalMove, enemyPosition.second + verticalMove };
+	if (_MapMatrix->GetTile(newPosition).tileStatus == MapMatrix::TileStatus::Player)
+	{
+		return false;
+	}
+
 	// Moves the enemy in logic
-	if (_MapMatrix->MoveTile(enemyPosition, { enemyPosition.first + horizontalMove, enemyPosition.second + verticalMove }, MapMatrix::TileStatus::Enemy, this))
+	if (_MapMatrix->MoveTile(enemyPosition, newPosition, MapMatrix::TileStatus::Enemy, this))
 	{
 		enemyPosition.first += horizontalMove;
 		enemyPosition.second += verticalMove;
@@ -192,6 +210,33 @@ bool Enemy::MoveEnemy(std::pair<int, int>& enemyPosition, int horizontalMove, in
 	return false;
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Moves the enemy one tile along the map's shared flow field toward the player
+
+	\param enemyPosition
+		The current position of the enemy (will be modified if the enemy moves)
+
+	\param moveSpeed
+		How long the movement takes
+
+	\return
+		Returns true if the enemy moved, false if it is next to the player or can't reach them
+*/
+/*************************************************************************************************/
+bool Enemy::StepTowardPlayer(std::pair<int, int>& enemyPosition, double moveSpeed)
+{
+	// Looks up the step from the field every enemy shares instead of searching
+	std::pair<int, int> step = _MapMatrix->GetPathfinder().GetFlowDirection(enemyPosition);
+	if (step.first == 0 && step.second == 0)
+	{
+		return false;
+	}
+
+	return MoveEnemy(enemyPosition, step.first, step.second, moveSpeed);
+}
+
 /*************************************************************************************************/
 /*!
 	\brief
@@ -120,6 +120,17 @@ public:
 	/*************************************************************************************************/
 	virtual void Update(double dt, InputManager* inputManager);
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets whether the enemy walks toward the player along the map's flow field on its own
+
+		\param followsPlayer_
+			Whether the enemy follows the player
+	*/
+	/*************************************************************************************************/
+	void SetFollowsPlayer(bool followsPlayer_) { followsPlayer = followsPlayer_; }
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -154,6 +165,23 @@ public:
 	/*************************************************************************************************/
 	bool MoveEnemy(std::pair<int, int>& enemyPosition, int horizontalMove, int verticalMove, double moveSpeed);
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Moves the enemy one tile along the map's shared flow field toward the player
+
+		\param enemyPosition
+			The current position of the enemy (will be modified if the enemy moves)
+
+		\param moveSpeed
+			How long the movement takes
+
+		\return
+			Returns true if the enemy moved, false if it is next to the player or can't reach them
+	*/
+	/*************************************************************************************************/
+	bool StepTowardPlayer(std::pair<int, int>& enemyPosition, double moveSpeed);
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -193,6 +221,7 @@ private:
 	//---------------------------------------------------------------------------------------------
 
 	double attackTimer;							// The active time on the attack
+	bool followsPlayer;							// Whether the enemy walks toward the player by itself
 
 	Pool* healthPool;							// The health pool of the enemy
 
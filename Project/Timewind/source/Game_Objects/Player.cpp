@@ -220,7 +220,7 @@ void Player::Update(double dt)
 			if (wallJumpTimer > 0.0f && verticalVelocity <= 0.0f)
 			{
 				// Double checks that we're still at a wall
-				if (_MapMatrix->GetTile(_MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::Center), !wallJumpRight, 1, 0)).tileStatus > MapMatrix::TileStatus::Player)
+				if (_MapMatrix->TestTileMask(MapMatrix::TileMask::Solid, _MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::Center), !wallJumpRight, 1, 0)))
 				{
 					verticalVelocity = 0.0f;
 				}
@@ -467,11 +467,8 @@ void Player::MovePlayer(double dt)
 	float horizontalMovement = horizontalVelocity * (float)dt;
 	float verticalMovement = verticalVelocity * (float)dt;
 
-	// Tries to move the player horizontally
-	if (!againstWall || horizontalMovement * againstWall > 0.0f)
-	{
-		playerWorldPosition.x += horizontalMovement;
-	}
+	// Only moves horizontally if we aren't pressed up against a wall
+	float horizontalStep = (!againstWall || horizontalMovement * againstWall > 0.0f) ? horizontalMovement : 0.0f;
 
 	// Resets against wall
 	againstWall = 0;
@@ -481,26 +478,30 @@ void Player::MovePlayer(double dt)
 	{
 		SetIsFacingRight(true);
 
-		// Calculates the tiles the player might be moving into
-		std::pair<int, int> rightBottomSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomRightIn);
-		std::pair<int, int> rightTopSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::TopRightIn);
-
 		// If we are being launched, we break through destructibles
 		if (reducedGravity > 0.0f)
 		{
-			InteractWithTile(rightBottomSideTile, true, false);
-			InteractWithTile(rightTopSideTile, true, false);
+			glm::vec2 targetPosition = { playerWorldPosition.x + horizontalStep, playerWorldPosition.y };
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomRightIn), true, false);
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::TopRightIn), true, false);
 		}
 
-		// Checks if the right side of the player has moved into an object
-		if (_MapMatrix->GetTile(rightBottomSideTile).tileStatus > MapMatrix::TileStatus::Player ||
-			_MapMatrix->GetTile(rightTopSideTile).tileStatus > MapMatrix::TileStatus::Player)
+		// Sweeps the player right so fast movement can't skip through a wall
+		MapMatrix::SweepResult sweep = _MapMatrix->SweepBox(CalculatePlayerCollisionBox(playerWorldPosition), { horizontalStep, 0.0f });
+
+		// Checks if the right side of the player ran into an object
+		if (sweep.hit)
 		{
+			// Calculates the tiles beside the player in the column that was hit
+			std::pair<int, int> rightBottomSideTile = { sweep.tile.first, CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomRightIn).second };
+			std::pair<int, int> rightTopSideTile = { sweep.tile.first, CalculatePlayerMapPositions(playerWorldPosition, Positions::TopRightIn).second };
+			glm::vec2 targetPosition = { playerWorldPosition.x + horizontalStep, playerWorldPosition.y + verticalMovement };
+
 			// Checks if we can move into a side wall
 			if (!(verticalMovement > 0.0f && _MapMatrix->GetTile(rightBottomSideTile).tileStatus < MapMatrix::TileStatus::Player &&
-				_MapMatrix->GetTile(CalculatePlayerMapPositions({ playerWorldPosition.x, playerWorldPosition.y + verticalMovement }, Positions::TopRightIn)).tileStatus < MapMatrix::TileStatus::Player) &&
+				_MapMatrix->GetTile(CalculatePlayerMapPositions(targetPosition, Positions::TopRightIn)).tileStatus < MapMatrix::TileStatus::Player) &&
 				!(verticalMovement > 0.0f && _MapMatrix->GetTile(rightTopSideTile).tileStatus < MapMatrix::TileStatus::Player &&
-				_MapMatrix->GetTile(CalculatePlayerMapPositions({ playerWorldPosition.x, playerWorldPosition.y + verticalMovement }, Positions::BottomRightIn)).tileStatus < MapMatrix::TileStatus::Player))
+				_MapMatrix->GetTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomRightIn)).tileStatus < MapMatrix::TileStatus::Player))
 			{
 				// If none of that is happening, we are up against a wall
 				playerWorldPosition.x = ConvertMapCoordsToWorldCoords(rightBottomSideTile).x - 2.0078125f + upperInnerGap;
@@ -516,32 +517,44 @@ void Player::MovePlayer(double dt)
 				horizontalVelocity = 0;
 				againstWall = 1;
 			}
+			else
+			{
+				playerWorldPosition.x += horizontalStep;
+			}
+		}
+		else
+		{
+			playerWorldPosition.x += horizontalStep;
 		}
 	}
 	else if (horizontalMovement < 0.0f)
 	{
 		SetIsFacingRight(false);
 
-		// Calculates which tiles the player is moving into
-		std::pair<int, int> leftBottomSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomLeftIn);
-		std::pair<int, int> leftTopSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::TopLeftIn);
-
 		// If we are being launched, we break through destructibles
 		if (reducedGravity > 0.0f)
 		{
-			InteractWithTile(leftBottomSideTile, true, false);
-			InteractWithTile(leftTopSideTile, true, false);
+			glm::vec2 targetPosition = { playerWorldPosition.x + horizontalStep, playerWorldPosition.y };
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomLeftIn), true, false);
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::TopLeftIn), true, false);
 		}
 
-		// Checks if the right side of the player has moved into an object
-		if (_MapMatrix->GetTile(leftBottomSideTile).tileStatus > MapMatrix::TileStatus::Player ||
-			_MapMatrix->GetTile(leftTopSideTile).tileStatus > MapMatrix::TileStatus::Player)
+		// Sweeps the player left so fast movement can't skip through a wall
+		MapMatrix::SweepResult sweep = _MapMatrix->SweepBox(CalculatePlayerCollisionBox(playerWorldPosition), { horizontalStep, 0.0f });
+
+		// Checks if the left side of the player ran into an object
+		if (sweep.hit)
 		{
+			// Calculates the tiles beside the player in the column that was hit
+			std::pair<int, int> leftBottomSideTile = { sweep.tile.first, CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomLeftIn).second };
+			std::pair<int, int> leftTopSideTile = { sweep.tile.first, CalculatePlayerMapPositions(playerWorldPosition, Positions::TopLeftIn).second };
+			glm::vec2 targetPosition = { playerWorldPosition.x + horizontalStep, playerWorldPosition.y + verticalMovement };
+
 			// Checks if we can move into a side wall
 			if (!(verticalMovement < 0.0f && _MapMatrix->GetTile(leftBottomSideTile).tileStatus < MapMatrix::TileStatus::Player &&
-				_MapMatrix->GetTile(CalculatePlayerMapPositions({ playerWorldPosition.x, playerWorldPosition.y + verticalMovement }, Positions::TopLeftIn)).tileStatus < MapMatrix::TileStatus::Player) &&
+				_MapMatrix->GetTile(CalculatePlayerMapPositions(targetPosition, Positions::TopLeftIn)).tileStatus < MapMatrix::TileStatus::Player) &&
 				!(verticalMovement > 0.0f && _MapMatrix->GetTile(leftTopSideTile).tileStatus < MapMatrix::TileStatus::Player &&
-				_MapMatrix->GetTile(CalculatePlayerMapPositions({ playerWorldPosition.x, playerWorldPosition.y + verticalMovement }, Positions::BottomLeftIn)).tileStatus < MapMatrix::TileStatus::Player))
+				_MapMatrix->GetTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomLeftIn)).tileStatus < MapMatrix::TileStatus::Player))
 			{
 				playerWorldPosition.x = ConvertMapCoordsToWorldCoords(leftBottomSideTile).x + 2.0078125f - upperInnerGap;
 
@@ -556,47 +569,47 @@ void Player::MovePlayer(double dt)
 				horizontalVelocity = 0;
 				againstWall = -1;
 			}
+			else
+			{
+				playerWorldPosition.x += horizontalStep;
+			}
+		}
+		else
+		{
+			playerWorldPosition.x += horizontalStep;
 		}
 	}
 
-	// Tries to move the player vertically 
-	playerWorldPosition.y += verticalMovement;
-
 	// Checks if the player is moving up or down
 	if (verticalMovement > 0.0f)
 	{
-		// Calculates which tiles the player is moving into
-		std::pair<int, int> topLeftSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::TopLeftIn);
-		std::pair<int, int> topRightSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::TopRightIn);
-		std::pair<int, int> topCenter = CalculatePlayerMapPositions(playerWorldPosition, Positions::TopCenter);
-
 		// If we are being launched, we break through destructibles
 		if (reducedGravity > 0.0f)
 		{
-			InteractWithTile(topLeftSideTile, true, false);
-			InteractWithTile(topRightSideTile, true, false);
-			InteractWithTile(topCenter, true, false);
+			glm::vec2 targetPosition = { playerWorldPosition.x, playerWorldPosition.y + verticalMovement };
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::TopLeftIn), true, false);
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::TopRightIn), true, false);
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::TopCenter), true, false);
 		}
 
-		// Checks if the right side of the player has moved into an object
-		if (_MapMatrix->GetTile(topLeftSideTile).tileStatus > MapMatrix::TileStatus::Player ||
-			_MapMatrix->GetTile(topRightSideTile).tileStatus > MapMatrix::TileStatus::Player)
+		// Sweeps the player up
+		MapMatrix::SweepResult sweep = _MapMatrix->SweepBox(CalculatePlayerCollisionBox(playerWorldPosition), { 0.0f, verticalMovement });
+
+		// Checks if the top of the player ran into an object
+		if (sweep.hit)
 		{
-			// If we are being launched, we break through destructibles
-			if (reducedGravity > 0.0f)
-			{
-				InteractWithTile(topLeftSideTile, true, false);
-				InteractWithTile(topRightSideTile, true, false);
-			}
+			// Calculates the tiles above the player in the row that was hit
+			std::pair<int, int> topLeftSideTile = { CalculatePlayerMapPositions(playerWorldPosition, Positions::TopLeftIn).first, sweep.tile.second };
+			std::pair<int, int> topCenter = { CalculatePlayerMapPositions(playerWorldPosition, Positions::TopCenter).first, sweep.tile.second };
 
 			// Checks if the center is clear and if so moves the player towards the opening
 			if (_MapMatrix->GetTile(topCenter).tileStatus < MapMatrix::TileStatus::Player)
 			{
 				float downYPos = ConvertMapCoordsToWorldCoords(topLeftSideTile).y - 2.0f + upperInnerGap;
-				float distInObject = playerWorldPosition.y - downYPos;
+				float distInObject = playerWorldPosition.y + verticalMovement - downYPos;
 				playerWorldPosition.y = downYPos;
 				
-				if (_MapMatrix->GetTile(topLeftSideTile).tileStatus > MapMatrix::TileStatus::Player)
+				if (_MapMatrix->TestTileMask(MapMatrix::TileMask::Solid, topLeftSideTile))
 				{
 					playerWorldPosition.x += distInObject;
 				}
@@ -618,25 +631,28 @@ void Player::MovePlayer(double dt)
 				InteractWithTile(_MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(playerWorldPosition, Positions::TopLeftIn), GetIsFacingRight(), 0, 1), true, false);
 			}
 		}
+		else
+		{
+			playerWorldPosition.y += verticalMovement;
+		}
 	}
 	else if (verticalMovement < 0.0f)
 	{
-		// Calculates the tiles the player is moving into
-		std::pair<int, int> bottomLeftSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomLeftIn);
-		std::pair<int, int> bottomRightSideTile = CalculatePlayerMapPositions(playerWorldPosition, Positions::BottomRightIn);
-
 		// If we are being launched, we break through destructibles
 		if (reducedGravity > 0.0f)
 		{
-			InteractWithTile(bottomRightSideTile, true, false);
-			InteractWithTile(bottomLeftSideTile, true, false);
+			glm::vec2 targetPosition = { playerWorldPosition.x, playerWorldPosition.y + verticalMovement };
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomRightIn), true, false);
+			InteractWithTile(CalculatePlayerMapPositions(targetPosition, Positions::BottomLeftIn), true, false);
 		}
 
-		// Checks if the right side of the player has moved into an object
-		if (_MapMatrix->GetTile(bottomLeftSideTile).tileStatus > MapMatrix::TileStatus::Player ||
-			_MapMatrix->GetTile(bottomRightSideTile).tileStatus > MapMatrix::TileStatus::Player)
+		// Sweeps the player down
+		MapMatrix::SweepResult sweep = _MapMatrix->SweepBox(CalculatePlayerCollisionBox(playerWorldPosition), { 0.0f, verticalMovement });
+
+		// Checks if the bottom of the player landed on an object
+		if (sweep.hit)
 		{
-			playerWorldPosition.y = ConvertMapCoordsToWorldCoords(bottomLeftSideTile).y + 2.0f;// 15625f;
+			playerWorldPosition.y = ConvertMapCoordsToWorldCoords(sweep.tile).y + 2.0f;
 
 			grounded = true;
 			floating = false;
@@ -644,6 +660,10 @@ void Player::MovePlayer(double dt)
 			// Kills the player's velocity
 			verticalVelocity = 0;
 		}
+		else
+		{
+			playerWorldPosition.y += verticalMovement;
+		}
 	}
 
 	// Decrements the player's timers
@@ -671,12 +691,11 @@ bool Player::UngroundedCheck()
 	// Checks if the player was grounded
 	if (grounded)
 	{
-		// Checks if there is now nothing to collide with in the space under the player
-		if (_MapMatrix->GetTile(_MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::BottomLeftOut), GetIsFacingRight(), 0, -1)).tileStatus < MapMatrix::TileStatus::Player &&
-			_MapMatrix->GetTile(_MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::BottomRightOut), GetIsFacingRight(), 0, -1)).tileStatus < MapMatrix::TileStatus::Player)
+		// Checks if there is now nothing to collide with in the space under the player by sweeping the outer hitbox down half a tile
+		if (!_MapMatrix->SweepBox(CalculatePlayerCollisionBox(GetPosition(), true), { 0.0f, -1.0f }).hit)
 		{
 			// If the player is going max speed, they can skip over 1 block gaps
-			if (goingMaxSpeed && _MapMatrix->GetTile(_MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::Center), GetIsFacingRight(), 1, -1)).tileStatus > MapMatrix::TileStatus::Player)
+			if (goingMaxSpeed && _MapMatrix->TestTileMask(MapMatrix::TileMask::Solid, _MapMatrix->CalculateOffsetTile(CalculatePlayerMapPositions(GetPosition(), Positions::Center), GetIsFacingRight(), 1, -1)))
 			{
 				return false;
 			}
@@ -862,6 +881,30 @@ std::pair<int, int> Player::CalculatePlayerMapPositions(glm::vec2 position, Play
 	}
 }
 
+/*************************************************************************************************/
+/*!
+	\brief
+		Calculates the player's collision box for sweeping through the map
+
+	\param position
+		The given world position to build the box around
+
+	\param outer
+		Whether to use the wider outer hitbox (used for ground checks) instead of the inner one
+
+	\return
+		The collision box in world coordinates
+*/
+/*************************************************************************************************/
+MapMatrix::CollisionBox Player::CalculatePlayerCollisionBox(glm::vec2 position, bool outer)
+{
+	glm::vec2 halfScale = GetScale() * 0.5f;
+	float sideGap = outer ? lowerInnerGap : upperInnerGap;
+
+	// Matches the anchor points in CalculatePlayerMapPositions. The outer box keeps the full height
+	return { { position.x - halfScale.x + sideGap, position.y - halfScale.y }, { position.x + halfScale.x - sideGap, position.y + halfScale.y - (outer ? 0.0f : upperInnerGap) } };
+}
+
 /*************************************************************************************************/
 /*!
 	\brief
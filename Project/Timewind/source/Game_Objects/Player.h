@@ -38,6 +38,9 @@ Copyright (c) 2023 Aiden Cvengros
 // Includes the input manager because we need to check for specific inputs
 #include "../Engine/InputManager.h"
 
+// The map matrix for the collision box type used by sweeps
+#include "../Gameplay/MapMatrix.h"
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
@@ -328,6 +331,23 @@ private:
 	/*************************************************************************************************/
 	std::pair<int, int> CalculatePlayerMapPositions(glm::vec2 position, Positions anchorPoint);
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Calculates the player's collision box for sweeping through the map
+	
+		\param position
+			The given world position to build the box around
+	
+		\param outer
+			Whether to use the wider outer hitbox (used for ground checks) instead of the inner one
+	
+		\return
+			The collision box in world coordinates
+	*/
+	/*************************************************************************************************/
+	MapMatrix::CollisionBox CalculatePlayerCollisionBox(glm::vec2 position, bool outer = false);
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -24,13 +24,21 @@ Copyright (c) 2023 Aiden Cvengros
 
 // Includes the window to interface with vulkan instance
 #include "../Engine/Window.h"
-#include "../Engine/Vertex.h"
 #include "../Engine/Font.h"
+#include "../Engine/Texture.h"
 
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
+// Drawn in place of bytes that aren't valid utf-8
+const uint32_t replacementCharacter = 0xFFFD;
+
+// The largest codepoint, and the range only used by utf-16 that utf-8 can't hold
+const uint32_t maxCodepoint = 0x10FFFF;
+const uint32_t firstSurrogate = 0xD800;
+const uint32_t lastSurrogate = 0xDFFF;
+
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
 //-------------------------------------------------------------------------------------------------
@@ -72,8 +80,7 @@ Copyright (c) 2023 Aiden Cvengros
 Text::Text(const std::string& _text, Font* _font, int _fontSize, glm::vec2 pos, float rot, glm::vec2 sca, int drawPriority, glm::vec4 color_) :
 	GameObject(pos, rot, sca, drawPriority, true, color_),
 	font(_font), fontSize(_fontSize), alignment(-1),
-	vertexBuffer(NULL), vertexBufferMemory(NULL), indexBuffer(NULL), indexBufferMemory(NULL), indexCount(0),
-	textScroll(false), textScrollSpeed(1.0f) 
+	layoutGeneration(0), layoutComplete(false), textScroll(false), textScrollSpeed(1.0f) 
 {
 	SetText(_text);
 	SetRender(2);
@@ -87,7 +94,6 @@ Text::Text(const std::string& _text, Font* _font, int _fontSize, glm::vec2 pos,
 /*************************************************************************************************/
 Text::~Text()
 {
-	FreeBuffers();
 }
 
 /*************************************************************************************************/
@@ -106,59 +112,22 @@ void Text::SetText(const std::string& newText)
 		// Sets the text variable
 		text = newText;
 
-		// Frees the old buffers
-		FreeBuffers();
-		indexCount = 0;
-
-		// Variables to track vertices and indices for rendering text
-		std::vector<Vertex> vertices;
-		std::vector<uint32_t> indices;
-
-		// Variables for the loop
-		int indexOffset = 0;
-		float xPos = 0.0f;
-		float yPos = 0.0f;
-
-		// Loops through the string
-		for (size_t i = 0; i < text.length(); i++)
-		{
-			char c = text[i];
-			Font::Character fontData = font->GetCharacter(c);
-			float localXPos = xPos + fontData.bearing.x * fontSize / font->GetBmpHeight();
-			float localYPos = yPos + (fontData.bearing.y - fontData.size.y) * fontSize / font->GetBmpHeight();// (character.Size.y - character.Bearing.y)* scale;
-			//localXPos *= -1;
-			//localYPos *= -1;
-
-			float w = (float)fontData.size.x * fontSize / font->GetBmpHeight();
-			float hraw = (float)fontData.size.y;
-			float h = hraw * fontSize / font->GetBmpHeight();
-			float u0 = (float)fontData.offset * font->GetInvertedBmpWidth();
-			float v = (hraw) / font->GetBmpHeight();
-			float u1 = (float)(fontData.offset + fontData.size.x) * font->GetInvertedBmpWidth();
-			float offset = 0.00048828125;
-
-			Vertex bottomRight({ localXPos - w, localYPos }, GetColor(), { u1 - offset, 1.0f - v });
-			Vertex bottomLeft({ localXPos, localYPos }, GetColor(), { u0 + offset, 1.f - v });
-			Vertex topLeft({ localXPos, localYPos + h }, GetColor(), { u0 + offset, 1.0f });
-			Vertex topRight = { {localXPos - w, localYPos + h }, GetColor(), { u1 - offset, 1.0f } };
-			vertices.push_back(bottomRight);
-			vertices.push_back(bottomLeft);
-			vertices.push_back(topLeft);
-			vertices.push_back(topRight);
-			indices.push_back(indexOffset + 0);
-			indices.push_back(indexOffset + 1);
-			indices.push_back(indexOffset + 2);
-			indices.push_back(indexOffset + 2);
-			indices.push_back(indexOffset + 3);
-			indices.push_back(indexOffset + 0);
-			indexOffset += 4;
-			xPos -= (fontData.advance >> 6) * fontSize / font->GetBmpHeight();
-		}
+		Layout();
+	}
+}
 
-		// Creates the vertex and indices buffers
-		_Window->CreateVulkanBuffer(vertexBuffer, vertexBufferMemory, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, sizeof(Vertex) * vertices.size(), (void*)vertices.data());
-		_Window->CreateVulkanBuffer(indexBuffer, indexBufferMemory, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, sizeof(uint32_t) * indices.size(), (void*)indices.data());
-		indexCount = indices.size();
+/*************************************************************************************************/
+/*!
+	\brief
+		Lays the text out again if some of its characters were still waiting to be rendered,
+		or if the font's glyph cache gave away a cell the text was using. Call before drawing
+*/
+/*************************************************************************************************/
+void Text::Refresh()
+{
+	if (font && (!layoutComplete || layoutGeneration != font->GetGlyphGeneration()))
+	{
+		Layout();
 	}
 }
 
@@ -169,29 +138,143 @@ void Text::SetText(const std::string& newText)
 /*************************************************************************************************/
 /*!
 	\brief
-		Frees the text object's index buffer and vertex buffer
+		Places each of the text's characters and finds where they are in the font's textures
 */
 /*************************************************************************************************/
-void Text::FreeBuffers()
+void Text::Layout()
 {
-	if (indexBuffer || vertexBuffer)
+	// Clears the old glyphs, keeping their memory. Nothing on the GPU refers to them, since
+	// they're copied each time they're drawn
+	glyphs.clear();
+	layoutComplete = true;
+
+	// Variables for the loop
+	float xPos = 0.0f;
+	float yPos = 0.0f;
+	uint32_t previous = 0;
+
+	// Loops through the string a character at a time, which can be several bytes
+	size_t index = 0;
+	while (index < text.length())
 	{
-		_Window->WaitForDrawFinished();
+		uint32_t c = DecodeUtf8(text, index);
+
+		// Characters the glyph cache hasn't got to yet are left out until a later frame
+		Font::Character fontData;
+		if (!font->GetCharacter(c, fontData))
+		{
+			layoutComplete = false;
+		}
+
+		// Pulls the pair together or apart before placing the character
+		if (previous != 0)
+		{
+			xPos -= font->GetKerning(previous, c) * fontSize / font->GetBmpHeight();
+		}
+		previous = c;
+
+		float localXPos = xPos + fontData.bearing.x * fontSize / font->GetBmpHeight();
+		float localYPos = yPos + (fontData.bearing.y - fontData.size.y) * fontSize / font->GetBmpHeight();
+
+		float w = (float)fontData.size.x * fontSize / font->GetBmpHeight();
+		float h = (float)fontData.size.y * fontSize / font->GetBmpHeight();
 
-		if (indexBuffer)
+		// Characters with nothing to draw, like spaces, only move the next one along. The sprite
+		// quad shows the right edge of its uv rect on its left, so the character's left edge
+		// goes on the quad's right. The atlas and the cache's cells keep a gap around each
+		// character, so the quad can cover all of it without picking up its neighbors
+		if (w > 0.0f && h > 0.0f && fontData.texture)
 		{
-			// Destroys the old index buffer
-			vkUnmapMemory(_Window->GetLogicalDevice(), indexBufferMemory);
-			vkDestroyBuffer(_Window->GetLogicalDevice(), indexBuffer, NULL);
-			vkFreeMemory(_Window->GetLogicalDevice(), indexBufferMemory, NULL);
+			glm::vec2 invertedTextureSize = glm::vec2(1.0f / (float)fontData.texture->GetWidth(), 1.0f / (float)fontData.texture->GetHeight());
+			glm::vec2 uvPosition = glm::vec2(fontData.atlasPosition) * invertedTextureSize;
+			glm::vec2 uvSize = glm::vec2(fontData.size) * invertedTextureSize;
+
+			Glyph glyph;
+			glyph.center = { localXPos - w * 0.5f, localYPos + h * 0.5f };
+			glyph.size = { w, h };
+			glyph.uvRect = { uvPosition.x, uvPosition.y, uvSize.x, uvSize.y };
+			glyph.texture = fontData.texture;
+			glyph.cacheSlot = fontData.cacheSlot;
+			glyphs.push_back(glyph);
 		}
 
-		if (vertexBuffer)
+		xPos -= (fontData.advance >> 6) * fontSize / font->GetBmpHeight();
+	}
+
+	// Taken after the characters are found, since rendering them can give away other cells
+	layoutGeneration = font->GetGlyphGeneration();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads one utf-8 character from a string
+
+	\param string
+		The string to read from
+
+	\param index
+		The byte the character starts at. Moved past the character
+
+	\return
+		The character's codepoint, or the replacement character if the bytes aren't valid utf-8
+*/
+/*************************************************************************************************/
+uint32_t Text::DecodeUtf8(const std::string& string, size_t& index)
+{
+	unsigned char lead = (unsigned char)string[index++];
+	if (lead < 0x80)
+	{
+		return lead;
+	}
+
+	// The lead byte says how many continuation bytes follow and the smallest codepoint that
+	// needs that many, so overlong encodings can be turned away
+	size_t length;
+	uint32_t codepoint;
+	uint32_t minimum;
+	if ((lead & 0xE0) == 0xC0)
+	{
+		length = 1;
+		codepoint = lead & 0x1F;
+		minimum = 0x80;
+	}
+	else if ((lead & 0xF0) == 0xE0)
+	{
+		length = 2;
+		codepoint = lead & 0x0F;
+		minimum = 0x800;
+	}
+	else if ((lead & 0xF8) == 0xF0)
+	{
+		length = 3;
+		codepoint = lead & 0x07;
+		minimum = 0x10000;
+	}
+	else
+	{
+		return replacementCharacter;
+	}
+
+	// A bad sequence only skips its lead byte, so whatever follows is still read
+	if (index + length > string.length())
+	{
+		return replacementCharacter;
+	}
+	for (size_t i = 0; i < length; i++)
+	{
+		unsigned char next = (unsigned char)string[index + i];
+		if ((next & 0xC0) != 0x80)
 		{
-			// Destroys the old vertex buffer
-			vkUnmapMemory(_Window->GetLogicalDevice(), vertexBufferMemory);
-			vkDestroyBuffer(_Window->GetLogicalDevice(), vertexBuffer, NULL);
-			vkFreeMemory(_Window->GetLogicalDevice(), vertexBufferMemory, NULL);
+			return replacementCharacter;
 		}
+		codepoint = (codepoint << 6) | (next & 0x3F);
+	}
+	index += length;
+
+	if (codepoint < minimum || codepoint > maxCodepoint || (codepoint >= firstSurrogate && codepoint <= lastSurrogate))
+	{
+		return replacementCharacter;
 	}
+	return codepoint;
 }
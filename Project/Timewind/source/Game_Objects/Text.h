@@ -32,6 +32,9 @@ Copyright (c) 2023 Aiden Cvengros
 // The base game object class
 #include "GameObject.h"
 
+// The text's glyphs
+#include <vector>
+
 // Includes glfw libraries for callback functions
 #define VK_USE_PLATFORM_WIN32_KHR
 #define GLFW_INCLUDE_VULKAN
@@ -42,6 +45,7 @@ Copyright (c) 2023 Aiden Cvengros
 //-------------------------------------------------------------------------------------------------
 
 class Font;
+class Texture;
 
 //-------------------------------------------------------------------------------------------------
 // Public Constants
@@ -67,6 +71,16 @@ public:
 	//---------------------------------------------------------------------------------------------
 	// Public Structures
 	//---------------------------------------------------------------------------------------------
+
+	// Where one character sits in the text and in the font's texture. Drawn as a sprite instance
+	typedef struct
+	{
+		glm::vec2 center;						// The middle of the character's quad, in the text's space
+		glm::vec2 size;							// The width and height of the character's quad, in the text's space
+		glm::vec4 uvRect;						// The offset (xy) and size (zw) of the character in its texture
+		Texture* texture;						// The font's atlas, or the glyph cache page the character is in
+		int cacheSlot;							// The character's cell in the glyph cache, -1 if it doesn't have one
+	}Glyph;
 	
 	//---------------------------------------------------------------------------------------------
 	// Public Variables
@@ -115,6 +129,15 @@ public:
 	/*************************************************************************************************/
 	void SetText(const std::string& newText);
 
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Lays the text out again if some of its characters were still waiting to be rendered,
+			or if the font's glyph cache gave away a cell the text was using. Call before drawing
+	*/
+	/*************************************************************************************************/
+	void Refresh();
+
 	/*************************************************************************************************/
 	/*!
 		\brief
@@ -124,7 +147,7 @@ public:
 			The new font for the text
 	*/
 	/*************************************************************************************************/
-	void SetFont(Font* newFont) { font = newFont; }
+	void SetFont(Font* newFont) { font = newFont; layoutComplete = false; }
 
 	/*************************************************************************************************/
 	/*!
@@ -135,7 +158,7 @@ public:
 			The new font size for the text
 	*/
 	/*************************************************************************************************/
-	void SetFontSize(float newFontSize) { fontSize = newFontSize; }
+	void SetFontSize(float newFontSize) { fontSize = newFontSize; layoutComplete = false; }
 
 	/*************************************************************************************************/
 	/*!
@@ -184,35 +207,13 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Returns the text's vertex buffer
-
-		\return
-			The vertex buffer
-	*/
-	/*************************************************************************************************/
-	VkBuffer GetVertexBuffer() { return vertexBuffer; }
-
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Returns the text's index buffer
-
-		\return
-			The index buffer
-	*/
-	/*************************************************************************************************/
-	VkBuffer GetIndexBuffer() { return indexBuffer; }
-
-	/*************************************************************************************************/
-	/*!
-		\brief
-			Returns the text's index buffer
+			Returns the text's visible characters, laid out from the text's position
 
 		\return
-			The index buffer
+			The glyphs, in the order they're read
 	*/
 	/*************************************************************************************************/
-	uint32_t GetIndexCount() { return indexCount; }
+	const std::vector<Glyph>& GetGlyphs() { return glyphs; }
 	
 private:
 	//---------------------------------------------------------------------------------------------
@@ -231,11 +232,9 @@ private:
 	Font* font;									// The font of the text
 	float fontSize;								// The font size
 	int alignment;								// <0 for left aligned, 0 for center aligned, >0 for right aligned
-	VkBuffer vertexBuffer;						// The text's vertex buffer
-	VkDeviceMemory vertexBufferMemory;			// The vertex buffer memory
-	VkBuffer indexBuffer;						// The text's index buffer
-	VkDeviceMemory indexBufferMemory;			// The index buffer memory
-	uint32_t indexCount;						// The number of indices in the buffer
+	std::vector<Glyph> glyphs;					// The text's visible characters, turned into sprite instances each time it's drawn
+	unsigned int layoutGeneration;				// The font's glyph cache generation when the text was laid out
+	bool layoutComplete;						// Whether every character was ready when the text was laid out
 
 	bool textScroll;							// Whether the text should display all at once (false) or be typed out (true)
 	float textScrollSpeed;						// How quickly the text should reveal
@@ -247,10 +246,27 @@ private:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Frees the text object's index buffer and vertex buffer
+			Places each of the text's characters and finds where they are in the font's textures
+	*/
+	/*************************************************************************************************/
+	void Layout();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads one utf-8 character from a string
+
+		\param string
+			The string to read from
+
+		\param index
+			The byte the character starts at. Moved past the character
+
+		\return
+			The character's codepoint, or the replacement character if the bytes aren't valid utf-8
 	*/
 	/*************************************************************************************************/
-	void FreeBuffers();
+	static uint32_t DecodeUtf8(const std::string& string, size_t& index);
 };
 
 //-------------------------------------------------------------------------------------------------
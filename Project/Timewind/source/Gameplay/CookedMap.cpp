@@ -0,0 +1,634 @@
+/*************************************************************************************************/
+/*!
+\file CookedMap.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    The binary cooked map format. Maps are cooked from the csv files ahead of time, then memory
+	mapped and validated at load time instead of being parsed.
+
+    Functions include:
+        + CookedMap::CookedMap
+		+ CookedMap::~CookedMap
+		+ CookedMap::Open
+		+ CookedMap::Close
+		+ CookedMap::CookFromCsv
+		+ CookedMap::WriteToFile
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "CookedMap.h"
+
+// File streams for reading csv files and writing cooked files
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+// OS headers for memory mapping
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+const uint32_t fnvOffsetBasis = 2166136261u;	// FNV-1a starting value
+const uint32_t fnvPrime = 16777619u;			// FNV-1a multiplier
+const uint32_t maxMapDimension = 4096;			// Anything bigger than this is treated as a corrupt file
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Hashes the given bytes with FNV-1a
+
+	\param data
+		The bytes to hash
+
+	\param size
+		The number of bytes
+
+	\return
+		The hash
+*/
+/*************************************************************************************************/
+static uint32_t HashBytes(const uint8_t* data, size_t size);
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the first character of each cell in a csv line. Empty cells come back as '0'
+
+	\param line
+		The csv line
+
+	\param cells
+		The vector the cells are written into
+*/
+/*************************************************************************************************/
+static void SplitCsvLine(const std::string& line, std::vector<char>& cells);
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the cooked map class
+*/
+/*************************************************************************************************/
+CookedMap::CookedMap() : imageData(NULL), imageSize(0), header(NULL), mappedView(NULL), mappingHandle(NULL), fileHandle(NULL)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the cooked map class. Unmaps the file if one is mapped
+*/
+/*************************************************************************************************/
+CookedMap::~CookedMap()
+{
+	Close();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Opens a map image. Cooked files are memory mapped, while csv files are cooked in memory
+		so unconverted maps still load
+
+	\param filename
+		The file to open
+
+	\return
+		Whether the map was opened and passed validation
+*/
+/*************************************************************************************************/
+bool CookedMap::Open(const std::string& _filename)
+{
+	// Releases whatever was open before
+	Close();
+	filename = _filename;
+	error.clear();
+
+	// Checks if this is a csv that still needs cooking
+	if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0)
+	{
+		// Reads in the whole csv
+		std::ifstream csvFile(filename, std::ios::binary);
+		if (!csvFile)
+		{
+			error = "failed to open " + filename;
+			return false;
+		}
+		std::string csvData((std::istreambuf_iterator<char>(csvFile)), std::istreambuf_iterator<char>());
+
+		// Cooks it into the owned image
+		if (!CookFromCsv(csvData.data(), csvData.size(), ownedImage, error))
+		{
+			return false;
+		}
+		imageData = ownedImage.data();
+		imageSize = ownedImage.size();
+	}
+	// Otherwise maps the cooked file
+	else if (!MapFile(filename))
+	{
+		return false;
+	}
+
+	// Checks the image before anything reads from it
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Releases the current image
+*/
+/*************************************************************************************************/
+void CookedMap::Close()
+{
+	// Unmaps the file if there is one mapped
+#ifdef _WIN32
+	if (mappedView)
+	{
+		UnmapViewOfFile(mappedView);
+	}
+	if (mappingHandle)
+	{
+		CloseHandle((HANDLE)mappingHandle);
+	}
+	if (fileHandle)
+	{
+		CloseHandle((HANDLE)fileHandle);
+	}
+#else
+	if (mappedView)
+	{
+		munmap(mappedView, imageSize);
+	}
+	if (fileHandle)
+	{
+		close((int)(intptr_t)fileHandle - 1);
+	}
+#endif
+
+	// Resets the image
+	mappedView = NULL;
+	mappingHandle = NULL;
+	fileHandle = NULL;
+	ownedImage.clear();
+	imageData = NULL;
+	imageSize = 0;
+	header = NULL;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Cooks a csv map into a binary image
+
+	\param csvData
+		The raw contents of the csv file
+
+	\param csvSize
+		The size of the csv data in bytes
+
+	\param cookedImage
+		The vector the cooked image is written into
+
+	\param error
+		Set to a description of the problem if cooking fails
+
+	\return
+		Whether the map was cooked successfully
+*/
+/*************************************************************************************************/
+bool CookedMap::CookFromCsv(const char* csvData, size_t csvSize, std::vector<uint8_t>& cookedImage, std::string& error)
+{
+	// Splits the csv into lines
+	std::vector<std::string> lines;
+	size_t lineStart = 0;
+	for (size_t i = 0; i <= csvSize; i++)
+	{
+		if (i == csvSize || csvData[i] == '\n')
+		{
+			// Drops carriage returns from windows line endings
+			size_t lineEnd = i;
+			if (lineEnd > lineStart && csvData[lineEnd - 1] == '\r')
+			{
+				lineEnd--;
+			}
+			lines.push_back(std::string(csvData + lineStart, lineEnd - lineStart));
+			lineStart = i + 1;
+		}
+	}
+
+	// Reads in the width and height of the map from the first line
+	int mapWidth = 0;
+	int mapHeight = 0;
+	if (lines.empty() || sscanf(lines[0].c_str(), "%d,%d", &mapWidth, &mapHeight) != 2 ||
+		mapWidth <= 0 || mapHeight <= 0 || (uint32_t)mapWidth > maxMapDimension || (uint32_t)mapHeight > maxMapDimension)
+	{
+		error = "map header is missing or has an invalid size";
+		return false;
+	}
+	if ((int)lines.size() - 1 < mapHeight)
+	{
+		error = "map has fewer rows than its header says";
+		return false;
+	}
+
+	// Builds the tile grid and the special tile table
+	std::vector<uint8_t> tiles((size_t)mapWidth * mapHeight, tileEmpty);
+	std::vector<SpecialTile> specialTiles;
+	int32_t playerStartX = -1;
+	int32_t playerStartY = -1;
+	std::vector<char> cells;
+
+	// Rows are stored top down in the csv, so the first row is the top of the map
+	for (int i = mapHeight - 1; i >= 0; i--)
+	{
+		SplitCsvLine(lines[mapHeight - i], cells);
+
+		for (int j = 0; j < mapWidth; j++)
+		{
+			// Missing cells at the end of a row are empty
+			char newChar = j < (int)cells.size() ? cells[j] : '0';
+			uint8_t& tile = tiles[(size_t)j * mapHeight + i];
+
+			// Sets the walls
+			if (newChar == 'w')
+			{
+				tile = tileWall;
+			}
+			// Sets the player starting location
+			else if (newChar == 'p')
+			{
+				tile = tilePlayer;
+				playerStartX = j;
+				playerStartY = i;
+			}
+			// If the space isn't empty or something simple, notes it so the scene can populate these objects
+			else if (newChar != '0' && newChar != '/')
+			{
+				SpecialTile specialTile = { j, i, newChar, { 0, 0, 0 } };
+				specialTiles.push_back(specialTile);
+			}
+		}
+	}
+
+	// Lays out the image
+	Header newHeader;
+	memset(&newHeader, 0, sizeof(newHeader));
+	newHeader.magic = magic;
+	newHeader.version = version;
+	newHeader.headerSize = sizeof(Header);
+	newHeader.width = (uint32_t)mapWidth;
+	newHeader.height = (uint32_t)mapHeight;
+	newHeader.playerStartX = playerStartX;
+	newHeader.playerStartY = playerStartY;
+	newHeader.tileOffset = sizeof(Header);
+	newHeader.specialTileOffset = (newHeader.tileOffset + (uint32_t)tiles.size() + 3u) & ~3u;
+	newHeader.specialTileCount = (uint32_t)specialTiles.size();
+	newHeader.fileSize = newHeader.specialTileOffset + newHeader.specialTileCount * sizeof(SpecialTile);
+
+	// Copies everything into the image
+	cookedImage.assign(newHeader.fileSize, 0);
+	memcpy(cookedImage.data() + newHeader.tileOffset, tiles.data(), tiles.size());
+	if (!specialTiles.empty())
+	{
+		memcpy(cookedImage.data() + newHeader.specialTileOffset, specialTiles.data(), specialTiles.size() * sizeof(SpecialTile));
+	}
+
+	// Hashes the payload, then writes the header in front of it
+	newHeader.checksum = HashBytes(cookedImage.data() + sizeof(Header), cookedImage.size() - sizeof(Header));
+	memcpy(cookedImage.data(), &newHeader, sizeof(Header));
+
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Writes a cooked image to disk. Writes to a temporary file first then renames it over
+		the target so a half written map is never left behind
+
+	\param filename
+		The file to write to
+
+	\param cookedImage
+		The cooked image
+
+	\return
+		Whether the file was written
+*/
+/*************************************************************************************************/
+bool CookedMap::WriteToFile(const std::string& filename, const std::vector<uint8_t>& cookedImage)
+{
+	// Writes the image to a temporary file
+	std::string tempFilename = filename + ".tmp";
+	{
+		std::ofstream outputFile(tempFilename, std::ios::binary | std::ios::trunc);
+		if (!outputFile)
+		{
+			return false;
+		}
+		outputFile.write((const char*)cookedImage.data(), cookedImage.size());
+		if (!outputFile)
+		{
+			return false;
+		}
+	}
+
+	// Swaps the finished file into place
+#ifdef _WIN32
+	return MoveFileExA(tempFilename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(tempFilename.c_str(), filename.c_str()) == 0;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Memory maps the given file
+
+	\param mapFilename
+		The file to map
+
+	\return
+		Whether the file was mapped
+*/
+/*************************************************************************************************/
+bool CookedMap::MapFile(const std::string& mapFilename)
+{
+#ifdef _WIN32
+	// Opens the file
+	HANDLE file = CreateFileA(mapFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		error = "failed to open " + mapFilename;
+		return false;
+	}
+	fileHandle = file;
+
+	// Gets the file size
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(Header))
+	{
+		error = mapFilename + " is too small to be a cooked map";
+		Close();
+		return false;
+	}
+	imageSize = (size_t)fileSize.QuadPart;
+
+	// Maps the file
+	mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!mappingHandle)
+	{
+		error = "failed to create a file mapping for " + mapFilename;
+		Close();
+		return false;
+	}
+	mappedView = MapViewOfFile((HANDLE)mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+	// Opens the file
+	int file = open(mapFilename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		error = "failed to open " + mapFilename;
+		return false;
+	}
+	// Stores the descriptor offset by one so 0 can still mean no file
+	fileHandle = (void*)(intptr_t)(file + 1);
+
+	// Gets the file size
+	struct stat fileStats;
+	if (fstat(file, &fileStats) != 0 || fileStats.st_size < (off_t)sizeof(Header))
+	{
+		error = mapFilename + " is too small to be a cooked map";
+		Close();
+		return false;
+	}
+	imageSize = (size_t)fileStats.st_size;
+
+	// Maps the file
+	mappedView = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, file, 0);
+	if (mappedView == MAP_FAILED)
+	{
+		mappedView = NULL;
+	}
+#endif
+
+	// Checks that the view was created
+	if (!mappedView)
+	{
+		error = "failed to map " + mapFilename;
+		Close();
+		return false;
+	}
+	imageData = (const uint8_t*)mappedView;
+
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks that the image is a well formed cooked map. Every offset and value is checked
+		so the loader can read the image without any further bounds checks
+
+	\return
+		Whether the image is valid
+*/
+/*************************************************************************************************/
+bool CookedMap::Validate()
+{
+	// Checks the header itself
+	const Header* newHeader = (const Header*)imageData;
+	if (imageSize < sizeof(Header) || newHeader->magic != magic)
+	{
+		error = filename + " is not a cooked map";
+		return false;
+	}
+	if (newHeader->version != version || newHeader->headerSize != sizeof(Header))
+	{
+		error = filename + " was cooked with a different map version, recook it";
+		return false;
+	}
+	if (newHeader->fileSize != imageSize)
+	{
+		error = filename + " is truncated";
+		return false;
+	}
+
+	// Checks the dimensions and that each section is inside the image
+	uint64_t tileCount = (uint64_t)newHeader->width * newHeader->height;
+	if (newHeader->width == 0 || newHeader->height == 0 || newHeader->width > maxMapDimension || newHeader->height > maxMapDimension ||
+		newHeader->tileOffset < sizeof(Header) || newHeader->tileOffset + tileCount > imageSize ||
+		newHeader->specialTileOffset % 4 != 0 || newHeader->specialTileOffset < newHeader->tileOffset + tileCount ||
+		newHeader->specialTileOffset + (uint64_t)newHeader->specialTileCount * sizeof(SpecialTile) > imageSize)
+	{
+		error = filename + " has an invalid layout";
+		return false;
+	}
+
+	// Checks the payload wasn't corrupted
+	if (HashBytes(imageData + sizeof(Header), imageSize - sizeof(Header)) != newHeader->checksum)
+	{
+		error = filename + " failed its checksum";
+		return false;
+	}
+
+	// Checks every tile holds a known status
+	const uint8_t* tiles = imageData + newHeader->tileOffset;
+	for (uint64_t i = 0; i < tileCount; i++)
+	{
+		if (tiles[i] >= tileMax)
+		{
+			error = filename + " contains an unknown tile status";
+			return false;
+		}
+	}
+
+	// Checks every special tile is on the map
+	const SpecialTile* specialTiles = (const SpecialTile*)(imageData + newHeader->specialTileOffset);
+	for (uint32_t i = 0; i < newHeader->specialTileCount; i++)
+	{
+		if (specialTiles[i].xCoord < 0 || (uint32_t)specialTiles[i].xCoord >= newHeader->width ||
+			specialTiles[i].yCoord < 0 || (uint32_t)specialTiles[i].yCoord >= newHeader->height)
+		{
+			error = filename + " has a special tile outside the map";
+			return false;
+		}
+	}
+
+	// Checks the player start is either missing or on the map
+	if ((newHeader->playerStartX != -1 || newHeader->playerStartY != -1) &&
+		(newHeader->playerStartX < 0 || (uint32_t)newHeader->playerStartX >= newHeader->width ||
+		newHeader->playerStartY < 0 || (uint32_t)newHeader->playerStartY >= newHeader->height))
+	{
+		error = filename + " has a player start outside the map";
+		return false;
+	}
+
+	// Everything checks out
+	header = newHeader;
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Hashes the given bytes with FNV-1a
+
+	\param data
+		The bytes to hash
+
+	\param size
+		The number of bytes
+
+	\return
+		The hash
+*/
+/*************************************************************************************************/
+static uint32_t HashBytes(const uint8_t* data, size_t size)
+{
+	uint32_t hash = fnvOffsetBasis;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= fnvPrime;
+	}
+	return hash;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the first character of each cell in a csv line. Empty cells come back as '0'
+
+	\param line
+		The csv line
+
+	\param cells
+		The vector the cells are written into
+*/
+/*************************************************************************************************/
+static void SplitCsvLine(const std::string& line, std::vector<char>& cells)
+{
+	cells.clear();
+	bool cellStarted = false;
+	for (size_t i = 0; i < line.size(); i++)
+	{
+		// Commas end the current cell
+		if (line[i] == ',')
+		{
+			if (!cellStarted)
+			{
+				cells.push_back('0');
+			}
+			cellStarted = false;
+		}
+		// Only the first character of a cell matters
+		else if (!cellStarted)
+		{
+			cells.push_back(line[i]);
+			cellStarted = true;
+		}
+	}
+
+	// Handles the final cell
+	if (!cellStarted && !line.empty())
+	{
+		cells.push_back('0');
+	}
+}
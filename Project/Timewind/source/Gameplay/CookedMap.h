@@ -0,0 +1,330 @@
+/*************************************************************************************************/
+/*!
+\file CookedMap.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    The binary cooked map format. Maps are cooked from the csv files ahead of time, then memory
+	mapped and validated at load time instead of being parsed.
+
+    Public Functions:
+        + CookedMap
+		+ ~CookedMap
+		+ Open
+		+ Close
+		+ CookFromCsv
+		+ WriteToFile
+
+	Private Functions:
+		+ MapFile
+		+ Validate
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_CookedMap_H_
+#define Syncopatience_CookedMap_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Fixed width integers for the file layout
+#include <cstdint>
+#include <cstddef>
+
+// Strings for filenames and error messages
+#include <string>
+
+// The vector that holds cooked images that weren't memory mapped
+#include <vector>
+
+// Tile coordinates are returned as pairs like the rest of the map code
+#include <utility>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		A read only view of a cooked map image. This class deliberately doesn't depend on the engine
+		so the map cooker tool can share it.
+*/
+/*************************************************************************************************/
+class CookedMap
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t magic = 0x504D5754;	// "TWMP" when read as bytes on little endian
+	static constexpr uint32_t version = 1;		// Bumped whenever the layout below changes
+
+	// Tile values written into the tile grid. These are checked against MapMatrix::TileStatus
+	static constexpr uint8_t tileEmpty = 0;
+	static constexpr uint8_t tilePlayer = 8;
+	static constexpr uint8_t tileWall = 13;
+	static constexpr uint8_t tileMax = 14;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	// The header at the start of every cooked map. Every field is 4 bytes so there is no padding
+	typedef struct
+	{
+		uint32_t magic;							// Identifies the file as a cooked map
+		uint32_t version;						// The layout version the file was cooked with
+		uint32_t headerSize;					// Size of this header in bytes
+		uint32_t fileSize;						// Size of the whole image in bytes
+		uint32_t width;							// The width of the map in tiles
+		uint32_t height;						// The height of the map in tiles
+		int32_t playerStartX;					// The player's starting x coordinate, -1 if none
+		int32_t playerStartY;					// The player's starting y coordinate, -1 if none
+		uint32_t tileOffset;					// Byte offset to the tile grid (width * height bytes, column major)
+		uint32_t specialTileOffset;				// Byte offset to the special tile table
+		uint32_t specialTileCount;				// Number of entries in the special tile table
+		uint32_t checksum;						// FNV-1a hash of everything after the header
+	}Header;
+
+	// An entry in the special tile table. Stored in the same order the csv parser used to find them
+	typedef struct
+	{
+		int32_t xCoord;							// The x coordinate of the tile
+		int32_t yCoord;							// The y coordinate of the tile
+		char tileChar;							// The character that marked the tile in the csv
+		uint8_t padding[3];						// Keeps the entries 4 byte aligned
+	}SpecialTile;
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the cooked map class
+	*/
+	/*************************************************************************************************/
+	CookedMap();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the cooked map class. Unmaps the file if one is mapped
+	*/
+	/*************************************************************************************************/
+	~CookedMap();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Opens a map image. Cooked files are memory mapped, while csv files are cooked in memory
+			so unconverted maps still load
+
+		\param filename
+			The file to open
+
+		\return
+			Whether the map was opened and passed validation
+	*/
+	/*************************************************************************************************/
+	bool Open(const std::string& filename);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Releases the current image
+	*/
+	/*************************************************************************************************/
+	void Close();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Cooks a csv map into a binary image
+
+		\param csvData
+			The raw contents of the csv file
+
+		\param csvSize
+			The size of the csv data in bytes
+
+		\param cookedImage
+			The vector the cooked image is written into
+
+		\param error
+			Set to a description of the problem if cooking fails
+
+		\return
+			Whether the map was cooked successfully
+	*/
+	/*************************************************************************************************/
+	static bool CookFromCsv(const char* csvData, size_t csvSize, std::vector<uint8_t>& cookedImage, std::string& error);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Writes a cooked image to disk. Writes to a temporary file first then renames it over
+			the target so a half written map is never left behind
+
+		\param filename
+			The file to write to
+
+		\param cookedImage
+			The cooked image
+
+		\return
+			Whether the file was written
+	*/
+	/*************************************************************************************************/
+	static bool WriteToFile(const std::string& filename, const std::vector<uint8_t>& cookedImage);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns whether there is a valid image open
+	*/
+	/*************************************************************************************************/
+	bool IsOpen() const { return header != NULL; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the file name of the open image
+	*/
+	/*************************************************************************************************/
+	const std::string& GetFilename() const { return filename; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the reason the last open failed
+	*/
+	/*************************************************************************************************/
+	const std::string& GetError() const { return error; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the dimensions of the map in tiles
+	*/
+	/*************************************************************************************************/
+	int GetWidth() const { return (int)header->width; }
+	int GetHeight() const { return (int)header->height; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the player's starting tile, (-1, -1) if the map has no player start
+	*/
+	/*************************************************************************************************/
+	std::pair<int, int> GetPlayerStart() const { return { header->playerStartX, header->playerStartY }; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the cooked tile grid. The grid is column major so tile (x, y) is at
+			x * height + y, matching the map matrix layout
+	*/
+	/*************************************************************************************************/
+	const uint8_t* GetTiles() const { return imageData + header->tileOffset; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the special tile table and its size
+	*/
+	/*************************************************************************************************/
+	const SpecialTile* GetSpecialTiles() const { return (const SpecialTile*)(imageData + header->specialTileOffset); }
+	int GetSpecialTileCount() const { return (int)header->specialTileCount; }
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	std::string filename;						// The file the image came from
+	std::string error;							// The reason the last open failed
+
+	const uint8_t* imageData;					// The start of the image, either mapped or owned
+	size_t imageSize;							// The size of the image in bytes
+	const Header* header;						// The validated header, null if nothing is open
+
+	std::vector<uint8_t> ownedImage;			// Storage for images cooked in memory from csv files
+
+	void* mappedView;							// The mapped view of the file
+	void* mappingHandle;						// The OS handle for the file mapping (windows only)
+	void* fileHandle;							// The OS handle for the mapped file
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Memory maps the given file
+
+		\param mapFilename
+			The file to map
+
+		\return
+			Whether the file was mapped
+	*/
+	/*************************************************************************************************/
+	bool MapFile(const std::string& mapFilename);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks that the image is a well formed cooked map. Every offset and value is checked
+			so the loader can read the image without any further bounds checks
+
+		\return
+			Whether the image is valid
+	*/
+	/*************************************************************************************************/
+	bool Validate();
+
+	// Cooked maps own OS handles so they can't be copied
+	CookedMap(const CookedMap&) = delete;
+	CookedMap& operator=(const CookedMap&) = delete;
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_CookedMap_H_
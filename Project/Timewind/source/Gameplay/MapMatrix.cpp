@@ -29,19 +29,36 @@ Copyright (c) 2023 Aiden Cvengros
 // Includes window class to be drawn to
 #include "../Engine/Window.h"
 
+// Floor, ceil and infinity for the sweep queries
+#include <cmath>
+#include <limits>
+
+// Min and max for clipping mask queries
+#include <algorithm>
+
+// Ray directions and timing for the raycast benchmark
+#include <random>
+#include <chrono>
+#include <string>
+
 //#ifdef DEBUG
 #include "../Engine/TextureManager.h"
 #include "../Engine/GameObjectManager.h"
 #include "../Game_Objects/Player.h"
 //#endif // DEBUG
 
-#include <fstream>
-
 //-------------------------------------------------------------------------------------------------
 // Private Constants
 //-------------------------------------------------------------------------------------------------
 
-const int bufferSize = 512;					// The default buffer size used for reading files
+// The cooked map format stores raw tile statuses, so make sure the two stay in step
+static_assert(CookedMap::tileEmpty == (uint8_t)MapMatrix::TileStatus::Empty, "Cooked map tile values are out of date");
+static_assert(CookedMap::tilePlayer == (uint8_t)MapMatrix::TileStatus::Player, "Cooked map tile values are out of date");
+static_assert(CookedMap::tileWall == (uint8_t)MapMatrix::TileStatus::Wall, "Cooked map tile values are out of date");
+static_assert(CookedMap::tileMax == (uint8_t)MapMatrix::TileStatus::Max, "Cooked map tile values are out of date");
+
+// The most changes the journal holds before subscribers that aren't keeping up are told to rebuild
+const size_t maxJournalLength = 65536;
 
 //-------------------------------------------------------------------------------------------------
 // Public Declarations
@@ -67,7 +84,8 @@ const int bufferSize = 512;					// The default buffer size used for reading file
 		The max height for maps
 */
 /*************************************************************************************************/
-MapMatrix::MapMatrix(int width, int height) : System(SystemTypes::mapMatrix), debugDraw(false), defaultWallTexture(NULL), defaultWallColor(0)
+MapMatrix::MapMatrix(int width, int height) : System(SystemTypes::mapMatrix), defaultWallTexture(NULL), defaultWallColor(0),
+	maskWidth(0), maskHeight(0), maskWordsPerRow(0), journalStart(0), journalSuspended(false), pathfinder(this), debugOverlay(this)
 {
 	// Creates width number of columns
 	for (int i = 0; i < width; i++)
@@ -81,6 +99,9 @@ MapMatrix::MapMatrix(int width, int height) : System(SystemTypes::mapMatrix), de
 	// Sets the minimum dimensions
 	minX = -4.0f;
 	minY = 4.0f;
+
+	// Sizes the tile masks to match
+	RebuildTileMasks();
 }
 
 /*************************************************************************************************/
@@ -116,10 +137,27 @@ void MapMatrix::Init()
 /*************************************************************************************************/
 void MapMatrix::Update(double dt)
 {
+	// Drops the changes everyone has seen so the journal only holds recent ones
+	TrimTileChangeJournal();
+
 	if (_InputManager->CheckInputStatus(InputManager::Inputs::F1) == InputManager::InputStatus::Pressed)
 	{
-		// Toggles the debug draw
-		debugDraw = !debugDraw;
+		// Cycles through the debug overlay's layers, then off
+		debugOverlay.NextLayer();
+	}
+
+	if (_InputManager->CheckInputStatus(InputManager::Inputs::F4) == InputManager::InputStatus::Pressed)
+	{
+		// Compares per enemy searches against the shared flow field on the current map
+		pathfinder.Benchmark(1);
+		pathfinder.Benchmark(100);
+		pathfinder.Benchmark(1000);
+
+		// Times keeping the shared field up to date while the player walks
+		pathfinder.BenchmarkTargetMoves(100);
+
+		// Times single raycasts against batched ones from the player
+		BenchmarkRaycasts(100000);
 	}
 }
 
@@ -154,62 +192,8 @@ void MapMatrix::Draw()
 		}
 	}
 
-	if (debugDraw)
-	{
-		// Creates a square game object that's gonna be the drawing
-		GameObject debugSquare({ 0.0f, 0.0f }, 0.0f, { 2.0f, 2.0f }, 49, true, { 0.0f, 0.0f, 0.0f, 0.3f });
-		debugSquare.SetRender(true);
-		Texture* teleporterTexture = _TextureManager->AddTexture("Assets/Sprites/Highlight_Box.png");
-		GameObject playerHighlight(ConvertMapCoordsToWorldCoords(ConvertWorldCoordsToMapCoords(_GameObjectManager->GetPlayer()->GetPosition())), 0.0f, {2.0f, 2.0f}, 49, true, teleporterTexture, {1.0f, 1.0f, 1.0f, 0.5f});
-		_Window->DrawGameObject(&playerHighlight);
-
-		// Draws the map
-		for (int i = 0; i < mapMatrix.size(); i++)
-		{
-			for (int j = 0; j < mapMatrix[i].size(); j++)
-			{
-				// Boolean to track whether a square should be drawn on this tile
-				bool shouldDraw = false;
-
-				// Checks for the player
-				switch (mapMatrix[i][j].tileStatus)
-				{
-					// Does nothing because the spot is empty
-				case TileStatus::Empty:
-					break;
-					// Uses green for the player
-				case TileStatus::Player:
-					debugSquare.SetColor({ 0.0f, 1.0f, 0.0f, 0.5f });
-					shouldDraw = true;
-					break;
-					// Uses red for enemies
-				case TileStatus::Enemy:
-					debugSquare.SetColor({ 1.0f, 0.0f, 0.0f, 0.5f });
-					shouldDraw = true;
-					break;
-					// Uses light blue for destructibles
-				case TileStatus::Destructible:
-					debugSquare.SetColor({ 0.2f, 0.2f, 1.0f, 0.5f });
-					shouldDraw = true;
-					break;
-					// Uses light grey for walls
-				case TileStatus::Wall:
-					debugSquare.SetColor({ 0.6f, 0.6f, 0.6f, 0.5f });
-					shouldDraw = true;
-					break;
-				default:
-					break;
-				}
-
-				// Checks if the square should be drawn
-				if (shouldDraw)
-				{
-					debugSquare.SetPosition({ ConvertMapCoordToWorldCoord(i), ConvertMapCoordToWorldCoord(j) });
-					_Window->DrawGameObject(&debugSquare);
-				}
-			}
-		}
-	}
+	// Draws the debug view over the map
+	debugOverlay.Draw();
 }
 
 /*************************************************************************************************/
@@ -222,6 +206,12 @@ void MapMatrix::Shutdown()
 {
 	// Clears the map
 	Clear();
+
+	// Frees the debug overlay's textures while the window is still around
+	debugOverlay.Free();
+
+	// Releases the map image
+	currentMap.Close();
 }
 
 /*************************************************************************************************/
@@ -239,6 +229,12 @@ void MapMatrix::Clear()
 		mapMatrix[i].clear();
 		mapMatrix[i].resize(mapMatrix.capacity(), { TileStatus::Empty, NULL });
 	}
+
+	// Empties the tile masks along with the grid
+	RebuildTileMasks();
+
+	// Anything tracking the map has to start over
+	ResetTileChangeJournal();
 }
 
 /*************************************************************************************************/
@@ -264,8 +260,23 @@ void MapMatrix::SetTile(int xCoord, int yCoord, TileStatus newStatus, GameObject
 	// Checks if the coordinates are valid
 	if (ValidateCoordinates(xCoord, yCoord))
 	{
+		// Records status changes for anything tracking the map
+		TileStatus oldStatus = mapMatrix[xCoord][yCoord].tileStatus;
+		if (oldStatus != newStatus && !journalSuspended)
+		{
+			// Subscribers that let the journal grow this far rebuild instead of holding on to everything
+			if (tileChangeJournal.size() >= maxJournalLength)
+			{
+				ResetTileChangeJournal();
+			}
+			tileChangeJournal.push_back({ { xCoord, yCoord }, oldStatus, newStatus });
+		}
+
 		// Updates the relevant tile
 		mapMatrix[xCoord][yCoord] = { newStatus, gameObject };
+
+		// Keeps the tile masks in step
+		UpdateTileMasks(xCoord, yCoord, newStatus);
 	}
 }
 
@@ -292,6 +303,9 @@ bool MapMatrix::SetPlayerPosition(int xCoord, int yCoord)
 		// Sets the new player position
 		playerPos = { xCoord, yCoord };
 
+		// Points the flow field at the player's new tile
+		pathfinder.SetFlowFieldTarget(playerPos);
+
 		// Returns that the player position was set
 		return true;
 	}
@@ -504,90 +518,594 @@ std::pair<int, int> MapMatrix::CalculateOffsetTile(int xCoord, int yCoord, bool
 /*************************************************************************************************/
 /*!
 	\brief
-		Reads in a map from the given file
+		Sweeps a box through the map and finds the first solid tile it runs into. Walks the tile
+		boundaries the leading edges cross in order, so fast moving boxes can't skip over tiles.
+		Tiles the box already overlaps at the start are ignored so a box resting against a wall
+		can still move away from it
 
-	\param filename
-		The file to build the map from
+	\param box
+		The box to sweep in world coordinates
 
-	\param specialTileList
-		The list of all nonstandard tiles that need filling
+	\param delta
+		The movement of the box in world coordinates
 
-	\param clear
-		Whether the map should be cleared before overwriting (defaults to true, only set false if refreshing map)
+	\param isSolid
+		Decides which tile statuses block the box. Defaults to everything the player can't walk through
+
+	\return
+		The time of impact, hit normal and the tile that was hit
 */
 /*************************************************************************************************/
-void MapMatrix::ReadMapFromFile(std::string filename, std::vector< std::pair< char, std::pair< int, int > > >& specialTileList, bool clear)
+MapMatrix::SweepResult MapMatrix::SweepBox(const CollisionBox& box, glm::vec2 delta, SolidityPredicate isSolid)
 {
-	// Opens the file
-	currentMapFilename = filename;
-	std::ifstream fileInput(filename);
-	if (fileInput)
+	// Starts off assuming the whole movement is clear
+	SweepResult result = { false, 1.0f, { 0.0f, 0.0f }, TileStatus::Empty, { -1, -1 } };
+
+	// Converts everything to tile space where tile n covers [n, n + 1) (see ConvertWorldCoordToMapCoord)
+	float boxMin[2] = { (box.min.x + 1.0f) * 0.5f, (box.min.y + 1.0f) * 0.5f };
+	float boxMax[2] = { (box.max.x + 1.0f) * 0.5f, (box.max.y + 1.0f) * 0.5f };
+	float movement[2] = { delta.x * 0.5f, delta.y * 0.5f };
+
+	// Sets up the walk along each axis
+	int step[2];					// Which way the leading edge moves
+	int nextSlab[2];				// The next row or column of tiles the leading edge will enter
+	float nextTime[2];				// When the leading edge enters that row or column
+	float timeDelta[2];				// How long it takes the leading edge to cross a whole tile
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (movement[axis] > 0.0f)
+		{
+			// The first boundary is the one at or past the leading edge, so touching a tile counts as entering it
+			float boundary = std::ceil(boxMax[axis]);
+			step[axis] = 1;
+			nextSlab[axis] = (int)boundary;
+			nextTime[axis] = (boundary - boxMax[axis]) / movement[axis];
+			timeDelta[axis] = 1.0f / movement[axis];
+		}
+		else if (movement[axis] < 0.0f)
+		{
+			float boundary = std::floor(boxMin[axis]);
+			step[axis] = -1;
+			nextSlab[axis] = (int)boundary - 1;
+			nextTime[axis] = (boundary - boxMin[axis]) / movement[axis];
+			timeDelta[axis] = -1.0f / movement[axis];
+		}
+		else
+		{
+			// Not moving on this axis so it never crosses anything
+			step[axis] = 0;
+			nextSlab[axis] = 0;
+			nextTime[axis] = std::numeric_limits<float>::infinity();
+			timeDelta[axis] = 0.0f;
+		}
+	}
+
+	// Visits the boundaries in the order they are crossed
+	while (true)
 	{
-		// Reads in the file
-		char bufferInput[bufferSize] = { 0 };
-		int mapWidth;
-		int mapHeight;
+		// Picks whichever axis crosses a boundary first and stops once the movement is used up
+		int axis = nextTime[0] <= nextTime[1] ? 0 : 1;
+		float time = nextTime[axis];
+		if (time > 1.0f)
+		{
+			break;
+		}
 
-		// Reads in the width and height of the map, then moves to the next line
-		fileInput >> mapWidth;
-		fileInput.getline(bufferInput, bufferSize, ',');
-		fileInput >> mapHeight;
-		fileInput.getline(bufferInput, bufferSize);
+		// Works out which tiles along the other axis the box covers at the moment it crosses
+		int otherAxis = 1 - axis;
+		int firstTile = (int)std::floor(boxMin[otherAxis] + movement[otherAxis] * time);
+		int lastTile = (int)std::ceil(boxMax[otherAxis] + movement[otherAxis] * time) - 1;
 
-		// Checks that we are clearing the map
-		if (clear)
+		// With the default predicate the tile masks can rule out the whole row or column at once
+		if (isSolid == IsSolid && !(axis == 0 ? AnyTileInRect(TileMask::Solid, nextSlab[0], firstTile, nextSlab[0], lastTile) :
+			AnyTileInRow(TileMask::Solid, nextSlab[1], firstTile, lastTile)))
 		{
-			// Sets the size of the map matrix
-			mapMatrix.clear();
-			for (size_t i = 0; i < mapWidth; i++)
-			{
-				// Makes the columns height tall
-				std::vector<MapTile> column;
-				column.resize(mapHeight, { TileStatus::Empty, NULL });
-				mapMatrix.push_back(column);
-			}
+			nextSlab[axis] += step[axis];
+			nextTime[axis] += timeDelta[axis];
+			continue;
 		}
 
-		// Fills in the map
-		for (int i = mapHeight - 1; i >= 0; i--)
+		// Checks every tile in the row or column being entered
+		for (int i = firstTile; i <= lastTile; i++)
 		{
-			fileInput.getline(bufferInput, bufferSize);
+			std::pair<int, int> coords = axis == 0 ? std::make_pair(nextSlab[0], i) : std::make_pair(i, nextSlab[1]);
+			TileStatus tileStatus = GetTile(coords).tileStatus;
 
-			for (int j = 0; j < mapWidth; j++)
+			// Stops at the first solid tile
+			if (isSolid(tileStatus))
 			{
-				// Checks what the next character is, and populates generic tiles (walls, coins, etc.)
-				char newChar = bufferInput[j * 2];
-				// Sets the walls
-				if (newChar == 'w')
-				{
-					SetTile(j, i, TileStatus::Wall);
-				}
-				// Sets the player starting location
-				else if (newChar == 'p')
-				{
-					SetPlayerPosition(j, i);
-					playerStartingPos = playerPos;
-					SetTile(j, i, MapMatrix::TileStatus::Player);
-				}
-				else if (newChar != '0' && newChar != '/')
-				{
-					// If the space isn't empty or something simple, notes it so the scene can populate these objects
-					specialTileList.push_back({ bufferInput[j * 2], {j, i} });
-				}
+				result.hit = true;
+				result.time = time;
+				result.normal = axis == 0 ? glm::vec2(-(float)step[0], 0.0f) : glm::vec2(0.0f, -(float)step[1]);
+				result.tileStatus = tileStatus;
+				result.tile = coords;
+				return result;
 			}
 		}
+
+		// Moves on to the next row or column
+		nextSlab[axis] += step[axis];
+		nextTime[axis] += timeDelta[axis];
 	}
-	// If the file didn't read, throw an error
-	else
+
+	return result;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Casts a ray through the map and finds the first tile set in the given mask. Steps
+		through the tiles the ray crosses one boundary at a time (grid DDA) reading the mask bits
+		directly. The tile the ray starts in is ignored so enemies can see out of their own tile
+
+	\param origin
+		Where the ray starts in world coordinates
+
+	\param direction
+		The direction of the ray. Doesn't need to be normalized
+
+	\param maxDistance
+		How far the ray goes in world units
+
+	\param mask
+		The tiles that stop the ray. Defaults to solid tiles, where leaving the map counts as a hit
+
+	\return
+		Where the ray stopped and what it hit
+*/
+/*************************************************************************************************/
+MapMatrix::RaycastResult MapMatrix::Raycast(glm::vec2 origin, glm::vec2 direction, float maxDistance, TileMask mask)
+{
+	RaycastResult result;
+	CastRay(PrepareRayOrigin(origin, mask), direction, maxDistance, result);
+	return result;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Casts many rays from the same origin at once. The origin and mask lookups are only done
+		once for the whole batch
+
+	\param origin
+		Where the rays start in world coordinates
+
+	\param directions
+		The direction of each ray. Don't need to be normalized
+
+	\param rayCount
+		The number of rays to cast
+
+	\param maxDistance
+		How far each ray goes in world units
+
+	\param results
+		Filled with a result for each ray. Must have room for rayCount results
+
+	\param mask
+		The tiles that stop the rays. Defaults to solid tiles
+*/
+/*************************************************************************************************/
+void MapMatrix::RaycastBatch(glm::vec2 origin, const glm::vec2* directions, int rayCount, float maxDistance, RaycastResult* results, TileMask mask)
+{
+	RayOrigin rayOrigin = PrepareRayOrigin(origin, mask);
+	for (int i = 0; i < rayCount; i++)
+	{
+		CastRay(rayOrigin, directions[i], maxDistance, results[i]);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks whether anything solid is between two points. The tile the check starts in is
+		ignored, the tile it ends in isn't
+
+	\param from
+		The point looking in world coordinates
+
+	\param to
+		The point being looked at in world coordinates
+
+	\return
+		Whether the line between the points is clear
+*/
+/*************************************************************************************************/
+bool MapMatrix::HasLineOfSight(glm::vec2 from, glm::vec2 to)
+{
+	glm::vec2 delta = to - from;
+	float distance = glm::length(delta);
+
+	// A point can always see itself
+	if (distance <= 0.0f)
 	{
-		throw std::runtime_error("Failed to read in scene map");
+		return true;
 	}
+
+	return !Raycast(from, delta, distance).hit;
 }
 
 /*************************************************************************************************/
 /*!
 	\brief
-		Reads in a map from the given file
+		Casts rays evenly all the way around a point and collects where each one stopped,
+		giving the area that can be seen from it
+
+	\param origin
+		The point to see from in world coordinates
+
+	\param rayCount
+		The number of rays to cast. More rays give a smoother outline
+
+	\param maxDistance
+		How far can be seen in world units
+
+	\param polygon
+		Filled with where each ray stopped, in order counterclockwise from the positive x axis
+
+	\param mask
+		The tiles that block sight. Defaults to solid tiles
+*/
+/*************************************************************************************************/
+void MapMatrix::CastVisibilityPolygon(glm::vec2 origin, int rayCount, float maxDistance, std::vector<glm::vec2>& polygon, TileMask mask)
+{
+	polygon.clear();
+	if (rayCount <= 0)
+	{
+		return;
+	}
+
+	// The directions only change with the ray count, so callers asking for the same count every frame skip the trig
+	if ((int)visibilityDirections.size() != rayCount)
+	{
+		visibilityDirections.resize(rayCount);
+		for (int i = 0; i < rayCount; i++)
+		{
+			float angle = 2.0f * glm::pi<float>() * (float)i / (float)rayCount;
+			visibilityDirections[i] = { std::cos(angle), std::sin(angle) };
+		}
+		visibilityResults.resize(rayCount);
+	}
+
+	RaycastBatch(origin, visibilityDirections.data(), rayCount, maxDistance, visibilityResults.data(), mask);
+
+	polygon.resize(rayCount);
+	for (int i = 0; i < rayCount; i++)
+	{
+		polygon[i] = visibilityResults[i].point;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Times single raycasts against visibility polygon batches from the player and prints the
+		rays per second to the debug log
+
+	\param rayCount
+		The number of rays to cast each way
+*/
+/*************************************************************************************************/
+void MapMatrix::BenchmarkRaycasts(int rayCount)
+{
+	if (rayCount <= 0 || !_GameObjectManager->GetPlayer())
+	{
+		return;
+	}
+
+	// Long enough to cross the whole map from anywhere
+	glm::vec2 origin = _GameObjectManager->GetPlayer()->GetPosition();
+	float maxDistance = 2.0f * (float)(maskWidth + maskHeight);
+
+	// Points the single rays the same way every run so results are comparable
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> pickAngle(0.0f, 2.0f * glm::pi<float>());
+	std::vector<glm::vec2> directions(rayCount);
+	for (int i = 0; i < rayCount; i++)
+	{
+		float angle = pickAngle(random);
+		directions[i] = { std::cos(angle), std::sin(angle) };
+	}
+
+	// One ray at a time
+	float totalDistance = 0.0f;
+	auto singleStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < rayCount; i++)
+	{
+		totalDistance += Raycast(origin, directions[i], maxDistance).distance;
+	}
+	double singleTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - singleStart).count();
+
+	// The whole circle as one batch. Runs once first so building the direction table isn't timed
+	std::vector<glm::vec2> polygon;
+	CastVisibilityPolygon(origin, rayCount, maxDistance, polygon);
+	auto batchStart = std::chrono::steady_clock::now();
+	CastVisibilityPolygon(origin, rayCount, maxDistance, polygon);
+	double batchTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count();
+
+	_Debug->Print(Debug::MessageType::Debug, "MapMatrix: " + std::to_string(rayCount) + " rays (average length " + std::to_string(totalDistance / rayCount) +
+		"), single " + std::to_string((long long)(rayCount / std::max(singleTime, 1e-9))) + " rays/s, batch " +
+		std::to_string((long long)(rayCount / std::max(batchTime, 1e-9))) + " rays/s");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks a single tile against one of the tile masks. Out of bounds tiles count as solid,
+		matching GetTile returning a wall
+
+	\param mask
+		The mask to check
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+
+	\return
+		Whether the tile's bit is set
+*/
+/*************************************************************************************************/
+bool MapMatrix::TestTileMask(TileMask mask, int xCoord, int yCoord)
+{
+	// Treats anything outside the masks the same way GetTile does
+	if (xCoord < 0 || xCoord >= maskWidth || yCoord < 0 || yCoord >= maskHeight)
+	{
+		return mask == TileMask::Solid;
+	}
+
+	return (tileMasks[(int)mask][yCoord * maskWordsPerRow + (xCoord >> 6)] >> (xCoord & 63)) & 1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks if any tile in a span of a row is set in the given mask. Out of bounds tiles count
+		as solid
+
+	\param mask
+		The mask to check
+
+	\param yCoord
+		The row to check
+
+	\param minX
+		The first column of the span
+
+	\param maxX
+		The last column of the span (inclusive)
+
+	\return
+		Whether any tile in the span is set
+*/
+/*************************************************************************************************/
+bool MapMatrix::AnyTileInRow(TileMask mask, int yCoord, int minX, int maxX)
+{
+	// Empty spans never hit anything
+	if (minX > maxX)
+	{
+		return false;
+	}
+
+	// Spans that leave the map hit the out of bounds walls
+	if (yCoord < 0 || yCoord >= maskHeight || minX < 0 || maxX >= maskWidth)
+	{
+		if (mask == TileMask::Solid)
+		{
+			return true;
+		}
+
+		// Other masks just clip the span to the map
+		if (yCoord < 0 || yCoord >= maskHeight)
+		{
+			return false;
+		}
+		minX = std::max(minX, 0);
+		maxX = std::min(maxX, maskWidth - 1);
+		if (minX > maxX)
+		{
+			return false;
+		}
+	}
+
+	// Ors together the words the span covers, trimming the bits outside the span off the end words
+	const uint64_t* row = tileMasks[(int)mask].data() + yCoord * maskWordsPerRow;
+	int firstWord = minX >> 6;
+	int lastWord = maxX >> 6;
+	uint64_t firstWordMask = ~0ULL << (minX & 63);
+	uint64_t lastWordMask = ~0ULL >> (63 - (maxX & 63));
+
+	// Maps are rarely more than a couple of words wide, so the common case is a single word
+	if (firstWord == lastWord)
+	{
+		return (row[firstWord] & firstWordMask & lastWordMask) != 0;
+	}
+
+	uint64_t bits = (row[firstWord] & firstWordMask) | (row[lastWord] & lastWordMask);
+	for (int i = firstWord + 1; i < lastWord; i++)
+	{
+		bits |= row[i];
+	}
+	return bits != 0;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Checks if any tile in a rectangle is set in the given mask. Out of bounds tiles count as
+		solid
+
+	\param mask
+		The mask to check
+
+	\param minX
+		The left column of the rectangle
+
+	\param minY
+		The bottom row of the rectangle
+
+	\param maxX
+		The right column of the rectangle (inclusive)
+
+	\param maxY
+		The top row of the rectangle (inclusive)
+
+	\return
+		Whether any tile in the rectangle is set
+*/
+/*************************************************************************************************/
+bool MapMatrix::AnyTileInRect(TileMask mask, int minX, int minY, int maxX, int maxY)
+{
+	// Checks each row of the rectangle
+	for (int j = minY; j <= maxY; j++)
+	{
+		if (AnyTileInRow(mask, j, minX, maxX))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Subscribes to the tile change journal. Every tile status change made after this point is
+		kept until the subscriber has read it
+
+	\return
+		The id to read changes with
+*/
+/*************************************************************************************************/
+int MapMatrix::SubscribeToTileChanges()
+{
+	// The new subscriber starts at the end of the journal and has nothing to catch up on
+	TileChangeSubscriber newSubscriber = { journalStart + tileChangeJournal.size(), true, false };
+
+	// Reuses a free slot if there is one
+	for (int i = 0; i < (int)tileChangeSubscribers.size(); i++)
+	{
+		if (!tileChangeSubscribers[i].active)
+		{
+			tileChangeSubscribers[i] = newSubscriber;
+			return i;
+		}
+	}
+
+	tileChangeSubscribers.push_back(newSubscriber);
+	return (int)tileChangeSubscribers.size() - 1;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Stops a subscriber from holding on to journal entries
+
+	\param subscriber
+		The id returned when subscribing
+*/
+/*************************************************************************************************/
+void MapMatrix::UnsubscribeFromTileChanges(int subscriber)
+{
+	if (subscriber >= 0 && subscriber < (int)tileChangeSubscribers.size())
+	{
+		tileChangeSubscribers[subscriber].active = false;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns every tile change the subscriber hasn't read yet and marks them as read. The
+		changes stay valid until the next call that modifies the map
+
+	\param subscriber
+		The id returned when subscribing
+
+	\param changes
+		Set to the first unread change
+
+	\param changeCount
+		Set to the number of unread changes
+
+	\return
+		False if changes were missed because the whole map was replaced or the subscriber fell
+		too far behind. The subscriber should rebuild from the full map instead
+*/
+/*************************************************************************************************/
+bool MapMatrix::ReadTileChanges(int subscriber, const TileChange*& changes, int& changeCount)
+{
+	changes = tileChangeJournal.data();
+	changeCount = 0;
+
+	// Unknown subscribers can't know what they missed
+	if (subscriber < 0 || subscriber >= (int)tileChangeSubscribers.size() || !tileChangeSubscribers[subscriber].active)
+	{
+		return false;
+	}
+
+	// Hands out everything past the subscriber's cursor, then moves the cursor to the end
+	TileChangeSubscriber& reader = tileChangeSubscribers[subscriber];
+	uint64_t journalEnd = journalStart + tileChangeJournal.size();
+	changes = tileChangeJournal.data() + (size_t)(reader.cursor - journalStart);
+	changeCount = (int)(journalEnd - reader.cursor);
+	reader.cursor = journalEnd;
+
+	// Clears the missed flag now that the subscriber has been told. The full map already includes any changes since
+	if (reader.missedChanges)
+	{
+		reader.missedChanges = false;
+		changeCount = 0;
+		return false;
+	}
+
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Reads in a map from the given file. Cooked maps (.cmap) are memory mapped, csv maps are
+		cooked in memory. If the file is already open its image is reused without any file i/o
+
+	\param filename
+		The file to build the map from
+
+	\param specialTileList
+		The list of all nonstandard tiles that need filling
+
+	\param clear
+		Whether the map should be cleared before overwriting (defaults to true, only set false if refreshing map)
+*/
+/*************************************************************************************************/
+void MapMatrix::ReadMapFromFile(std::string filename, std::vector< std::pair< char, std::pair< int, int > > >& specialTileList, bool clear)
+{
+	// Only opens the file if it isn't the map that's already loaded
+	if (!currentMap.IsOpen() || currentMap.GetFilename() != filename)
+	{
+		// If the file didn't open or failed validation, throw an error
+		if (!currentMap.Open(filename))
+		{
+			throw std::runtime_error("Failed to read in scene map: " + currentMap.GetError());
+		}
+
+		// Notes maps that are still being cooked at load time
+		if (filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0)
+		{
+			_Debug->Print(Debug::MessageType::Debug, "MapMatrix: " + filename + " isn't cooked, run MapCooker on it");
+		}
+	}
+
+	// Builds the map from the image
+	LoadFromCookedMap(specialTileList, clear);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Rebuilds the map from the image that is already loaded. Doesn't touch the disk
 
 	\param specialTileList
 		The list of all nonstandard tiles that need filling
@@ -598,8 +1116,14 @@ void MapMatrix::ReadMapFromFile(std::string filename, std::vector< std::pair< ch
 /*************************************************************************************************/
 void MapMatrix::ReloadMap(std::vector< std::pair< char, std::pair< int, int > > >& specialTileList, bool clear)
 {
-	// Loads the map using the saved filename
-	ReadMapFromFile(currentMapFilename, specialTileList, clear);
+	// Checks that there is a map to reload
+	if (!currentMap.IsOpen())
+	{
+		throw std::runtime_error("Failed to reload scene map: no map is loaded");
+	}
+
+	// Rebuilds the map using the loaded image
+	LoadFromCookedMap(specialTileList, clear);
 }
 
 /*************************************************************************************************/
@@ -686,3 +1210,329 @@ bool MapMatrix::ValidateCoordinates(int xCoord, int yCoord)
 //-------------------------------------------------------------------------------------------------
 // Private Function Definitions
 //-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Fills in the map from the current cooked map image
+
+	\param specialTileList
+		The list of all nonstandard tiles that need filling
+
+	\param clear
+		Whether the map should be resized and cleared before filling
+*/
+/*************************************************************************************************/
+void MapMatrix::LoadFromCookedMap(std::vector< std::pair< char, std::pair< int, int > > >& specialTileList, bool clear)
+{
+	int mapWidth = currentMap.GetWidth();
+	int mapHeight = currentMap.GetHeight();
+
+	// Checks that we are clearing the map
+	if (clear)
+	{
+		// Sets the size of the map matrix
+		mapMatrix.assign(mapWidth, std::vector<MapTile>(mapHeight, { TileStatus::Empty, NULL }));
+		RebuildTileMasks();
+	}
+
+	// Subscribers rebuild from the whole map afterwards, so the individual tiles aren't journaled
+	journalSuspended = true;
+
+	// Fills in the generic tiles. The image was validated when it was opened so no checks are needed here
+	const uint8_t* tiles = currentMap.GetTiles();
+	for (int i = 0; i < mapWidth; i++)
+	{
+		for (int j = 0; j < mapHeight; j++)
+		{
+			TileStatus tileStatus = (TileStatus)tiles[i * mapHeight + j];
+			if (tileStatus != TileStatus::Empty)
+			{
+				SetTile(i, j, tileStatus);
+			}
+		}
+	}
+	journalSuspended = false;
+	ResetTileChangeJournal();
+
+	// Sets the player starting location
+	std::pair<int, int> playerStart = currentMap.GetPlayerStart();
+	if (playerStart.first >= 0)
+	{
+		SetPlayerPosition(playerStart);
+		playerStartingPos = playerPos;
+	}
+
+	// Copies out the special tiles so the scene can populate these objects
+	const CookedMap::SpecialTile* specialTiles = currentMap.GetSpecialTiles();
+	int specialTileCount = currentMap.GetSpecialTileCount();
+	specialTileList.reserve(specialTileList.size() + specialTileCount);
+	for (int i = 0; i < specialTileCount; i++)
+	{
+		specialTileList.push_back({ specialTiles[i].tileChar, { specialTiles[i].xCoord, specialTiles[i].yCoord } });
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Resizes the tile masks to the current map size and refills them from the map grid
+*/
+/*************************************************************************************************/
+void MapMatrix::RebuildTileMasks()
+{
+	// Sizes the masks to the grid. Columns are all the same height
+	maskWidth = (int)mapMatrix.size();
+	maskHeight = mapMatrix.empty() ? 0 : (int)mapMatrix[0].size();
+	maskWordsPerRow = (maskWidth + 63) >> 6;
+	for (int i = 0; i < (int)TileMask::Max; i++)
+	{
+		tileMasks[i].assign((size_t)maskWordsPerRow * maskHeight, 0);
+	}
+
+	// The pathfinder's grids follow the map size
+	pathfinder.Resize(maskWidth, maskHeight);
+
+	// Fills in the bits for anything already on the grid
+	for (int i = 0; i < maskWidth; i++)
+	{
+		for (int j = 0; j < maskHeight; j++)
+		{
+			if (mapMatrix[i][j].tileStatus != TileStatus::Empty)
+			{
+				UpdateTileMasks(i, j, mapMatrix[i][j].tileStatus);
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Updates every tile mask bit for a single tile
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+
+	\param tileStatus
+		The new status of the tile
+*/
+/*************************************************************************************************/
+void MapMatrix::UpdateTileMasks(int xCoord, int yCoord, TileStatus tileStatus)
+{
+	// Ignores tiles outside the masks
+	if (xCoord < 0 || xCoord >= maskWidth || yCoord < 0 || yCoord >= maskHeight)
+	{
+		return;
+	}
+
+	// Works out which masks the tile belongs in
+	bool inMask[(int)TileMask::Max];
+	inMask[(int)TileMask::Solid] = IsSolid(tileStatus);
+	inMask[(int)TileMask::Collectible] = tileStatus == TileStatus::Key || tileStatus == TileStatus::Coin || tileStatus == TileStatus::BigCoin;
+	inMask[(int)TileMask::Sticker] = IsSticker(tileStatus);
+	inMask[(int)TileMask::Hazard] = tileStatus == TileStatus::Enemy;
+
+	// Sets or clears the tile's bit in each mask
+	size_t word = (size_t)yCoord * maskWordsPerRow + (xCoord >> 6);
+	uint64_t bit = 1ULL << (xCoord & 63);
+	for (int i = 0; i < (int)TileMask::Max; i++)
+	{
+		tileMasks[i][word] = inMask[i] ? (tileMasks[i][word] | bit) : (tileMasks[i][word] & ~bit);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Empties the tile change journal and tells every subscriber it missed changes. Used when
+		the whole map is replaced
+*/
+/*************************************************************************************************/
+void MapMatrix::ResetTileChangeJournal()
+{
+	// Moves the start past everything that was in the journal so old cursors can't read new entries
+	journalStart += tileChangeJournal.size();
+	tileChangeJournal.clear();
+
+	// Flags every subscriber and brings it up to date
+	for (TileChangeSubscriber& subscriber : tileChangeSubscribers)
+	{
+		if (subscriber.active)
+		{
+			subscriber.cursor = journalStart;
+			subscriber.missedChanges = true;
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Drops the journal entries every subscriber has already read
+*/
+/*************************************************************************************************/
+void MapMatrix::TrimTileChangeJournal()
+{
+	// Finds the oldest change someone still needs
+	uint64_t journalEnd = journalStart + tileChangeJournal.size();
+	uint64_t oldestCursor = journalEnd;
+	for (const TileChangeSubscriber& subscriber : tileChangeSubscribers)
+	{
+		if (subscriber.active)
+		{
+			oldestCursor = std::min(oldestCursor, subscriber.cursor);
+		}
+	}
+
+	// Erases everything before it
+	if (oldestCursor > journalStart)
+	{
+		tileChangeJournal.erase(tileChangeJournal.begin(), tileChangeJournal.begin() + (size_t)(oldestCursor - journalStart));
+		journalStart = oldestCursor;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Works out everything about a ray's starting point that doesn't depend on its direction
+
+	\param origin
+		Where the ray starts in world coordinates
+
+	\param mask
+		The tiles that stop the ray
+
+	\return
+		The prepared origin
+*/
+/*************************************************************************************************/
+MapMatrix::RayOrigin MapMatrix::PrepareRayOrigin(glm::vec2 origin, TileMask mask)
+{
+	RayOrigin rayOrigin;
+	rayOrigin.world = origin;
+
+	// Converts to tile space where tile n covers [n, n + 1) (see ConvertWorldCoordToMapCoord)
+	rayOrigin.position[0] = (origin.x + 1.0f) * 0.5f;
+	rayOrigin.position[1] = (origin.y + 1.0f) * 0.5f;
+	rayOrigin.tile[0] = (int)std::floor(rayOrigin.position[0]);
+	rayOrigin.tile[1] = (int)std::floor(rayOrigin.position[1]);
+
+	// Only solid matches GetTile treating the outside of the map as a wall
+	rayOrigin.maskBits = tileMasks[(int)mask].data();
+	rayOrigin.outOfBoundsHits = mask == TileMask::Solid;
+	return rayOrigin;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Walks a single ray through the map with grid DDA
+
+	\param origin
+		The prepared starting point of the ray
+
+	\param direction
+		The direction of the ray. Doesn't need to be normalized
+
+	\param maxDistance
+		How far the ray goes in world units
+
+	\param result
+		Filled with where the ray stopped and what it hit
+*/
+/*************************************************************************************************/
+void MapMatrix::CastRay(const RayOrigin& origin, glm::vec2 direction, float maxDistance, RaycastResult& result)
+{
+	result = { false, maxDistance, origin.world, { 0.0f, 0.0f }, TileStatus::Empty, { -1, -1 } };
+
+	// Rays without a direction don't go anywhere
+	float length = glm::length(direction);
+	if (length <= 0.0f)
+	{
+		result.distance = 0.0f;
+		return;
+	}
+	direction /= length;
+	result.point = origin.world + direction * maxDistance;
+
+	// Tiles are two world units wide, so everything in tile space is half as far
+	float maxTime = maxDistance * 0.5f;
+	float rayDirection[2] = { direction.x, direction.y };
+
+	// Sets up the walk along each axis
+	int tile[2] = { origin.tile[0], origin.tile[1] };
+	int step[2];					// Which way the ray moves through the tiles
+	float nextTime[2];				// How far along the ray the next boundary is
+	float timeDelta[2];				// How far along the ray it takes to cross a whole tile
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (rayDirection[axis] > 0.0f)
+		{
+			step[axis] = 1;
+			nextTime[axis] = ((float)(tile[axis] + 1) - origin.position[axis]) / rayDirection[axis];
+			timeDelta[axis] = 1.0f / rayDirection[axis];
+		}
+		else if (rayDirection[axis] < 0.0f)
+		{
+			step[axis] = -1;
+			nextTime[axis] = (origin.position[axis] - (float)tile[axis]) / -rayDirection[axis];
+			timeDelta[axis] = -1.0f / rayDirection[axis];
+		}
+		else
+		{
+			// Not moving on this axis so it never crosses anything
+			step[axis] = 0;
+			nextTime[axis] = std::numeric_limits<float>::infinity();
+			timeDelta[axis] = 0.0f;
+		}
+	}
+
+	// Visits the tiles in the order the ray enters them
+	while (true)
+	{
+		int axis = nextTime[0] <= nextTime[1] ? 0 : 1;
+		float time = nextTime[axis];
+		if (time > maxTime)
+		{
+			return;
+		}
+		tile[axis] += step[axis];
+		nextTime[axis] += timeDelta[axis];
+
+		bool blocked;
+		if (tile[0] < 0 || tile[0] >= maskWidth || tile[1] < 0 || tile[1] >= maskHeight)
+		{
+			// Nothing out there can stop the ray once it's heading away from the map
+			if (!origin.outOfBoundsHits)
+			{
+				if ((tile[axis] < 0 && step[axis] < 0) || (tile[axis] >= (axis == 0 ? maskWidth : maskHeight) && step[axis] > 0))
+				{
+					return;
+				}
+				continue;
+			}
+			blocked = true;
+		}
+		else
+		{
+			blocked = (origin.maskBits[tile[1] * maskWordsPerRow + (tile[0] >> 6)] >> (tile[0] & 63)) & 1;
+		}
+
+		// Stops at the first blocked tile
+		if (blocked)
+		{
+			result.hit = true;
+			result.distance = time * 2.0f;
+			result.point = origin.world + direction * result.distance;
+			result.normal = axis == 0 ? glm::vec2(-(float)step[0], 0.0f) : glm::vec2(0.0f, -(float)step[1]);
+			result.tile = { tile[0], tile[1] };
+			result.tileStatus = GetTile(result.tile).tileStatus;
+			return;
+		}
+	}
+}
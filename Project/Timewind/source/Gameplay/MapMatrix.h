@@ -42,6 +42,15 @@ Copyright (c) 2023 Aiden Cvengros
 // Includes the game object class for the tile struct to not throw an error
 #include "../Game_Objects/GameObject.h"
 
+// The cooked map image maps are loaded from
+#include "CookedMap.h"
+
+// Navigation over the map
+#include "Pathfinder.h"
+
+// The debug view of the map
+#include "TileDebugOverlay.h"
+
 //-------------------------------------------------------------------------------------------------
 // Forward References
 //-------------------------------------------------------------------------------------------------
@@ -89,6 +98,16 @@ public:
 		Max
 	};
 
+	// The bit planes kept alongside the map grid. Each one has a bit per tile so area checks are a few mask operations
+	enum class TileMask
+	{
+		Solid,									// Tiles the player can't walk through
+		Collectible,							// Keys and coins
+		Sticker,								// Tiles holding a sticker the player can pick up
+		Hazard,									// Tiles that hurt the player
+		Max
+	};
+
 	//---------------------------------------------------------------------------------------------
 	// Public Structures
 	//---------------------------------------------------------------------------------------------
@@ -99,6 +118,45 @@ public:
 		GameObject* tileObject;
 	}MapTile;
 
+	// An axis aligned box in world coordinates used for sweep queries
+	typedef struct
+	{
+		glm::vec2 min;							// The bottom left corner of the box
+		glm::vec2 max;							// The top right corner of the box
+	}CollisionBox;
+
+	// The result of a sweep query
+	typedef struct
+	{
+		bool hit;								// Whether the box hit anything
+		float time;								// The fraction of the movement completed before the hit, 1 if nothing was hit
+		glm::vec2 normal;						// The normal of the face that was hit, zero if nothing was hit
+		TileStatus tileStatus;					// The status of the tile that was hit, Empty if nothing was hit
+		std::pair<int, int> tile;				// The coordinates of the tile that was hit, (-1, -1) if nothing was hit
+	}SweepResult;
+
+	// The result of a raycast
+	typedef struct
+	{
+		bool hit;								// Whether the ray hit anything
+		float distance;							// How far the ray went in world units, the max distance if nothing was hit
+		glm::vec2 point;						// Where the ray stopped in world coordinates
+		glm::vec2 normal;						// The normal of the face that was hit, zero if nothing was hit
+		TileStatus tileStatus;					// The status of the tile that was hit, Empty if nothing was hit
+		std::pair<int, int> tile;				// The coordinates of the tile that was hit, (-1, -1) if nothing was hit
+	}RaycastResult;
+
+	// Decides whether a tile status blocks movement in a sweep
+	typedef bool (*SolidityPredicate)(TileStatus tileStatus);
+
+	// An entry in the tile change journal
+	typedef struct
+	{
+		std::pair<int, int> tile;				// The coordinates of the tile that changed
+		TileStatus oldStatus;					// The status the tile had before the change
+		TileStatus newStatus;					// The status the tile has after the change
+	}TileChange;
+
 	//---------------------------------------------------------------------------------------------
 	// Public Variables
 	//---------------------------------------------------------------------------------------------
@@ -466,7 +524,280 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Reads in a map from the given file
+			Sweeps a box through the map and finds the first solid tile it runs into. Walks the tile
+			boundaries the leading edges cross in order, so fast moving boxes can't skip over tiles.
+			Tiles the box already overlaps at the start are ignored so a box resting against a wall
+			can still move away from it
+
+		\param box
+			The box to sweep in world coordinates
+
+		\param delta
+			The movement of the box in world coordinates
+
+		\param isSolid
+			Decides which tile statuses block the box. Defaults to everything the player can't walk through
+
+		\return
+			The time of impact, hit normal and the tile that was hit
+	*/
+	/*************************************************************************************************/
+	SweepResult SweepBox(const CollisionBox& box, glm::vec2 delta, SolidityPredicate isSolid = IsSolid);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			The default solidity predicate. Returns whether the player can't walk through the tile status
+
+		\param tileStatus
+			The given tile status
+
+		\return
+			Whether the tile status is solid
+	*/
+	/*************************************************************************************************/
+	static bool IsSolid(TileStatus tileStatus) { return tileStatus > TileStatus::Player; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Casts a ray through the map and finds the first tile set in the given mask. Steps
+			through the tiles the ray crosses one boundary at a time (grid DDA) reading the mask bits
+			directly. The tile the ray starts in is ignored so enemies can see out of their own tile
+
+		\param origin
+			Where the ray starts in world coordinates
+
+		\param direction
+			The direction of the ray. Doesn't need to be normalized
+
+		\param maxDistance
+			How far the ray goes in world units
+
+		\param mask
+			The tiles that stop the ray. Defaults to solid tiles, where leaving the map counts as a hit
+
+		\return
+			Where the ray stopped and what it hit
+	*/
+	/*************************************************************************************************/
+	RaycastResult Raycast(glm::vec2 origin, glm::vec2 direction, float maxDistance, TileMask mask = TileMask::Solid);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Casts many rays from the same origin at once. The origin and mask lookups are only done
+			once for the whole batch
+
+		\param origin
+			Where the rays start in world coordinates
+
+		\param directions
+			The direction of each ray. Don't need to be normalized
+
+		\param rayCount
+			The number of rays to cast
+
+		\param maxDistance
+			How far each ray goes in world units
+
+		\param results
+			Filled with a result for each ray. Must have room for rayCount results
+
+		\param mask
+			The tiles that stop the rays. Defaults to solid tiles
+	*/
+	/*************************************************************************************************/
+	void RaycastBatch(glm::vec2 origin, const glm::vec2* directions, int rayCount, float maxDistance, RaycastResult* results, TileMask mask = TileMask::Solid);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks whether anything solid is between two points. The tile the check starts in is
+			ignored, the tile it ends in isn't
+
+		\param from
+			The point looking in world coordinates
+
+		\param to
+			The point being looked at in world coordinates
+
+		\return
+			Whether the line between the points is clear
+	*/
+	/*************************************************************************************************/
+	bool HasLineOfSight(glm::vec2 from, glm::vec2 to);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Casts rays evenly all the way around a point and collects where each one stopped,
+			giving the area that can be seen from it
+
+		\param origin
+			The point to see from in world coordinates
+
+		\param rayCount
+			The number of rays to cast. More rays give a smoother outline
+
+		\param maxDistance
+			How far can be seen in world units
+
+		\param polygon
+			Filled with where each ray stopped, in order counterclockwise from the positive x axis
+
+		\param mask
+			The tiles that block sight. Defaults to solid tiles
+	*/
+	/*************************************************************************************************/
+	void CastVisibilityPolygon(glm::vec2 origin, int rayCount, float maxDistance, std::vector<glm::vec2>& polygon, TileMask mask = TileMask::Solid);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Times single raycasts against visibility polygon batches from the player and prints the
+			rays per second to the debug log
+
+		\param rayCount
+			The number of rays to cast each way
+	*/
+	/*************************************************************************************************/
+	void BenchmarkRaycasts(int rayCount);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks a single tile against one of the tile masks. Out of bounds tiles count as solid,
+			matching GetTile returning a wall
+
+		\param mask
+			The mask to check
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+
+		\return
+			Whether the tile's bit is set
+	*/
+	/*************************************************************************************************/
+	bool TestTileMask(TileMask mask, int xCoord, int yCoord);
+	bool TestTileMask(TileMask mask, std::pair<int, int> coords) { return TestTileMask(mask, coords.first, coords.second); }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks if any tile in a span of a row is set in the given mask. Out of bounds tiles count
+			as solid
+
+		\param mask
+			The mask to check
+
+		\param yCoord
+			The row to check
+
+		\param minX
+			The first column of the span
+
+		\param maxX
+			The last column of the span (inclusive)
+
+		\return
+			Whether any tile in the span is set
+	*/
+	/*************************************************************************************************/
+	bool AnyTileInRow(TileMask mask, int yCoord, int minX, int maxX);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Checks if any tile in a rectangle is set in the given mask. Out of bounds tiles count as
+			solid
+
+		\param mask
+			The mask to check
+
+		\param minX
+			The left column of the rectangle
+
+		\param minY
+			The bottom row of the rectangle
+
+		\param maxX
+			The right column of the rectangle (inclusive)
+
+		\param maxY
+			The top row of the rectangle (inclusive)
+
+		\return
+			Whether any tile in the rectangle is set
+	*/
+	/*************************************************************************************************/
+	bool AnyTileInRect(TileMask mask, int minX, int minY, int maxX, int maxY);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the map's pathfinder. Its flow field always leads to the player's tile
+
+		\return
+			The pathfinder
+	*/
+	/*************************************************************************************************/
+	Pathfinder& GetPathfinder() { return pathfinder; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Subscribes to the tile change journal. Every tile status change made after this point is
+			kept until the subscriber has read it
+
+		\return
+			The id to read changes with
+	*/
+	/*************************************************************************************************/
+	int SubscribeToTileChanges();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Stops a subscriber from holding on to journal entries
+
+		\param subscriber
+			The id returned when subscribing
+	*/
+	/*************************************************************************************************/
+	void UnsubscribeFromTileChanges(int subscriber);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns every tile change the subscriber hasn't read yet and marks them as read. The
+			changes stay valid until the next call that modifies the map
+
+		\param subscriber
+			The id returned when subscribing
+
+		\param changes
+			Set to the first unread change
+
+		\param changeCount
+			Set to the number of unread changes
+
+		\return
+			False if changes were missed because the whole map was replaced or the subscriber fell
+			too far behind. The subscriber should rebuild from the full map instead
+	*/
+	/*************************************************************************************************/
+	bool ReadTileChanges(int subscriber, const TileChange*& changes, int& changeCount);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Reads in a map from the given file. Cooked maps (.cmap) are memory mapped, csv maps are
+			cooked in memory. If the file is already open its image is reused without any file i/o
 
 		\param filename
 			The file to build the map from
@@ -483,10 +814,7 @@ public:
 	/*************************************************************************************************/
 	/*!
 		\brief
-			Reads in a map from the given file
-
-		\param filename
-			The file to build the map from
+			Rebuilds the map from the image that is already loaded. Doesn't touch the disk
 
 		\param specialTileList
 			The list of all nonstandard tiles that need filling
@@ -553,27 +881,153 @@ private:
 	// Private Structures
 	//---------------------------------------------------------------------------------------------
 
+	// A reader of the tile change journal
+	typedef struct
+	{
+		uint64_t cursor;						// The journal position of the next change to read
+		bool active;							// Whether the slot is in use
+		bool missedChanges;						// Whether changes were dropped since the last read
+	}TileChangeSubscriber;
+
+	// The parts of a raycast that only depend on where the ray starts, shared by every ray in a batch
+	typedef struct
+	{
+		glm::vec2 world;						// The origin in world coordinates
+		float position[2];						// The origin in tile space, where tile n covers [n, n + 1)
+		int tile[2];							// The tile the origin is in
+		const uint64_t* maskBits;				// The mask the rays test against
+		bool outOfBoundsHits;					// Whether leaving the map stops the rays
+	}RayOrigin;
+
 	//---------------------------------------------------------------------------------------------
 	// Private Variables
 	//---------------------------------------------------------------------------------------------
 
 	std::vector<std::vector<MapTile>> mapMatrix;	// The map grid
-	std::string currentMapFilename;					// The file name of the current map
+	CookedMap currentMap;							// The image of the current map, kept open so refreshes don't reload it
 
 	std::pair<int, int> playerPos;					// The position of the player
 	std::pair<int, int> playerStartingPos;			// The starting position of the player
 
-	bool debugDraw;									// Boolean denoting whether the debug view of the map matrix should be drawn
-
 	Texture* defaultWallTexture;					// The texture that will be drawn on walls if the wall doesn't have an associated game object
 	glm::vec4 defaultWallColor;						// The default color applied to the wall texture
 
 	float minX;										// The farthest left you can go
 	float minY;										// The farthest down you can go (y is inverted btw)
 
+	std::vector<uint64_t> tileMasks[(int)TileMask::Max];	// The tile bit planes, stored row by row
+	int maskWidth;									// The number of columns the tile masks cover
+	int maskHeight;									// The number of rows the tile masks cover
+	int maskWordsPerRow;							// The number of 64 bit words in each row of a tile mask
+
+	std::vector<TileChange> tileChangeJournal;		// Tile changes that haven't been read by every subscriber
+	uint64_t journalStart;							// The journal position of the first entry in the journal
+	std::vector<TileChangeSubscriber> tileChangeSubscribers;	// Everything reading the journal
+	bool journalSuspended;							// Whether changes are being skipped for a bulk load
+
+	Pathfinder pathfinder;							// Path queries and the flow field toward the player
+
+	TileDebugOverlay debugOverlay;					// The debug view of the map, cycled through with F1
+
+	std::vector<glm::vec2> visibilityDirections;	// The ray directions of the last visibility polygon, reused while the ray count stays the same
+	std::vector<RaycastResult> visibilityResults;	// Reused results for visibility polygons
+
 	//---------------------------------------------------------------------------------------------
 	// Private Function Declarations
 	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Fills in the map from the current cooked map image
+
+		\param specialTileList
+			The list of all nonstandard tiles that need filling
+
+		\param clear
+			Whether the map should be resized and cleared before filling
+	*/
+	/*************************************************************************************************/
+	void LoadFromCookedMap(std::vector< std::pair< char, std::pair< int, int > > >& specialTileList, bool clear);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Resizes the tile masks to the current map size and refills them from the map grid
+	*/
+	/*************************************************************************************************/
+	void RebuildTileMasks();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Updates every tile mask bit for a single tile
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+
+		\param tileStatus
+			The new status of the tile
+	*/
+	/*************************************************************************************************/
+	void UpdateTileMasks(int xCoord, int yCoord, TileStatus tileStatus);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Empties the tile change journal and tells every subscriber it missed changes. Used when
+			the whole map is replaced
+	*/
+	/*************************************************************************************************/
+	void ResetTileChangeJournal();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Drops the journal entries every subscriber has already read
+	*/
+	/*************************************************************************************************/
+	void TrimTileChangeJournal();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Works out everything about a ray's starting point that doesn't depend on its direction
+
+		\param origin
+			Where the ray starts in world coordinates
+
+		\param mask
+			The tiles that stop the ray
+
+		\return
+			The prepared origin
+	*/
+	/*************************************************************************************************/
+	RayOrigin PrepareRayOrigin(glm::vec2 origin, TileMask mask);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Walks a single ray through the map with grid DDA
+
+		\param origin
+			The prepared starting point of the ray
+
+		\param direction
+			The direction of the ray. Doesn't need to be normalized
+
+		\param maxDistance
+			How far the ray goes in world units
+
+		\param result
+			Filled with where the ray stopped and what it hit
+	*/
+	/*************************************************************************************************/
+	void CastRay(const RayOrigin& origin, glm::vec2 direction, float maxDistance, RaycastResult& result);
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -74,7 +74,7 @@ void QuitOption::Hovering()
 /*************************************************************************************************/
 void QuitOption::Selected()
 {
-	glfwSetWindowShouldClose(_Window->GetVulkanWindowPtr(), true);
+	_Window->Close();
 }
 
 //-------------------------------------------------------------------------------------------------
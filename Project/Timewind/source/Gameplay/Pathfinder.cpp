@@ -0,0 +1,721 @@
+/*************************************************************************************************/
+/*!
+\file Pathfinder.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Grid navigation for the map matrix. Handles one off A* path queries and a shared flow field
+	toward the player that any number of enemies can follow without searching themselves
+
+    Functions include:
+        + Pathfinder::Pathfinder
+		+ Pathfinder::~Pathfinder
+		+ Pathfinder::Resize
+		+ Pathfinder::MarkTileChanged
+		+ Pathfinder::SetFlowFieldTarget
+		+ Pathfinder::FindPath
+		+ Pathfinder::GetFlowDirection
+		+ Pathfinder::GetFlowDistance
+		+ Pathfinder::GetFlowFieldVersion
+		+ Pathfinder::Benchmark
+		+ Pathfinder::BenchmarkTargetMoves
+		+ Pathfinder::IsBlocked
+		+ Pathfinder::ApplyTileChanges
+		+ Pathfinder::RebuildFlowField
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "Pathfinder.h"
+#include "MapMatrix.h"
+#include "../Engine/cppShortcuts.h"
+
+// The open list for A*
+#include <queue>
+#include <functional>
+#include <algorithm>
+
+// Agent placement and timing for the benchmark
+#include <random>
+#include <chrono>
+#include <string>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// The four steps an enemy can take. Index 0 is reserved for "don't move"
+const int stepCount = 5;
+const int stepX[stepCount] = { 0, 1, -1, 0, 0 };
+const int stepY[stepCount] = { 0, 0, 0, 1, -1 };
+
+// The step that undoes each step, used when a tile is reached from a neighbor
+const uint8_t reverseStep[stepCount] = { 0, 2, 1, 4, 3 };
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns whether a tile status is a wall as far as navigation is concerned
+
+	\param tileStatus
+		The status to check
+
+	\return
+		Whether the status blocks movement
+*/
+/*************************************************************************************************/
+static bool BlocksNavigation(MapMatrix::TileStatus tileStatus);
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the pathfinder class
+
+	\param map_
+		The map the pathfinder navigates
+*/
+/*************************************************************************************************/
+Pathfinder::Pathfinder(MapMatrix* map_) : map(map_), width(0), height(0), flowTarget(-1, -1), flowFieldDirty(true), flowFieldVersion(0), currentSearch(0),
+	tileChangeSubscriber(-1)
+{
+
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the pathfinder class
+*/
+/*************************************************************************************************/
+Pathfinder::~Pathfinder()
+{
+	// Stops the map keeping changes around for us
+	map->UnsubscribeFromTileChanges(tileChangeSubscriber);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Resizes the pathfinder's grids to match the map. Called whenever the map is resized
+
+	\param width_
+		The width of the map in tiles
+
+	\param height_
+		The height of the map in tiles
+*/
+/*************************************************************************************************/
+void Pathfinder::Resize(int width_, int height_)
+{
+	width = width_;
+	height = height_;
+	size_t tileCount = (size_t)width * height;
+
+	// Resets the flow field so it gets rebuilt for the new map
+	flowDistance.assign(tileCount, unreachable);
+	flowDirection.assign(tileCount, 0);
+	flowFieldDirty = true;
+
+	// Resets the search grids
+	searchStamp.assign(tileCount, 0);
+	searchCost.assign(tileCount, 0);
+	searchParent.assign(tileCount, -1);
+	searchQueue.reserve(tileCount);
+	currentSearch = 0;
+
+	// Starts following the map's changes the first time it's sized. The map is fully built by then
+	if (tileChangeSubscriber < 0)
+	{
+		tileChangeSubscriber = map->SubscribeToTileChanges();
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Tells the pathfinder a tile changed whether it can be walked through. The flow field is
+		only rebuilt if the change could affect it
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+*/
+/*************************************************************************************************/
+void Pathfinder::MarkTileChanged(int xCoord, int yCoord)
+{
+	// Nothing to patch if the field is getting rebuilt anyway
+	if (flowFieldDirty || xCoord < 0 || xCoord >= width || yCoord < 0 || yCoord >= height)
+	{
+		return;
+	}
+
+	int index = xCoord * height + yCoord;
+
+	// A tile being blocked only matters if paths could run through it
+	if (IsBlocked(xCoord, yCoord))
+	{
+		if (flowDistance[index] != unreachable)
+		{
+			flowFieldDirty = true;
+		}
+		return;
+	}
+
+	// A tile opening up can only make things closer, so the new distances are spread out from it
+	// instead of redoing the whole field. Starts by connecting it to its closest neighbor
+	for (int i = 1; i < stepCount; i++)
+	{
+		int neighborX = xCoord + stepX[i];
+		int neighborY = yCoord + stepY[i];
+		if (neighborX < 0 || neighborX >= width || neighborY < 0 || neighborY >= height)
+		{
+			continue;
+		}
+
+		uint32_t neighborDistance = flowDistance[neighborX * height + neighborY];
+		if (neighborDistance != unreachable && neighborDistance + 1 < flowDistance[index])
+		{
+			flowDistance[index] = neighborDistance + 1;
+			flowDirection[index] = (uint8_t)i;
+		}
+	}
+
+	// If the tile is still cut off from the target there's nothing else to do
+	if (flowDistance[index] == unreachable)
+	{
+		return;
+	}
+
+	// Spreads the shorter distances out breadth first
+	flowFieldVersion++;
+	searchQueue.clear();
+	searchQueue.push_back(index);
+	for (size_t head = 0; head < searchQueue.size(); head++)
+	{
+		int current = searchQueue[head];
+		int currentX = current / height;
+		int currentY = current % height;
+
+		for (int i = 1; i < stepCount; i++)
+		{
+			int neighborX = currentX + stepX[i];
+			int neighborY = currentY + stepY[i];
+			if (neighborX < 0 || neighborX >= width || neighborY < 0 || neighborY >= height || IsBlocked(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			int neighbor = neighborX * height + neighborY;
+			if (flowDistance[current] + 1 < flowDistance[neighbor])
+			{
+				flowDistance[neighbor] = flowDistance[current] + 1;
+				flowDirection[neighbor] = reverseStep[i];
+				searchQueue.push_back(neighbor);
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Sets the tile the flow field leads to. Does nothing if the target hasn't changed. A new
+	target rebuilds the field on its next use, since moving it even one tile changes the
+	distance of nearly every tile
+
+	\param target
+		The new target tile
+*/
+/*************************************************************************************************/
+void Pathfinder::SetFlowFieldTarget(std::pair<int, int> target)
+{
+	if (target != flowTarget)
+	{
+		flowTarget = target;
+		flowFieldDirty = true;
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Finds the shortest path between two tiles with A*
+
+	\param start
+		The tile to start from
+
+	\param goal
+		The tile to reach
+
+	\param path
+		Filled with the tiles to step through, not including the start but including the goal
+
+	\return
+		Whether a path was found
+*/
+/*************************************************************************************************/
+bool Pathfinder::FindPath(std::pair<int, int> start, std::pair<int, int> goal, std::vector<std::pair<int, int>>& path)
+{
+	path.clear();
+
+	// Checks that both ends are on the map and the goal can be stood on
+	if (start.first < 0 || start.first >= width || start.second < 0 || start.second >= height ||
+		goal.first < 0 || goal.first >= width || goal.second < 0 || goal.second >= height || IsBlocked(goal.first, goal.second))
+	{
+		return false;
+	}
+
+	// Already there
+	if (start == goal)
+	{
+		return true;
+	}
+
+	// Starts a new search. The stamps only need clearing when the counter wraps
+	currentSearch++;
+	if (currentSearch == 0)
+	{
+		std::fill(searchStamp.begin(), searchStamp.end(), 0);
+		currentSearch = 1;
+	}
+
+	int startIndex = start.first * height + start.second;
+	int goalIndex = goal.first * height + goal.second;
+
+	// The open list is ordered by estimated total cost. Manhattan distance is exact on an empty four way grid
+	typedef std::pair<int, int> OpenEntry;
+	std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openList;
+	searchStamp[startIndex] = currentSearch;
+	searchCost[startIndex] = 0;
+	searchParent[startIndex] = -1;
+	openList.push({ std::abs(start.first - goal.first) + std::abs(start.second - goal.second), startIndex });
+
+	bool found = false;
+	while (!openList.empty())
+	{
+		OpenEntry entry = openList.top();
+		openList.pop();
+
+		int current = entry.second;
+		int currentX = current / height;
+		int currentY = current % height;
+
+		// Skips entries that were superseded by a cheaper route
+		int heuristic = std::abs(currentX - goal.first) + std::abs(currentY - goal.second);
+		if (entry.first > searchCost[current] + heuristic)
+		{
+			continue;
+		}
+
+		if (current == goalIndex)
+		{
+			found = true;
+			break;
+		}
+
+		// Expands the neighbors
+		for (int i = 1; i < stepCount; i++)
+		{
+			int neighborX = currentX + stepX[i];
+			int neighborY = currentY + stepY[i];
+			if (neighborX < 0 || neighborX >= width || neighborY < 0 || neighborY >= height || IsBlocked(neighborX, neighborY))
+			{
+				continue;
+			}
+
+			int neighbor = neighborX * height + neighborY;
+			int newCost = searchCost[current] + 1;
+			if (searchStamp[neighbor] != currentSearch || newCost < searchCost[neighbor])
+			{
+				searchStamp[neighbor] = currentSearch;
+				searchCost[neighbor] = newCost;
+				searchParent[neighbor] = current;
+				openList.push({ newCost + std::abs(neighborX - goal.first) + std::abs(neighborY - goal.second), neighbor });
+			}
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	// Walks back from the goal to build the path
+	for (int current = goalIndex; current != startIndex; current = searchParent[current])
+	{
+		path.push_back({ current / height, current % height });
+	}
+	std::reverse(path.begin(), path.end());
+	return true;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns the step to take from a tile to follow the flow field toward its target.
+		Rebuilds the field first if anything changed since the last query
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+
+	\return
+		The step to take, (0, 0) if the tile is the target or can't reach it
+*/
+/*************************************************************************************************/
+std::pair<int, int> Pathfinder::GetFlowDirection(int xCoord, int yCoord)
+{
+	ApplyTileChanges();
+	if (flowFieldDirty)
+	{
+		RebuildFlowField();
+	}
+
+	if (xCoord < 0 || xCoord >= width || yCoord < 0 || yCoord >= height)
+	{
+		return { 0, 0 };
+	}
+
+	uint8_t step = flowDirection[xCoord * height + yCoord];
+	return { stepX[step], stepY[step] };
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns how many steps a tile is from the flow field's target
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+
+	\return
+		The number of steps, or unreachable
+*/
+/*************************************************************************************************/
+uint32_t Pathfinder::GetFlowDistance(int xCoord, int yCoord)
+{
+	ApplyTileChanges();
+	if (flowFieldDirty)
+	{
+		RebuildFlowField();
+	}
+
+	if (xCoord < 0 || xCoord >= width || yCoord < 0 || yCoord >= height)
+	{
+		return unreachable;
+	}
+
+	return flowDistance[xCoord * height + yCoord];
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns a counter that goes up whenever the flow field changes, so anything built from
+		it knows when to refresh. Brings the field up to date first
+
+	\return
+		The flow field's version
+*/
+/*************************************************************************************************/
+uint32_t Pathfinder::GetFlowFieldVersion()
+{
+	ApplyTileChanges();
+	if (flowFieldDirty)
+	{
+		RebuildFlowField();
+	}
+
+	return flowFieldVersion;
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Times per agent A* searches against agents sharing the flow field on the current map and
+		prints the results to the debug log
+
+	\param agentCount
+		The number of agents to simulate
+*/
+/*************************************************************************************************/
+void Pathfinder::Benchmark(int agentCount)
+{
+	// Collects every tile an agent could stand on that can reach the target
+	std::vector<std::pair<int, int>> openTiles;
+	for (int i = 0; i < width; i++)
+	{
+		for (int j = 0; j < height; j++)
+		{
+			if (GetFlowDistance(i, j) != unreachable)
+			{
+				openTiles.push_back({ i, j });
+			}
+		}
+	}
+
+	if (openTiles.empty())
+	{
+		_Debug->Print(Debug::MessageType::Debug, "Pathfinder: Nothing can reach the target, skipping benchmark");
+		return;
+	}
+
+	// Places the agents the same way every run so results are comparable
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<size_t> pickTile(0, openTiles.size() - 1);
+	std::vector<std::pair<int, int>> agents(agentCount);
+	for (int i = 0; i < agentCount; i++)
+	{
+		agents[i] = openTiles[pickTile(random)];
+	}
+
+	// Every agent running its own search
+	std::vector<std::pair<int, int>> path;
+	size_t searchSteps = 0;
+	auto searchStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < agentCount; i++)
+	{
+		if (FindPath(agents[i], flowTarget, path))
+		{
+			searchSteps += path.size();
+		}
+	}
+	double searchTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - searchStart).count();
+
+	// One shared field, then every agent walking it all the way to the target
+	size_t flowSteps = 0;
+	auto flowStart = std::chrono::steady_clock::now();
+	RebuildFlowField();
+	double rebuildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - flowStart).count();
+	for (int i = 0; i < agentCount; i++)
+	{
+		std::pair<int, int> position = agents[i];
+		for (std::pair<int, int> step = GetFlowDirection(position); step.first || step.second; step = GetFlowDirection(position))
+		{
+			position.first += step.first;
+			position.second += step.second;
+			flowSteps++;
+		}
+	}
+	double flowTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - flowStart).count();
+
+	_Debug->Print(Debug::MessageType::Debug, "Pathfinder: " + std::to_string(agentCount) + " agents, A* " + std::to_string(searchTime) + "ms (" +
+		std::to_string(searchSteps) + " steps), flow field " + std::to_string(flowTime) + "ms (rebuild " + std::to_string(rebuildTime) + "ms, " +
+		std::to_string(flowSteps) + " steps)");
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Walks the flow field's target one tile at a time, the way the player moves, and prints
+		how long the field took to bring up to date after each step to the debug log
+
+	\param moveCount
+		The number of steps to take
+*/
+/*************************************************************************************************/
+void Pathfinder::BenchmarkTargetMoves(int moveCount)
+{
+	// Heads for the reachable tile furthest from the target so the walk doesn't run out of steps
+	std::pair<int, int> startTarget = flowTarget;
+	std::pair<int, int> furthest = startTarget;
+	size_t reachableTiles = 0;
+	for (int i = 0; i < width; i++)
+	{
+		for (int j = 0; j < height; j++)
+		{
+			uint32_t distance = GetFlowDistance(i, j);
+			if (distance != unreachable)
+			{
+				reachableTiles++;
+				if (distance > GetFlowDistance(furthest.first, furthest.second))
+				{
+					furthest = { i, j };
+				}
+			}
+		}
+	}
+
+	std::vector<std::pair<int, int>> path;
+	if (!FindPath(startTarget, furthest, path) || path.empty())
+	{
+		_Debug->Print(Debug::MessageType::Debug, "Pathfinder: The target has nowhere to move, skipping benchmark");
+		return;
+	}
+
+	// Each step changes the target, so the next query brings the whole field up to date
+	int moves = std::min(moveCount, (int)path.size());
+	double totalTime = 0.0;
+	double worstTime = 0.0;
+	for (int i = 0; i < moves; i++)
+	{
+		auto moveStart = std::chrono::steady_clock::now();
+		SetFlowFieldTarget(path[i]);
+		GetFlowFieldVersion();
+		double moveTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - moveStart).count();
+		totalTime += moveTime;
+		worstTime = std::max(worstTime, moveTime);
+	}
+
+	// Puts the target back where the map left it
+	SetFlowFieldTarget(startTarget);
+
+	_Debug->Print(Debug::MessageType::Debug, "Pathfinder: " + std::to_string(moves) + " target moves over " + std::to_string(reachableTiles) +
+		" reachable tiles, " + std::to_string(totalTime / moves) + "ms per move (worst " + std::to_string(worstTime) + "ms)");
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns whether a tile is a wall as far as navigation is concerned
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+
+	\return
+		Whether the tile blocks movement
+*/
+/*************************************************************************************************/
+bool Pathfinder::IsBlocked(int xCoord, int yCoord)
+{
+	// Enemies are solid but move out of the way, so they don't count as walls
+	return map->TestTileMask(MapMatrix::TileMask::Solid, xCoord, yCoord) && !map->TestTileMask(MapMatrix::TileMask::Hazard, xCoord, yCoord);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Catches the flow field up on the tile changes in the map's journal
+*/
+/*************************************************************************************************/
+void Pathfinder::ApplyTileChanges()
+{
+	// Rebuilds from scratch if the map was replaced
+	const MapMatrix::TileChange* changes;
+	int changeCount;
+	if (!map->ReadTileChanges(tileChangeSubscriber, changes, changeCount))
+	{
+		flowFieldDirty = true;
+		return;
+	}
+
+	// Only tiles that started or stopped blocking movement affect the field
+	for (int i = 0; i < changeCount && !flowFieldDirty; i++)
+	{
+		if (BlocksNavigation(changes[i].oldStatus) != BlocksNavigation(changes[i].newStatus))
+		{
+			MarkTileChanged(changes[i].tile.first, changes[i].tile.second);
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Rebuilds the flow field with a breadth first search out from the target
+*/
+/*************************************************************************************************/
+void Pathfinder::RebuildFlowField()
+{
+	flowFieldDirty = false;
+	flowFieldVersion++;
+	std::fill(flowDistance.begin(), flowDistance.end(), unreachable);
+	std::fill(flowDirection.begin(), flowDirection.end(), 0);
+
+	// Leaves the field empty if the target isn't somewhere that can be reached
+	if (flowTarget.first < 0 || flowTarget.first >= width || flowTarget.second < 0 || flowTarget.second >= height ||
+		IsBlocked(flowTarget.first, flowTarget.second))
+	{
+		return;
+	}
+
+	// Every step costs the same, so a breadth first search gives the exact distances
+	int targetIndex = flowTarget.first * height + flowTarget.second;
+	flowDistance[targetIndex] = 0;
+	searchQueue.clear();
+	searchQueue.push_back(targetIndex);
+	for (size_t head = 0; head < searchQueue.size(); head++)
+	{
+		int current = searchQueue[head];
+		int currentX = current / height;
+		int currentY = current % height;
+
+		for (int i = 1; i < stepCount; i++)
+		{
+			int neighborX = currentX + stepX[i];
+			int neighborY = currentY + stepY[i];
+			if (neighborX < 0 || neighborX >= width || neighborY < 0 || neighborY >= height)
+			{
+				continue;
+			}
+
+			// Visits each open tile once and points it back the way the search came
+			int neighbor = neighborX * height + neighborY;
+			if (flowDistance[neighbor] == unreachable && !IsBlocked(neighborX, neighborY))
+			{
+				flowDistance[neighbor] = flowDistance[current] + 1;
+				flowDirection[neighbor] = reverseStep[i];
+				searchQueue.push_back(neighbor);
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Returns whether a tile status is a wall as far as navigation is concerned
+
+	\param tileStatus
+		The status to check
+
+	\return
+		Whether the status blocks movement
+*/
+/*************************************************************************************************/
+static bool BlocksNavigation(MapMatrix::TileStatus tileStatus)
+{
+	// Matches IsBlocked, enemies move out of the way so they don't count
+	return MapMatrix::IsSolid(tileStatus) && tileStatus != MapMatrix::TileStatus::Enemy;
+}
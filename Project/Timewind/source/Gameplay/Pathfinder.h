@@ -0,0 +1,327 @@
+/*************************************************************************************************/
+/*!
+\file Pathfinder.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    Grid navigation for the map matrix. Handles one off A* path queries and a shared flow field
+	toward the player that any number of enemies can follow without searching themselves
+
+    Public Functions:
+        + Pathfinder
+		+ ~Pathfinder
+		+ Resize
+		+ MarkTileChanged
+		+ SetFlowFieldTarget
+		+ FindPath
+		+ GetFlowDirection
+		+ GetFlowDistance
+		+ GetFlowFieldVersion
+		+ Benchmark
+		+ BenchmarkTargetMoves
+
+	Private Functions:
+		+ IsBlocked
+		+ ApplyTileChanges
+		+ RebuildFlowField
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_Pathfinder_H_
+#define Syncopatience_Pathfinder_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Fixed width integers for the compact grids
+#include <cstdint>
+
+// The grids and returned paths
+#include <vector>
+
+// Tile coordinates
+#include <utility>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+// Dependency references
+class MapMatrix;
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The pathfinder class. Moves are the four tile steps MapMatrix::MoveTile allows. Other
+		enemies don't block navigation since they move out of the way, so only tiles that are solid
+		and aren't hazards count as walls
+*/
+/*************************************************************************************************/
+class Pathfinder
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	static constexpr uint32_t unreachable = 0xFFFFFFFF;	// The flow distance of tiles that can't reach the target
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the pathfinder class
+
+		\param map_
+			The map the pathfinder navigates
+	*/
+	/*************************************************************************************************/
+	Pathfinder(MapMatrix* map_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the pathfinder class
+	*/
+	/*************************************************************************************************/
+	~Pathfinder();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Resizes the pathfinder's grids to match the map. Called whenever the map is resized
+
+		\param width_
+			The width of the map in tiles
+
+		\param height_
+			The height of the map in tiles
+	*/
+	/*************************************************************************************************/
+	void Resize(int width_, int height_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Tells the pathfinder a tile changed whether it can be walked through. The flow field is
+			only rebuilt if the change could affect it. Changes made through the map are picked up
+			from its tile change journal automatically
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+	*/
+	/*************************************************************************************************/
+	void MarkTileChanged(int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Sets the tile the flow field leads to. Does nothing if the target hasn't changed. A new
+		target rebuilds the field on its next use, since moving it even one tile changes the
+		distance of nearly every tile
+
+		\param target
+			The new target tile
+	*/
+	/*************************************************************************************************/
+	void SetFlowFieldTarget(std::pair<int, int> target);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Finds the shortest path between two tiles with A*
+
+		\param start
+			The tile to start from
+
+		\param goal
+			The tile to reach
+
+		\param path
+			Filled with the tiles to step through, not including the start but including the goal
+
+		\return
+			Whether a path was found
+	*/
+	/*************************************************************************************************/
+	bool FindPath(std::pair<int, int> start, std::pair<int, int> goal, std::vector<std::pair<int, int>>& path);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the step to take from a tile to follow the flow field toward its target.
+			Rebuilds the field first if anything changed since the last query
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+
+		\return
+			The step to take, (0, 0) if the tile is the target or can't reach it
+	*/
+	/*************************************************************************************************/
+	std::pair<int, int> GetFlowDirection(int xCoord, int yCoord);
+	std::pair<int, int> GetFlowDirection(std::pair<int, int> coords) { return GetFlowDirection(coords.first, coords.second); }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns how many steps a tile is from the flow field's target
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+
+		\return
+			The number of steps, or unreachable
+	*/
+	/*************************************************************************************************/
+	uint32_t GetFlowDistance(int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns a counter that goes up whenever the flow field changes, so anything built from
+			it knows when to refresh. Brings the field up to date first
+
+		\return
+			The flow field's version
+	*/
+	/*************************************************************************************************/
+	uint32_t GetFlowFieldVersion();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Times per agent A* searches against agents sharing the flow field on the current map and
+			prints the results to the debug log
+
+		\param agentCount
+			The number of agents to simulate
+	*/
+	/*************************************************************************************************/
+	void Benchmark(int agentCount);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Walks the flow field's target one tile at a time, the way the player moves, and prints
+			how long the field took to bring up to date after each step to the debug log
+
+		\param moveCount
+			The number of steps to take
+	*/
+	/*************************************************************************************************/
+	void BenchmarkTargetMoves(int moveCount);
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	MapMatrix* map;								// The map being navigated
+	int width;									// The width of the grids
+	int height;									// The height of the grids
+
+	std::pair<int, int> flowTarget;				// The tile the flow field leads to
+	bool flowFieldDirty;						// Whether the flow field needs rebuilding before its next use
+	std::vector<uint32_t> flowDistance;			// Steps from each tile to the target. A 4096 square map can be further than 16 bits reach
+	std::vector<uint8_t> flowDirection;			// The step each tile takes toward the target (index into the step table)
+	uint32_t flowFieldVersion;					// Goes up every time the flow field changes
+
+	std::vector<uint32_t> searchStamp;			// Which search last touched each tile, so the search grids never need clearing
+	std::vector<int> searchCost;				// The cost to reach each tile in the current search
+	std::vector<int> searchParent;				// The tile each tile was reached from in the current search
+	uint32_t currentSearch;						// The stamp of the current search
+
+	std::vector<int> searchQueue;				// Reused queue for flow field updates
+
+	int tileChangeSubscriber;					// The pathfinder's id in the map's tile change journal
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns whether a tile is a wall as far as navigation is concerned
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+
+		\return
+			Whether the tile blocks movement
+	*/
+	/*************************************************************************************************/
+	bool IsBlocked(int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Catches the flow field up on the tile changes in the map's journal
+	*/
+	/*************************************************************************************************/
+	void ApplyTileChanges();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Rebuilds the flow field with a breadth first search out from the target
+	*/
+	/*************************************************************************************************/
+	void RebuildFlowField();
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_Pathfinder_H_
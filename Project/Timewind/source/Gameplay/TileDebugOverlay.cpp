@@ -0,0 +1,462 @@
+/*************************************************************************************************/
+/*!
+\file TileDebugOverlay.cpp
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    The map's debug view. Keeps a single channel texture per layer with a value for every tile
+	and draws the shown layer as one quad over the whole map. Textures are only patched where
+	the map's tile change journal says something changed
+
+    Functions include:
+        + TileDebugOverlay::TileDebugOverlay
+		+ TileDebugOverlay::~TileDebugOverlay
+		+ TileDebugOverlay::Draw
+		+ TileDebugOverlay::NextLayer
+		+ TileDebugOverlay::Free
+		+ TileDebugOverlay::Resize
+		+ TileDebugOverlay::RebuildLayers
+		+ TileDebugOverlay::ApplyTileChanges
+		+ TileDebugOverlay::UpdateTile
+		+ TileDebugOverlay::UpdateDensity
+		+ TileDebugOverlay::UpdatePathCost
+		+ TileDebugOverlay::MarkDirty
+		+ TileDebugOverlay::UploadLayer
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Base includes
+#include "TileDebugOverlay.h"
+#include "MapMatrix.h"
+#include "../Engine/cppShortcuts.h"
+
+// The textures and the draw call
+#include "../Engine/Window.h"
+#include "../Engine/Texture.h"
+#include "../Engine/TextureManager.h"
+
+// Finding the player's tile
+#include "../Engine/GameObjectManager.h"
+#include "../Game_Objects/Player.h"
+
+#include <algorithm>
+
+//-------------------------------------------------------------------------------------------------
+// Private Constants
+//-------------------------------------------------------------------------------------------------
+
+// How opaque the overlay is drawn
+const float overlayAlpha = 0.5f;
+
+// The path cost value the shader draws as unreachable. Reachable costs are capped just below it
+const uint8_t unreachableCost = 255;
+
+//-------------------------------------------------------------------------------------------------
+// Public Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Declarations
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Constructor for the tile debug overlay class
+
+	\param map_
+		The map the overlay shows
+*/
+/*************************************************************************************************/
+TileDebugOverlay::TileDebugOverlay(MapMatrix* map_) : map(map_), width(0), height(0), shownLayer(Layer::Max), tileChangeSubscriber(-1),
+	pathCostVersion(0), pathCostBuilt(false)
+{
+	for (int i = 0; i < (int)Layer::Max; i++)
+	{
+		layerTextures[i] = NULL;
+		dirtyRects[i] = { 0, 0, -1, -1 };
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Destructor for the tile debug overlay class
+*/
+/*************************************************************************************************/
+TileDebugOverlay::~TileDebugOverlay()
+{
+	Free();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Catches the layers up with the map, uploads whatever changed in the shown layer and
+		draws it. Does nothing while the overlay is off
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::Draw()
+{
+	if (shownLayer == Layer::Max)
+	{
+		return;
+	}
+
+	// Starts following the map the first time it's shown
+	if (tileChangeSubscriber < 0)
+	{
+		tileChangeSubscriber = map->SubscribeToTileChanges();
+		Resize();
+	}
+
+	// Brings the values up to date. The path cost is only worth following while it's on screen
+	ApplyTileChanges();
+	if (shownLayer == Layer::PathCost)
+	{
+		UpdatePathCost();
+	}
+	UploadLayer(shownLayer);
+
+	// Draws the whole layer as a single quad. Tile n covers world [2n - 1, 2n + 1)
+	glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3((float)(width - 1), (float)(height - 1), 0.0f));
+	transform = glm::scale(transform, glm::vec3(2.0f * width, 2.0f * height, 1.0f));
+	_Window->DrawTileOverlay(layerTextures[(int)shownLayer], transform, (uint32_t)shownLayer, overlayAlpha);
+
+	// Boxes the player's tile on top. Looked up every time since changing scenes clears the texture manager
+	Texture* highlightTexture = _TextureManager->AddTexture("Assets/Sprites/Highlight_Box.png");
+	GameObject playerHighlight(ConvertMapCoordsToWorldCoords(ConvertWorldCoordsToMapCoords(_GameObjectManager->GetPlayer()->GetPosition())), 0.0f, { 2.0f, 2.0f }, 49, true, highlightTexture, { 1.0f, 1.0f, 1.0f, 0.5f });
+	_Window->DrawGameObject(&playerHighlight);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Moves on to the next layer, turning the overlay off after the last one and back on
+		after that
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::NextLayer()
+{
+	shownLayer = (Layer)(((int)shownLayer + 1) % ((int)Layer::Max + 1));
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Frees the layer textures. Has to happen before the window shuts down
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::Free()
+{
+	for (int i = 0; i < (int)Layer::Max; i++)
+	{
+		delete layerTextures[i];
+		layerTextures[i] = NULL;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+// Private Function Definitions
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Resizes the layers to match the map, dropping any textures of the old size
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::Resize()
+{
+	width = map->GetMaxMapWidth();
+	height = map->GetMaxMapHeight();
+
+	for (int i = 0; i < (int)Layer::Max; i++)
+	{
+		layerValues[i].assign((size_t)width * height, 0);
+		delete layerTextures[i];
+		layerTextures[i] = NULL;
+	}
+
+	pathCostBuilt = false;
+	RebuildLayers();
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Rebuilds every layer but the path cost from the whole map
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::RebuildLayers()
+{
+	for (int i = 0; i < width; i++)
+	{
+		for (int j = 0; j < height; j++)
+		{
+			UpdateTile(i, j);
+		}
+	}
+
+	// Counts each tile's neighborhood from scratch
+	std::vector<uint8_t>& density = layerValues[(int)Layer::ObjectDensity];
+	const std::vector<uint8_t>& status = layerValues[(int)Layer::TileStatus];
+	for (int j = 0; j < height; j++)
+	{
+		for (int i = 0; i < width; i++)
+		{
+			uint8_t occupied = 0;
+			for (int y = std::max(j - 1, 0); y <= std::min(j + 1, height - 1); y++)
+			{
+				for (int x = std::max(i - 1, 0); x <= std::min(i + 1, width - 1); x++)
+				{
+					occupied += status[y * width + x] != (uint8_t)MapMatrix::TileStatus::Empty;
+				}
+			}
+			density[j * width + i] = occupied;
+		}
+	}
+
+	for (int i = 0; i < (int)Layer::Max; i++)
+	{
+		if (i != (int)Layer::PathCost && width > 0 && height > 0)
+		{
+			MarkDirty((Layer)i, 0, 0);
+			MarkDirty((Layer)i, width - 1, height - 1);
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Catches the layers up on the tile changes in the map's journal
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::ApplyTileChanges()
+{
+	const MapMatrix::TileChange* changes;
+	int changeCount;
+
+	// Missed changes mean the whole map was replaced, which may have resized it
+	if (!map->ReadTileChanges(tileChangeSubscriber, changes, changeCount))
+	{
+		if (width != map->GetMaxMapWidth() || height != map->GetMaxMapHeight())
+		{
+			Resize();
+		}
+		else
+		{
+			RebuildLayers();
+		}
+		return;
+	}
+
+	for (int i = 0; i < changeCount; i++)
+	{
+		UpdateTile(changes[i].tile.first, changes[i].tile.second);
+
+		// Density only moves when a tile goes between empty and occupied
+		if ((changes[i].oldStatus == MapMatrix::TileStatus::Empty) != (changes[i].newStatus == MapMatrix::TileStatus::Empty))
+		{
+			UpdateDensity(changes[i].tile.first, changes[i].tile.second);
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Refreshes the status and solidity values of a single tile
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::UpdateTile(int xCoord, int yCoord)
+{
+	if (xCoord < 0 || xCoord >= width || yCoord < 0 || yCoord >= height)
+	{
+		return;
+	}
+
+	int index = yCoord * width + xCoord;
+
+	// The status goes in as is, the shader has a color for each one
+	uint8_t status = (uint8_t)map->GetTile(xCoord, yCoord).tileStatus;
+	if (layerValues[(int)Layer::TileStatus][index] != status)
+	{
+		layerValues[(int)Layer::TileStatus][index] = status;
+		MarkDirty(Layer::TileStatus, xCoord, yCoord);
+	}
+
+	// Packs a bit per tile mask
+	uint8_t maskBits = 0;
+	for (int i = 0; i < (int)MapMatrix::TileMask::Max; i++)
+	{
+		if (map->TestTileMask((MapMatrix::TileMask)i, xCoord, yCoord))
+		{
+			maskBits |= (uint8_t)(1 << i);
+		}
+	}
+	if (layerValues[(int)Layer::Solidity][index] != maskBits)
+	{
+		layerValues[(int)Layer::Solidity][index] = maskBits;
+		MarkDirty(Layer::Solidity, xCoord, yCoord);
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Recounts the occupied tiles around each tile near the given one
+
+	\param xCoord
+		The x coordinate of the tile that changed
+
+	\param yCoord
+		The y coordinate of the tile that changed
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::UpdateDensity(int xCoord, int yCoord)
+{
+	std::vector<uint8_t>& density = layerValues[(int)Layer::ObjectDensity];
+	const std::vector<uint8_t>& status = layerValues[(int)Layer::TileStatus];
+
+	// Every tile whose neighborhood includes the changed one gets recounted
+	for (int j = std::max(yCoord - 1, 0); j <= std::min(yCoord + 1, height - 1); j++)
+	{
+		for (int i = std::max(xCoord - 1, 0); i <= std::min(xCoord + 1, width - 1); i++)
+		{
+			uint8_t occupied = 0;
+			for (int y = std::max(j - 1, 0); y <= std::min(j + 1, height - 1); y++)
+			{
+				for (int x = std::max(i - 1, 0); x <= std::min(i + 1, width - 1); x++)
+				{
+					occupied += status[y * width + x] != (uint8_t)MapMatrix::TileStatus::Empty;
+				}
+			}
+
+			if (density[j * width + i] != occupied)
+			{
+				density[j * width + i] = occupied;
+				MarkDirty(Layer::ObjectDensity, i, j);
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Rebuilds the path cost layer if the flow field changed since it was last built
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::UpdatePathCost()
+{
+	Pathfinder& pathfinder = map->GetPathfinder();
+	uint32_t version = pathfinder.GetFlowFieldVersion();
+	if (pathCostBuilt && version == pathCostVersion)
+	{
+		return;
+	}
+	pathCostBuilt = true;
+	pathCostVersion = version;
+
+	// Only the tiles whose cost actually moved get uploaded
+	std::vector<uint8_t>& cost = layerValues[(int)Layer::PathCost];
+	for (int i = 0; i < width; i++)
+	{
+		for (int j = 0; j < height; j++)
+		{
+			uint32_t distance = pathfinder.GetFlowDistance(i, j);
+			uint8_t value = distance == Pathfinder::unreachable ? unreachableCost : (uint8_t)std::min<uint32_t>(distance, unreachableCost - 1u);
+			if (cost[j * width + i] != value)
+			{
+				cost[j * width + i] = value;
+				MarkDirty(Layer::PathCost, i, j);
+			}
+		}
+	}
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Grows a layer's dirty rectangle to cover a tile
+
+	\param layer
+		The layer that changed
+
+	\param xCoord
+		The x coordinate of the tile
+
+	\param yCoord
+		The y coordinate of the tile
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::MarkDirty(Layer layer, int xCoord, int yCoord)
+{
+	DirtyRect& rect = dirtyRects[(int)layer];
+
+	// An empty rectangle has its max below its min
+	if (rect.maxX < rect.minX)
+	{
+		rect = { xCoord, yCoord, xCoord, yCoord };
+		return;
+	}
+
+	rect.minX = std::min(rect.minX, xCoord);
+	rect.minY = std::min(rect.minY, yCoord);
+	rect.maxX = std::max(rect.maxX, xCoord);
+	rect.maxY = std::max(rect.maxY, yCoord);
+}
+
+/*************************************************************************************************/
+/*!
+	\brief
+		Creates a layer's texture if it doesn't exist yet, otherwise uploads its dirty rectangle
+
+	\param layer
+		The layer to upload
+*/
+/*************************************************************************************************/
+void TileDebugOverlay::UploadLayer(Layer layer)
+{
+	DirtyRect& rect = dirtyRects[(int)layer];
+	std::vector<uint8_t>& values = layerValues[(int)layer];
+
+	// A new texture takes the whole layer at once
+	if (!layerTextures[(int)layer])
+	{
+		layerTextures[(int)layer] = new Texture(width, height, values.data());
+	}
+	else if (rect.maxX >= rect.minX)
+	{
+		layerTextures[(int)layer]->UpdatePixels(values.data(), width, rect.minX, rect.minY, rect.maxX - rect.minX + 1, rect.maxY - rect.minY + 1);
+	}
+
+	rect = { 0, 0, -1, -1 };
+}
@@ -0,0 +1,293 @@
+/*************************************************************************************************/
+/*!
+\file TileDebugOverlay.h
+\author Aiden Cvengros
+\par email: ajcvengros\@gmail.com
+\date 2026.10.18
+\brief
+    The map's debug view. Keeps a single channel texture per layer with a value for every tile
+	and draws the shown layer as one quad over the whole map. Textures are only patched where
+	the map's tile change journal says something changed
+
+    Public Functions:
+        + TileDebugOverlay
+		+ ~TileDebugOverlay
+		+ Draw
+		+ NextLayer
+		+ GetLayer
+		+ Free
+
+	Private Functions:
+		+ Resize
+		+ RebuildLayers
+		+ ApplyTileChanges
+		+ UpdateTile
+		+ UpdateDensity
+		+ UpdatePathCost
+		+ MarkDirty
+		+ UploadLayer
+
+Copyright (c) 2026 Aiden Cvengros
+*/
+/*************************************************************************************************/
+
+#ifndef Syncopatience_TileDebugOverlay_H_
+#define Syncopatience_TileDebugOverlay_H_
+
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Include Header Files
+//-------------------------------------------------------------------------------------------------
+
+// Fixed width integers for the layer values
+#include <cstdint>
+
+// The layer values
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+// Forward References
+//-------------------------------------------------------------------------------------------------
+
+// Dependency references
+class MapMatrix;
+class Texture;
+
+//-------------------------------------------------------------------------------------------------
+// Public Constants
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Classes
+//-------------------------------------------------------------------------------------------------
+
+/*************************************************************************************************/
+/*!
+	\brief
+		The tile debug overlay class
+*/
+/*************************************************************************************************/
+class TileDebugOverlay
+{
+public:
+	//---------------------------------------------------------------------------------------------
+	// Public Consts
+	//---------------------------------------------------------------------------------------------
+
+	// The views the overlay can show. Matches the layers the 2d fragment shader knows how to color
+	enum class Layer
+	{
+		TileStatus,								// The status of each tile
+		Solidity,								// The tile mask bits of each tile
+		PathCost,								// Steps to the player along the flow field
+		ObjectDensity,							// How many of the surrounding tiles are occupied
+		Max
+	};
+
+	//---------------------------------------------------------------------------------------------
+	// Public Structures
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Variables
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Public Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Constructor for the tile debug overlay class
+
+		\param map_
+			The map the overlay shows
+	*/
+	/*************************************************************************************************/
+	TileDebugOverlay(MapMatrix* map_);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Destructor for the tile debug overlay class
+	*/
+	/*************************************************************************************************/
+	~TileDebugOverlay();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Catches the layers up with the map, uploads whatever changed in the shown layer and
+			draws it. Does nothing while the overlay is off
+	*/
+	/*************************************************************************************************/
+	void Draw();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Moves on to the next layer, turning the overlay off after the last one and back on
+			after that
+	*/
+	/*************************************************************************************************/
+	void NextLayer();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Returns the layer being shown
+
+		\return
+			The shown layer, Max if the overlay is off
+	*/
+	/*************************************************************************************************/
+	Layer GetLayer() { return shownLayer; }
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Frees the layer textures. Has to happen before the window shuts down
+	*/
+	/*************************************************************************************************/
+	void Free();
+
+private:
+	//---------------------------------------------------------------------------------------------
+	// Private Consts
+	//---------------------------------------------------------------------------------------------
+
+	//---------------------------------------------------------------------------------------------
+	// Private Structures
+	//---------------------------------------------------------------------------------------------
+
+	// The rectangle of a layer that changed since its last upload
+	typedef struct
+	{
+		int minX;								// The leftmost changed column
+		int minY;								// The lowest changed row
+		int maxX;								// The rightmost changed column
+		int maxY;								// The highest changed row
+	}DirtyRect;
+
+	//---------------------------------------------------------------------------------------------
+	// Private Variables
+	//---------------------------------------------------------------------------------------------
+
+	MapMatrix* map;								// The map being shown
+	int width;									// The width of the layers in tiles
+	int height;									// The height of the layers in tiles
+
+	Layer shownLayer;							// The layer being drawn, Max when off
+
+	std::vector<uint8_t> layerValues[(int)Layer::Max];	// A byte per tile for each layer, stored row by row
+	Texture* layerTextures[(int)Layer::Max];	// The gpu copy of each layer, made the first time it's shown
+	DirtyRect dirtyRects[(int)Layer::Max];		// What each layer needs to upload
+
+	int tileChangeSubscriber;					// The overlay's id in the map's tile change journal
+	uint32_t pathCostVersion;					// The flow field version the path cost layer was built from
+	bool pathCostBuilt;							// Whether the path cost layer has been built at all
+
+	//---------------------------------------------------------------------------------------------
+	// Private Function Declarations
+	//---------------------------------------------------------------------------------------------
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Resizes the layers to match the map, dropping any textures of the old size
+	*/
+	/*************************************************************************************************/
+	void Resize();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Rebuilds every layer but the path cost from the whole map
+	*/
+	/*************************************************************************************************/
+	void RebuildLayers();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Catches the layers up on the tile changes in the map's journal
+	*/
+	/*************************************************************************************************/
+	void ApplyTileChanges();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Refreshes the status and solidity values of a single tile
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+	*/
+	/*************************************************************************************************/
+	void UpdateTile(int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Recounts the occupied tiles around each tile near the given one
+
+		\param xCoord
+			The x coordinate of the tile that changed
+
+		\param yCoord
+			The y coordinate of the tile that changed
+	*/
+	/*************************************************************************************************/
+	void UpdateDensity(int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Rebuilds the path cost layer if the flow field changed since it was last built
+	*/
+	/*************************************************************************************************/
+	void UpdatePathCost();
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Grows a layer's dirty rectangle to cover a tile
+
+		\param layer
+			The layer that changed
+
+		\param xCoord
+			The x coordinate of the tile
+
+		\param yCoord
+			The y coordinate of the tile
+	*/
+	/*************************************************************************************************/
+	void MarkDirty(Layer layer, int xCoord, int yCoord);
+
+	/*************************************************************************************************/
+	/*!
+		\brief
+			Creates a layer's texture if it doesn't exist yet, otherwise uploads its dirty rectangle
+
+		\param layer
+			The layer to upload
+	*/
+	/*************************************************************************************************/
+	void UploadLayer(Layer layer);
+};
+
+//-------------------------------------------------------------------------------------------------
+// Public Variables
+//-------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------
+// Public Functions
+//-------------------------------------------------------------------------------------------------
+
+#endif // Syncopatience_TileDebugOverlay_H_
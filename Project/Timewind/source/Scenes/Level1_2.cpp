@@ -94,7 +94,7 @@ void Level1_2::LoadScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-2.csv", specialTileList);
+    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-2.cmap", specialTileList);
 
     // Creates essential game objects (player, camera, and default square)
     Player* player = new Player(ConvertMapCoordsToWorldCoords(_MapMatrix->GetPlayerPosition()), 0.0f, {2.0f, 2.0f}, 50, playerTexture, {2, 2});
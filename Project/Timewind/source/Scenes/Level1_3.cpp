@@ -94,7 +94,7 @@ void Level1_3::LoadScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-3.csv", specialTileList);
+    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-3.cmap", specialTileList);
 
     // Creates essential game objects (player, camera, and default square)
     Player* player = new Player(ConvertMapCoordsToWorldCoords(_MapMatrix->GetPlayerPosition()), 0.0f, {2.0f, 2.0f}, 50, playerTexture, {2, 2});
@@ -205,7 +205,7 @@ void Level1_3::RefreshScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-3.csv", specialTileList, false);
+    _MapMatrix->ReloadMap(specialTileList, false);
 
     // Resets the player and camera positions
     glm::vec2 playerPosition = ConvertMapCoordsToWorldCoords(_MapMatrix->GetPlayerPosition());
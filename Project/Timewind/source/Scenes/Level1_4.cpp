@@ -94,7 +94,7 @@ void Level1_4::LoadScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-4.csv", specialTileList);
+    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-4.cmap", specialTileList);
 
     // Creates essential game objects (player, camera, and default square)
     Player* player = new Player(ConvertMapCoordsToWorldCoords(_MapMatrix->GetPlayerPosition()), 0.0f, {2.0f, 2.0f}, 50, playerTexture, _MapMatrix->GetPlayerPosition());
@@ -208,7 +208,7 @@ void Level1_4::RefreshScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Level1-4.csv", specialTileList, false);
+    _MapMatrix->ReloadMap(specialTileList, false);
 
     // Resets the player and camera positions
     glm::vec2 playerPosition = ConvertMapCoordsToWorldCoords(_MapMatrix->GetPlayerPosition());
@@ -82,7 +82,7 @@ void MainMenu::LoadScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/MainMenuBackground.csv", specialTileList);
+    _MapMatrix->ReadMapFromFile("Assets/Maps/MainMenuBackground.cmap", specialTileList);
 
     // Creates essential game objects (player, camera, and default square)
     Player* player = new Player({ 6.0f, 4.0f }, 0.0f, { 2.0f, 2.0f }, 50, playerTexture, { 3, 2 });
@@ -104,7 +104,7 @@ void Sandbox::LoadScene()
 
     // Sets the map for the scene
     std::vector< std::pair< char, std::pair< int, int > > > specialTileList;
-    _MapMatrix->ReadMapFromFile("Assets/Maps/Sandbox.csv", specialTileList);
+    _MapMatrix->ReadMapFromFile("Assets/Maps/Sandbox.cmap", specialTileList);
 
     // Refreshes the game object manager
     _GameObjectManager->RefreshScene();
@@ -1,11 +1,23 @@
 #version 450
 
+// Compiled a second time with BINDLESS_TEXTURES defined for cards with descriptor indexing,
+// where set 1 holds every texture and each sprite picks its own
+#ifdef BINDLESS_TEXTURES
+#extension GL_EXT_nonuniform_qualifier : require
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+#define texSampler textures[nonuniformEXT(fragTextureSlot)]
+#else
 layout(set= 1, binding = 0) uniform sampler2D texSampler;
+#endif
 
 layout(location = 0) in vec4 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragDrawMode;
+layout(location = 3) flat in uint fragOverlayLayer;
+layout(location = 4) flat in uint fragTextureSlot;
 
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec4 outMask;
 
 const vec2 resolution = {800, 600};
 
@@ -20,14 +32,113 @@ vec2 curve(vec2 uv)
 	return uv;
 }
 
+// Colors for each map tile status, matching MapMatrix::TileStatus
+const vec3 tileStatusColors[14] = vec3[](
+  vec3(0.0, 0.0, 0.0),    // Empty
+  vec3(1.0, 1.0, 1.0),    // FinishFlag
+  vec3(1.0, 0.85, 0.2),   // Key
+  vec3(1.0, 0.5, 0.0),    // Bumper
+  vec3(0.0, 1.0, 1.0),    // Teleporter
+  vec3(0.8, 0.3, 1.0),    // Sticker
+  vec3(1.0, 0.7, 0.1),    // BigCoin
+  vec3(1.0, 0.9, 0.4),    // Coin
+  vec3(0.0, 1.0, 0.0),    // Player
+  vec3(1.0, 0.0, 0.0),    // Enemy
+  vec3(0.2, 0.2, 1.0),    // Destructible
+  vec3(0.8, 0.7, 0.4),    // SandBlock
+  vec3(0.5, 0.3, 0.1),    // LockedDoor
+  vec3(0.6, 0.6, 0.6)     // Wall
+);
+
+// Colors for each bit of the tile mask layer, matching MapMatrix::TileMask
+const vec3 tileMaskColors[4] = vec3[](
+  vec3(0.6, 0.6, 0.6),    // Solid
+  vec3(1.0, 0.85, 0.2),   // Collectible
+  vec3(0.8, 0.3, 1.0),    // Sticker
+  vec3(1.0, 0.0, 0.0)     // Hazard
+);
+
+// Turns a tile debug overlay value into a color. Alpha 0 means nothing is drawn on the tile
+vec4 OverlayColor(uint value)
+{
+  // Tile statuses
+  if (fragOverlayLayer == 0)
+  {
+    return vec4(tileStatusColors[min(value, 13u)], value == 0u ? 0.0 : 1.0);
+  }
+  // Tile mask bits, averaged where a tile is in more than one mask
+  else if (fragOverlayLayer == 1)
+  {
+    vec3 color = vec3(0.0);
+    float count = 0.0;
+    for (int i = 0; i < 4; i++)
+    {
+      if ((value & (1u << i)) != 0u)
+      {
+        color += tileMaskColors[i];
+        count += 1.0;
+      }
+    }
+    return count > 0.0 ? vec4(color / count, 1.0) : vec4(0.0);
+  }
+  // Flow field distance, green near the player fading to red, with a band every 8 steps. 255 is unreachable
+  else if (fragOverlayLayer == 2)
+  {
+    if (value == 255u)
+    {
+      return vec4(0.0);
+    }
+    float band = (value % 8u) == 0u ? 1.25 : 1.0;
+    return vec4(mix(vec3(0.0, 1.0, 0.2), vec3(1.0, 0.0, 0.2), float(value) / 254.0) * band, 1.0);
+  }
+  // Object density, blue through yellow for 1 to 9 objects nearby
+  else
+  {
+    return vec4(mix(vec3(0.1, 0.2, 1.0), vec3(1.0, 1.0, 0.0), float(value) / 9.0), value == 0u ? 0.0 : 1.0);
+  }
+}
+
 void main()
 {
-  if (fragColor.a < 0.0f)
+  vec4 color;
+
+  // Draw mode 2 is the tile debug overlay. Each texel is one tile holding a raw value rather than a color
+  if (fragDrawMode == 2)
+  {
+    ivec2 overlaySize = textureSize(texSampler, 0);
+    ivec2 tile = clamp(ivec2((1.0 - fragTexCoord) * vec2(overlaySize)), ivec2(0), overlaySize - 1);
+    uint value = uint(texelFetch(texSampler, tile, 0).r * 255.0 + 0.5);
+    vec4 overlayColor = OverlayColor(value);
+    if (overlayColor.a == 0.0)
+    {
+      discard;
+    }
+    color = vec4(overlayColor.rgb, fragColor.a);
+  }
+  // Text reads a distance field, where 0.5 is the glyph's edge. The edge is softened over about
+  // a screen pixel, so it stays sharp at any size
+  else if (fragColor.a < 0.0f)
+  {
+    float distance = texture(texSampler, fragTexCoord).r;
+    float edgeWidth = max(fwidth(distance) * 0.5, 0.001);
+    float coverage = smoothstep(0.5 - edgeWidth, 0.5 + edgeWidth, distance);
+    color = vec4(fragColor.rgb, coverage * fragColor.a * -1.0f);
+  }
+  else
+  {
+    color = texture(texSampler, fragTexCoord) * fragColor;
+  }
+
+  // Draw mode 3 is a glitch, which only goes to the glitch mask. Writing nothing to the other
+  // target leaves it as it was
+  if (fragDrawMode == 3)
   {
-    outColor = vec4(1.0f, 1.0f, 1.0f, texture(texSampler, fragTexCoord).r) * vec4(fragColor.rgb, fragColor.a * -1.0f);
+    outColor = vec4(0.0);
+    outMask = color;
   }
   else
   {
-    outColor = texture(texSampler, fragTexCoord) * fragColor;
+    outColor = color;
+    outMask = vec4(0.0);
   }
 }
\ No newline at end of file
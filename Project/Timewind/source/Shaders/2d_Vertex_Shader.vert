@@ -10,23 +10,29 @@ layout(set = 0, binding = 0) uniform UniformBufferObject
   //vec4 playerPos;
 } ubo;
 
-layout(push_constant) uniform pushConstant
-{
-  layout(offset = 0) mat4 model;
-  layout(offset = 64) vec4 color;
-  layout(offset = 80) bool simpleTexture;
-} ps;
-
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec4 inColor;
 layout(location = 2) in vec2 inTexCoord;
 
+// Per sprite data from the sprite batch (see SpriteBatch::Instance)
+layout(location = 3) in vec4 instanceRow0;
+layout(location = 4) in vec4 instanceRow1;
+layout(location = 5) in vec4 instanceRow2;
+layout(location = 6) in vec4 instanceColor;
+layout(location = 7) in vec4 instanceUVRect;
+layout(location = 8) in uvec3 instanceModes;
+
 layout(location = 0) out vec4 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragDrawMode;
+layout(location = 3) flat out uint fragOverlayLayer;
+layout(location = 4) flat out uint fragTextureSlot;
 
 void main()
 {
-  vec4 vertWorldPosition = ps.model * vec4(inPosition, 0.0, 1.0);
+  // The instance holds the top three rows of the sprite's affine transform
+  vec4 localPosition = vec4(inPosition, 0.0, 1.0);
+  vec4 vertWorldPosition = vec4(dot(instanceRow0, localPosition), dot(instanceRow1, localPosition), dot(instanceRow2, localPosition), 1.0);
   
   vec3 screenCenter = vec3(ubo.camPos.x + ubo.lookAt.x, ubo.camPos.y + ubo.lookAt.y, 0.0);
   vec3 camVec = vertWorldPosition.xyz - screenCenter;
@@ -35,13 +41,17 @@ void main()
   //vertWorldPosition.z += -(camVec.x * camVec.x) / 4.0f;
   gl_Position = ubo.proj * ubo.view * vertWorldPosition;
   
-  if (ps.simpleTexture)
+  // Draw mode 1 is text, which reads the single channel font atlas as alpha
+  if (instanceModes.x == 1)
   {
-    fragColor = vec4(ps.color.rgb, ps.color.a * -1.0f);
+    fragColor = vec4(instanceColor.rgb, instanceColor.a * -1.0f);
   }
   else
   {
-    fragColor = ps.color;
+    fragColor = instanceColor;
   }
-  fragTexCoord = vec2(inTexCoord.x, 1.0f - inTexCoord.y);
+  fragTexCoord = instanceUVRect.xy + vec2(inTexCoord.x, 1.0f - inTexCoord.y) * instanceUVRect.zw;
+  fragDrawMode = instanceModes.x;
+  fragOverlayLayer = instanceModes.y;
+  fragTextureSlot = instanceModes.z;
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 glslc.exe 2d_Vertex_Shader.vert -o 2d_vert.spv
 glslc.exe post_process_vert.vert -o post_process_vert.spv
 glslc.exe 2d_Fragment_Shader.frag -o 2d_frag.spv
+glslc.exe -DBINDLESS_TEXTURES 2d_Fragment_Shader.frag -o 2d_bindless_frag.spv
 glslc.exe fisheye_frag.frag -o fisheye_frag.spv
+glslc.exe crt_resolve_frag.frag -o crt_resolve_frag.spv
+glslc.exe crt_filter_frag.frag -o crt_filter_frag.spv
+glslc.exe crt_filter_comp.comp -o crt_filter_comp.spv
 pause
\ No newline at end of file
@@ -0,0 +1,48 @@
+#version 450
+
+// The emulated screen's resolution, and how many positions across each emulated pixel are filtered
+layout(constant_id = 0) const float virtualWidth = 320.0;
+layout(constant_id = 1) const float virtualHeight = 240.0;
+layout(constant_id = 2) const int filterPhases = 12;
+
+// The filter's weights for each phase, worked out once on the CPU. The first vec4 holds the 5 tap
+// weights for -2 to 1, the second the 5 tap weight for 2 then the 3 tap weights for -1 to 1
+const int maxFilterPhases = 16;
+layout(set = 0, binding = 0) uniform CrtFilterUniformBufferObject
+{
+  vec4 weights[maxFilterPhases * 2];
+} cubo;
+
+layout(set = 0, binding = 1) uniform sampler2D virtualScene;
+
+layout(location = 0) out vec4 outRows5;
+layout(location = 1) out vec4 outRows3;
+
+const vec3 defaultColor = vec3(0.025, 0.0125, 0.0);
+
+// Emulated pixel on this row, off screen pixels are the default color
+vec3 Fetch(int x, int y)
+{
+  if (x < 0 || x >= int(virtualWidth))return defaultColor;
+  return texelFetch(virtualScene, ivec2(x, y), 0).rgb;
+}
+
+// Filters one row of the emulated screen horizontally. Each emulated pixel gets a texel for each
+// phase, so the fisheye pass only has to pick the nearest rows and blend them
+void main()
+{
+  ivec2 texel = ivec2(gl_FragCoord.xy);
+  int x = texel.x / filterPhases;
+  int phase = texel.x - x * filterPhases;
+
+  vec3 a = Fetch(x - 2, texel.y);
+  vec3 b = Fetch(x - 1, texel.y);
+  vec3 c = Fetch(x, texel.y);
+  vec3 d = Fetch(x + 1, texel.y);
+  vec3 e = Fetch(x + 2, texel.y);
+
+  vec4 w0 = cubo.weights[phase * 2];
+  vec4 w1 = cubo.weights[phase * 2 + 1];
+  outRows5 = vec4(a * w0.x + b * w0.y + c * w0.z + d * w0.w + e * w1.x, 1.0);
+  outRows3 = vec4(b * w1.y + c * w1.z + d * w1.w, 1.0);
+}
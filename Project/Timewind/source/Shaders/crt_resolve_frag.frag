@@ -0,0 +1,24 @@
+#version 450
+
+// The emulated screen's resolution
+layout(constant_id = 0) const float virtualWidth = 320.0;
+layout(constant_id = 1) const float virtualHeight = 240.0;
+
+layout(set = 0, binding = 0) uniform CrtResolveUniformBufferObject
+{
+  vec2 renderScale;
+} rubo;
+
+layout(set = 0, binding = 1) uniform sampler2D texSampler;
+
+layout(location = 0) out vec4 outColor;
+
+// Draws one texel per emulated pixel. Each is sampled where the CRT filter used to fetch it,
+// at the emulated pixel's corner, so the filters reading this see the same colors. Only the part
+// of the scene that was drawn to is read
+void main()
+{
+  vec2 res = vec2(virtualWidth, virtualHeight);
+  vec2 pos = floor(gl_FragCoord.xy) / res * rubo.renderScale;
+  outColor = vec4(texture(texSampler, pos, -16.0).rgb, 1.0);
+}
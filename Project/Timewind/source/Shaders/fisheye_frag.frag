@@ -1,35 +1,42 @@
 #version 450
 
+// The emulated screen's resolution, and how many positions across each emulated pixel the
+// filtered rows hold
+layout(constant_id = 0) const float virtualWidth = 320.0;
+layout(constant_id = 1) const float virtualHeight = 240.0;
+layout(constant_id = 2) const int filterPhases = 12;
+
 layout(set = 0, binding = 0) uniform FisheyeUniformBufferObject
 {
   float fisheyeStrength;
   float screenWidth;
   float screenHeight;
+  uint crtQuality;
+  vec2 renderScale;
 } fubo;
 
 layout(set = 0, binding = 1) uniform sampler2D texSampler;
 layout(set = 0, binding = 2) uniform sampler2D glitchMask;
+layout(set = 0, binding = 3) uniform sampler2D filteredRows5;
+layout(set = 0, binding = 4) uniform sampler2D filteredRows3;
+layout(set = 0, binding = 5) uniform sampler2D virtualScene;
 
 layout(location = 0) in vec4 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
 
-vec2 res = vec2(320, 240);
+// Matches Window::CrtQuality
+const uint crtFull = 0;
+const uint crtScanline = 1;
+const uint crtReference = 3;
+
+vec2 res = vec2(virtualWidth, virtualHeight);
 const vec3 defaultColor = vec3(0.025, 0.0125, 0.0);
 // Amount of shadow mask.
 float maskDark=0.5;
 float maskLight=1.5;
 
-// Nearest emulated sample given floating point position and texel offset.
-// Also zero's off screen.
-vec3 Fetch(vec2 pos,vec2 off)
-{
-  pos=floor(pos*res+off)/res;
-  if(max(abs(pos.x-0.5),abs(pos.y-0.5))>0.5)return defaultColor;
-  return texture(texSampler,pos.xy,-16.0).rgb;
-}
-
 // Distance in emulated pixels to nearest texel.
 vec2 Dist(vec2 pos)
 {
@@ -43,6 +50,49 @@ float Gaus(float pos,float scale)
   return exp2(scale*pos*pos);
 }
 
+// Horizontally filtered line, read from the rows the filter pass made. The phases of an
+// emulated pixel run from its left edge to its right, so blending the two nearest never mixes
+// in the next pixel's. Also zero's off screen.
+vec3 Horz(sampler2D rows,vec2 pos,float off)
+{
+  vec2 texel=pos*res;
+  float line=floor(texel.y)+off;
+  if(line<0.0||line>=res.y)return defaultColor;
+  float column=floor(texel.x);
+  float phase=(texel.x-column)*float(filterPhases-1);
+  vec2 rowPos=vec2((column*float(filterPhases)+phase+0.5)/(res.x*float(filterPhases)),(line+0.5)/res.y);
+  return texture(rows,rowPos).rgb;
+}
+
+// Return scanline weight.
+float Scan(vec2 pos,float off)
+{
+  float dst=Dist(pos).y;
+  return Gaus(dst+off,-8.0);
+}
+
+// Allow nearest three lines to effect pixel.
+vec3 Tri(vec2 pos)
+{
+  vec3 a=Horz(filteredRows3,pos,-1.0);
+  vec3 b=Horz(filteredRows5,pos, 0.0);
+  vec3 c=Horz(filteredRows3,pos, 1.0);
+  float wa=Scan(pos,-1.0);
+  float wb=Scan(pos, 0.0);
+  float wc=Scan(pos, 1.0);
+  return a*wa+b*wb+c*wc;
+}
+
+// The filter as it was before it was split into passes, kept so golden frames can check the
+// split one against it. Nearest emulated sample given floating point position and texel offset.
+// Also zero's off screen.
+vec3 Fetch(vec2 pos,vec2 off)
+{
+  pos=floor(pos*res+off)/res;
+  if(max(abs(pos.x-0.5),abs(pos.y-0.5))>0.5)return defaultColor;
+  return texture(texSampler,pos.xy*fubo.renderScale,-16.0).rgb;
+}
+
 // 3-tap Gaussian filter along horz line.
 vec3 Horz3(vec2 pos,float off)
 {
@@ -79,15 +129,8 @@ vec3 Horz5(vec2 pos,float off)
   return (a*wa+b*wb+c*wc+d*wd+e*we)/(wa+wb+wc+wd+we);
 }
 
-// Return scanline weight.
-float Scan(vec2 pos,float off)
-{
-  float dst=Dist(pos).y;
-  return Gaus(dst+off,-8.0);
-}
-
-// Allow nearest three lines to effect pixel.
-vec3 Tri(vec2 pos)
+// Allow nearest three lines to effect pixel, with the original filter.
+vec3 TriReference(vec2 pos)
 {
   vec3 a=Horz3(pos,-1.0);
   vec3 b=Horz5(pos, 0.0);
@@ -98,6 +141,22 @@ vec3 Tri(vec2 pos)
   return a*wa+b*wb+c*wc;
 }
 
+// Cheap scanlines. The nearest emulated pixel with the same brightness across the line as Tri,
+// but no blur.
+vec3 Nearest(vec2 pos)
+{
+  vec3 b=texelFetch(virtualScene,ivec2(clamp(pos*res,vec2(0.0),res-1.0)),0).rgb;
+  return b*(Scan(pos,-1.0)+Scan(pos,0.0)+Scan(pos,1.0));
+}
+
+// Where a screen position lands in the part of the scene that was drawn to. Kept half a texel
+// inside it, so filtering never reads what wasn't.
+vec2 ScenePos(vec2 pos)
+{
+  vec2 size=vec2(fubo.screenWidth,fubo.screenHeight);
+  return min(pos*fubo.renderScale,(fubo.renderScale*size-0.5)/size);
+}
+
 // Shadow mask.
 vec3 Mask(vec2 pos)
 {
@@ -140,9 +199,34 @@ void main()
   }
   else
   {
-    vec4 maskValue = texture(glitchMask, newTexCoords);
-    
-    vec3 newColor= (Tri(newTexCoords)*Mask(newTexCoords * res * 6.0) * (1.0 - maskValue.a)) + (texture(texSampler, newTexCoords).rgb * maskValue.rgb * maskValue.a);
+    vec2 scenePos = ScenePos(newTexCoords);
+    vec4 maskValue = texture(glitchMask, scenePos);
+
+    // The CRT look at the chosen quality, or the plain scene with it off
+    vec3 crtColor;
+    if (fubo.crtQuality == crtFull)
+    {
+      crtColor = Tri(newTexCoords)*Mask(newTexCoords * res * 6.0);
+    }
+    else if (fubo.crtQuality == crtScanline)
+    {
+      crtColor = Nearest(newTexCoords)*Mask(newTexCoords * res * 6.0);
+    }
+    else if (fubo.crtQuality == crtReference)
+    {
+      crtColor = TriReference(newTexCoords)*Mask(newTexCoords * res * 6.0);
+    }
+    else
+    {
+      crtColor = texture(texSampler, scenePos).rgb;
+    }
+
+    // Glitches show the scene through the mask, skipped where there are none
+    vec3 newColor = crtColor * (1.0 - maskValue.a);
+    if (maskValue.a > 0.0)
+    {
+      newColor += texture(texSampler, scenePos).rgb * maskValue.rgb * maskValue.a;
+    }
     outColor = vec4(newColor, 1.0);
   }
 }
\ No newline at end of file